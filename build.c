@@ -6,12 +6,32 @@
 #define DIR_SRC "src/"
 #define DIR_DEPS "deps/"
 #define DIR_DST "fossil/" /* your project name */
+#define DIR_OBJ "obj/"
+#define DIR_OBJ_PGO DIR_OBJ"pgo/"
+#define DIR_PROFILE DIR_OBJ_PGO"profile/"
+#define DIR_PGO_TRAIN "tests/pgo_train/"
+#define PGO_TRAIN_RUNS 3 /* timed runs per build, best is kept */
+#define FILE_PATHS DIR_OBJ_PGO"paths.txt" /* per-path timings written by the training workload */
+#define PATH_COUNT_MAX 16
+#define DIR_MODES DIR_OBJ_PGO"modes/"
+#define MODES_ROUNDS 3 /* rounds of `./build modes`, best of each path is kept */
+
+/*! @brief how the engine's sources are compiled and linked, for @ref build_lib().
+ */
+enum build_mode
+{
+    BUILD_MODE_SEPARATE =   0x0000, /* one object per source */
+    BUILD_MODE_UNITY =      0x0001, /* amalgamated translation units, @ref compile_unity() */
+    BUILD_MODE_LTO =        0x0002, /* link-time optimization */
+}; /* build_mode */
 
-bt_buf cmd = {0};
+bt_buf cmd = {0};       /* compile cmd */
+bt_buf cmd_link = {0};  /* link cmd */
+bt_buf src = {0};       /* source files */
+bt_buf cmd_train = {0}; /* pgo training workload cmd */
 
 static str str_cflags[][CMD_SIZE] =
 {
-    "-shared",
     "-fPIC",
     "-fvisibility=hidden",
     "-std="FSL_ENGINE_C_STD,
@@ -21,6 +41,13 @@ static str str_cflags[][CMD_SIZE] =
     "-Ofast"
 };
 
+static str str_cflags_pgo_train[][CMD_SIZE] =
+{
+    "-std="FSL_ENGINE_C_STD,
+    "-D_GNU_SOURCE",
+    "-Ofast"
+};
+
 static str str_cflags_debug[][CMD_SIZE] =
 {
     "-Wall",
@@ -44,7 +71,9 @@ static str str_files[][CMD_SIZE] =
     DIR_SRC"input/input.c",
     DIR_SRC"logger/logger.c",
     DIR_SRC"math/math.c",
+    DIR_SRC"math/math_kernels.c",
     DIR_SRC"math/perlin_noise.c",
+    DIR_SRC"memory/hash_map.c",
     DIR_SRC"memory/memory.c",
     DIR_SRC"physics/collision.c",
     DIR_SRC"physics/physics.c",
@@ -54,14 +83,18 @@ static str str_files[][CMD_SIZE] =
     DIR_SRC"ui/ui.c",
     DIR_SRC"ui/ui_element.c",
     DIR_SRC"ui/ui_event.c",
+    DIR_SRC"cpu.c",
     DIR_SRC"dir.c",
+    DIR_SRC"io.c",
     DIR_SRC FSL_FILE_NAME_PLATFORM,
     DIR_SRC"time.c"
 };
 
 static str str_files_plugins[][CMD_SIZE] =
 {
+    DIR_SRC"plugins/fsl_native/noise_graph/noise_graph.c",
     DIR_SRC"plugins/fsl_native/noise_sampler/noise_sampler.c",
+    DIR_SRC"plugins/fsl_native/noise_sampler/noise_sampler_cache.c",
     DIR_SRC"plugins/fsl_native/noise_sampler/noise_sampler_sample.c"
 };
 
@@ -97,6 +130,7 @@ static str str_make_dir_plugins[][CMD_SIZE] =
 {
     DIR_DST DIR_DEPS DIR_DST"plugins/",
     DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/",
+    DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/noise_graph/",
     DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/noise_sampler/"
 };
 
@@ -121,6 +155,7 @@ static str *copy_targets[][48] =
     {DIR_SRC"math/noise.h",                 DIR_DST DIR_DEPS DIR_DST"math/"},
     {DIR_SRC"math/trigonometry.h",          DIR_DST DIR_DEPS DIR_DST"math/"},
     {DIR_SRC"math/vector.h",                DIR_DST DIR_DEPS DIR_DST"math/"},
+    {DIR_SRC"memory/hash_map.h",            DIR_DST DIR_DEPS DIR_DST"memory/"},
     {DIR_SRC"memory/memory.h",              DIR_DST DIR_DEPS DIR_DST"memory/"},
     {DIR_SRC"memory/memory_types.h",        DIR_DST DIR_DEPS DIR_DST"memory/"},
     {DIR_SRC"physics/collision.h",          DIR_DST DIR_DEPS DIR_DST"physics/"},
@@ -136,13 +171,48 @@ static str *copy_targets[][48] =
 
 static str *copy_targets_plugins[][48] =
 {
+    {DIR_SRC"plugins/fsl_native/noise_graph/noise_graph.h", DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/noise_graph/"},
     {DIR_SRC"plugins/fsl_native/noise_sampler/noise_sampler.h", DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/noise_sampler/"},
+    {DIR_SRC"plugins/fsl_native/noise_sampler/noise_sampler_cache.h", DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/noise_sampler/"},
     {DIR_SRC"plugins/fsl_native/noise_sampler/noise_sampler_sample.h", DIR_DST DIR_DEPS DIR_DST"plugins/fsl_native/noise_sampler/"}
 };
 
+/*!
+ *  @brief compile and link the engine into 'lib/<platform>/'.
+ *
+ *  @param pgo_stage enum @ref pgo_stage, both pgo stages compile into @ref DIR_OBJ_PGO.
+ *  @param mode enum @ref build_mode, combined.
+ */
+static void build_lib(int argc, char **argv, u32 pgo_stage, u32 mode);
+
+/*!
+ *  @brief copy headers, assets and libs into the distribution directory @ref DIR_DST.
+ */
+static void build_dist(void);
+
+/*!
+ *  @brief build and run the training workload 'tests/pgo_train/' against 'lib/<platform>/'.
+ *
+ *  @param runs number of runs, 1 for training.
+ *  @param paths also time each hot path alone, into @ref FILE_PATHS.
+ *
+ *  @return shortest run time in nanoseconds.
+ */
+static u64 pgo_train(u32 runs, b8 paths);
+
+/*!
+ *  @brief build the engine separate, unity and lto, time the training workload and each
+ *  of its hot paths against each, taking turns for @ref MODES_ROUNDS rounds, and print
+ *  the best of each side by side.
+ */
+static void build_modes(int argc, char **argv);
+
 int main(int argc, char **argv)
 {
     u32 i = 0;
+    u32 mode = BUILD_MODE_SEPARATE;
+    u64 time_base = 0;
+    u64 time_pgo = 0;
 
     /* if error, will fail and exit */
     build_init(argc, argv, "build.c", "build"EXE);
@@ -166,9 +236,65 @@ int main(int argc, char **argv)
             cmd_fail(&cmd);
     }
 
+    if (find_token("unity", argc, argv))
+        mode |= BUILD_MODE_UNITY;
+    if (find_token("lto", argc, argv))
+        mode |= BUILD_MODE_LTO;
+
+    if (find_token("modes", argc, argv))
+    {
+        build_modes(argc, argv);
+        build_lib(argc, argv, PGO_STAGE_NONE, mode);
+        build_dist();
+        return ERR_SUCCESS;
+    }
+
+    if (!find_token("pgo", argc, argv))
+    {
+        build_lib(argc, argv, PGO_STAGE_NONE, mode);
+        build_dist();
+        return ERR_SUCCESS;
+    }
+
+    /* ---- profile-guided optimization ------------------------------------- */
+
+    LOGINFO(FALSE, "Building With Profile-Guided Optimization, Baseline..\n");
+    build_lib(argc, argv, PGO_STAGE_NONE, mode);
+    build_dist();
+    time_base = pgo_train(PGO_TRAIN_RUNS, FALSE);
+
+    LOGINFO(FALSE, "Building With Profile-Guided Optimization, Instrumented..\n");
+    if (pgo_reset(DIR_PROFILE) != ERR_SUCCESS)
+        cmd_fail(&cmd);
+    build_lib(argc, argv, PGO_STAGE_GENERATE, mode);
+    pgo_train(1, FALSE);
+
+    LOGINFO(FALSE, "Building With Profile-Guided Optimization, Optimized..\n");
+    build_lib(argc, argv, PGO_STAGE_USE, mode);
+    time_pgo = pgo_train(PGO_TRAIN_RUNS, FALSE);
+    build_dist();
+
+    LOGINFO(FALSE,
+            logger_stringf("Training Workload: Baseline %.3lfs, Optimized %.3lfs, Speedup %.3lfx\n",
+                (f64)time_base / 1e9, (f64)time_pgo / 1e9, (f64)time_base / (f64)time_pgo));
+
+    return ERR_SUCCESS;
+}
+
+void build_lib(int argc, char **argv, u32 pgo_stage, u32 mode)
+{
+    const str *dir_obj = pgo_stage == PGO_STAGE_NONE ? DIR_OBJ : DIR_OBJ_PGO;
+    u32 i = 0;
+
+    cmd_free(&cmd);
+    cmd_free(&cmd_link);
+    cmd_free(&src);
+
     /* ---- building `cmd` -------------------------------------------------- */
 
     cmd_push(&cmd, COMPILER);
+    cmd_push(&cmd_link, COMPILER);
+    cmd_push(&cmd_link, "-shared");
 
     if (find_token("release", argc, argv))
     {
@@ -179,30 +305,61 @@ int main(int argc, char **argv)
     {
         LOGWARNING(0, FALSE, "Building in Debug Mode..\n");
         for (i = 0; i < arr_len(str_cflags_debug); ++i)
+        {
             cmd_push(&cmd, str_cflags_debug[i]);
+            cmd_push(&cmd_link, str_cflags_debug[i]);
+        }
     }
 
     cmd_push(&cmd, stringf("-ffile-prefix-map=%s=", DIR_BUILDTOOL_BIN_ROOT));
     for (i = 0; i < arr_len(str_cflags); ++i)
+    {
         cmd_push(&cmd, str_cflags[i]);
+        cmd_push(&cmd_link, str_cflags[i]);
+    }
 
-    fsl_engine_set_runtime_path(&cmd);
-    for (i = 0; i < arr_len(fsl_str_libs_internal); ++i)
-        cmd_push(&cmd, fsl_str_libs_internal[i]);
+    if (mode & BUILD_MODE_LTO)
+    {
+        LOGINFO(FALSE, "Building With Link-Time Optimization..\n");
+        cmd_push(&cmd, "-flto=auto");
+        cmd_push(&cmd_link, "-flto=auto");
+    }
+
+    cmd_push_pgo(&cmd, pgo_stage, DIR_PROFILE);
+    cmd_push_pgo(&cmd_link, pgo_stage, DIR_PROFILE);
+    cmd_ready(&cmd);
 
     for (i = 0; i < arr_len(str_files); ++i)
-        cmd_push(&cmd, str_files[i]);
+        cmd_push(&src, str_files[i]);
 
     for (i = 0; i < arr_len(str_files_plugins); ++i)
-        cmd_push(&cmd, str_files_plugins[i]);
+        cmd_push(&src, str_files_plugins[i]);
 
-    cmd_push(&cmd, "-o");
-    cmd_push(&cmd, "lib/"PLATFORM"/"FSL_FILE_NAME_LIB);
-    cmd_ready(&cmd);
-
-    if (exec(&cmd, "build().cmd") != ERR_SUCCESS)
+    if (mode & BUILD_MODE_UNITY)
+    {
+        if (compile_unity(&cmd, &src, dir_obj, "fossil", &cmd_link) != ERR_SUCCESS)
+            cmd_fail(&cmd);
+    }
+    else if (compile(&cmd, &src, dir_obj, &cmd_link) != ERR_SUCCESS)
         cmd_fail(&cmd);
 
+    fsl_engine_set_runtime_path(&cmd_link);
+    for (i = 0; i < arr_len(fsl_str_libs_internal); ++i)
+        cmd_push(&cmd_link, fsl_str_libs_internal[i]);
+
+    cmd_push(&cmd_link, "-o");
+    cmd_push(&cmd_link, "lib/"PLATFORM"/"FSL_FILE_NAME_LIB);
+    cmd_ready(&cmd_link);
+
+    /* one stamp for all stages, so switching stages relinks */
+    if (link_objects(&cmd_link, "lib/"PLATFORM"/"FSL_FILE_NAME_LIB, DIR_OBJ, "build().cmd_link") != ERR_SUCCESS)
+        cmd_fail(&cmd_link);
+}
+
+void build_dist(void)
+{
+    u32 i = 0;
+
     if (
             copy_dir(DIR_SRC"common/",      DIR_DST DIR_DEPS DIR_DST, FALSE) != ERR_SUCCESS ||
             copy_dir(DIR_SRC"external/buildtool/", DIR_DST DIR_DEPS DIR_DST"external/", FALSE) != ERR_SUCCESS ||
@@ -225,6 +382,130 @@ int main(int argc, char **argv)
     for (i = 0; i < arr_len(copy_targets_plugins); ++i)
         if (copy_file(copy_targets_plugins[i][0], copy_targets_plugins[i][1]) != ERR_SUCCESS)
             cmd_fail(&cmd);
+}
 
-    return ERR_SUCCESS;
+u64 pgo_train(u32 runs, b8 paths)
+{
+    bt_buf cmd_run = {0};
+    u64 time_best = 0, time = 0;
+    u32 i = 0;
+
+    make_dir(DIR_OBJ_PGO);
+    make_dir(DIR_OBJ_PGO DIR_DST);
+    if (
+            is_dir_exists(DIR_PGO_TRAIN"src/", TRUE) != ERR_SUCCESS ||
+            copy_dir("assets/", DIR_OBJ_PGO DIR_DST, FALSE) != ERR_SUCCESS)
+        cmd_fail(&cmd);
+
+    cmd_free(&cmd_train);
+    cmd_push(&cmd_train, COMPILER);
+    for (i = 0; i < arr_len(str_cflags_pgo_train); ++i)
+        cmd_push(&cmd_train, str_cflags_pgo_train[i]);
+    cmd_push(&cmd_train, DIR_PGO_TRAIN"src/main.c");
+    cmd_push(&cmd_train, "-Llib/"PLATFORM);
+    cmd_push(&cmd_train, "-lfossil");
+    cmd_push(&cmd_train, "-lm");
+    cmd_push(&cmd_train, stringf("-Wl,-rpath=%slib/"PLATFORM, DIR_BUILDTOOL_BIN_ROOT));
+    cmd_push(&cmd_train, "-o");
+    cmd_push(&cmd_train, DIR_OBJ_PGO"pgo_train"EXE);
+    cmd_ready(&cmd_train);
+
+    if (exec(&cmd_train, "pgo_train().cmd_train") != ERR_SUCCESS)
+        cmd_fail(&cmd_train);
+
+    /* training run logs everything, timed runs only summaries (argv[2] is the log level) */
+    cmd_push(&cmd_run, DIR_OBJ_PGO"pgo_train"EXE);
+    cmd_push(&cmd_run, "pgo");
+    cmd_push(&cmd_run, runs > 1 || paths ? "loginfo" : "logtrace");
+    if (paths)
+        cmd_push(&cmd_run, "paths");
+    cmd_ready(&cmd_run);
+
+    for (i = 0; i < runs; ++i)
+    {
+        time = get_time_nsec();
+        if (exec(&cmd_run, "pgo_train().cmd_run") != ERR_SUCCESS)
+            cmd_fail(&cmd_run);
+        time = get_time_nsec() - time;
+
+        if (!time_best || time < time_best)
+            time_best = time;
+    }
+
+    cmd_free(&cmd_run);
+    return time_best;
+}
+
+void build_modes(int argc, char **argv)
+{
+    static const str *mode_name[] = {"separate", "unity", "lto"};
+    static const u32 mode_list[] = {BUILD_MODE_SEPARATE, BUILD_MODE_UNITY, BUILD_MODE_LTO};
+    str path_name[PATH_COUNT_MAX][ID_CAP] = {0};
+    str lib[arr_len(mode_list)][PATH_CAP] = {0};
+    u64 path_time[arr_len(mode_list)][PATH_COUNT_MAX] = {0};
+    u64 time_best[arr_len(mode_list)] = {0};
+    u64 path_count = 0, len = 0, time = 0;
+    u32 i = 0, j = 0, round = 0;
+    str *buf = NULL, *cursor = NULL;
+    str line[ID_CAP] = {0};
+
+    make_dir(DIR_OBJ_PGO);
+    make_dir(DIR_MODES);
+    for (i = 0; i < arr_len(mode_list); ++i)
+    {
+        LOGINFO(FALSE, logger_stringf("Building Mode '%s'..\n", mode_name[i]));
+        build_lib(argc, argv, PGO_STAGE_NONE, mode_list[i]);
+        snprintf(lib[i], PATH_CAP, DIR_MODES"%s_"FSL_FILE_NAME_LIB, mode_name[i]);
+        if (copy_file("lib/"PLATFORM"/"FSL_FILE_NAME_LIB, lib[i]) != ERR_SUCCESS)
+            cmd_fail(&cmd_link);
+    }
+
+    /* modes take turns each round, so drift of the machine's speed hits them alike */
+    for (round = 0; round < MODES_ROUNDS; ++round)
+        for (i = 0; i < arr_len(mode_list); ++i)
+        {
+            LOGINFO(FALSE, logger_stringf("Timing Mode '%s', Round %"PRIu32"/%d..\n",
+                        mode_name[i], round + 1, MODES_ROUNDS));
+            remove(FILE_PATHS);
+            if (copy_file(lib[i], "lib/"PLATFORM"/"FSL_FILE_NAME_LIB) != ERR_SUCCESS)
+                cmd_fail(&cmd_link);
+            time = pgo_train(1, TRUE);
+            if (!time_best[i] || time < time_best[i])
+                time_best[i] = time;
+
+            if ((len = get_file_contents(FILE_PATHS, (void*)&buf, 1, TRUE)) == 0)
+                cmd_fail(&cmd_train);
+
+            for (j = 0, cursor = buf; j < PATH_COUNT_MAX &&
+                    sscanf(cursor, "%255s %"SCNu64, path_name[j], &time) == 2; ++j)
+            {
+                if (!path_time[i][j] || time < path_time[i][j])
+                    path_time[i][j] = time;
+                cursor = strchr(cursor, '\n') + 1;
+            }
+            path_count = j;
+            mem_free((void*)&buf, len + 1, "build_modes().buf");
+        }
+
+    /* the lib left is the last mode timed, relink the requested one */
+    remove("lib/"PLATFORM"/"FSL_FILE_NAME_LIB);
+
+    LOGINFO(FALSE, logger_stringf("Build Modes, Best of %d Rounds in Milliseconds:\n", MODES_ROUNDS));
+    snprintf(line, ID_CAP, "%-16s", "");
+    for (i = 0; i < arr_len(mode_list); ++i)
+        snprintf(line + strlen(line), ID_CAP - strlen(line), " %10s", mode_name[i]);
+    printf("%s\n", line);
+
+    for (j = 0; j < path_count; ++j)
+    {
+        snprintf(line, ID_CAP, "%-16s", path_name[j]);
+        for (i = 0; i < arr_len(mode_list); ++i)
+            snprintf(line + strlen(line), ID_CAP - strlen(line), " %10.3lf", (f64)path_time[i][j] * 1e-6);
+        printf("%s\n", line);
+    }
+
+    snprintf(line, ID_CAP, "%-16s", "whole run");
+    for (i = 0; i < arr_len(mode_list); ++i)
+        snprintf(line + strlen(line), ID_CAP - strlen(line), " %10.3lf", (f64)time_best[i] * 1e-6);
+    printf("%s\n", line);
 }
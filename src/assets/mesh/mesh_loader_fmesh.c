@@ -58,19 +58,28 @@ b8 mesh_is_cooked(const fsl_fs_path *path)
 
 u32 mesh_load_fmesh_internal(const fsl_fs_path *path, fsl_array *vertex_buf, fsl_array *index_buf)
 {
-    FILE *file = NULL;
+    u8 *file_map = NULL;
+    u64 file_len = 0;
+    u64 cursor = 0;
     fsl_file_format_fmesh file_data = {0};
     u64 cache[4] = {0};
+    u64 vertex_len = 0;
+    u64 index_len = 0;
+
+    if (fsl_file_map(path, (void*)&file_map, &file_len,
+                FSL_FLAG_FILE_MAP_SEQUENTIAL | FSL_FLAG_FILE_MAP_WILLNEED) != FSL_ERR_SUCCESS)
+        return fsl_err;
 
-    if ((file = fopen(path, "rb")) == NULL)
+    if (file_len < sizeof(u64) + strlen(MESH_FILE_ID) + 5 * sizeof(u64))
     {
-        LOGERROR(FSL_ERR_FILE_OPEN_FAIL,
+        LOGERROR(FSL_ERR_FILE_FORMAT_INVALID,
                 FSL_FLAG_LOG_NO_VERBOSE,
-                MSG_FILE_OPEN_FAIL(path));
-        return fsl_err;
+                MSG_ACTION_SUBJECT_REASON_ERROR("Load Mesh", path, "File Too Small"));
+        goto cleanup;
     }
 
-    fread(&file_data.asset_type, 1, sizeof(u64), file);
+    memcpy(&file_data.asset_type, file_map + cursor, sizeof(u64));
+    cursor += sizeof(u64);
     if (file_data.asset_type != FSL_ASSET_MESH)
     {
         LOGERROR(FSL_ERR_FILE_FORMAT_INVALID,
@@ -79,7 +88,8 @@ u32 mesh_load_fmesh_internal(const fsl_fs_path *path, fsl_array *vertex_buf, fsl
         goto cleanup;
     }
 
-    fread(file_data.id, 1, strlen(MESH_FILE_ID), file);
+    memcpy(file_data.id, file_map + cursor, strlen(MESH_FILE_ID));
+    cursor += strlen(MESH_FILE_ID);
     if (strncmp(file_data.id, MESH_FILE_ID, strlen(MESH_FILE_ID)))
     {
         LOGERROR(FSL_ERR_FILE_FORMAT_INVALID,
@@ -88,8 +98,10 @@ u32 mesh_load_fmesh_internal(const fsl_fs_path *path, fsl_array *vertex_buf, fsl
         goto cleanup;
     }
 
-    fread(cache, 1, 4 * sizeof(u64), file);
-    fread(&file_data.hash, 1, sizeof(u64), file);
+    memcpy(cache, file_map + cursor, 4 * sizeof(u64));
+    cursor += 4 * sizeof(u64);
+    memcpy(&file_data.hash, file_map + cursor, sizeof(u64));
+    cursor += sizeof(u64);
 
     if (file_data.hash != fsl_hash_fnv1a_u64(cache, 4 * sizeof(u64)))
     {
@@ -104,28 +116,40 @@ u32 mesh_load_fmesh_internal(const fsl_fs_path *path, fsl_array *vertex_buf, fsl
     file_data.index_size = cache[2];
     file_data.index_len = cache[3];
 
-    if (file_data.vertex_size && file_data.vertex_len &&
-            fsl_mem_array_init(vertex_buf) != FSL_ERR_SUCCESS)
+    /* header values are untrusted, compare by division so the products can't overflow */
+    if (
+            (file_data.vertex_size &&
+             file_data.vertex_len > (file_len - cursor) / file_data.vertex_size) ||
+            (file_data.index_size &&
+             file_data.index_len > (file_len - cursor -
+                 file_data.vertex_size * file_data.vertex_len) / file_data.index_size))
+    {
+        LOGERROR(FSL_ERR_FILE_DATA_CORRUPT,
+                FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_SUBJECT_REASON_ERROR("Load Mesh", path, "File Truncated"));
         goto cleanup;
+    }
 
-    if (file_data.index_size && file_data.index_len &&
-            fsl_mem_array_init(index_buf) != FSL_ERR_SUCCESS)
+    vertex_len = file_data.vertex_size * file_data.vertex_len;
+    index_len = file_data.index_size * file_data.index_len;
+
+    if (vertex_len && fsl_mem_array_init(vertex_buf) != FSL_ERR_SUCCESS)
         goto cleanup;
 
-    fsl_mem_array_push(vertex_buf, NULL, file_data.vertex_size * file_data.vertex_len);
-    fsl_mem_array_push(index_buf, NULL, file_data.index_size * file_data.index_len);
+    if (index_len && fsl_mem_array_init(index_buf) != FSL_ERR_SUCCESS)
+        goto cleanup;
 
-    fread(vertex_buf->buf, file_data.vertex_size, file_data.vertex_len, file);
-    fread(index_buf->buf, file_data.index_size, file_data.index_len, file);
+    fsl_mem_array_push(vertex_buf, file_map + cursor, vertex_len);
+    cursor += vertex_len;
+    fsl_mem_array_push(index_buf, file_map + cursor, index_len);
 
-    fclose(file);
+    fsl_file_unmap((void*)&file_map, file_len);
     fsl_err = FSL_ERR_SUCCESS;
     return fsl_err;
 
 cleanup:
 
-    if (file)
-        fclose(file);
+    fsl_file_unmap((void*)&file_map, file_len);
     return fsl_err;
 }
 
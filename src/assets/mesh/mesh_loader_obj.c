@@ -27,6 +27,7 @@
 #include "../../logger/logger_messages_internal.h"
 #include "../../math/math.h"
 #include "../../math/vector.h"
+#include "../../memory/hash_map.h"
 #include "../../memory/memory.h"
 #include "../../string/string.h"
 
@@ -37,16 +38,7 @@
 #include <stdio.h>
 #include <string.h>
 
-#define HASH_TABLE_MAX 8192
-
-typedef struct hash_node hash_node;
-
-struct hash_node
-{
-    u64 hash;
-    u64 index;
-    hash_node *next;
-}; /* hash_node */
+#define VERTEX_MAP_CAP 8192
 
 struct vertex_indices
 {
@@ -55,6 +47,12 @@ struct vertex_indices
     u32 uv;
 }; /* vertex_indices */
 
+struct vertex_entry
+{
+    struct vertex_indices key;
+    u32 index;
+}; /* vertex_entry */
+
 struct triangle_indices
 {
     u32 first;
@@ -79,6 +77,14 @@ struct triangle_indices
 static void get_vertex_indices_internal(str *token, struct vertex_indices *vertex,
         fsl_len pos_len, fsl_len uv_len, fsl_len normal_len);
 
+/*!
+ *  @internal
+ *
+ *  @brief @ref fsl_hash_map_key_eq for vertex de-duplication, so colliding hashes
+ *  don't merge different vertices.
+ */
+static b8 vertex_entry_eq_internal(const void *val, const void *key);
+
 u32 mesh_load_obj_internal(const fsl_fs_path *path, fsl_array *vertex_dst, fsl_array *index_dst)
 {
     FILE *file = NULL;
@@ -96,20 +102,21 @@ u32 mesh_load_obj_internal(const fsl_fs_path *path, fsl_array *vertex_dst, fsl_a
     f32 vertex_w = 0.0f;
     u64 vertex_hash = 0;
     u64 vertex_hash_index = 0;
+    struct vertex_entry vertex_entry = {0};
+    struct vertex_entry *vertex_entry_found = NULL;
 
     fsl_array vertex_buf = {0};
     fsl_array uv_buf = {0};
     fsl_array normal_buf = {0};
 
-    hash_node *node_curr = NULL;
-    hash_node *node_new = NULL;
-    hash_node *hash_table = NULL;
-    u64 bucket_index = 0;
-    b8 hash_found = FALSE;
+    fsl_mem_arena vertex_arena = {0};
+    fsl_hash_map vertex_map = {0};
 
     if (
-            fsl_mem_map((void*)&hash_table, HASH_TABLE_MAX * sizeof(hash_node),
-                "mesh_load_obj_internal().hash_table") != FSL_ERR_SUCCESS ||
+            fsl_mem_arena_init(&vertex_arena,
+                "mesh_load_obj_internal().vertex_arena") != FSL_ERR_SUCCESS ||
+            fsl_hash_map_init(&vertex_map, &vertex_arena, VERTEX_MAP_CAP,
+                sizeof(struct vertex_entry), vertex_entry_eq_internal) != FSL_ERR_SUCCESS ||
             fsl_mem_array_init(&vertex_buf) != FSL_ERR_SUCCESS ||
             fsl_mem_array_init(&uv_buf) != FSL_ERR_SUCCESS ||
             fsl_mem_array_init(&normal_buf) != FSL_ERR_SUCCESS ||
@@ -202,28 +209,12 @@ u32 mesh_load_obj_internal(const fsl_fs_path *path, fsl_array *vertex_dst, fsl_a
                         uv_buf.cursor / sizeof(v2f32),
                         normal_buf.cursor / sizeof(v3f32));
                 vertex_hash = fsl_hash_djb2_u64(&vertex_indices, 3 * sizeof(u32));
-                bucket_index = vertex_hash & (HASH_TABLE_MAX - 1);
-                node_curr = &hash_table[bucket_index];
+                vertex_entry.key = vertex_indices;
+                vertex_entry.index = vertex_dst->cursor / sizeof(struct mesh_vertex);
 
-                while (node_curr)
+                if (fsl_hash_map_insert(&vertex_map, vertex_hash, &vertex_indices,
+                            &vertex_entry, (void*)&vertex_entry_found) == FSL_ERR_SUCCESS)
                 {
-                    if (node_curr->hash == vertex_hash)
-                    {
-                        vertex_hash_index = node_curr->index;
-                        hash_found = TRUE;
-                        break;
-                    }
-                    node_curr = node_curr->next;
-                }
-
-                if (!hash_found)
-                {
-                    node_new = &hash_table[bucket_index];
-                    node_new->hash = vertex_hash;
-                    node_new->index = vertex_dst->cursor / sizeof(struct mesh_vertex);
-                    node_new->next = node_curr;
-
-                    vertex_hash_index = node_new->index;
                     vertex = novertex;
                     if (vertex_indices.pos)
                         vertex.pos = *((v3f32*)vertex_buf.buf + vertex_indices.pos - 1);
@@ -233,7 +224,12 @@ u32 mesh_load_obj_internal(const fsl_fs_path *path, fsl_array *vertex_dst, fsl_a
                         vertex.normal = *((v3f32*)normal_buf.buf + vertex_indices.normal - 1);
                     fsl_mem_array_push(vertex_dst, &vertex, sizeof(struct mesh_vertex));
                 }
+                else if (fsl_err == FSL_ERR_KEY_EXISTS)
+                    fsl_err = FSL_ERR_SUCCESS; /* vertex already emitted, reuse its index */
+                else
+                    goto cleanup;
 
+                vertex_hash_index = vertex_entry_found->index;
                 triangle.curr = vertex_hash_index;
                 if (i == 0)
                     triangle.first = triangle.curr;
@@ -246,8 +242,8 @@ u32 mesh_load_obj_internal(const fsl_fs_path *path, fsl_array *vertex_dst, fsl_a
     }
 
     fclose(file);
-    fsl_mem_unmap((void*)&hash_table, HASH_TABLE_MAX * sizeof(hash_node*),
-            "mesh_load_obj_internal().hash_table");
+    fsl_hash_map_free(&vertex_map);
+    fsl_mem_arena_free(&vertex_arena, "mesh_load_obj_internal().vertex_arena");
     fsl_mem_array_free(&vertex_buf);
     fsl_mem_array_free(&uv_buf);
     fsl_mem_array_free(&normal_buf);
@@ -259,8 +255,8 @@ cleanup:
 
     if (file)
         fclose(file);
-    fsl_mem_unmap((void*)&hash_table, HASH_TABLE_MAX * sizeof(hash_node*),
-            "mesh_load_obj_internal().hash_table");
+    fsl_hash_map_free(&vertex_map);
+    fsl_mem_arena_free(&vertex_arena, "mesh_load_obj_internal().vertex_arena");
     fsl_mem_array_free(vertex_dst);
     fsl_mem_array_free(index_dst);
     fsl_mem_array_free(&vertex_buf);
@@ -325,3 +321,11 @@ static void get_vertex_indices_internal(str *token, struct vertex_indices *verte
     vertex->uv = (u32)index[1];
     vertex->normal = (u32)index[2];
 }
+
+static b8 vertex_entry_eq_internal(const void *val, const void *key)
+{
+    const struct vertex_indices *a = &((const struct vertex_entry*)val)->key;
+    const struct vertex_indices *b = key;
+
+    return a->pos == b->pos && a->uv == b->uv && a->normal == b->normal;
+}
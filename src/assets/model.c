@@ -33,7 +33,9 @@ void fsl_model_draw(const fsl_model *model, const fsl_camera *camera,
         GLuint texture_id)
 {
     fsl_shader_program *shader = fsl_mem_handle_get(fsl_shader_buf);
-    m4f32 transform = fsl_multiply_m4f32(model->mat_model, camera->projection.perspective);
+    m4f32 transform = {0};
+
+    fsl_multiply_m4f32_ptr(&model->mat_model, &camera->projection.perspective, &transform);
 
     glBindBuffer(GL_ARRAY_BUFFER, model->mesh.transform_buf.id);
     glBufferData(GL_ARRAY_BUFFER, sizeof(m4f32), &transform, GL_DYNAMIC_DRAW);
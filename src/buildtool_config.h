@@ -69,6 +69,7 @@
         "-lm",
         "-lmvec",
         "-lglfw",
+        "-lpthread",
     };
 
     /*!
@@ -80,6 +81,7 @@
         "-lm",
         "-lglfw",
         "-lfossil",
+        "-lpthread",
     };
 
 #endif /* FSL_PLATFORM */
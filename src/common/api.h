@@ -65,4 +65,13 @@
 #   define FSLAPI
 #endif /* FSLAPI */
 
+/*!
+ *  @brief minimum alignment of a type, in bytes, placed after the type in a `typedef`.
+ */
+#if defined(__GNUC__)
+#   define FSL_ALIGN(n) __attribute__((aligned(n)))
+#else
+#   define FSL_ALIGN(n)
+#endif /* FSL_ALIGN */
+
 #endif /* FSL_API_H */
@@ -26,7 +26,8 @@
 enum fsl_flag
 {
     FSL_FLAG_RELEASE_BUILD =        0x0001, /* output 'TRACE' and 'DEBUG' logs to console */
-    FSL_FLAG_MULTISAMPLE =          0x0002  /* use 'GLFW' multisampling */
+    FSL_FLAG_MULTISAMPLE =          0x0002, /* use 'GLFW' multisampling */
+    FSL_FLAG_HEADLESS =             0x0004  /* no window, no 'OpenGL' context, no ui */
 }; /* fsl_flag */
 
 #endif /* FSL_COMMON_VALUES_H */
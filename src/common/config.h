@@ -33,7 +33,6 @@
 #define FSL_FILE_NAME_LOG_ERROR         "log_error.log"
 #define FSL_FILE_NAME_LOG_INFO          "log_info.log"
 #define FSL_FILE_NAME_LOG_EXTRA         "log_verbose.log"
-#define FSL_FILE_NAME_LOOKUP_RAND_TAB   "lookup_rand_tab.bin"
 
 #define FSL_FILE_FORMAT_NAME_FOSSIL_MESH "fmesh"
 
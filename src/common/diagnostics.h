@@ -102,6 +102,11 @@
 #define FSL_ERR_FILE_FORMAT_INVALID         4159
 #define FSL_ERR_FILE_DATA_CORRUPT           4160
 #define FSL_ERR_DIR_EMPTY                   4161
+#define FSL_ERR_KEY_EXISTS                  4162
+#define FSL_ERR_FILE_COPY_FAIL              4163
+#define FSL_ERR_IO_INIT_FAIL                4164
+#define FSL_ERR_FILE_WRITE_FAIL             4165
+#define FSL_ERR_CPU_LEVEL_UNSUPPORTED       4166
 
 /*!
  *  @brief global variable for engine-specific error codes.
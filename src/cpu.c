@@ -0,0 +1,239 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file cpu.c
+ *
+ *  @brief cpu feature detection and kernel dispatch.
+ */
+
+#include "common/diagnostics.h"
+#include "logger/logger.h"
+#include "logger/logger_messages_internal.h"
+#include "math/math_kernels_internal.h"
+
+#include "h/cpu.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(FSL_KERNELS_X86)
+#   include <cpuid.h>
+#endif /* FSL_KERNELS_X86 */
+
+fsl_kernel_table fsl_kernels =
+{
+    multiply_m4f32_scalar_internal,
+    transform_v4f32_scalar_internal,
+    transpose_m4f32_scalar_internal,
+    inverse_m4f32_scalar_internal,
+    sincos_f32_scalar_internal,
+    perlin_noise_1d_scalar_internal,
+    perlin_noise_2d_scalar_internal,
+    perlin_noise_3d_scalar_internal,
+};
+
+static struct cpu_internal
+{
+    b8 initialized;
+    u32 features;   /* enum @ref fsl_cpu_feature */
+    u32 level_max;  /* enum @ref fsl_cpu_level */
+    u32 level;      /* enum @ref fsl_cpu_level */
+} cpu_internal;
+
+static const str *cpu_level_name[FSL_CPU_LEVEL_COUNT] =
+{
+    "scalar",
+    "sse4.1",
+    "avx2",
+    "avx512",
+};
+
+/*!
+ *  @internal
+ *
+ *  @brief query cpuid and the OS-enabled register state (XCR0).
+ *
+ *  @return enum @ref fsl_cpu_feature flags.
+ */
+static u32 detect_internal(void);
+
+u32 fsl_cpu_init(void)
+{
+    const str *env = getenv("FSL_CPU_LEVEL");
+    u32 level = 0;
+    u32 i = 0;
+
+    if (cpu_internal.initialized)
+        return FSL_ERR_SUCCESS;
+
+    cpu_internal.features = detect_internal();
+
+    if ((cpu_internal.features & FSL_CPU_FEATURE_SSE41))
+        cpu_internal.level_max = FSL_CPU_LEVEL_SSE41;
+    if (cpu_internal.level_max == FSL_CPU_LEVEL_SSE41 &&
+            (cpu_internal.features & FSL_CPU_FEATURE_AVX2) &&
+            (cpu_internal.features & FSL_CPU_FEATURE_FMA))
+        cpu_internal.level_max = FSL_CPU_LEVEL_AVX2;
+    if (cpu_internal.level_max == FSL_CPU_LEVEL_AVX2 &&
+            (cpu_internal.features & FSL_CPU_FEATURE_AVX512F))
+        cpu_internal.level_max = FSL_CPU_LEVEL_AVX512;
+
+    level = cpu_internal.level_max;
+    if (env)
+    {
+        for (i = 0; i < FSL_CPU_LEVEL_COUNT; ++i)
+            if (!strcmp(env, cpu_level_name[i]))
+                break;
+
+        if (i < FSL_CPU_LEVEL_COUNT)
+            level = i;
+        else
+            LOGWARNING(FSL_ERR_CPU_LEVEL_UNSUPPORTED, 0, MSG_CPU_LEVEL_UNKNOWN(env));
+    }
+
+    cpu_internal.initialized = TRUE;
+    fsl_cpu_set_level(level);
+
+    LOGTRACE(0, MSG_CPU_INIT(cpu_level_name[cpu_internal.level]));
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+u32 fsl_cpu_get_features(void)
+{
+    fsl_cpu_init();
+    return cpu_internal.features;
+}
+
+u32 fsl_cpu_get_level_max(void)
+{
+    fsl_cpu_init();
+    return cpu_internal.level_max;
+}
+
+u32 fsl_cpu_get_level(void)
+{
+    fsl_cpu_init();
+    return cpu_internal.level;
+}
+
+u32 fsl_cpu_set_level(u32 level)
+{
+    fsl_cpu_init();
+
+    if (level > cpu_internal.level_max)
+        level = cpu_internal.level_max;
+
+    fsl_cpu_get_kernels(level, &fsl_kernels);
+    cpu_internal.level = level;
+    return level;
+}
+
+u32 fsl_cpu_get_kernels(u32 level, fsl_kernel_table *dst)
+{
+    fsl_cpu_init();
+
+    if (level > cpu_internal.level_max)
+    {
+        LOGERROR(FSL_ERR_CPU_LEVEL_UNSUPPORTED, 0,
+                MSG_ACTION_REASON_ERROR("Get CPU Kernels", "Level Not Supported"));
+        return fsl_err;
+    }
+
+    /* levels are cumulative, a level without its own kernel keeps the one below */
+    dst->multiply_m4f32 = multiply_m4f32_scalar_internal;
+    dst->transform_v4f32 = transform_v4f32_scalar_internal;
+    dst->transpose_m4f32 = transpose_m4f32_scalar_internal;
+    dst->inverse_m4f32 = inverse_m4f32_scalar_internal;
+    dst->sincos_f32 = sincos_f32_scalar_internal;
+    dst->perlin_noise_1d = perlin_noise_1d_scalar_internal;
+    dst->perlin_noise_2d = perlin_noise_2d_scalar_internal;
+    dst->perlin_noise_3d = perlin_noise_3d_scalar_internal;
+
+#if defined(FSL_KERNELS_X86)
+    if (level >= FSL_CPU_LEVEL_SSE41)
+    {
+        dst->multiply_m4f32 = multiply_m4f32_sse41_internal;
+        dst->transform_v4f32 = transform_v4f32_sse41_internal;
+        dst->transpose_m4f32 = transpose_m4f32_sse41_internal;
+        dst->inverse_m4f32 = inverse_m4f32_sse41_internal;
+    }
+
+    if (level >= FSL_CPU_LEVEL_AVX2)
+    {
+        dst->multiply_m4f32 = multiply_m4f32_avx2_internal;
+        dst->transform_v4f32 = transform_v4f32_avx2_internal;
+        dst->sincos_f32 = sincos_f32_avx2_internal;
+        dst->perlin_noise_1d = perlin_noise_1d_avx2_internal;
+        dst->perlin_noise_2d = perlin_noise_2d_avx2_internal;
+        dst->perlin_noise_3d = perlin_noise_3d_avx2_internal;
+    }
+
+    if (level >= FSL_CPU_LEVEL_AVX512)
+    {
+        dst->multiply_m4f32 = multiply_m4f32_avx512_internal;
+        dst->transform_v4f32 = transform_v4f32_avx512_internal;
+        dst->transpose_m4f32 = transpose_m4f32_avx512_internal;
+    }
+#endif /* FSL_KERNELS_X86 */
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+static u32 detect_internal(void)
+{
+    u32 features = 0;
+#if defined(FSL_KERNELS_X86)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    unsigned int xcr0_lo = 0, xcr0_hi = 0;
+    b8 osxsave = FALSE;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+
+    if (ecx & bit_SSE4_1)
+        features |= FSL_CPU_FEATURE_SSE41;
+
+    /* the OS must save the wide registers on context switch, or using them corrupts state */
+    osxsave = (ecx & bit_OSXSAVE) != 0;
+    if (!osxsave)
+        return features;
+
+    __asm__ __volatile__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+
+    /* xmm, ymm */
+    if ((xcr0_lo & 0x06) != 0x06)
+        return features;
+
+    if (ecx & bit_FMA)
+        features |= FSL_CPU_FEATURE_FMA;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return features;
+
+    if (ebx & bit_AVX2)
+        features |= FSL_CPU_FEATURE_AVX2;
+
+    /* opmask, zmm0-15 upper halves, zmm16-31 */
+    if ((ebx & bit_AVX512F) && (xcr0_lo & 0xe6) == 0xe6)
+        features |= FSL_CPU_FEATURE_AVX512F;
+#endif /* FSL_KERNELS_X86 */
+
+    return features;
+}
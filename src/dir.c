@@ -37,6 +37,108 @@
 #include <fcntl.h>
 #include <errno.h>
 
+#define COPY_FILE_CHUNK (64 * 1024)
+
+/* initial entry capacity of @ref fsl_get_dir_contents_ex(), doubled as needed */
+#define DIR_CONTENTS_CAP_MIN 64
+
+/* pending renames per write batch, a full batch is committed early */
+#define WRITE_BATCH_CAP 64
+
+static struct
+{
+    b8 active;
+    u64 count;
+    struct
+    {
+        int fd;
+        const fsl_dir_handle *dir;  /* `NULL` for paths relative to the working directory */
+        str path[FSL_PATH_CAP];
+        str path_temp[FSL_PATH_CAP];
+    } entry[WRITE_BATCH_CAP];
+} write_batch_internal;
+
+/* suffix of temp files, `<path>.<serial>.fsltmp`, swept by @ref fsl_write_temp_sweep_internal() */
+#define WRITE_TEMP_EXT ".fsltmp"
+
+/* makes temp names unique, so rewriting a pending path can't clobber its temp file */
+static u64 write_temp_serial_internal = 0;
+
+/*!
+ *  @internal
+ *
+ *  @brief copy `size` bytes from `fd_in` to `fd_out` from their current offsets.
+ *
+ *  try @ref fsl_copy_file_kernel_internal() (no user-space copy where the platform
+ *  has one), then a chunked `read()`/`write()` loop picking up where it stopped.
+ *
+ *  @param len recipient of bytes copied.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 copy_file_data_internal(int fd_in, int fd_out, u64 size, u64 *len,
+        const fsl_fs_path *src, const fsl_fs_path *dst);
+
+/*!
+ *  @internal
+ *
+ *  @brief body of @ref fsl_write_file_atomic() and @ref fsl_write_file_atomic_at(),
+ *  `path` is relative to `dir`, or to the working directory if `dir` is `NULL`.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 write_file_atomic_internal(const fsl_dir_handle *dir, const fsl_fs_path *path,
+        u64 size, void *buf, b8 log, b8 text, b8 sync_dir);
+
+/*!
+ *  @internal
+ *
+ *  @brief create a uniquely named `path_temp` next to `path` and write `buf` into it.
+ *
+ *  @param fd recipient of the open temp file descriptor.
+ *
+ *  @remark on failure the temp file is removed and `path` is left untouched.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 write_temp_internal(const fsl_dir_handle *dir, const fsl_fs_path *path, str *path_temp, int *fd,
+        u64 size, void *buf, b8 log, b8 text);
+
+/*!
+ *  @internal
+ *
+ *  @return `TRUE` if `name` is shaped like the temp files of @ref write_temp_internal(),
+ *  `<name>.<serial>` + @ref WRITE_TEMP_EXT.
+ */
+static b8 is_write_temp_name_internal(const str *name);
+
+/*!
+ *  @internal
+ *
+ *  @brief flush `fd` to disk, close it and rename `path_temp` over `path`.
+ *
+ *  @remark on failure the temp file is removed and `path` is left untouched.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 write_commit_internal(const fsl_dir_handle *dir, const fsl_fs_path *path, const str *path_temp, int fd, b8 log);
+
+/*!
+ *  @internal
+ *
+ *  @brief flush the directory holding `path`, making renames into it durable.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 dir_sync_internal(const fsl_dir_handle *dir, const fsl_fs_path *path, b8 log);
+
+/*!
+ *  @internal
+ *
+ *  @return length of the directory part of `path`, without the trailing slash.
+ */
+static u64 dir_name_len_internal(const str *path);
+
 u32 fsl_is_file(const fsl_fs_path *path)
 {
     struct stat stats = {0};
@@ -236,17 +338,75 @@ cleanup:
     return 0;
 }
 
+u64 fsl_read_file_at(const fsl_dir_handle *dir, const str *name, void *dst, u64 size, b8 log)
+{
+    u8 *cursor = dst;
+    i64 len = 0;
+    int fd = -1;
+
+    if (!dir || !dir->loaded || !name || !dst)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Read File"));
+        return 0;
+    }
+
+    fd = fsl_file_open_at_internal(dir, name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        fsl_err = errno == ENOENT ? FSL_ERR_FILE_NOT_FOUND : FSL_ERR_FILE_OPEN_FAIL;
+        if (log)
+            LOGERROR(fsl_err, 0,
+                    MSG_FILE_OPEN_FAIL(name));
+        return 0;
+    }
+
+    while (size)
+    {
+        len = read(fd, cursor, size);
+        if (len < 0 && errno == EINTR)
+            continue;
+        if (len <= 0)
+            break;
+        cursor += len;
+        size -= len;
+    }
+
+    close(fd);
+
+    if (len < 0)
+    {
+        if (log)
+            LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0,
+                    MSG_ACTION_SUBJECT_REASON_ERROR("Read File", name, "`read()` Failed"));
+        else
+            fsl_err = FSL_ERR_FILE_OPEN_FAIL;
+        return 0;
+    }
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return (u64)(cursor - (u8*)dst);
+}
+
 fsl_buf fsl_get_dir_contents(const fsl_fs_path *path)
+{
+    return fsl_get_dir_contents_ex(path, NULL);
+}
+
+fsl_buf fsl_get_dir_contents_ex(const fsl_fs_path *path, const str *ext)
 {
     fsl_buf nobuf = {0};
 
-    str *dir_name_absolute = NULL;
-    str dir_name_absolute_usable[FSL_PATH_CAP] = {0};
-    str entry_name_full[FSL_PATH_CAP] = {0};
     DIR *dir = NULL;
     struct dirent *entry = {0};
+    struct stat stats = {0};
     fsl_buf contents = {0};
+    u64 cap = DIR_CONTENTS_CAP_MIN;
+    u64 cap_new = 0;
+    u64 ext_len = ext ? strlen(ext) : 0;
+    u64 len = 0;
     u64 i = 0;
+    b8 is_dir = FALSE;
 
     if (!path)
     {
@@ -257,60 +417,76 @@ fsl_buf fsl_get_dir_contents(const fsl_fs_path *path)
     if (fsl_is_dir_exists(path, TRUE) != FSL_ERR_SUCCESS)
         return nobuf;
 
-    if (fsl_get_path_absolute(path, &dir_name_absolute) != FSL_ERR_SUCCESS)
-        goto cleanup;
-
-    snprintf(dir_name_absolute_usable, FSL_PATH_CAP, "%s", dir_name_absolute);
-
-    dir = opendir(dir_name_absolute);
+    dir = opendir(path);
     if (!dir)
     {
         fsl_err = FSL_ERR_DIR_OPEN_FAIL;
-        goto cleanup;
-    }
-
-    while ((entry = readdir(dir)) != NULL)
-        ++contents.memb;
-
-    /* subtract for '.' and '..' */
-    contents.memb -= 2;
-
-    if (!contents.memb)
-    {
-        closedir(dir);
-        if (dir_name_absolute)
-            fsl_mem_free((void*)&dir_name_absolute, strlen(dir_name_absolute),
-                    "fsl_get_dir_contents().dir_name_absolute");
-        fsl_mem_free_buf(&contents, "fsl_get_dir_contents().contents");
-
-        fsl_err = FSL_ERR_DIR_EMPTY;
         return nobuf;
     }
 
-    if (fsl_mem_alloc_buf(&contents, contents.memb,
-                FSL_ID_CAP, "fsl_get_dir_contents().contents") != FSL_ERR_SUCCESS)
+    if (fsl_mem_alloc_memb(&contents.buf, cap, FSL_ID_CAP,
+                "fsl_get_dir_contents().contents.buf") != FSL_ERR_SUCCESS)
         goto cleanup;
 
-    rewinddir(dir);
-    i = 0;
+    /* single pass, `d_type` spares a `stat()` per entry on file systems that fill it */
     while ((entry = readdir(dir)) != NULL)
     {
         if (!strncmp(entry->d_name, ".\0", 2) ||
                 !strncmp(entry->d_name, "..\0", 3))
             continue;
 
-        contents.i[i] = (u8*)contents.buf + i * FSL_ID_CAP;
-        memcpy(contents.i[i], entry->d_name, FSL_ID_CAP - 1);
-        snprintf(entry_name_full, FSL_PATH_CAP, "%s%s", dir_name_absolute_usable, entry->d_name);
+        if (entry->d_type == DT_DIR)
+            is_dir = TRUE;
+        else if (entry->d_type == DT_UNKNOWN)
+            is_dir = fstatat(dirfd(dir), entry->d_name, &stats, AT_SYMLINK_NOFOLLOW) == 0 &&
+                S_ISDIR(stats.st_mode);
+        else
+            is_dir = FALSE;
+
+        len = strlen(entry->d_name);
+        if (ext && (is_dir || len < ext_len || strcmp(entry->d_name + len - ext_len, ext)))
+            continue;
 
-        if (fsl_is_dir(entry_name_full) == FSL_ERR_SUCCESS)
-            fsl_check_slash(contents.i[i]);
+        if (i == cap)
+        {
+            /* `cap` keeps the old count until the buffer grows, cleanup frees by it */
+            cap_new = cap * 2;
+            if (fsl_mem_realloc_memb(&contents.buf, cap_new, FSL_ID_CAP,
+                        "fsl_get_dir_contents().contents.buf") != FSL_ERR_SUCCESS)
+                goto cleanup;
+            cap = cap_new;
+        }
+
+        /* leave room for the trailing slash of directories */
+        if (len > FSL_ID_CAP - 2)
+            len = FSL_ID_CAP - 2;
+        memcpy((u8*)contents.buf + i * FSL_ID_CAP, entry->d_name, len);
+        ((str*)contents.buf)[i * FSL_ID_CAP + len] = 0;
+
+        if (is_dir)
+            fsl_check_slash((str*)contents.buf + i * FSL_ID_CAP);
         ++i;
     }
 
     closedir(dir);
-    fsl_mem_free((void*)&dir_name_absolute, strlen(dir_name_absolute),
-            "fsl_get_dir_contents().dir_name_absolute");
+    dir = NULL;
+
+    if (!i)
+    {
+        fsl_mem_free(&contents.buf, cap * FSL_ID_CAP, "fsl_get_dir_contents().contents.buf");
+        fsl_err = FSL_ERR_DIR_EMPTY;
+        return nobuf;
+    }
+
+    if (fsl_mem_alloc_memb((void*)&contents.i, i, sizeof(str*),
+                "fsl_get_dir_contents().contents.i") != FSL_ERR_SUCCESS)
+        goto cleanup;
+
+    contents.memb = i;
+    contents.size = FSL_ID_CAP;
+    contents.loaded = TRUE;
+    for (i = 0; i < contents.memb; ++i)
+        contents.i[i] = (u8*)contents.buf + i * FSL_ID_CAP;
 
     fsl_err = FSL_ERR_SUCCESS;
     return contents;
@@ -320,10 +496,7 @@ cleanup:
     if (dir)
         closedir(dir);
 
-    if (dir_name_absolute)
-        fsl_mem_free((void*)&dir_name_absolute, strlen(dir_name_absolute),
-                "fsl_get_dir_contents().dir_name_absolute");
-    fsl_mem_free_buf(&contents, "fsl_get_dir_contents().contents");
+    fsl_mem_free(&contents.buf, cap * FSL_ID_CAP, "fsl_get_dir_contents().contents.buf");
     return nobuf;
 }
 
@@ -362,16 +535,24 @@ u64 fsl_get_dir_entry_count(const fsl_fs_path *path)
 }
 
 u32 fsl_copy_file(const fsl_fs_path *src, const fsl_fs_path *dst)
+{
+    return fsl_copy_file_ex(src, dst, NULL);
+}
+
+u32 fsl_copy_file_ex(const fsl_fs_path *src, const fsl_fs_path *dst, u64 *len)
 {
     str str_dst[FSL_PATH_CAP] = {0};
     str str_lnk[FSL_PATH_CAP] = {0}; /* if is symlink, store symlink's link in this buffer */
-    str *in_file = NULL;
-    FILE *out_file = NULL;
-    u64 len = 0;
+    int fd_in = -1;
+    int fd_out = -1;
+    u64 bytes_copied = 0;
     u32 file_type = 0;
     struct stat stats = {0};
     struct timespec ts[2] = {0};
 
+    if (len)
+        *len = 0;
+
     if (fsl_is_file_exists(src, TRUE) != FSL_ERR_SUCCESS)
             return fsl_err;
 
@@ -390,37 +571,46 @@ u32 fsl_copy_file(const fsl_fs_path *src, const fsl_fs_path *dst)
     switch (file_type)
     {
         case FSL_FILE_TYPE_REG:
-            if ((out_file = fopen(str_dst, "wb")) == NULL)
+            if ((fd_in = fsl_file_open_at_internal(NULL, src, O_RDONLY, 0)) == -1)
             {
                 LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0,
-                        MSG_FILE_COPY_FAIL(src, str_dst));
+                        MSG_FILE_COPY_REASON_FAIL(src, str_dst, "`open()` Failed"));
                 return fsl_err;
             }
 
-            len = fsl_get_file_contents(src, (void*)&in_file, FALSE);
-            if (fsl_err != FSL_ERR_SUCCESS || !in_file)
+            if (fstat(fd_in, &stats) != 0)
             {
-                fclose(out_file);
+                close(fd_in);
+                LOGWARNING(FSL_ERR_FILE_STAT_FAIL,
+                        FSL_FLAG_LOG_NO_VERBOSE,
+                        MSG_FILE_PERMISSION_COPY_FAIL(src, str_dst));
                 return fsl_err;
             }
 
-            fwrite(in_file, 1, len, out_file);
+            if ((fd_out = fsl_file_open_at_internal(NULL, str_dst, O_WRONLY | O_CREAT | O_TRUNC,
+                            stats.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO))) == -1)
+            {
+                close(fd_in);
+                LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0,
+                        MSG_FILE_COPY_REASON_FAIL(src, str_dst, "`open()` Failed"));
+                return fsl_err;
+            }
 
-            LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
-                    MSG_FILE_COPY(src, str_dst));
+            copy_file_data_internal(fd_in, fd_out, stats.st_size, &bytes_copied, src, str_dst);
 
-            fclose(out_file);
-            fsl_mem_free((void*)&in_file, strlen(in_file), "fsl_copy_file().in_file");
+            /* mode passed to `open()` is masked by umask and ignored for existing files */
+            fchmod(fd_out, stats.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+            close(fd_in);
+            close(fd_out);
 
-            if (fsl_stat(src, &stats) == 0)
-                fsl_chmod(str_dst, stats.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
-            else
-            {
-                LOGWARNING(FSL_ERR_FILE_STAT_FAIL,
-                        FSL_FLAG_LOG_NO_VERBOSE,
-                        MSG_FILE_PERMISSION_COPY_FAIL(src, str_dst));
+            if (len)
+                *len = bytes_copied;
+
+            if (fsl_err != FSL_ERR_SUCCESS)
                 return fsl_err;
-            }
+
+            LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
+                    MSG_FILE_COPY(src, str_dst));
             break;
 
         case FSL_FILE_TYPE_LNK:
@@ -599,6 +789,111 @@ u32 fsl_append_file(const fsl_fs_path *path, u64 size, void *buf, b8 log, b8 tex
     return fsl_err;
 }
 
+u32 fsl_write_file_atomic(const fsl_fs_path *path, u64 size, void *buf, b8 log, b8 text, b8 sync_dir)
+{
+    return write_file_atomic_internal(NULL, path, size, buf, log, text, sync_dir);
+}
+
+u32 fsl_write_file_atomic_at(const fsl_dir_handle *dir, const str *name,
+        u64 size, void *buf, b8 log, b8 text, b8 sync_dir)
+{
+    if (!dir || !dir->loaded)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Write File"));
+        return fsl_err;
+    }
+
+    return write_file_atomic_internal(dir, name, size, buf, log, text, sync_dir);
+}
+
+void fsl_write_batch_begin(void)
+{
+    write_batch_internal.active = TRUE;
+}
+
+u32 fsl_write_batch_end(void)
+{
+    u32 result = FSL_ERR_SUCCESS;
+    u64 i = 0;
+    u64 j = 0;
+    u64 len = 0;
+
+    write_batch_internal.active = FALSE;
+
+    for (i = 0; i < write_batch_internal.count; ++i)
+    {
+        if (write_commit_internal(write_batch_internal.entry[i].dir,
+                    write_batch_internal.entry[i].path,
+                    write_batch_internal.entry[i].path_temp,
+                    write_batch_internal.entry[i].fd, TRUE) != FSL_ERR_SUCCESS)
+        {
+            result = fsl_err;
+            *write_batch_internal.entry[i].path = 0;
+            continue;
+        }
+
+        LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_FILE_WRITE(write_batch_internal.entry[i].path));
+    }
+
+    /* one flush per directory, not per file */
+    for (i = 0; i < write_batch_internal.count; ++i)
+    {
+        if (!*write_batch_internal.entry[i].path)
+            continue;
+
+        len = dir_name_len_internal(write_batch_internal.entry[i].path);
+        for (j = 0; j < i; ++j)
+            if (*write_batch_internal.entry[j].path &&
+                    write_batch_internal.entry[j].dir == write_batch_internal.entry[i].dir &&
+                    dir_name_len_internal(write_batch_internal.entry[j].path) == len &&
+                    !strncmp(write_batch_internal.entry[j].path, write_batch_internal.entry[i].path, len))
+                break;
+
+        if (j == i && dir_sync_internal(write_batch_internal.entry[i].dir,
+                    write_batch_internal.entry[i].path, TRUE) != FSL_ERR_SUCCESS)
+            result = fsl_err;
+    }
+
+    write_batch_internal.count = 0;
+
+    fsl_err = result;
+    return fsl_err;
+}
+
+void fsl_write_temp_sweep_internal(const fsl_dir_handle *dir)
+{
+    fsl_buf contents = {0};
+    const str *name = NULL;
+    u64 i = 0;
+    u64 j = 0;
+
+    contents = fsl_get_dir_contents_ex(dir->path, WRITE_TEMP_EXT);
+    for (i = 0; i < contents.memb; ++i)
+    {
+        if (!is_write_temp_name_internal((str*)contents.i[i]))
+            continue;
+
+        /* pending in the open batch, not stale */
+        for (j = 0; j < write_batch_internal.count; ++j)
+        {
+            name = strrchr(write_batch_internal.entry[j].path_temp, '/');
+            name = name ? name + 1 : write_batch_internal.entry[j].path_temp;
+            if (!strcmp(name, (str*)contents.i[i]))
+                break;
+        }
+        if (j < write_batch_internal.count)
+            continue;
+
+        if (fsl_file_remove_at_internal(dir, (str*)contents.i[i]) == FSL_ERR_SUCCESS)
+            LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
+                    MSG_FILE_TEMP_REMOVE((str*)contents.i[i]));
+    }
+
+    fsl_mem_free_buf(&contents, "fsl_write_temp_sweep_internal().contents");
+}
+
 u32 fsl_get_path_absolute(const fsl_fs_path *path, str **dst)
 {
     str path_absolute[FSL_PATH_CAP] = {0};
@@ -821,3 +1116,268 @@ u32 fsl_get_base_name(const fsl_fs_path *path, str *dst, u64 size)
     fsl_err = FSL_ERR_SUCCESS;
     return fsl_err;
 }
+
+static u32 copy_file_data_internal(int fd_in, int fd_out, u64 size, u64 *len,
+        const fsl_fs_path *src, const fsl_fs_path *dst)
+{
+    u8 buf[COPY_FILE_CHUNK];
+    ssize_t result = 0;
+    ssize_t written = 0;
+    ssize_t cursor = 0;
+
+    if (fsl_copy_file_kernel_internal(fd_in, fd_out, size, len, src, dst) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (*len >= size)
+        goto done;
+
+    while ((result = read(fd_in, buf, COPY_FILE_CHUNK)) != 0)
+    {
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            goto cleanup;
+        }
+
+        for (cursor = 0; cursor < result; cursor += written)
+        {
+            written = write(fd_out, buf + cursor, result - cursor);
+            if (written < 0)
+            {
+                if (errno != EINTR)
+                    goto cleanup;
+                written = 0;
+            }
+        }
+        *len += result;
+    }
+
+done:
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    LOGERROR(FSL_ERR_FILE_COPY_FAIL, 0,
+            MSG_FILE_COPY_REASON_FAIL(src, dst, strerror(errno)));
+    return fsl_err;
+}
+
+static u32 write_temp_internal(const fsl_dir_handle *dir, const fsl_fs_path *path, str *path_temp, int *fd,
+        u64 size, void *buf, b8 log, b8 text)
+{
+    const u8 *cursor = buf;
+    i64 len = 0;
+
+    if (snprintf(path_temp, FSL_PATH_CAP, "%s.%"PRIu64 WRITE_TEMP_EXT,
+                path, write_temp_serial_internal++) >= FSL_PATH_CAP)
+    {
+        if (log)
+            LOGERROR(FSL_ERR_PATH_TOO_LONG, 0,
+                    MSG_FILE_WRITE_REASON_FAIL(path, "Path Too Long"));
+        else
+            fsl_err = FSL_ERR_PATH_TOO_LONG;
+        return fsl_err;
+    }
+
+    /* new files get the usual mode less the umask, as with `fopen()` */
+    *fd = fsl_file_open_at_internal(dir, path_temp, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (*fd < 0)
+    {
+        if (log)
+            LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0,
+                    MSG_FILE_WRITE_REASON_FAIL(path_temp, "`open()` Failed"));
+        else
+            fsl_err = FSL_ERR_FILE_OPEN_FAIL;
+        return fsl_err;
+    }
+
+    /* the rename replaces `path` whole, its mode too */
+    fsl_file_mode_copy_at_internal(dir, path, *fd);
+
+    while (size || text)
+    {
+        if (!size)
+        {
+            cursor = (const u8*)"\n";
+            size = 1;
+            text = FALSE;
+        }
+
+        len = write(*fd, cursor, size);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            goto cleanup;
+        }
+        cursor += len;
+        size -= len;
+    }
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    close(*fd);
+    *fd = -1;
+    fsl_file_remove_at_internal(dir, path_temp);
+
+    if (log)
+        LOGERROR(FSL_ERR_FILE_WRITE_FAIL, 0,
+                MSG_FILE_WRITE_REASON_FAIL(path_temp, "`write()` Failed"));
+    else
+        fsl_err = FSL_ERR_FILE_WRITE_FAIL;
+
+    return fsl_err;
+}
+
+static b8 is_write_temp_name_internal(const str *name)
+{
+    u64 len = strlen(name);
+    u64 ext_len = strlen(WRITE_TEMP_EXT);
+    u64 i = 0;
+
+    if (len <= ext_len || strcmp(name + len - ext_len, WRITE_TEMP_EXT))
+        return FALSE;
+
+    /* serial digits, then a dot after a non-empty name */
+    i = len - ext_len;
+    while (i > 0 && name[i - 1] >= '0' && name[i - 1] <= '9')
+        --i;
+    return i != len - ext_len && i >= 2 && name[i - 1] == '.';
+}
+
+static u32 write_commit_internal(const fsl_dir_handle *dir, const fsl_fs_path *path, const str *path_temp, int fd, b8 log)
+{
+    const str *reason = NULL;
+
+    /* data must be on disk before the rename is, or a crash can leave an empty `path` */
+    if (fsl_file_flush_internal(fd, TRUE) != FSL_ERR_SUCCESS)
+        reason = "Flush Failed";
+
+    if (close(fd) != 0 && !reason)
+        reason = "`close()` Failed";
+
+    if (!reason && fsl_file_rename_at_internal(dir, path_temp, path) != FSL_ERR_SUCCESS)
+        reason = "Rename Failed";
+
+    if (reason)
+    {
+        fsl_file_remove_at_internal(dir, path_temp);
+
+        if (log)
+            LOGERROR(FSL_ERR_FILE_WRITE_FAIL, 0,
+                    MSG_FILE_WRITE_REASON_FAIL(path, reason));
+        else
+            fsl_err = FSL_ERR_FILE_WRITE_FAIL;
+        return fsl_err;
+    }
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+static u32 dir_sync_internal(const fsl_dir_handle *dir, const fsl_fs_path *path, b8 log)
+{
+    str dir_name[FSL_PATH_CAP] = {0};
+    u64 len = dir_name_len_internal(path);
+
+    if (len)
+        snprintf(dir_name, FSL_PATH_CAP, "%.*s", (int)len, path);
+    else
+        snprintf(dir_name, FSL_PATH_CAP, "%s", path[0] == '/' ? "/" : ".");
+
+    if (fsl_dir_sync_at_internal(dir, dir_name) != FSL_ERR_SUCCESS)
+    {
+        if (log)
+            LOGERROR(FSL_ERR_FILE_WRITE_FAIL, 0,
+                    MSG_DIR_SYNC_FAIL(dir_name));
+        else
+            fsl_err = FSL_ERR_FILE_WRITE_FAIL;
+        return fsl_err;
+    }
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+static u64 dir_name_len_internal(const str *path)
+{
+    const str *slash = strrchr(path, '/');
+    return slash ? (u64)(slash - path) : 0;
+}
+
+static u32 write_file_atomic_internal(const fsl_dir_handle *dir, const fsl_fs_path *path,
+        u64 size, void *buf, b8 log, b8 text, b8 sync_dir)
+{
+    str path_temp[FSL_PATH_CAP] = {0};
+    int fd = -1;
+    u64 i = 0;
+
+    if (!path || (!buf && size))
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Write File"));
+        return fsl_err;
+    }
+
+    if (write_batch_internal.active)
+    {
+        /* same path twice in one batch, the latest write replaces the pending entry */
+        for (i = 0; i < write_batch_internal.count; ++i)
+            if (write_batch_internal.entry[i].dir == dir &&
+                    !strncmp(write_batch_internal.entry[i].path, path, FSL_PATH_CAP))
+                break;
+
+        if (i == WRITE_BATCH_CAP)
+        {
+            if (fsl_write_batch_end() != FSL_ERR_SUCCESS)
+                LOGWARNING(fsl_err, 0,
+                        MSG_ACTION_REASON_ERROR("Commit Write Batch", "Some Files Kept Old Contents"));
+            fsl_write_batch_begin();
+            i = 0;
+        }
+
+        if (write_temp_internal(dir, path, path_temp, &fd, size, buf, log, text) != FSL_ERR_SUCCESS)
+            return fsl_err;
+
+        /* only drop the pending temp file once its replacement is written */
+        if (i < write_batch_internal.count)
+        {
+            close(write_batch_internal.entry[i].fd);
+            fsl_file_remove_at_internal(write_batch_internal.entry[i].dir,
+                    write_batch_internal.entry[i].path_temp);
+        }
+        else
+        {
+            ++write_batch_internal.count;
+            snprintf(write_batch_internal.entry[i].path, FSL_PATH_CAP, "%s", path);
+        }
+        snprintf(write_batch_internal.entry[i].path_temp, FSL_PATH_CAP, "%s", path_temp);
+        write_batch_internal.entry[i].fd = fd;
+        write_batch_internal.entry[i].dir = dir;
+
+        /* start writeback now, so the flush in @ref fsl_write_batch_end() mostly waits on work in flight */
+        fsl_file_flush_internal(fd, FALSE);
+
+        fsl_err = FSL_ERR_SUCCESS;
+        return fsl_err;
+    }
+
+    if (write_temp_internal(dir, path, path_temp, &fd, size, buf, log, text) != FSL_ERR_SUCCESS ||
+            write_commit_internal(dir, path, path_temp, fd, log) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (sync_dir && dir_sync_internal(dir, path, log) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
+            MSG_FILE_WRITE(path));
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
@@ -38,7 +38,9 @@
 #include "../shaders/shader_types.h"
 #include "../ui/ui.h"
 
+#include "../h/cpu.h"
 #include "../h/dir.h"
+#include "../h/io.h"
 #include "../h/process.h"
 #include "../h/time.h"
 
@@ -181,6 +183,10 @@ u32 fsl_engine_init(int argc, char **argv, const str *title,
                 "fsl_engine_init().mem_arena_path_internal") != FSL_ERR_SUCCESS)
         goto cleanup;
 
+    if (fsl_io_init(0) != FSL_ERR_SUCCESS ||
+            fsl_cpu_init() != FSL_ERR_SUCCESS)
+        goto cleanup;
+
     if (FSL_SESSION.bin_root == NULL)
     {
         if (fsl_get_path_bin_root(&FSL_SESSION.bin_root) != FSL_ERR_SUCCESS)
@@ -188,6 +194,15 @@ u32 fsl_engine_init(int argc, char **argv, const str *title,
         fsl_change_dir(FSL_SESSION.bin_root);
     }
 
+    if (flags & FSL_FLAG_HEADLESS)
+    {
+        if (noise_init_internal() != FSL_ERR_SUCCESS)
+            goto cleanup;
+
+        fsl_err = FSL_ERR_SUCCESS;
+        return fsl_err;
+    }
+
     if (
             fsl_glfw_init(flags & FSL_FLAG_MULTISAMPLE) != FSL_ERR_SUCCESS ||
             fsl_window_init(title, size_x, size_y) != FSL_ERR_SUCCESS ||
@@ -258,6 +273,8 @@ b8 fsl_engine_running(void (*callback_framebuffer_size)(i32 size_x, i32 size_y))
             glfwWindowShouldClose(render_internal.window))
         return FALSE;
 
+    fsl_io_poll(FALSE);
+
     if (fsl_update_render_settings(callback_framebuffer_size) != FSL_ERR_SUCCESS)
     {
         LOGWARNING(fsl_err, 0,
@@ -341,6 +358,7 @@ void fsl_engine_close(void)
 
     fsl_core.flag.active = FALSE;
 
+    fsl_io_free();
     noise_free_internal();
     fsl_ui_free();
     fsl_assets_free();
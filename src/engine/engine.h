@@ -110,6 +110,10 @@ extern fsl_render render_internal;
  *      logdebug:   only output <= debug logs.
  *      logtrace:   only output <= trace logs (most verbose).
  *
+ *  @remark with @ref fsl_flag.FSL_FLAG_HEADLESS only the logger, memory, I/O and
+ *  noise are initialized, `title`, `size_x` and `size_y` are ignored and
+ *  @ref fsl_engine_running() must not be called.
+ *
  *  @note @ref fsl_engine_close() will be called on failure.
  *
  *  @return non-zero on failure and @ref fsl_err is set accordingly.
@@ -26,6 +26,46 @@
 
 /* ---- section: changelog -------------------------------------------------- */
 
+/*  v1.12.0 (2026 10 18):
+ *      - (2026 10 18): add function `cmd_push_pgo()` to push profile-guided
+ *                      optimization flags for the generate or use stage.
+ *      - (2026 10 18): add function `pgo_reset()` to remove profiles left
+ *                      over from earlier training runs.
+ *      - (2026 10 18): add function `get_time_nsec()`.
+ */
+
+/*  v1.11.0 (2026 10 18):
+ *      - (2026 10 18): add function `compile_unity()` to compile sources as
+ *                      few amalgamated translation units, files whose
+ *                      file-scope static symbols, macros or tags collide are
+ *                      placed in separate units.
+ *      - (2026 10 18): make function `compile()` not prefix `dir_obj` onto
+ *                      sources already inside it.
+ */
+
+/*  v1.10.0 (2026 10 18):
+ *      - (2026 10 18): make function `compile()` track header dependencies,
+ *                      objects are compiled with `-MMD -MF <object>.d` and are
+ *                      rebuilt if any file listed in their depfile is newer or
+ *                      missing.
+ */
+
+/*  v1.9.0 (2026 10 18):
+ *      - (2026 10 18): add function `compile()` to compile sources into object
+ *                      files in parallel, skipping objects that are newer than
+ *                      their source and built with the same command.
+ *      - (2026 10 18): add function `link_objects()` to link only if the output
+ *                      is older than its inputs or the command changed.
+ *      - (2026 10 18): add command `-j<N>` to set the number of parallel jobs,
+ *                      defaults to the number of online processors.
+ *      - (2026 10 18): add functions `exec_spawn()`, `exec_poll()` and
+ *                      `exec_wait_any()` to run commands without waiting.
+ *      - (2026 10 18): spawn child processes with `posix_spawnp()` instead of
+ *                      `fork()` + `execvp()` on linux.
+ *      - (2026 10 18): fix function `cmd_fail()` exiting with 0, the error was
+ *                      reset while freeing the command.
+ */
+
 /*  v1.8.7 (2026 06 07):
  *      - (2026 06 07): fix version, because I released too quickly to check.
  */
@@ -300,8 +340,8 @@
 #define BUILDTOOL_VERSION_DEV       "-dev"
 
 #define BUILDTOOL_VERSION_MAJOR 1
-#define BUILDTOOL_VERSION_MINOR 8
-#define BUILDTOOL_VERSION_PATCH 7
+#define BUILDTOOL_VERSION_MINOR 12
+#define BUILDTOOL_VERSION_PATCH 0
 #define BUILDTOOL_VERSION_BUILD BUILDTOOL_VERSION_STABLE
 
 #define COMPILER "cc"EXE
@@ -309,6 +349,10 @@
 #define CMD_SIZE 256
 #define ARG_MEMB 64
 #define ARG_SIZE 256
+#define HASH_STAMP_EXT ".hash"
+#define DEPFILE_EXT ".d"
+#define UNITY_DIR "unity/"
+#define PROFILE_EXT ".gcda"
 
 enum build_flag
 {
@@ -317,6 +361,36 @@ enum build_flag
     FLAG_SELF_BUILD_DEBUG = 0x0004
 }; /* build_flag */
 
+/*! @brief stages of a profile-guided optimization build, for @ref cmd_push_pgo().
+ */
+enum pgo_stage
+{
+    PGO_STAGE_NONE = 0,
+    PGO_STAGE_GENERATE, /* instrument, the program writes profiles on exit */
+    PGO_STAGE_USE       /* optimize with the profiles written by the training run */
+}; /* pgo_stage */
+
+/*! @brief one slot of @ref compile(), the command it runs and the object it writes.
+ */
+typedef struct bt_job
+{
+    bt_buf cmd;
+    void *argv[CMD_MEMB + 9];
+    str obj[PATH_CAP];
+    str dep[PATH_CAP];
+    u64 hash;
+} bt_job;
+
+/*! @brief file-scope symbol of a source in @ref compile_unity().
+ */
+typedef struct bt_sym
+{
+    str name[ID_CAP];
+    u64 file;   /* index of source */
+    u64 unit;   /* index of translation unit */
+    u64 macro;  /* hash of macro body + 1, 0 if not a macro */
+} bt_sym;
+
 /* ---- section: declarations ----------------------------------------------- */
 
 /*! @brief project root directory.
@@ -328,6 +402,7 @@ static str *DIR_BUILDTOOL_BIN_ROOT = NULL;
 u32 log_level_max = LOGLEVEL_INFO;
 u32 build_err = ERR_SUCCESS;
 static u32 flag = 0;
+static u32 build_jobs = 0; /* 0 for @ref get_nproc() */
 static str str_build_src[CMD_SIZE] = {0};
 static str str_build_bin[CMD_SIZE] = {0};
 static str str_build_bin_new[CMD_SIZE] = {0};
@@ -423,6 +498,124 @@ static void cmd_show(bt_buf *cmd);
  */
 static void cmd_raw(bt_buf *cmd);
 
+/*! @brief compile each of `src` into an object file under `dir_obj`, running up to
+ *  `-j<N>` (default: @ref get_nproc()) compiler processes at once.
+ *
+ *  - object path is `dir_obj` + source path with extension `.o`, sub-directories are created.
+ *  - an object is up to date if it's newer than its source and every header
+ *    listed in its depfile (`<object>.d`, written by the compiler with `-MMD`),
+ *    and its stamp (`<object>.hash`), a hash of `cmd` and the source name,
+ *    matches, up-to-date objects are not rebuilt.
+ *  - on failure no new jobs are started, running jobs are waited for.
+ *
+ *  @param cmd compiler and flags, without `-c`, `-o` or sources.
+ *  @param src source files, loaded with @ref cmd_push().
+ *  @param dir_obj object directory, ending with slash (`/`).
+ *  @param obj cmd to push object paths onto in order of `src` (e.g. the link command), optional.
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+static u32 compile(bt_buf *cmd, bt_buf *src, const str *dir_obj, bt_buf *obj);
+
+/*! @brief compile `src` as few amalgamated translation units ("unity build") with
+ *  @ref compile(), so calls across sources can be inlined.
+ *
+ *  - units are written to `<dir_obj>unity/<name>_<n>.c` and only rewritten if changed.
+ *  - sources whose file-scope statics, macros, struct/union/enum tags or typedefs
+ *    collide with a unit's are placed in the next unit that has no collision,
+ *    identical macro definitions don't collide.
+ *
+ *  @param dir_obj object directory, relative to the working directory, ending with slash (`/`).
+ *  @param name unit name prefix.
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+static u32 compile_unity(bt_buf *cmd, bt_buf *src, const str *dir_obj, const str *name, bt_buf *obj);
+
+/*! @brief execute link command `cmd` unless `out` is up to date.
+ *
+ *  `out` is up to date if it's newer than every file named in `cmd` and its stamp
+ *  (`<dir_obj><base name of out>.hash`), a hash of `cmd`, matches.
+ *
+ *  @param cmd link command including `-o` and `out`, finalized with @ref cmd_ready().
+ *  @param cmd_name command name (for logging).
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+static u32 link_objects(bt_buf *cmd, const str *out, const str *dir_obj, str *cmd_name);
+
+/*! @brief push profile-guided optimization flags for `stage` onto `cmd`.
+ *
+ *  - push onto both the compile and the link command.
+ *  - compile both stages into the same `dir_obj` with @ref compile(), profiles
+ *    are named after the object they were generated by.
+ *  - both stages rebuild all objects, their commands differ.
+ *
+ *  @param stage enum @ref pgo_stage, @ref PGO_STAGE_NONE pushes nothing.
+ *  @param dir_profile profile directory, relative to project root, ending with slash (`/`).
+ */
+static void cmd_push_pgo(bt_buf *cmd, u32 stage, const str *dir_profile);
+
+/*! @brief remove profiles (`*.gcda`) in `dir_profile` left over from earlier
+ *  training runs, the instrumented program adds its counts onto existing ones.
+ *
+ *  @remark create `dir_profile` if it doesn't exist.
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+static u32 pgo_reset(const str *dir_profile);
+
+/*! -- INTERNAL USE ONLY --;
+ *
+ *  @brief load `dst` with object path of `src` and create its directories.
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+static u32 object_path_internal(const str *src, const str *dir_obj, str *dst);
+
+/*! -- INTERNAL USE ONLY --;
+ *
+ *  @brief collect file-scope symbols of C source `buf` that would collide in a unity build.
+ *
+ *  @param dst symbols to load, if `NULL`, only count.
+ *  @param file index of source, stored in `dst`.
+ *
+ *  @return number of symbols (upper bound if `dst` is `NULL`).
+ */
+static u64 unity_symbols_internal(const str *buf, bt_sym *dst, u64 file);
+
+/*! -- INTERNAL USE ONLY --;
+ *
+ *  @return FNV-1a hash of macro definition at `p` (parameters and body) up to the
+ *  end of the line, whitespace runs and line continuations count as one space.
+ */
+static u64 macro_hash_internal(const str *p);
+
+/*! -- INTERNAL USE ONLY --;
+ *
+ *  @brief parse make-style depfile `path` (`target: prerequisite...`).
+ *
+ *  @return `TRUE` if `path` can't be read or any prerequisite is missing or
+ *  newer than `mtime`.
+ */
+static b8 is_deps_changed_internal(const str *path, u64 mtime);
+
+/*! -- INTERNAL USE ONLY --;
+ *
+ *  @return FNV-1a hash of the first `n` arguments of `cmd` followed by `extra`.
+ */
+static u64 cmd_hash_internal(bt_buf *cmd, u64 n, const str *extra);
+
+/*! -- INTERNAL USE ONLY --;
+ *
+ *  @return `TRUE` if stamp file `path` holds `hash`.
+ */
+static b8 stamp_match_internal(const str *path, u64 hash);
+
+/*! -- INTERNAL USE ONLY --;
+ */
+static void stamp_write_internal(const str *path, u64 hash);
+
 static void help(void);
 static void print_version(void);
 
@@ -448,7 +641,7 @@ u32 build_init(int argc, char **argv, const str *build_src_name, const str *buil
         change_dir(DIR_BUILDTOOL_BIN_ROOT);
     }
 
-    for (i = 0; i < argc; ++i)
+    for (i = 0; (int)i < argc; ++i)
         cmd_push(&args, argv[i]);
     cmd_ready(&args);
 
@@ -458,6 +651,10 @@ u32 build_init(int argc, char **argv, const str *build_src_name, const str *buil
     if (find_token("raw", argc, argv))
         flag |= FLAG_CMD_RAW;
 
+    for (i = 1; (int)i < argc; ++i)
+        if (!strncmp(argv[i], "-j", 2) && isdigit((u8)argv[i][2]))
+            build_jobs = (u32)strtoul(argv[i] + 2, NULL, 10);
+
     if (find_token("btdebug", argc, argv))
     {
         flag |= FLAG_SELF_BUILD_DEBUG;
@@ -708,6 +905,7 @@ void cmd_free(bt_buf *cmd)
 void cmd_fail(bt_buf *cmd)
 {
     bt_buf *cmdp = cmd;
+    u32 err = 0;
 
     if (!cmdp)
         cmdp = &cmd_internal;
@@ -721,8 +919,10 @@ void cmd_fail(bt_buf *cmd)
             cmd_raw(cmdp);
     }
 
+    /* keep the error, freeing resets it */
+    err = build_err;
     cmd_free(cmdp);
-    _exit(build_err);
+    _exit(err);
 }
 
 void cmd_show(bt_buf *cmd)
@@ -765,6 +965,843 @@ void cmd_raw(bt_buf *cmd)
     fprintf(stderr, "%s", "\n\n");
 }
 
+u32 compile(bt_buf *cmd, bt_buf *src, const str *dir_obj, bt_buf *obj)
+{
+    bt_job *job = NULL;
+    bt_proc *proc = NULL;
+    u64 *stale = NULL;
+    u64 stale_len = 0;
+    u64 jobs = build_jobs ? build_jobs : get_nproc();
+    u64 next = 0, running = 0, i = 0, j = 0;
+    u64 mtime_src = 0, mtime_obj = 0;
+    str path[PATH_CAP] = {0};
+    b8 failed = FALSE;
+    u32 err = 0;
+
+    if (!cmd || !src || !dir_obj)
+    {
+        LOGERROR(ERR_POINTER_NULL, TRUE,
+                "Failed to Compile, Pointer NULL\n");
+        return build_err;
+    }
+
+    if (!src->cursor)
+    {
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+
+    if (mem_alloc((void*)&stale, src->cursor * sizeof(u64), "compile().stale") != ERR_SUCCESS)
+        return build_err;
+
+    /* ---- find stale objects ---------------------------------------------- */
+
+    for (i = 0; i < src->cursor; ++i)
+    {
+        if (object_path_internal(src->i[i], dir_obj, path) != ERR_SUCCESS)
+            goto cleanup;
+
+        if (obj)
+            cmd_push(obj, path);
+
+        if (
+                get_file_mtime(src->i[i], &mtime_src) != ERR_SUCCESS ||
+                get_file_mtime(path, &mtime_obj) != ERR_SUCCESS ||
+                mtime_src > mtime_obj ||
+                is_deps_changed_internal(stringf("%s"DEPFILE_EXT, path), mtime_obj) ||
+                !stamp_match_internal(stringf("%s"HASH_STAMP_EXT, path),
+                    cmd_hash_internal(cmd, cmd->cursor, src->i[i])))
+            stale[stale_len++] = i;
+        else
+            LOGTRACE(FALSE,
+                    logger_stringf("'%s' Up to Date\n", path));
+    }
+
+    if (!stale_len)
+    {
+        LOGINFO(FALSE,
+                logger_stringf("Objects Up to Date in '%s'\n", dir_obj));
+        mem_free((void*)&stale, src->cursor * sizeof(u64), "compile().stale");
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+
+    if (jobs > stale_len)
+        jobs = stale_len;
+
+    LOGINFO(FALSE,
+            logger_stringf("Compiling %"PRIu64"/%"PRIu64" Objects, %"PRIu64" Jobs..\n",
+                stale_len, src->cursor, jobs));
+
+    if (
+            mem_alloc((void*)&job, jobs * sizeof(bt_job), "compile().job") != ERR_SUCCESS ||
+            mem_alloc((void*)&proc, jobs * sizeof(bt_proc), "compile().proc") != ERR_SUCCESS)
+        goto cleanup;
+
+    /* ---- run jobs -------------------------------------------------------- */
+
+    while (next < stale_len || running)
+    {
+        for (i = 0; i < jobs && !failed && next < stale_len; ++i)
+        {
+            if (proc[i].running)
+                continue;
+
+            object_path_internal(src->i[stale[next]], dir_obj, job[i].obj);
+            snprintf(job[i].dep, PATH_CAP, "%s"DEPFILE_EXT, job[i].obj);
+            job[i].hash = cmd_hash_internal(cmd, cmd->cursor, src->i[stale[next]]);
+            remove(stringf("%s"HASH_STAMP_EXT, job[i].obj));
+
+            for (j = 0; j < cmd->cursor; ++j)
+                job[i].argv[j] = cmd->i[j];
+            job[i].argv[j++] = "-c";
+            job[i].argv[j++] = src->i[stale[next]];
+            job[i].argv[j++] = "-o";
+            job[i].argv[j++] = job[i].obj;
+            job[i].argv[j++] = "-MMD";
+            job[i].argv[j++] = "-MF";
+            job[i].argv[j++] = job[i].dep;
+            job[i].argv[j] = NULL;
+
+            job[i].cmd.loaded = TRUE;
+            job[i].cmd.i = job[i].argv;
+            job[i].cmd.buf = job[i].argv;
+            job[i].cmd.memb = j;
+            job[i].cmd.size = CMD_SIZE;
+
+            if (exec_spawn(&job[i].cmd, src->i[stale[next]], &proc[i]) != ERR_SUCCESS)
+            {
+                failed = TRUE;
+                break;
+            }
+
+            ++running;
+            ++next;
+        }
+
+        if (!running)
+            break;
+
+        exec_wait_any(proc, jobs);
+
+        for (i = 0; i < jobs; ++i)
+        {
+            if (!proc[i].running || !exec_poll(&proc[i], FALSE))
+                continue;
+
+            --running;
+            if (proc[i].result == ERR_SUCCESS)
+                stamp_write_internal(stringf("%s"HASH_STAMP_EXT, job[i].obj), job[i].hash);
+            else
+                failed = TRUE;
+        }
+
+        if (failed)
+            next = stale_len;
+    }
+
+    if (failed)
+    {
+        build_err = ERR_EXEC_PROCESS_NON_ZERO;
+        goto cleanup;
+    }
+
+    mem_free((void*)&proc, jobs * sizeof(bt_proc), "compile().proc");
+    mem_free((void*)&job, jobs * sizeof(bt_job), "compile().job");
+    mem_free((void*)&stale, src->cursor * sizeof(u64), "compile().stale");
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+
+cleanup:
+
+    /* keep the error, freeing resets it */
+    err = build_err;
+    mem_free((void*)&proc, jobs * sizeof(bt_proc), "compile().proc");
+    mem_free((void*)&job, jobs * sizeof(bt_job), "compile().job");
+    mem_free((void*)&stale, src->cursor * sizeof(u64), "compile().stale");
+    build_err = err;
+    return build_err;
+}
+
+u32 compile_unity(bt_buf *cmd, bt_buf *src, const str *dir_obj, const str *name, bt_buf *obj)
+{
+    bt_buf unit_src = {0};
+    bt_sym *sym = NULL;
+    u64 *file_unit = NULL;
+    str *buf = NULL;
+    str *text = NULL;
+    str *old = NULL;
+    str path[PATH_CAP] = {0};
+    str up[PATH_CAP] = {0};
+    str temp[PATH_CAP] = {0};
+    u64 sym_cap = 0, sym_len = 0, sym_file = 0;
+    u64 units = 0, len = 0, text_len = 0, old_len = 0;
+    u64 i = 0, j = 0, k = 0, l = 0;
+    FILE *file = NULL;
+    b8 collide = FALSE;
+    u32 err = 0;
+
+    if (!cmd || !src || !dir_obj || !name)
+    {
+        LOGERROR(ERR_POINTER_NULL, TRUE,
+                "Failed to Compile Unity, Pointer NULL\n");
+        return build_err;
+    }
+
+    if (!src->cursor)
+    {
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+
+    /* ---- collect symbols ------------------------------------------------- */
+
+    for (i = 0; i < src->cursor; ++i)
+    {
+        if (!(len = get_file_contents(src->i[i], (void*)&buf, 1, TRUE)))
+            goto cleanup;
+        sym_cap += unity_symbols_internal(buf, NULL, i);
+        mem_free((void*)&buf, len + 1, "compile_unity().buf");
+    }
+
+    if (
+            mem_alloc((void*)&sym, (sym_cap + 1) * sizeof(bt_sym), "compile_unity().sym") != ERR_SUCCESS ||
+            mem_alloc((void*)&file_unit, src->cursor * sizeof(u64), "compile_unity().file_unit") != ERR_SUCCESS)
+        goto cleanup;
+
+    /* ---- assign sources to units ----------------------------------------- */
+
+    for (i = 0; i < src->cursor; ++i)
+    {
+        if (!(len = get_file_contents(src->i[i], (void*)&buf, 1, TRUE)))
+            goto cleanup;
+        sym_file = sym_len;
+        sym_len += unity_symbols_internal(buf, sym + sym_len, i);
+        mem_free((void*)&buf, len + 1, "compile_unity().buf");
+
+        for (k = 0;; ++k)
+        {
+            collide = FALSE;
+            for (j = sym_file; j < sym_len && !collide; ++j)
+                for (l = 0; l < sym_file; ++l)
+                    if (sym[l].unit == k && !strcmp(sym[l].name, sym[j].name) &&
+                            (!sym[l].macro || sym[l].macro != sym[j].macro))
+                    {
+                        LOGWARNING(0, FALSE,
+                                logger_stringf("'%s' Collides With '%s' at '%s' in Unit %"PRIu64"\n",
+                                    src->i[i], src->i[sym[l].file], sym[j].name, k + 1));
+                        collide = TRUE;
+                        break;
+                    }
+
+            if (!collide)
+                break;
+        }
+
+        for (j = sym_file; j < sym_len; ++j)
+            sym[j].unit = k;
+        file_unit[i] = k;
+        if (units < k + 1)
+            units = k + 1;
+    }
+
+    /* ---- write units ----------------------------------------------------- */
+
+    /* units live in `<dir_obj>unity/`, sources are included relative to it */
+    for (i = 0; dir_obj[i]; ++i)
+        if (dir_obj[i] == '/' || dir_obj[i] == '\\')
+            strncat(up, "../", PATH_CAP - strlen(up) - 1);
+    strncat(up, "../", PATH_CAP - strlen(up) - 1);
+
+    text_len = PATH_CAP * (src->cursor + 2);
+    if (mem_alloc((void*)&text, text_len, "compile_unity().text") != ERR_SUCCESS)
+        goto cleanup;
+
+    for (k = 0; k < units; ++k)
+    {
+        len = (u64)snprintf(text, text_len,
+                "/* generated by buildtool, unity build '%s' unit %"PRIu64"/%"PRIu64" */\n\n",
+                name, k + 1, units);
+        for (i = 0; i < src->cursor; ++i)
+            if (file_unit[i] == k)
+                len += (u64)snprintf(text + len, text_len - len,
+                        "#include \"%s%s\"\n", up, (str*)src->i[i]);
+
+        snprintf(path, PATH_CAP, "%s"UNITY_DIR"%s_%"PRIu64".c", dir_obj, name, k);
+        /* create directories of `path` */
+        if (object_path_internal(path, "", temp) != ERR_SUCCESS)
+            goto cleanup;
+
+        old_len = 0;
+        if (is_file_exists(path, FALSE) == ERR_SUCCESS)
+            old_len = get_file_contents(path, (void*)&old, 1, TRUE);
+
+        if (!old || old_len != len || memcmp(old, text, len))
+        {
+            if ((file = fopen(path, "wb")) == NULL)
+            {
+                LOGERROR(ERR_FILE_OPEN_FAIL, TRUE,
+                        logger_stringf("Failed to Write Unity '%s'\n", path));
+                goto cleanup;
+            }
+            fwrite(text, 1, len, file);
+            fclose(file);
+        }
+        mem_free((void*)&old, old_len + 1, "compile_unity().old");
+
+        cmd_push(&unit_src, path);
+    }
+
+    LOGINFO(FALSE,
+            logger_stringf("Unity Build '%s': %"PRIu64" Sources in %"PRIu64" Units\n",
+                name, src->cursor, units));
+
+    if (compile(cmd, &unit_src, dir_obj, obj) != ERR_SUCCESS)
+        goto cleanup;
+
+    mem_free((void*)&text, text_len, "compile_unity().text");
+    mem_free((void*)&file_unit, src->cursor * sizeof(u64), "compile_unity().file_unit");
+    mem_free((void*)&sym, (sym_cap + 1) * sizeof(bt_sym), "compile_unity().sym");
+    mem_free_buf(&unit_src, "compile_unity().unit_src");
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+
+cleanup:
+
+    /* keep the error, freeing resets it */
+    err = build_err;
+    mem_free((void*)&text, text_len, "compile_unity().text");
+    mem_free((void*)&file_unit, src->cursor * sizeof(u64), "compile_unity().file_unit");
+    mem_free((void*)&sym, (sym_cap + 1) * sizeof(bt_sym), "compile_unity().sym");
+    mem_free_buf(&unit_src, "compile_unity().unit_src");
+    build_err = err;
+    return build_err;
+}
+
+u32 link_objects(bt_buf *cmd, const str *out, const str *dir_obj, str *cmd_name)
+{
+    str stamp[PATH_CAP] = {0};
+    str out_name[ID_CAP] = {0};
+    u64 mtime_out = 0, mtime = 0, i = 0;
+    u64 hash = 0;
+    b8 stale = FALSE;
+
+    if (get_base_name(out, out_name, ID_CAP) != ERR_SUCCESS)
+        return build_err;
+
+    snprintf(stamp, PATH_CAP, "%s%s"HASH_STAMP_EXT, dir_obj, out_name);
+    hash = cmd_hash_internal(cmd, cmd->cursor, NULL);
+
+    if (
+            get_file_mtime(out, &mtime_out) != ERR_SUCCESS ||
+            !stamp_match_internal(stamp, hash))
+        stale = TRUE;
+
+    for (i = 0; i < cmd->cursor && !stale; ++i)
+    {
+        if (!strcmp(cmd->i[i], out))
+            continue;
+
+        if (get_file_mtime(cmd->i[i], &mtime) == ERR_SUCCESS && mtime > mtime_out)
+            stale = TRUE;
+    }
+
+    if (!stale)
+    {
+        LOGINFO(FALSE,
+                logger_stringf("'%s' Up to Date\n", out));
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+
+    remove(stamp);
+    if (exec(cmd, cmd_name) != ERR_SUCCESS)
+        return build_err;
+
+    stamp_write_internal(stamp, hash);
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
+
+void cmd_push_pgo(bt_buf *cmd, u32 stage, const str *dir_profile)
+{
+    switch (stage)
+    {
+        case PGO_STAGE_GENERATE:
+            /* absolute, the training run doesn't start in the project root */
+            cmd_push(cmd, stringf("-fprofile-generate=%s%s", DIR_BUILDTOOL_BIN_ROOT, dir_profile));
+            cmd_push(cmd, "-fprofile-update=prefer-atomic");
+            break;
+
+        case PGO_STAGE_USE:
+            cmd_push(cmd, stringf("-fprofile-use=%s%s", DIR_BUILDTOOL_BIN_ROOT, dir_profile));
+            cmd_push(cmd, "-fprofile-partial-training");
+            cmd_push(cmd, "-Wno-missing-profile");
+            break;
+    }
+}
+
+u32 pgo_reset(const str *dir_profile)
+{
+    bt_buf contents = {0};
+    str path[PATH_CAP] = {0};
+    u64 i = 0, len = 0;
+
+    if (is_dir_exists(dir_profile, FALSE) != ERR_SUCCESS)
+    {
+        make_dir(dir_profile);
+        if (build_err != ERR_SUCCESS && build_err != ERR_DIR_EXISTS)
+            return build_err;
+
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+
+    contents = get_dir_contents(dir_profile);
+    if (build_err == ERR_DIR_EMPTY)
+    {
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+    else if (build_err != ERR_SUCCESS)
+        return build_err;
+
+    for (i = 0; i < contents.memb; ++i)
+    {
+        len = strlen(contents.i[i]);
+        if (len <= strlen(PROFILE_EXT) ||
+                strcmp((str*)contents.i[i] + len - strlen(PROFILE_EXT), PROFILE_EXT))
+            continue;
+
+        snprintf(path, PATH_CAP, "%s%s", dir_profile, (str*)contents.i[i]);
+        remove(path);
+    }
+
+    mem_free_buf(&contents, "pgo_reset().contents");
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
+
+u32 object_path_internal(const str *src, const str *dir_obj, str *dst)
+{
+    str *ext = NULL;
+    u64 i = 0, len = 0;
+
+    if (dir_obj[0] && !strncmp(src, dir_obj, strlen(dir_obj)))
+        dir_obj = "";
+
+    len = (u64)snprintf(dst, PATH_CAP - 2, "%s%s", dir_obj, src);
+    if (len >= PATH_CAP - 2)
+    {
+        LOGERROR(ERR_PATH_TOO_LONG, TRUE,
+                logger_stringf("Failed to Get Object Path of '%s', Path Too Long\n", src));
+        return build_err;
+    }
+
+    posix_slash(dst);
+
+    /* keep objects of '../' sources inside `dir_obj` */
+    for (i = strlen(dir_obj); i + 1 < len; ++i)
+        if (dst[i] == '.' && dst[i + 1] == '.' &&
+                (i == 0 || dst[i - 1] == '/') && (dst[i + 2] == '/' || !dst[i + 2]))
+            dst[i] = dst[i + 1] = '_';
+
+    ext = strrchr(dst, '.');
+    if (!ext || strchr(ext, '/'))
+        ext = dst + len;
+    snprintf(ext, 3, ".o");
+
+    for (i = 1; dst[i]; ++i)
+    {
+        if (dst[i] != '/')
+            continue;
+
+        dst[i] = 0;
+        make_dir(dst);
+        dst[i] = '/';
+        if (build_err != ERR_SUCCESS && build_err != ERR_DIR_EXISTS)
+            return build_err;
+    }
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
+
+u64 unity_symbols_internal(const str *buf, bt_sym *dst, u64 file)
+{
+    const str *p = buf;
+    str tok[ID_CAP] = {0};      /* current identifier */
+    str first[ID_CAP] = {0};    /* first identifier of the current declaration */
+    str last[ID_CAP] = {0};     /* last identifier of the current declaration */
+    str tag[ID_CAP] = {0};      /* pending struct/union/enum tag */
+    str name[ID_CAP] = {0};
+    u64 n = 0, i = 0, len = 0;
+    u64 depth = 0, paren = 0;
+    b8 line_start = TRUE;
+    b8 is_static = FALSE, is_typedef = FALSE, named = FALSE, fn_ptr = FALSE;
+    str prev = 0, quote = 0;
+
+    while (*p)
+    {
+        /* ---- comments, literals and whitespace --------------------------- */
+
+        if (p[0] == '/' && p[1] == '*')
+        {
+            if (!(p = strstr(p + 2, "*/")))
+                break;
+            p += 2;
+            continue;
+        }
+
+        if (p[0] == '/' && p[1] == '/')
+        {
+            while (*p && *p != '\n')
+                ++p;
+            continue;
+        }
+
+        if (*p == '"' || *p == '\'')
+        {
+            for (quote = *p++; *p && *p != quote; ++p)
+                if (*p == '\\' && p[1])
+                    ++p;
+            if (*p)
+                ++p;
+            if (!depth)
+                prev = quote;
+            continue;
+        }
+
+        if (*p == '\n')
+        {
+            line_start = TRUE;
+            ++p;
+            continue;
+        }
+
+        if (isspace((u8)*p))
+        {
+            ++p;
+            continue;
+        }
+
+        /* ---- preprocessor, macros are global to the translation unit ----- */
+
+        if (line_start && *p == '#')
+        {
+            for (++p; *p == ' ' || *p == '\t'; ++p);
+            i = !strncmp(p, "define", 6) ? 6 : !strncmp(p, "undef", 5) ? 5 : 0;
+            for (p += i; i && (*p == ' ' || *p == '\t'); ++p);
+
+            for (len = 0; i && (isalnum((u8)*p) || *p == '_'); ++p)
+                if (len < ID_CAP - 1)
+                    name[len++] = *p;
+            name[len] = 0;
+
+            if (len && i == 6)
+            {
+                if (dst)
+                {
+                    snprintf(dst[n].name, ID_CAP, "%s", name);
+                    dst[n].macro = macro_hash_internal(p) + 1;
+                }
+                ++n;
+            }
+            else if (len && i == 5 && dst)
+            {
+                for (i = 0; i < n; ++i)
+                    if (!strcmp(dst[i].name, name))
+                        dst[i] = dst[--n];
+            }
+
+            for (; *p && *p != '\n'; ++p)
+                if (*p == '\\' && p[1] == '\n')
+                    ++p;
+            continue;
+        }
+
+        line_start = FALSE;
+
+        /* ---- identifiers ------------------------------------------------- */
+
+        if (isalpha((u8)*p) || *p == '_')
+        {
+            for (len = 0; isalnum((u8)*p) || *p == '_'; ++p)
+                if (len < ID_CAP - 1)
+                    tok[len++] = *p;
+            tok[len] = 0;
+
+            /* name of a function pointer, `(*name)` */
+            if (!depth && paren == 1 && fn_ptr && !named)
+                snprintf(last, ID_CAP, "%s", tok);
+
+            if (depth || paren)
+                continue;
+
+            if (!first[0])
+            {
+                snprintf(first, ID_CAP, "%s", tok);
+                is_static = !strcmp(tok, "static");
+                is_typedef = !strcmp(tok, "typedef");
+            }
+
+            if (!strcmp(last, "struct") || !strcmp(last, "union") || !strcmp(last, "enum"))
+                snprintf(tag, ID_CAP, "%s %s", last, tok);
+
+            snprintf(last, ID_CAP, "%s", tok);
+            prev = 'a';
+            continue;
+        }
+
+        /* ---- punctuation ------------------------------------------------- */
+
+        name[0] = 0;
+        switch (*p)
+        {
+            case '{':
+                if (!depth && !paren && prev != ')' && tag[0] && !strcmp(tag + strcspn(tag, " ") + 1, last))
+                    snprintf(name, ID_CAP, "%s", tag);
+                ++depth;
+                break;
+
+            case '}':
+                if (depth && !--depth && prev == ')')
+                {
+                    /* end of function body */
+                    first[0] = last[0] = tag[0] = 0;
+                    named = fn_ptr = FALSE;
+                    prev = 0;
+                    ++p;
+                    continue;
+                }
+                break;
+
+            case '(':
+                if (!depth && !paren && (is_static || is_typedef) && !named)
+                {
+                    for (i = 1; isspace((u8)p[i]); ++i);
+                    if (p[i] == '*')
+                        fn_ptr = TRUE;
+                    else if (is_static)
+                    {
+                        snprintf(name, ID_CAP, "%s", last);
+                        named = TRUE;
+                    }
+                }
+                ++paren;
+                break;
+
+            case ')':
+                if (paren && !--paren && !depth && fn_ptr && !named)
+                {
+                    snprintf(name, ID_CAP, "%s", last);
+                    named = TRUE;
+                }
+                break;
+
+            case '[':
+            case '=':
+                if (!depth && !paren && is_static && !named)
+                {
+                    snprintf(name, ID_CAP, "%s", last);
+                    named = TRUE;
+                }
+                break;
+
+            case ';':
+                if (depth || paren)
+                    break;
+                if ((is_static || is_typedef) && !named)
+                    snprintf(name, ID_CAP, "%s", last);
+                first[0] = last[0] = tag[0] = 0;
+                is_static = is_typedef = named = fn_ptr = FALSE;
+                break;
+        }
+
+        if (!depth || (*p == '{' && depth == 1))
+            prev = *p == '{' ? prev : *p;
+        ++p;
+
+        if (!name[0])
+            continue;
+
+        for (i = 0; dst && i < n; ++i)
+            if (!strcmp(dst[i].name, name))
+                break;
+        if (dst && i < n)
+            continue;
+
+        if (dst)
+        {
+            snprintf(dst[n].name, ID_CAP, "%s", name);
+            dst[n].macro = 0;
+        }
+        ++n;
+    }
+
+    for (i = 0; dst && i < n; ++i)
+        dst[i].file = file;
+
+    return n;
+}
+
+u64 macro_hash_internal(const str *p)
+{
+    const u64 prime = ((u64)1 << 40) | 0x1b3;
+    u64 hash = ((u64)0xcbf29ce4 << 32) | 0x84222325;
+    b8 space = FALSE;
+
+    for (; *p && *p != '\n'; ++p)
+    {
+        if (*p == '\\' && (p[1] == '\n' || p[1] == '\r'))
+        {
+            for (++p; *p == '\r' || *p == '\n'; ++p);
+            --p;
+            space = TRUE;
+            continue;
+        }
+
+        if (isspace((u8)*p))
+        {
+            space = TRUE;
+            continue;
+        }
+
+        if (space)
+            hash = (hash ^ ' ') * prime;
+        space = FALSE;
+        hash = (hash ^ (u8)*p) * prime;
+    }
+
+    return hash;
+}
+
+b8 is_deps_changed_internal(const str *path, u64 mtime)
+{
+    str *buf = NULL;
+    str name[PATH_CAP] = {0};
+    u64 len = 0, i = 0, n = 0;
+    u64 mtime_dep = 0;
+    b8 target = TRUE;
+    b8 changed = TRUE;
+    str c = 0;
+
+    if (is_file_exists(path, FALSE) != ERR_SUCCESS)
+        return TRUE;
+
+    len = get_file_contents(path, (void*)&buf, 1, TRUE);
+    if (!buf)
+        return TRUE;
+
+    for (i = 0; i <= len; ++i)
+    {
+        c = buf[i];
+
+        /* line continuation, escaped space and escaped '$' */
+        if (c == '\\' && (buf[i + 1] == '\n' || buf[i + 1] == '\r'))
+        {
+            ++i;
+            c = ' ';
+        }
+        else if ((c == '\\' && buf[i + 1] == ' ') || (c == '$' && buf[i + 1] == '$'))
+        {
+            c = buf[++i];
+            if (n < PATH_CAP - 1)
+                name[n++] = c;
+            continue;
+        }
+
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r' && c != 0)
+        {
+            if (n < PATH_CAP - 1)
+                name[n++] = c;
+            continue;
+        }
+
+        if (!n)
+            continue;
+
+        name[n] = 0;
+        n = 0;
+
+        if (target)
+        {
+            if (name[strlen(name) - 1] == ':')
+                target = FALSE;
+            continue;
+        }
+
+        if (get_file_mtime(name, &mtime_dep) != ERR_SUCCESS || mtime_dep > mtime)
+        {
+            LOGTRACE(FALSE,
+                    logger_stringf("'%s' Changed\n", name));
+            goto cleanup;
+        }
+    }
+
+    changed = target;
+
+cleanup:
+
+    mem_free((void*)&buf, len + 1, "is_deps_changed_internal().buf");
+    return changed;
+}
+
+u64 cmd_hash_internal(bt_buf *cmd, u64 n, const str *extra)
+{
+    const u64 prime = ((u64)1 << 40) | 0x1b3;
+    u64 hash = ((u64)0xcbf29ce4 << 32) | 0x84222325;
+    const str *s = NULL;
+    u64 i = 0;
+
+    for (i = 0; i <= n; ++i)
+    {
+        s = i < n ? (const str*)cmd->i[i] : extra;
+        if (!s)
+            continue;
+
+        for (; *s; ++s)
+            hash = (hash ^ (u8)*s) * prime;
+        hash *= prime; /* separator */
+    }
+
+    return hash;
+}
+
+b8 stamp_match_internal(const str *path, u64 hash)
+{
+    FILE *file = NULL;
+    str line[32] = {0};
+
+    if ((file = fopen(path, "rb")) == NULL)
+        return FALSE;
+
+    if (!fgets(line, sizeof(line), file))
+        line[0] = 0;
+    fclose(file);
+
+    return !strcmp(line, stringf("%016"PRIx64"\n", hash));
+}
+
+void stamp_write_internal(const str *path, u64 hash)
+{
+    FILE *file = NULL;
+
+    if ((file = fopen(path, "wb")) == NULL)
+    {
+        LOGWARNING(ERR_FILE_OPEN_FAIL, TRUE,
+                logger_stringf("Failed to Write Stamp '%s'\n", path));
+        return;
+    }
+
+    fprintf(file, "%016"PRIx64"\n", hash);
+    fclose(file);
+}
+
 void help(void)
 {
     fprintf(stderr, "%s",
@@ -774,7 +1811,8 @@ void help(void)
             "    show       show build command in list format\n"
             "    raw        show build command in raw format\n"
             "    self       build build source\n"
-            "    btdebug    build build source in debug mode\n");
+            "    btdebug    build build source in debug mode\n"
+            "    -j<N>      run N compile jobs at once (default: number of processors)\n");
     _exit(ERR_SUCCESS);
 }
 
@@ -136,6 +136,15 @@ enum file_type_index
     FILE_TYPE_FIFO
 }; /* file_type_index */
 
+typedef struct bt_proc
+{
+    i64 pid;        /* process id (linux) */
+    void *handle;   /* process handle (windows) */
+    b8 running;
+    u32 result;     /* @ref build_err of the finished process */
+    str name[ID_CAP];
+} bt_proc;
+
 /* ---- section: signatures ------------------------------------------------- */
 
 /*! @brief write temporary formatted string.
@@ -158,6 +167,10 @@ extern u64 find_token(str *arg, int argc, str **argv);
  */
 extern void get_time_str(str *dst, const str *format);
 
+/*! @return monotonic time in nanoseconds, for measuring durations.
+ */
+extern u64 get_time_nsec(void);
+
 /* ---- section: implementation --------------------------------------------- */
 
 str *stringf(const str *format, ...)
@@ -203,4 +216,11 @@ void get_time_str(str *dst, const str *format)
     strftime(dst, TIME_STRING_MAX, format, time_metadata);
 }
 
+u64 get_time_nsec(void)
+{
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000 + (u64)ts.tv_nsec;
+}
+
 #endif /* BUILDTOOL_COMMON_H */
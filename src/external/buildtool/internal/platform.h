@@ -159,6 +159,48 @@ extern u32 get_path_bin_root_internal(str *path);
  */
 extern u32 exec(bt_buf *cmd, str *cmd_name);
 
+/*! @brief start command in a separate child process and return without waiting.
+ *
+ *  -- IMPLEMENTATION: platform_<PLATFORM>.h --;
+ *
+ *  @param cmd command and args to execute, only read during the call.
+ *  @param cmd_name command name (for logging).
+ *  @param x process to start, finish with @ref exec_poll().
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+extern u32 exec_spawn(bt_buf *cmd, str *cmd_name, bt_proc *x);
+
+/*! @brief check if process `x` has finished and log its exit status.
+ *
+ *  -- IMPLEMENTATION: platform_<PLATFORM>.h --;
+ *
+ *  @param wait block until `x` finishes.
+ *
+ *  @return `TRUE` if `x` is not running (anymore), `x->result` holds its outcome.
+ */
+extern b8 exec_poll(bt_proc *x, b8 wait);
+
+/*! @brief block until any of the `n` processes at `x` finishes, without reaping it.
+ *
+ *  -- IMPLEMENTATION: platform_<PLATFORM>.h --;
+ */
+extern void exec_wait_any(bt_proc *x, u64 n);
+
+/*! -- IMPLEMENTATION: platform_<PLATFORM>.h --;
+ *
+ *  @return number of online processors, at least 1.
+ */
+extern u32 get_nproc(void);
+
+/*! @brief get modification time of `name` in nanoseconds.
+ *
+ *  @remark does not follow symlinks.
+ *
+ *  @return non-zero on failure and @ref build_err is set accordingly.
+ */
+extern u32 get_file_mtime(const str *name, u64 *mtime);
+
 /*! @brief append @ref SLASH_NATIVE onto `path` if `path` not ending in @ref SLASH_NATIVE, null (`\n`) terminated.
  *
  *  @remark @ref build_err is set accordingly on failure.
@@ -696,6 +738,26 @@ str *get_path_bin_root(void)
     return result;
 }
 
+u32 get_file_mtime(const str *name, u64 *mtime)
+{
+    struct stat stats = {0};
+
+    if (bt_stat(name, &stats) != 0)
+    {
+        build_err = ERR_FILE_NOT_FOUND;
+        return build_err;
+    }
+
+#if defined(PLATFORM_LINUX)
+    *mtime = (u64)stats.st_mtim.tv_sec * 1000000000 + (u64)stats.st_mtim.tv_nsec;
+#else
+    *mtime = (u64)stats.st_mtime * 1000000000;
+#endif /* PLATFORM */
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
+
 void check_slash(str *path)
 {
     u64 len = 0;
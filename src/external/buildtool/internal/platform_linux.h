@@ -29,6 +29,7 @@
 #include "common.h"
 
 #include <dirent.h>
+#include <spawn.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
@@ -64,30 +65,54 @@ u32 get_path_bin_root_internal(str *path)
     return build_err;
 }
 
-u32 exec(bt_buf *cmd, str *cmd_name)
+u32 exec_spawn(bt_buf *cmd, str *cmd_name, bt_proc *x)
 {
-    pid_t pid = fork();
-    int status, exit_code = 0, sig;
+    bt_proc noproc = {0};
+    pid_t pid = 0;
+    int err = 0;
 
-    if (pid < 0)
-    {
-        LOGERROR(ERR_PROCESS_FORK_FAIL, TRUE,
-                logger_stringf("Failed to Fork '%s'\n", cmd_name));
-        return build_err;
-    }
-    else if (pid == 0)
+    *x = noproc;
+    snprintf(x->name, ID_CAP, "%s", cmd_name);
+
+    /* no fork, the parent's pages are not copied for a child that only execs */
+    err = posix_spawnp(&pid, (const str*)cmd->i[0], NULL, NULL, (str *const *)cmd->i, environ);
+    if (err != 0)
     {
-        execvp((const str*)cmd->i[0], (str *const *)cmd->i);
         LOGERROR(ERR_EXEC_FAIL, TRUE,
-                logger_stringf("Failed '%s'\n", cmd_name));
+                logger_stringf("Failed '%s', %s\n", cmd_name, strerror(err)));
+        x->result = build_err;
         return build_err;
     }
 
-    if (waitpid(pid, &status, 0) == -1)
+    x->pid = pid;
+    x->running = TRUE;
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
+
+b8 exec_poll(bt_proc *x, b8 wait)
+{
+    pid_t pid = 0;
+    int status = 0, exit_code = 0, sig = 0;
+
+    if (!x->running)
+        return TRUE;
+
+    do pid = waitpid((pid_t)x->pid, &status, wait ? 0 : WNOHANG);
+    while (pid == -1 && errno == EINTR);
+
+    if (pid == 0)
+        return FALSE;
+
+    x->running = FALSE;
+
+    if (pid == -1)
     {
         LOGERROR(ERR_WAITPID_FAIL, TRUE,
-                logger_stringf("Failed to Waitpid '%s'\n", cmd_name));
-        return build_err;
+                logger_stringf("Failed to Waitpid '%s'\n", x->name));
+        x->result = build_err;
+        return TRUE;
     }
 
     if (WIFEXITED(status))
@@ -96,32 +121,67 @@ u32 exec(bt_buf *cmd, str *cmd_name)
         if (exit_code == 0)
         {
             LOGSUCCESS(FALSE,
-                    logger_stringf("'%s' Exit Code: %d\n", cmd_name, exit_code));
+                    logger_stringf("'%s' Exit Code: %d\n", x->name, exit_code));
         }
         else
         {
             LOGINFO(TRUE,
-                    logger_stringf("'%s' Exit Code: %d\n", cmd_name, exit_code));
+                    logger_stringf("'%s' Exit Code: %d\n", x->name, exit_code));
             build_err = ERR_EXEC_PROCESS_NON_ZERO;
-            return build_err;
+            x->result = build_err;
+            return TRUE;
         }
     }
     else if (WIFSIGNALED(status))
     {
         sig = WTERMSIG(status);
         LOGFATAL(ERR_EXEC_TERMINATE_BY_SIGNAL, TRUE,
-                logger_stringf("'%s' Terminated by Signal: %d, Process Aborted\n", cmd_name, sig));
-        return build_err;
+                logger_stringf("'%s' Terminated by Signal: %d, Process Aborted\n", x->name, sig));
+        x->result = build_err;
+        return TRUE;
     }
     else
     {
         LOGERROR(ERR_EXEC_ABNORMAL_EXIT, TRUE,
-                logger_stringf("'%s' Exited Abnormally\n", cmd_name));
-        return build_err;
+                logger_stringf("'%s' Exited Abnormally\n", x->name));
+        x->result = build_err;
+        return TRUE;
     }
 
-    build_err = ERR_SUCCESS;
+    x->result = ERR_SUCCESS;
+    return TRUE;
+}
+
+void exec_wait_any(bt_proc *x, u64 n)
+{
+    siginfo_t info = {0};
+    u64 i = 0;
+
+    for (i = 0; i < n && !x[i].running; ++i);
+    if (i == n)
+        return;
+
+    /* the build tool has no children other than its own jobs */
+    while (waitid(P_ALL, 0, &info, WEXITED | WNOWAIT) == -1 && errno == EINTR);
+}
+
+u32 exec(bt_buf *cmd, str *cmd_name)
+{
+    bt_proc proc = {0};
+
+    if (exec_spawn(cmd, cmd_name, &proc) != ERR_SUCCESS)
+        return build_err;
+
+    exec_poll(&proc, TRUE);
+
+    build_err = proc.result;
     return build_err;
 }
 
+u32 get_nproc(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n < 1 ? 1 : (u32)n;
+}
+
 #endif /* BUILDTOOL_PLATFORM_LINUX_H */
@@ -66,14 +66,17 @@ u32 get_path_bin_root_internal(str *path)
     return build_err;
 }
 
-u32 exec(bt_buf *cmd, str *cmd_name)
+u32 exec_spawn(bt_buf *cmd, str *cmd_name, bt_proc *x)
 {
     STARTUPINFOA        startup_info = {0};
     PROCESS_INFORMATION process_info = {0};
-    DWORD exit_code = 0;
+    bt_proc noproc = {0};
     str *cmd_cat = NULL;
     u32 i;
 
+    *x = noproc;
+    snprintf(x->name, ID_CAP, "%s", cmd_name);
+
     ZeroMemory(&startup_info, sizeof(startup_info));
     startup_info.cb = sizeof(startup_info);
 
@@ -81,14 +84,18 @@ u32 exec(bt_buf *cmd, str *cmd_name)
     {
         LOGERROR(ERR_PROCESS_FORK_FAIL, TRUE,
                 logger_stringf("Failed to Fork '%s'\n", cmd_name));
+        x->result = build_err;
         return build_err;
     }
 
     if (mem_alloc((void*)&cmd_cat, cmd->size * cmd->memb,
-            stringf("exec().%s", cmd_name)) != ERR_SUCCESS)
+            stringf("exec_spawn().%s", cmd_name)) != ERR_SUCCESS)
+    {
+        x->result = build_err;
         return build_err;
+    }
 
-    for (i = 0; i < cmd->memb; ++i)
+    for (i = 0; i < cmd->memb && cmd->i[i]; ++i)
         strncat(cmd_cat, stringf("%s ", cmd->i[i]), cmd->size);
 
     if(!CreateProcessA(NULL, cmd_cat, NULL, NULL, FALSE, 0, NULL, NULL,
@@ -96,36 +103,89 @@ u32 exec(bt_buf *cmd, str *cmd_name)
     {
         LOGFATAL(ERR_EXEC_FAIL, TRUE,
                 logger_stringf("Failed to Fork '%s', Process Aborted\n", cmd_name));
+        x->result = build_err;
         goto cleanup;
     }
 
-    WaitForSingleObject(process_info.hProcess, INFINITE);
+    CloseHandle(process_info.hThread);
+    x->pid = (i64)process_info.dwProcessId;
+    x->handle = process_info.hProcess;
+    x->running = TRUE;
 
-    GetExitCodeProcess(process_info.hProcess, &exit_code);
+    mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf("exec_spawn().%s", cmd_name));
 
-    CloseHandle(process_info.hProcess);
-    CloseHandle(process_info.hThread);
+    build_err = ERR_SUCCESS;
+    return build_err;
+
+cleanup:
+
+    mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf("exec_spawn().%s", cmd_name));
+    return build_err;
+}
+
+b8 exec_poll(bt_proc *x, b8 wait)
+{
+    DWORD exit_code = 0;
+
+    if (!x->running)
+        return TRUE;
+
+    if (WaitForSingleObject((HANDLE)x->handle, wait ? INFINITE : 0) == WAIT_TIMEOUT)
+        return FALSE;
+
+    GetExitCodeProcess((HANDLE)x->handle, &exit_code);
+    CloseHandle((HANDLE)x->handle);
+    x->handle = NULL;
+    x->running = FALSE;
 
     if (exit_code == 0)
         LOGSUCCESS(FALSE,
-                logger_stringf("'%s' Exit Code: %d\n", cmd_name, exit_code));
+                logger_stringf("'%s' Exit Code: %d\n", x->name, exit_code));
     else
     {
         LOGINFO(TRUE,
-                logger_stringf("'%s' Exit Code: %d\n", cmd_name, exit_code));
+                logger_stringf("'%s' Exit Code: %d\n", x->name, exit_code));
         build_err = ERR_EXEC_PROCESS_NON_ZERO;
-        goto cleanup;
+        x->result = build_err;
+        return TRUE;
     }
 
-    mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf("exec().%s", cmd_name));
+    x->result = ERR_SUCCESS;
+    return TRUE;
+}
 
-    build_err = ERR_SUCCESS;
-    return build_err;
+void exec_wait_any(bt_proc *x, u64 n)
+{
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS] = {0};
+    DWORD count = 0;
+    u64 i = 0;
 
-cleanup:
+    for (i = 0; i < n && count < MAXIMUM_WAIT_OBJECTS; ++i)
+        if (x[i].running)
+            handles[count++] = (HANDLE)x[i].handle;
+
+    if (count)
+        WaitForMultipleObjects(count, handles, FALSE, INFINITE);
+}
 
-    mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf("exec().%s", cmd_name));
+u32 exec(bt_buf *cmd, str *cmd_name)
+{
+    bt_proc proc = {0};
+
+    if (exec_spawn(cmd, cmd_name, &proc) != ERR_SUCCESS)
+        return build_err;
+
+    exec_poll(&proc, TRUE);
+
+    build_err = proc.result;
     return build_err;
 }
 
+u32 get_nproc(void)
+{
+    SYSTEM_INFO info = {0};
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors < 1 ? 1 : (u32)info.dwNumberOfProcessors;
+}
+
 #endif /* BUILDTOOL_PLATFORM_WIN_H */
@@ -33,6 +33,7 @@
 #include "math/matrix.h"
 #include "math/trigonometry.h"
 #include "math/vector.h"
+#include "memory/hash_map.h"
 #include "memory/memory.h"
 #include "physics/collision.h"
 #include "physics/physics_types.h"
@@ -40,7 +41,9 @@
 #include "string/string.h"
 #include "ui/ui.h"
 
+#include "h/cpu.h"
 #include "h/dir.h"
+#include "h/io.h"
 #include "h/process.h"
 #include "h/super_debugger.h"
 #include "h/time.h"
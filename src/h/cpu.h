@@ -0,0 +1,158 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file cpu.h
+ *
+ *  @brief cpu feature detection and runtime dispatch of SIMD kernels.
+ *
+ *  the engine is compiled for the baseline ISA, kernels for wider instruction
+ *  sets are compiled per function and picked at runtime through @ref fsl_kernels,
+ *  which @ref fsl_engine_init() fills for the highest level the cpu and OS support.
+ *
+ *  levels are cumulative, each level's kernels may use everything below it.
+ */
+
+#ifndef FSL_CPU_H
+#define FSL_CPU_H
+
+#include "../common/api.h"
+#include "../common/types.h"
+#include "../math/matrix.h"
+#include "../math/vector.h"
+
+enum fsl_cpu_feature
+{
+    FSL_CPU_FEATURE_SSE41 =     0x0001,
+    FSL_CPU_FEATURE_AVX2 =      0x0002,
+    FSL_CPU_FEATURE_FMA =       0x0004,
+    FSL_CPU_FEATURE_AVX512F =   0x0008
+}; /* fsl_cpu_feature */
+
+enum fsl_cpu_level
+{
+    FSL_CPU_LEVEL_SCALAR = 0,   /* reference kernels, plain C */
+    FSL_CPU_LEVEL_SSE41,        /* SSE4.1 */
+    FSL_CPU_LEVEL_AVX2,         /* AVX2 + FMA */
+    FSL_CPU_LEVEL_AVX512,       /* AVX-512F */
+    FSL_CPU_LEVEL_COUNT
+}; /* fsl_cpu_level */
+
+/*!
+ *  @brief kernels of one @ref fsl_cpu_level, all levels produce the same results
+ *  as @ref FSL_CPU_LEVEL_SCALAR up to floating-point rounding.
+ *
+ *  @remark pointer arguments may not alias unless stated.
+ */
+typedef struct fsl_kernel_table
+{
+    /*!
+     *  @brief `dst` = `a` * `b`, as @ref fsl_multiply_m4f32(), `dst` may alias `a` or `b`.
+     */
+    void (*multiply_m4f32)(const m4f32 *a, const m4f32 *b, m4f32 *dst);
+
+    /*!
+     *  @brief `dst[i]` = `m` * `src[i]` (column vectors) for `n` vectors, `dst` may alias `src`.
+     */
+    void (*transform_v4f32)(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n);
+
+    /*!
+     *  @brief `dst` = transpose of `m`, `dst` may alias `m`.
+     */
+    void (*transpose_m4f32)(const m4f32 *m, m4f32 *dst);
+
+    /*!
+     *  @brief `dst` = inverse of `m`, `dst` may alias `m`.
+     *
+     *  @return determinant of `m`, if 0 `dst` is left unchanged.
+     */
+    f32 (*inverse_m4f32)(const m4f32 *m, m4f32 *dst);
+
+    /*!
+     *  @brief as @ref fsl_sincos_f32_batch().
+     */
+    void (*sincos_f32)(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n);
+
+    /*!
+     *  @brief as @ref fsl_perlin_noise_1d_batch().
+     */
+    void (*perlin_noise_1d)(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+            u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+    /*!
+     *  @brief as @ref fsl_perlin_noise_2d_batch().
+     */
+    void (*perlin_noise_2d)(const f32 *x, const f32 *y, f32 *dst, u64 n,
+            f32 amplitude, f32 frequency,
+            u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+    /*!
+     *  @brief as @ref fsl_perlin_noise_3d_batch().
+     */
+    void (*perlin_noise_3d)(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+            f32 amplitude, f32 frequency,
+            u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+} fsl_kernel_table;
+
+/*!
+ *  @brief kernels of the current level, set by @ref fsl_cpu_init() and @ref fsl_cpu_set_level().
+ */
+FSLAPI extern fsl_kernel_table fsl_kernels;
+
+/*!
+ *  @brief detect cpu features and fill @ref fsl_kernels for the highest supported level.
+ *
+ *  @remark called from @ref fsl_engine_init(), does nothing if already initialized.
+ *  @remark environment variable `FSL_CPU_LEVEL` set to `scalar`, `sse4.1`, `avx2` or
+ *  `avx512` caps the level (for testing), levels above what's supported are ignored.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_cpu_init(void);
+
+/*!
+ *  @return enum @ref fsl_cpu_feature flags usable on this cpu and OS.
+ */
+FSLAPI u32 fsl_cpu_get_features(void);
+
+/*!
+ *  @return highest enum @ref fsl_cpu_level usable on this cpu and OS.
+ */
+FSLAPI u32 fsl_cpu_get_level_max(void);
+
+/*!
+ *  @return enum @ref fsl_cpu_level of @ref fsl_kernels.
+ */
+FSLAPI u32 fsl_cpu_get_level(void);
+
+/*!
+ *  @brief fill @ref fsl_kernels for `level`, clamped to @ref fsl_cpu_get_level_max().
+ *
+ *  @remark not thread-safe, call while no kernels are running.
+ *
+ *  @return level set.
+ */
+FSLAPI u32 fsl_cpu_set_level(u32 level);
+
+/*!
+ *  @brief load `dst` with the kernels of `level`, without changing @ref fsl_kernels,
+ *  to compare levels against each other.
+ *
+ *  @return non-zero on failure (`level` not supported) and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_cpu_get_kernels(u32 level, fsl_kernel_table *dst);
+
+#endif /* FSL_CPU_H */
@@ -24,6 +24,7 @@
 #define FSL_DIR_H
 
 #include "../common/api.h"
+#include "../common/limits.h"
 #include "../common/types.h"
 
 enum fsl_file_type_index
@@ -37,6 +38,35 @@ enum fsl_file_type_index
     FSL_FILE_TYPE_FIFO
 }; /* fsl_file_type_index */
 
+enum fsl_file_map_flag
+{
+    FSL_FLAG_FILE_MAP_SEQUENTIAL =  0x0001, /* read front to back, read ahead aggressively (linux: `MADV_SEQUENTIAL`) */
+    FSL_FLAG_FILE_MAP_RANDOM =      0x0002, /* read in no particular order, don't read ahead (linux: `MADV_RANDOM`) */
+    FSL_FLAG_FILE_MAP_WILLNEED =    0x0004  /* start paging the whole file in right away (linux: `MADV_WILLNEED`) */
+}; /* fsl_file_map_flag */
+
+enum fsl_dir_handle_flag
+{
+    FSL_FLAG_DIR_HANDLE_SWEEP_TEMP = 0x0001 /* remove temp files of atomic writes that never committed */
+}; /* fsl_dir_handle_flag */
+
+typedef struct fsl_dir_handle fsl_dir_handle;
+
+/*!
+ *  @brief an open directory, files are reached relative to it without walking
+ *  its path again, and its deletion is noticed without polling the path.
+ *
+ *  @remark zero-initialized means closed.
+ */
+struct fsl_dir_handle
+{
+    b8 loaded;
+    b8 valid;                   /* `FALSE` once the directory is deleted or moved away */
+    int fd;                     /* `O_DIRECTORY` file descriptor */
+    int watch_fd;               /* inotify instance watching the parent, -1 if unavailable */
+    str path[FSL_PATH_CAP];     /* path the handle was opened with, slash terminated */
+}; /* fsl_dir_handle */
+
 /*!
  *  @return non-zero on failure and @ref fsl_err is set accordingly.
  */
@@ -100,13 +130,100 @@ FSLAPI u32 fsl_get_file_type(const fsl_fs_path *path, u32 *type);
  */
 FSLAPI u64 fsl_get_file_contents(const fsl_fs_path *path, void **dst, b8 terminate);
 
+/*!
+ *  @brief map file at `path` read-only into `*dst`, without copying it into heap memory.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param dst pointer to `NULL` buffer to store the mapping address.
+ *  @param size recipient of file size, in bytes.
+ *  @param flags enum @ref fsl_file_map_flag, access pattern hints.
+ *
+ *  @remark the mapping is not null (`\0`) terminated, parse it using `size`.
+ *  @remark empty files can't be mapped and fail with @ref FSL_ERR_SIZE_TOO_SMALL.
+ *  @remark release with @ref fsl_file_unmap().
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_file_map(const fsl_fs_path *path, void **dst, u64 *size, u32 flags);
+
+/*!
+ *  @brief unmap a file previously mapped with @ref fsl_file_map() and set `*x` to `NULL`.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param size file size returned by @ref fsl_file_map().
+ */
+FSLAPI void fsl_file_unmap(void **x, u64 size);
+
+/*!
+ *  @brief open directory at `path` and watch it for deletion.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param flags enum @ref fsl_dir_handle_flag.
+ *  @param log enable/disable logging.
+ *
+ *  @remark closes `x` first if it's already open.
+ *  @remark with @ref FSL_FLAG_DIR_HANDLE_SWEEP_TEMP, removes the temp files interrupted
+ *  atomic writes left in the directory, only the ones named as @ref fsl_write_file_atomic()
+ *  names them.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_dir_handle_open(fsl_dir_handle *x, const fsl_fs_path *path, u32 flags, b8 log);
+
+/*!
+ *  @brief check whether the directory behind `x` still exists at its path.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @remark cheap enough to call every frame, it reads pending watch events and
+ *  never touches the path.
+ *  @remark once `FALSE`, it stays `FALSE` until `x` is opened again.
+ *
+ *  @return `TRUE` if `x` is open and its directory wasn't deleted or moved.
+ */
+FSLAPI b8 fsl_dir_handle_is_valid(fsl_dir_handle *x);
+
+/*!
+ *  @brief close `x` and zero it out.
+ *  implemented in `platform_<PLATFORM>.c`.
+ */
+FSLAPI void fsl_dir_handle_close(fsl_dir_handle *x);
+
+/*!
+ *  @brief read file `name`, relative to `dir`, into `dst`.
+ *
+ *  @param size capacity of `dst`, in bytes, longer files are cut short.
+ *  @param log enable/disable logging.
+ *
+ *  @remark a missing file sets @ref FSL_ERR_FILE_NOT_FOUND.
+ *
+ *  @return bytes read.
+ *  @return 0 on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u64 fsl_read_file_at(const fsl_dir_handle *dir, const str *name, void *dst, u64 size, b8 log);
+
 /*!
  *  @brief get directory entries at `path`.
  *
+ *  @remark directory names end with a slash.
+ *
  *  @return `(fsl_buf){0}` on failure and @ref fsl_err is set accordingly.
  */
 FSLAPI fsl_buf fsl_get_dir_contents(const fsl_fs_path *path);
 
+/*!
+ *  @brief get directory entries at `path`, optionally only files ending in `ext`.
+ *
+ *  @param ext file name suffix to keep (e.g. ".fmesh"), directories are skipped,
+ *  if `NULL` all entries are kept.
+ *
+ *  @remark the directory is read once, entries are only `stat()`ed when the file
+ *  system doesn't report their type.
+ *  @remark if no entry matches, @ref FSL_ERR_DIR_EMPTY is set.
+ *
+ *  @return `(fsl_buf){0}` on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI fsl_buf fsl_get_dir_contents_ex(const fsl_fs_path *path, const str *ext);
+
 /*!
  *  @brief get directory entry count at 'path'.
  *
@@ -124,6 +241,21 @@ FSLAPI u64 fsl_get_dir_entry_count(const fsl_fs_path *path);
  */
 FSLAPI u32 fsl_copy_file(const fsl_fs_path *src, const fsl_fs_path *dst);
 
+/*!
+ *  @brief copy `src` into `dst`, preserve permissions and modification time, and
+ *  report bytes copied.
+ *
+ *  regular files are copied kernel-side where possible (`copy_file_range()`, then
+ *  `sendfile()`), falling back to a chunked read/write loop.
+ *
+ *  @param len optional, recipient of bytes copied (0 for symlinks).
+ *
+ *  @remark can overwrite files and symlinks.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_copy_file_ex(const fsl_fs_path *src, const fsl_fs_path *dst, u64 *len);
+
 /*!
  *  @brief copy `src` into `dst`, preserve all permissions and modification times.
  *
@@ -165,6 +297,53 @@ FSLAPI u32 fsl_write_file(const fsl_fs_path *path, u64 size, void *buf, b8 log,
  */
 FSLAPI u32 fsl_append_file(const fsl_fs_path *path, u64 size, void *buf, b8 log, b8 text);
 
+/*!
+ *  @brief write contents of `buf` into `path` atomically, readers and crashes see
+ *  either the old or the new contents, never a mix or a truncated file.
+ *
+ *  writes `<path>.<serial>.fsltmp`, flushes it (linux: `fdatasync()`, windows:
+ *  `FlushFileBuffers()`) and renames it over `path`.
+ *
+ *  @param size size of data, in bytes.
+ *  @param log enable/disable logging.
+ *  @param text enable/disable newline (`\n`) termination of file.
+ *  @param sync_dir also flush the parent directory, so the rename itself survives
+ *  a power loss, not just the data.
+ *
+ *  @remark between @ref fsl_write_batch_begin() and @ref fsl_write_batch_end(), the
+ *  flush and rename are deferred to @ref fsl_write_batch_end() and `sync_dir` is ignored.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_write_file_atomic(const fsl_fs_path *path, u64 size, void *buf, b8 log, b8 text, b8 sync_dir);
+
+/*!
+ *  @brief like @ref fsl_write_file_atomic(), with `name` relative to `dir`.
+ *
+ *  @remark `dir` must stay open until a pending batch is ended.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_write_file_atomic_at(const fsl_dir_handle *dir, const str *name,
+        u64 size, void *buf, b8 log, b8 text, b8 sync_dir);
+
+/*!
+ *  @brief start batching @ref fsl_write_file_atomic() calls, e.g. for one save tick.
+ *
+ *  @remark not nestable, not thread-safe.
+ */
+FSLAPI void fsl_write_batch_begin(void);
+
+/*!
+ *  @brief flush and rename all files written since @ref fsl_write_batch_begin(), then
+ *  flush each directory they were written to once.
+ *
+ *  @remark a file failing to commit keeps its old contents, the rest are still committed.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_write_batch_end(void);
+
 /*!
  *  @brief get calloc'd string of resolved `path`.
  *
@@ -188,6 +367,110 @@ FSLAPI u32 fsl_get_path_absolute(const fsl_fs_path *path, str **dst);
  */
 u32 fsl_get_path_absolute_internal(const fsl_fs_path *path, str *dst);
 
+/*!
+ *  @internal
+ *
+ *  @brief copy up to `size` bytes from `fd_in` to `fd_out` from their current offsets
+ *  without a user-space copy, where the platform can.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  linux tries `copy_file_range()` (reflinks, server-side copies), then `sendfile()`,
+ *  windows copies nothing.
+ *
+ *  @param len recipient of bytes copied, short of `size` if the file shrank or the
+ *  platform can't copy the rest, the caller copies it.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+u32 fsl_copy_file_kernel_internal(int fd_in, int fd_out, u64 size, u64 *len,
+        const fsl_fs_path *src, const fsl_fs_path *dst);
+
+/*!
+ *  @internal
+ *
+ *  @brief open `name` relative to `dir`, or to the working directory if `dir` is `NULL`.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param flags `open()` flags, the platform adds its own (linux: `O_CLOEXEC`, windows: `O_BINARY`).
+ *  @param mode permission bits of a created file.
+ *
+ *  @return file descriptor, -1 on failure.
+ */
+int fsl_file_open_at_internal(const fsl_dir_handle *dir, const str *name, int flags, u32 mode);
+
+/*!
+ *  @internal
+ *
+ *  @brief give the file open at `fd` the permission bits of file `name`, relative to
+ *  `dir` as in @ref fsl_file_open_at_internal(), if `name` exists.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @remark windows has no mode bits to copy, only a read-only attribute, and a read-only
+ *  target can't be replaced anyway.
+ */
+void fsl_file_mode_copy_at_internal(const fsl_dir_handle *dir, const str *name, int fd);
+
+/*!
+ *  @internal
+ *
+ *  @brief flush the data of `fd` to disk.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param wait if `FALSE`, only start writing back and return (linux: `sync_file_range()`,
+ *  windows: nothing), else return once it's on disk (linux: `fdatasync()`, windows:
+ *  `FlushFileBuffers()`).
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+u32 fsl_file_flush_internal(int fd, b8 wait);
+
+/*!
+ *  @internal
+ *
+ *  @brief atomically replace `dst` with `src`, both relative to `dir` as in
+ *  @ref fsl_file_open_at_internal().
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  linux: `renameat()`, windows: `MoveFileExA()` writing through.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+u32 fsl_file_rename_at_internal(const fsl_dir_handle *dir, const str *src, const str *dst);
+
+/*!
+ *  @internal
+ *
+ *  @brief remove file `name`, relative to `dir` as in @ref fsl_file_open_at_internal().
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+u32 fsl_file_remove_at_internal(const fsl_dir_handle *dir, const str *name);
+
+/*!
+ *  @internal
+ *
+ *  @brief flush directory `name`, relative to `dir` as in @ref fsl_file_open_at_internal(),
+ *  making renames into it durable.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @remark windows can't flush directories, renames write through instead.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+u32 fsl_dir_sync_at_internal(const fsl_dir_handle *dir, const str *name);
+
+/*!
+ *  @internal
+ *
+ *  @brief remove temp files left in `dir` by atomic writes that never committed
+ *  (e.g. a crash mid-save), keep those pending in the open write batch.
+ *
+ *  @remark only names of the form `<name>.<serial>.fsltmp` are touched.
+ *  @remark called from @ref fsl_dir_handle_open() with @ref FSL_FLAG_DIR_HANDLE_SWEEP_TEMP.
+ */
+void fsl_write_temp_sweep_internal(const fsl_dir_handle *dir);
+
 /*!
  *  @brief append @ref FSL_SLASH_NATIVE onto `path` if `path` not ending in
  *  @ref FSL_SLASH_NATIVE, null (`\n`) terminated.
@@ -0,0 +1,150 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file io.h
+ *
+ *  @brief asynchronous file reads and writes.
+ *
+ *  requests are submitted to a queue and served by io_uring where the kernel
+ *  supports it, or by a small pool of worker threads using `pread()`/`pwrite()`
+ *  otherwise, completions are collected with @ref fsl_io_poll(), which
+ *  @ref fsl_engine_running() calls once per frame.
+ *
+ *  ordering:
+ *      - requests may complete in any order, independent requests are not ordered
+ *        against each other, not even two writes to the same file.
+ *      - callbacks run on the thread calling @ref fsl_io_poll(), in the order
+ *        their completions were reaped.
+ *      - a request's `buf` must stay valid until its completion is polled.
+ *
+ *  @remark @ref fsl_io_submit() and @ref fsl_io_poll() must be called from the same thread.
+ */
+
+#ifndef FSL_IO_H
+#define FSL_IO_H
+
+#include "../common/api.h"
+#include "../common/types.h"
+
+/*!
+ *  @brief default submission queue depth for @ref fsl_io_init().
+ */
+#define FSL_IO_QUEUE_DEPTH 256
+
+/*!
+ *  @brief largest transfer a single request may ask for, in bytes.
+ */
+#define FSL_IO_REQUEST_SIZE_MAX (1024 * 1024 * 1024)
+
+typedef struct fsl_io_request fsl_io_request;
+
+/*!
+ *  @brief called from @ref fsl_io_poll() when `request` completes, check `request->state`.
+ */
+typedef void (*fsl_io_callback)(fsl_io_request *request);
+
+enum fsl_io_op
+{
+    FSL_IO_OP_READ = 1,
+    FSL_IO_OP_WRITE
+}; /* fsl_io_op */
+
+enum fsl_io_state
+{
+    FSL_IO_STATE_IDLE = 0,
+    FSL_IO_STATE_PENDING,
+    FSL_IO_STATE_DONE,
+    FSL_IO_STATE_FAILED
+}; /* fsl_io_state */
+
+enum fsl_io_backend
+{
+    FSL_IO_BACKEND_NONE = 0,
+    FSL_IO_BACKEND_URING,   /* linux io_uring */
+    FSL_IO_BACKEND_THREADS, /* worker threads, `pread()`/`pwrite()` */
+    FSL_IO_BACKEND_SYNC     /* served inside @ref fsl_io_submit() */
+}; /* fsl_io_backend */
+
+/*!
+ *  @remark owned by the caller, fill `op` to `user` and submit, the rest is
+ *  written by the service.
+ */
+struct fsl_io_request
+{
+    u32 op;                     /* enum @ref fsl_io_op */
+    int fd;                     /* open file descriptor, owned by the caller */
+    void *buf;                  /* read destination or write source, owned by the caller */
+    u64 size;                   /* bytes to transfer, up to @ref FSL_IO_REQUEST_SIZE_MAX */
+    u64 offset;                 /* file offset */
+    fsl_io_callback callback;   /* optional */
+    void *user;                 /* optional, caller data */
+
+    u32 state;                  /* enum @ref fsl_io_state, only changes in @ref fsl_io_submit() and @ref fsl_io_poll() */
+    u64 result;                 /* bytes transferred, short reads mean end of file */
+    i32 error;                  /* `errno` value if `state` is @ref FSL_IO_STATE_FAILED */
+    fsl_io_request *next;       /* internal queue link */
+}; /* fsl_io_request */
+
+/*!
+ *  @brief initialize the I/O service, try io_uring then fall back to worker threads.
+ *
+ *  @param queue_depth submission queue depth, 0 for @ref FSL_IO_QUEUE_DEPTH,
+ *  requests beyond it are held back until slots free up.
+ *
+ *  @remark called from @ref fsl_engine_init(), does nothing if already initialized.
+ *  @remark environment variable `FSL_IO_BACKEND` set to `threads` or `sync` forces that backend.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_io_init(u32 queue_depth);
+
+/*!
+ *  @brief wait for all in-flight requests, run their callbacks and shut the service down.
+ *
+ *  @remark called from @ref fsl_engine_close().
+ */
+FSLAPI void fsl_io_free(void);
+
+/*!
+ *  @brief queue `request`, set its state to @ref FSL_IO_STATE_PENDING.
+ *
+ *  @remark `request` must not be pending already.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_io_submit(fsl_io_request *request);
+
+/*!
+ *  @brief reap completed requests, update their state and run their callbacks.
+ *
+ *  @param wait if `TRUE` and requests are in flight, block until at least one completes.
+ *
+ *  @return number of requests completed.
+ */
+FSLAPI u64 fsl_io_poll(b8 wait);
+
+/*!
+ *  @return number of submitted requests not yet reaped by @ref fsl_io_poll().
+ */
+FSLAPI u64 fsl_io_in_flight(void);
+
+/*!
+ *  @return enum @ref fsl_io_backend in use.
+ */
+FSLAPI u32 fsl_io_get_backend(void);
+
+#endif /* FSL_IO_H */
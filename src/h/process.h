@@ -17,15 +17,54 @@
 /*!
  *  @file process.h
  *
- *  @brief execute commands externally, identify current process, fork.
+ *  @brief execute commands externally, identify current process, spawn.
  */
 
 #ifndef FSL_PROCESS_H
 #define FSL_PROCESS_H
 
 #include "../common/api.h"
+#include "../common/limits.h"
 #include "../common/types.h"
 
+/*!
+ *  @brief initial capacity of @ref fsl_process.out, doubled as needed.
+ */
+#define FSL_PROCESS_OUT_CAP_MIN 4096
+
+enum fsl_spawn_flag
+{
+    FSL_FLAG_SPAWN_CAPTURE_STDOUT = 0x0001, /* collect child's stdout into @ref fsl_process.out */
+    FSL_FLAG_SPAWN_CAPTURE_STDERR = 0x0002  /* collect child's stderr into @ref fsl_process.out, interleaved with stdout if both */
+}; /* fsl_spawn_flag */
+
+enum fsl_process_state
+{
+    FSL_PROCESS_STATE_IDLE = 0,
+    FSL_PROCESS_STATE_RUNNING,
+    FSL_PROCESS_STATE_DONE
+}; /* fsl_process_state */
+
+typedef struct fsl_process fsl_process;
+
+/*!
+ *  @brief a child process started with @ref fsl_spawn().
+ */
+struct fsl_process
+{
+    i64 pid;
+    void *handle;               /* windows: process handle */
+    int fd_out;                 /* read end of the capture pipe, -1 if not capturing or drained */
+    void *pipe_out;             /* windows: read end of the capture pipe */
+    str *out;                   /* captured output, null terminated, `NULL` if nothing was captured */
+    u64 out_len;
+    u64 out_cap;
+    u32 state;                  /* enum @ref fsl_process_state */
+    i32 exit_code;              /* valid once done, exit status, or signal number if killed */
+    u32 result;                 /* valid once done, @ref FSL_ERR_SUCCESS if exited with 0 */
+    str name[FSL_ID_CAP];       /* for logging */
+}; /* fsl_process */
+
 /*!
  *  @brief get current path of binary/executable, slash (`/`) and null (`\0`) terminated,
  *  assign allocated path string (of size @ref FSL_PATH_CAP) to `dst`.
@@ -45,14 +84,52 @@ FSLAPI u32 fsl_get_path_bin_root(str **dst);
 u32 fsl_get_path_bin_root_internal(str *dst);
 
 /*!
- *  @brief execute command in a separate child process (use @ref execvp() internally).
+ *  @brief execute command in a separate child process and wait for it.
  *  implemented in `platform_<PLATFORM>.c`.
  *
- *  @param cmd command and args to execute.
+ *  @param cmd command and args to execute, `NULL` terminated.
  *  @param cmd_name command name (for logging).
  *
+ *  @remark same as @ref fsl_spawn() followed by a waiting @ref fsl_process_poll().
+ *
  *  @return non-zero on failure and @ref fsl_err is set accordingly.
  */
 FSLAPI u32 fsl_exec(fsl_buf *cmd, str *cmd_name);
 
+/*!
+ *  @brief start command in a separate child process without waiting for it.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param x process to fill, overwritten.
+ *  @param cmd command and args to execute, `NULL` terminated, only read during the call.
+ *  @param cmd_name command name (for logging).
+ *  @param flags enum @ref fsl_spawn_flag.
+ *
+ *  @remark linux: uses `posix_spawnp()`, which doesn't copy the parent's page tables
+ *  like `fork()` does, so spawning stays cheap with large arenas mapped.
+ *  @remark must be reaped with @ref fsl_process_poll() or @ref fsl_process_free().
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_spawn(fsl_process *x, fsl_buf *cmd, const str *cmd_name, u32 flags);
+
+/*!
+ *  @brief collect captured output and check whether `x` has exited.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param wait if `TRUE`, block until `x` exits.
+ *
+ *  @remark once done, `x->result` and `x->exit_code` hold the outcome and @ref fsl_err
+ *  is set to `x->result`.
+ *
+ *  @return `TRUE` if `x` is done.
+ */
+FSLAPI b8 fsl_process_poll(fsl_process *x, b8 wait);
+
+/*!
+ *  @brief wait for `x` if still running, release its output and zero it out.
+ *  implemented in `platform_<PLATFORM>.c`.
+ */
+FSLAPI void fsl_process_free(fsl_process *x);
+
 #endif /* FSL_PROCESS_H */
@@ -0,0 +1,686 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file io.c
+ *
+ *  @brief asynchronous file reads and writes.
+ */
+
+#include "common/diagnostics.h"
+#include "common/limits.h"
+#include "logger/logger.h"
+#include "logger/logger_messages_internal.h"
+
+#include "h/io.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(FSL_PLATFORM_LINUX)
+#   include <pthread.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <linux/io_uring.h>
+#endif /* FSL_PLATFORM */
+
+#define IO_THREADS_MAX 4
+
+static struct io_internal
+{
+    u32 backend;        /* enum @ref fsl_io_backend */
+    u64 in_flight;      /* submitted, not yet polled */
+
+    /* completed, not yet polled (backend: sync, threads) */
+    fsl_io_request *done_head;
+    fsl_io_request *done_tail;
+
+#if defined(FSL_PLATFORM_LINUX)
+    struct /* io_uring */
+    {
+        int fd;
+        void *sq_ptr;
+        u64 sq_size;
+        void *cq_ptr;
+        u64 cq_size;
+        struct io_uring_sqe *sqes;
+        u64 sqes_size;
+
+        u32 *sq_head;
+        u32 *sq_tail;
+        u32 *sq_mask;
+        u32 *sq_array;
+        u32 sq_entries;
+        u32 *cq_head;
+        u32 *cq_tail;
+        u32 *cq_mask;
+        struct io_uring_cqe *cqes;
+        u32 cq_entries;
+
+        u32 to_submit;  /* queued sqes not yet passed to the kernel */
+        u32 in_ring;    /* queued or in kernel, bounded by `cq_entries` so completions can't overflow */
+
+        /* waiting for a free submission slot */
+        fsl_io_request *held_head;
+        fsl_io_request *held_tail;
+    } uring;
+
+    struct /* worker threads */
+    {
+        pthread_t thread[IO_THREADS_MAX];
+        u32 count;
+        pthread_mutex_t lock;       /* guards `work_*`, `quit` and the `done_*` list above */
+        pthread_cond_t cond_work;
+        pthread_cond_t cond_done;
+        fsl_io_request *work_head;
+        fsl_io_request *work_tail;
+        b8 quit;
+    } threads;
+#endif /* FSL_PLATFORM */
+} io_internal;
+
+/*!
+ *  @internal
+ *
+ *  @brief append `request` to the intrusive list `head`/`tail`.
+ */
+static void queue_push_internal(fsl_io_request **head, fsl_io_request **tail, fsl_io_request *request);
+
+/*!
+ *  @internal
+ *
+ *  @brief serve `request` with blocking `pread()`/`pwrite()` calls, set `result` and `error`.
+ */
+static void transfer_internal(fsl_io_request *request);
+
+#if defined(FSL_PLATFORM_LINUX)
+
+/*!
+ *  @internal
+ *
+ *  @brief set up an io_uring instance and probe for `IORING_OP_READ`/`IORING_OP_WRITE`.
+ *
+ *  @return non-zero on failure.
+ */
+static u32 uring_init_internal(u32 queue_depth);
+
+static void uring_free_internal(void);
+
+/*!
+ *  @internal
+ *
+ *  @brief fill a submission queue entry for `request`.
+ *
+ *  @return `FALSE` if the ring has no room.
+ */
+static b8 uring_push_internal(fsl_io_request *request);
+
+/*!
+ *  @internal
+ *
+ *  @brief pass queued entries to the kernel and optionally wait for `min_complete` completions.
+ *
+ *  @remark on a hard error, queued requests fail through @ref uring_fail_queued_internal().
+ */
+static void uring_enter_internal(u32 min_complete);
+
+/*!
+ *  @internal
+ *
+ *  @brief take back entries not yet passed to the kernel and held requests, fail them
+ *  with `error` and move them onto `io_internal.done_*`.
+ */
+static void uring_fail_queued_internal(i32 error);
+
+/*!
+ *  @internal
+ *
+ *  @brief move completion queue entries onto `io_internal.done_*`.
+ */
+static void uring_reap_internal(void);
+
+static u32 threads_init_internal(void);
+static void threads_free_internal(void);
+static void *threads_worker_internal(void *arg);
+
+#endif /* FSL_PLATFORM */
+
+u32 fsl_io_init(u32 queue_depth)
+{
+    const str *backend = getenv("FSL_IO_BACKEND");
+
+    if (io_internal.backend)
+        return FSL_ERR_SUCCESS;
+
+    if (!queue_depth)
+        queue_depth = FSL_IO_QUEUE_DEPTH;
+
+    if (backend && !strcmp(backend, "sync"))
+    {
+        io_internal.backend = FSL_IO_BACKEND_SYNC;
+        goto done;
+    }
+
+#if defined(FSL_PLATFORM_LINUX)
+    if ((!backend || strcmp(backend, "threads")) &&
+            uring_init_internal(queue_depth) == FSL_ERR_SUCCESS)
+    {
+        io_internal.backend = FSL_IO_BACKEND_URING;
+        goto done;
+    }
+
+    if (threads_init_internal() == FSL_ERR_SUCCESS)
+    {
+        io_internal.backend = FSL_IO_BACKEND_THREADS;
+        goto done;
+    }
+
+    LOGERROR(FSL_ERR_IO_INIT_FAIL, 0,
+            MSG_ACTION_REASON_ERROR("Initialize I/O Service", "`pthread_create()` Failed"));
+    return fsl_err;
+#else
+    io_internal.backend = FSL_IO_BACKEND_SYNC;
+#endif /* FSL_PLATFORM */
+
+done:
+
+    LOGTRACE(0,
+            MSG_IO_INIT(io_internal.backend == FSL_IO_BACKEND_URING ? "io_uring" :
+                io_internal.backend == FSL_IO_BACKEND_THREADS ? "Worker Threads" : "Synchronous"));
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+void fsl_io_free(void)
+{
+    if (!io_internal.backend)
+        return;
+
+    while (io_internal.in_flight)
+        fsl_io_poll(TRUE);
+
+#if defined(FSL_PLATFORM_LINUX)
+    if (io_internal.backend == FSL_IO_BACKEND_URING)
+        uring_free_internal();
+    else if (io_internal.backend == FSL_IO_BACKEND_THREADS)
+        threads_free_internal();
+#endif /* FSL_PLATFORM */
+
+    memset(&io_internal, 0, sizeof(io_internal));
+}
+
+u32 fsl_io_submit(fsl_io_request *request)
+{
+    if (!request || (!request->buf && request->size))
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Submit I/O Request"));
+        return fsl_err;
+    }
+
+    if (request->size > FSL_IO_REQUEST_SIZE_MAX)
+    {
+        LOGERROR(FSL_ERR_SIZE_LIMIT, 0,
+                MSG_ACTION_REASON_ERROR("Submit I/O Request", "Size Limit Exceeded"));
+        return fsl_err;
+    }
+
+    if (!io_internal.backend && fsl_io_init(0) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    request->state = FSL_IO_STATE_PENDING;
+    request->result = 0;
+    request->error = 0;
+    request->next = NULL;
+    ++io_internal.in_flight;
+
+    switch (io_internal.backend)
+    {
+#if defined(FSL_PLATFORM_LINUX)
+        case FSL_IO_BACKEND_URING:
+            if (io_internal.uring.held_head || !uring_push_internal(request))
+                queue_push_internal(&io_internal.uring.held_head, &io_internal.uring.held_tail, request);
+            else
+                uring_enter_internal(0);
+            break;
+
+        case FSL_IO_BACKEND_THREADS:
+            pthread_mutex_lock(&io_internal.threads.lock);
+            queue_push_internal(&io_internal.threads.work_head, &io_internal.threads.work_tail, request);
+            pthread_cond_signal(&io_internal.threads.cond_work);
+            pthread_mutex_unlock(&io_internal.threads.lock);
+            break;
+#endif /* FSL_PLATFORM */
+
+        default:
+            transfer_internal(request);
+            queue_push_internal(&io_internal.done_head, &io_internal.done_tail, request);
+    }
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+u64 fsl_io_poll(b8 wait)
+{
+    fsl_io_request *done = NULL;
+    fsl_io_request *next = NULL;
+    u64 count = 0;
+
+    if (!io_internal.in_flight)
+        return 0;
+
+    switch (io_internal.backend)
+    {
+#if defined(FSL_PLATFORM_LINUX)
+        case FSL_IO_BACKEND_URING:
+            uring_reap_internal();
+            if (wait && !io_internal.done_head)
+            {
+                uring_enter_internal(1);
+                uring_reap_internal();
+            }
+
+            /* reaping freed up ring slots */
+            while (io_internal.uring.held_head && uring_push_internal(io_internal.uring.held_head))
+            {
+                next = io_internal.uring.held_head->next;
+                io_internal.uring.held_head->next = NULL;
+                io_internal.uring.held_head = next;
+            }
+            if (!io_internal.uring.held_head)
+                io_internal.uring.held_tail = NULL;
+            uring_enter_internal(0);
+
+            done = io_internal.done_head;
+            io_internal.done_head = NULL;
+            io_internal.done_tail = NULL;
+            break;
+
+        case FSL_IO_BACKEND_THREADS:
+            pthread_mutex_lock(&io_internal.threads.lock);
+            while (wait && !io_internal.done_head)
+                pthread_cond_wait(&io_internal.threads.cond_done, &io_internal.threads.lock);
+            done = io_internal.done_head;
+            io_internal.done_head = NULL;
+            io_internal.done_tail = NULL;
+            pthread_mutex_unlock(&io_internal.threads.lock);
+            break;
+#endif /* FSL_PLATFORM */
+
+        default:
+            done = io_internal.done_head;
+            io_internal.done_head = NULL;
+            io_internal.done_tail = NULL;
+    }
+
+    /* callbacks may submit new requests, so the lists are detached first */
+    for (; done; done = next, ++count)
+    {
+        next = done->next;
+        done->next = NULL;
+        done->state = done->error ? FSL_IO_STATE_FAILED : FSL_IO_STATE_DONE;
+        --io_internal.in_flight;
+        if (done->callback)
+            done->callback(done);
+    }
+
+    return count;
+}
+
+u64 fsl_io_in_flight(void)
+{
+    return io_internal.in_flight;
+}
+
+u32 fsl_io_get_backend(void)
+{
+    return io_internal.backend;
+}
+
+static void queue_push_internal(fsl_io_request **head, fsl_io_request **tail, fsl_io_request *request)
+{
+    request->next = NULL;
+    if (*tail)
+        (*tail)->next = request;
+    else
+        *head = request;
+    *tail = request;
+}
+
+static void transfer_internal(fsl_io_request *request)
+{
+    u8 *buf = request->buf;
+    i64 len = 0;
+
+    while (request->result < request->size)
+    {
+#if defined(FSL_PLATFORM_LINUX)
+        if (request->op == FSL_IO_OP_READ)
+            len = pread(request->fd, buf + request->result,
+                    request->size - request->result, request->offset + request->result);
+        else
+            len = pwrite(request->fd, buf + request->result,
+                    request->size - request->result, request->offset + request->result);
+#else
+        if (lseek(request->fd, request->offset + request->result, SEEK_SET) < 0)
+            len = -1;
+        else if (request->op == FSL_IO_OP_READ)
+            len = read(request->fd, buf + request->result, request->size - request->result);
+        else
+            len = write(request->fd, buf + request->result, request->size - request->result);
+#endif /* FSL_PLATFORM */
+
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            request->error = errno;
+            return;
+        }
+
+        if (len == 0)
+            return;
+
+        request->result += len;
+    }
+}
+
+#if defined(FSL_PLATFORM_LINUX)
+
+/* ---- section: io_uring --------------------------------------------------- */
+
+static u32 uring_init_internal(u32 queue_depth)
+{
+    struct io_uring_params params;
+    u64 probe_buf[(sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op)) / sizeof(u64) + 1];
+    struct io_uring_probe *probe = (struct io_uring_probe*)probe_buf;
+    int fd = -1;
+
+    memset(&params, 0, sizeof(params));
+    memset(probe_buf, 0, sizeof(probe_buf));
+
+    fd = (int)syscall(__NR_io_uring_setup, queue_depth, &params);
+    if (fd < 0)
+    {
+        LOGTRACE(0,
+                MSG_IO_FALLBACK("`io_uring_setup()` Failed"));
+        return FSL_ERR_IO_INIT_FAIL;
+    }
+
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+            probe->last_op < IORING_OP_WRITE ||
+            !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) ||
+            !(probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED))
+    {
+        LOGTRACE(0,
+                MSG_IO_FALLBACK("`IORING_OP_READ`/`IORING_OP_WRITE` Unsupported"));
+        close(fd);
+        return FSL_ERR_IO_INIT_FAIL;
+    }
+
+    io_internal.uring.fd = fd;
+    io_internal.uring.sq_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    io_internal.uring.cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    io_internal.uring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (io_internal.uring.cq_size > io_internal.uring.sq_size)
+            io_internal.uring.sq_size = io_internal.uring.cq_size;
+        io_internal.uring.cq_size = io_internal.uring.sq_size;
+    }
+
+    io_internal.uring.sq_ptr = mmap(NULL, io_internal.uring.sq_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (io_internal.uring.sq_ptr == MAP_FAILED)
+        goto cleanup;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        io_internal.uring.cq_ptr = io_internal.uring.sq_ptr;
+    else
+    {
+        io_internal.uring.cq_ptr = mmap(NULL, io_internal.uring.cq_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (io_internal.uring.cq_ptr == MAP_FAILED)
+            goto cleanup;
+    }
+
+    io_internal.uring.sqes = mmap(NULL, io_internal.uring.sqes_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (io_internal.uring.sqes == MAP_FAILED)
+        goto cleanup;
+
+    io_internal.uring.sq_head = (u32*)((u8*)io_internal.uring.sq_ptr + params.sq_off.head);
+    io_internal.uring.sq_tail = (u32*)((u8*)io_internal.uring.sq_ptr + params.sq_off.tail);
+    io_internal.uring.sq_mask = (u32*)((u8*)io_internal.uring.sq_ptr + params.sq_off.ring_mask);
+    io_internal.uring.sq_array = (u32*)((u8*)io_internal.uring.sq_ptr + params.sq_off.array);
+    io_internal.uring.sq_entries = params.sq_entries;
+    io_internal.uring.cq_head = (u32*)((u8*)io_internal.uring.cq_ptr + params.cq_off.head);
+    io_internal.uring.cq_tail = (u32*)((u8*)io_internal.uring.cq_ptr + params.cq_off.tail);
+    io_internal.uring.cq_mask = (u32*)((u8*)io_internal.uring.cq_ptr + params.cq_off.ring_mask);
+    io_internal.uring.cqes = (struct io_uring_cqe*)((u8*)io_internal.uring.cq_ptr + params.cq_off.cqes);
+    io_internal.uring.cq_entries = params.cq_entries;
+
+    return FSL_ERR_SUCCESS;
+
+cleanup:
+
+    LOGTRACE(0,
+            MSG_IO_FALLBACK("`mmap()` of io_uring Rings Failed"));
+    uring_free_internal();
+    return FSL_ERR_IO_INIT_FAIL;
+}
+
+static void uring_free_internal(void)
+{
+    if (io_internal.uring.sqes && io_internal.uring.sqes != MAP_FAILED)
+        munmap(io_internal.uring.sqes, io_internal.uring.sqes_size);
+    if (io_internal.uring.cq_ptr && io_internal.uring.cq_ptr != MAP_FAILED &&
+            io_internal.uring.cq_ptr != io_internal.uring.sq_ptr)
+        munmap(io_internal.uring.cq_ptr, io_internal.uring.cq_size);
+    if (io_internal.uring.sq_ptr && io_internal.uring.sq_ptr != MAP_FAILED)
+        munmap(io_internal.uring.sq_ptr, io_internal.uring.sq_size);
+    close(io_internal.uring.fd);
+    memset(&io_internal.uring, 0, sizeof(io_internal.uring));
+}
+
+static b8 uring_push_internal(fsl_io_request *request)
+{
+    struct io_uring_sqe *sqe = NULL;
+    u32 tail = *io_internal.uring.sq_tail;
+    u32 head = __atomic_load_n(io_internal.uring.sq_head, __ATOMIC_ACQUIRE);
+    u32 index = 0;
+
+    if (tail - head >= io_internal.uring.sq_entries ||
+            io_internal.uring.in_ring >= io_internal.uring.cq_entries)
+        return FALSE;
+
+    index = tail & *io_internal.uring.sq_mask;
+    sqe = &io_internal.uring.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = request->op == FSL_IO_OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = request->fd;
+    sqe->addr = (u64)((u8*)request->buf + request->result);
+    sqe->len = (u32)(request->size - request->result);
+    sqe->off = request->offset + request->result;
+    sqe->user_data = (u64)request;
+
+    io_internal.uring.sq_array[index] = index;
+    __atomic_store_n(io_internal.uring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++io_internal.uring.to_submit;
+    ++io_internal.uring.in_ring;
+    return TRUE;
+}
+
+static void uring_enter_internal(u32 min_complete)
+{
+    long result = 0;
+
+    if (!io_internal.uring.to_submit && !min_complete)
+        return;
+
+    do
+    {
+        result = syscall(__NR_io_uring_enter, io_internal.uring.fd,
+                io_internal.uring.to_submit, min_complete,
+                min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    }
+    while (result < 0 && errno == EINTR);
+
+    /* on `EAGAIN`/`EBUSY` the entries stay queued and are retried next call */
+    if (result > 0)
+        io_internal.uring.to_submit -= (u32)result;
+    else if (result < 0 && errno != EAGAIN && errno != EBUSY)
+        uring_fail_queued_internal(errno);
+}
+
+static void uring_fail_queued_internal(i32 error)
+{
+    fsl_io_request *request = NULL;
+    u32 tail = *io_internal.uring.sq_tail;
+
+    /* the kernel hasn't consumed the last `to_submit` entries, take them back */
+    for (; io_internal.uring.to_submit; --io_internal.uring.to_submit, --io_internal.uring.in_ring)
+    {
+        --tail;
+        request = (fsl_io_request*)io_internal.uring.sqes[tail & *io_internal.uring.sq_mask].user_data;
+        request->error = error;
+        queue_push_internal(&io_internal.done_head, &io_internal.done_tail, request);
+    }
+    __atomic_store_n(io_internal.uring.sq_tail, tail, __ATOMIC_RELEASE);
+
+    while ((request = io_internal.uring.held_head))
+    {
+        io_internal.uring.held_head = request->next;
+        request->error = error;
+        queue_push_internal(&io_internal.done_head, &io_internal.done_tail, request);
+    }
+    io_internal.uring.held_tail = NULL;
+}
+
+static void uring_reap_internal(void)
+{
+    struct io_uring_cqe *cqe = NULL;
+    fsl_io_request *request = NULL;
+    u32 head = *io_internal.uring.cq_head;
+    u32 tail = __atomic_load_n(io_internal.uring.cq_tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head)
+    {
+        cqe = &io_internal.uring.cqes[head & *io_internal.uring.cq_mask];
+        request = (fsl_io_request*)cqe->user_data;
+        --io_internal.uring.in_ring;
+        if (cqe->res < 0)
+            request->error = -cqe->res;
+        else
+        {
+            request->result += (u64)cqe->res;
+
+            /* short transfer, not end of file: queue the rest, as `transfer_internal()` loops */
+            if (cqe->res > 0 && request->result < request->size)
+            {
+                if (io_internal.uring.held_head || !uring_push_internal(request))
+                    queue_push_internal(&io_internal.uring.held_head, &io_internal.uring.held_tail, request);
+                continue;
+            }
+        }
+        queue_push_internal(&io_internal.done_head, &io_internal.done_tail, request);
+    }
+
+    __atomic_store_n(io_internal.uring.cq_head, head, __ATOMIC_RELEASE);
+}
+
+/* ---- section: worker threads --------------------------------------------- */
+
+static u32 threads_init_internal(void)
+{
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    u32 count = cpu_count > 1 ? (u32)cpu_count : 1;
+
+    if (count > IO_THREADS_MAX)
+        count = IO_THREADS_MAX;
+
+    pthread_mutex_init(&io_internal.threads.lock, NULL);
+    pthread_cond_init(&io_internal.threads.cond_work, NULL);
+    pthread_cond_init(&io_internal.threads.cond_done, NULL);
+
+    for (io_internal.threads.count = 0; io_internal.threads.count < count; ++io_internal.threads.count)
+        if (pthread_create(&io_internal.threads.thread[io_internal.threads.count], NULL,
+                    threads_worker_internal, NULL) != 0)
+            break;
+
+    if (!io_internal.threads.count)
+    {
+        threads_free_internal();
+        return FSL_ERR_IO_INIT_FAIL;
+    }
+
+    return FSL_ERR_SUCCESS;
+}
+
+static void threads_free_internal(void)
+{
+    u32 i = 0;
+
+    pthread_mutex_lock(&io_internal.threads.lock);
+    io_internal.threads.quit = TRUE;
+    pthread_cond_broadcast(&io_internal.threads.cond_work);
+    pthread_mutex_unlock(&io_internal.threads.lock);
+
+    for (i = 0; i < io_internal.threads.count; ++i)
+        pthread_join(io_internal.threads.thread[i], NULL);
+
+    pthread_cond_destroy(&io_internal.threads.cond_done);
+    pthread_cond_destroy(&io_internal.threads.cond_work);
+    pthread_mutex_destroy(&io_internal.threads.lock);
+}
+
+static void *threads_worker_internal(void *arg)
+{
+    fsl_io_request *request = NULL;
+    (void)arg;
+
+    pthread_mutex_lock(&io_internal.threads.lock);
+    for (;;)
+    {
+        while (!io_internal.threads.work_head && !io_internal.threads.quit)
+            pthread_cond_wait(&io_internal.threads.cond_work, &io_internal.threads.lock);
+
+        if (!io_internal.threads.work_head)
+            break;
+
+        request = io_internal.threads.work_head;
+        io_internal.threads.work_head = request->next;
+        if (!io_internal.threads.work_head)
+            io_internal.threads.work_tail = NULL;
+        pthread_mutex_unlock(&io_internal.threads.lock);
+
+        transfer_internal(request);
+
+        pthread_mutex_lock(&io_internal.threads.lock);
+        queue_push_internal(&io_internal.done_head, &io_internal.done_tail, request);
+        pthread_cond_signal(&io_internal.threads.cond_done);
+    }
+    pthread_mutex_unlock(&io_internal.threads.lock);
+
+    return NULL;
+}
+
+#endif /* FSL_PLATFORM */
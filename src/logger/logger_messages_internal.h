@@ -75,14 +75,27 @@
 #define MSG_IS_NOT_DIR(name)                                fsl_logger_stringf("'%s' is Not a Directory\n", name)
 #define MSG_FILE_OPEN_FAIL(name)                            MSG_ACTION_SUBJECT_ERROR("Open File", name)
 #define MSG_FILE_COPY_FAIL(name_in, name_out)               fsl_logger_stringf("Failed to Copy File '%s' -> '%s', `fopen()` Failed\n", name_in, name_out)
+#define MSG_FILE_COPY_REASON_FAIL(name_in, name_out, reason) fsl_logger_stringf("Failed to Copy File '%s' -> '%s', %s\n", name_in, name_out, reason)
+#define MSG_FILE_COPY_FALLBACK(name_in, name_out, reason)   fsl_logger_stringf("File Copy '%s' -> '%s' Falling Back, %s\n", name_in, name_out, reason)
 #define MSG_FILE_COPY(name_in, name_out)                    fsl_logger_stringf("File Copied '%s' -> '%s'\n", name_in, name_out)
+#define MSG_IO_INIT(backend)                                fsl_logger_stringf("I/O Service Initialized, Backend: %s\n", backend)
+#define MSG_IO_FALLBACK(reason)                             fsl_logger_stringf("I/O Service Falling Back to Worker Threads, %s\n", reason)
+#define MSG_CPU_INIT(level)                                 fsl_logger_stringf("CPU Kernels Initialized, Level: %s\n", level)
+#define MSG_CPU_LEVEL_UNKNOWN(level)                        fsl_logger_stringf("CPU Level '%s' Unknown, Ignoring\n", level)
 #define MSG_FILE_WRITE_FAIL(name)                           MSG_ACTION_SUBJECT_ERROR("Write File", name)
 #define MSG_FILE_WRITE(name)                                fsl_logger_stringf("File Written '%s'\n", name)
 #define MSG_FILE_APPEND_FAIL(name)                          MSG_ACTION_SUBJECT_ERROR("Append File", name)
 #define MSG_FILE_APPEND(name)                               fsl_logger_stringf("File Appended '%s'\n", name)
+#define MSG_FILE_WRITE_REASON_FAIL(name, reason)            MSG_ACTION_SUBJECT_REASON_ERROR("Write File", name, reason)
+#define MSG_DIR_SYNC_FAIL(name)                             MSG_ACTION_SUBJECT_ERROR("Sync Directory", name)
+#define MSG_FILE_TEMP_REMOVE(name)                          fsl_logger_stringf("Stale Temp File Removed '%s'\n", name)
+#define MSG_DIR_WATCH_FALLBACK(name)                        fsl_logger_stringf("Directory Watch Unavailable '%s', Falling Back to `fstat()`\n", name)
 #define MSG_FILE_PERMISSION_COPY_FAIL(name_in, name_out)    fsl_logger_stringf("Failed to Copy File Permissions '%s' -> '%s', `fsl_stat()` Failed\n", name_in, name_out)
 #define MSG_FILE_SYMLINK_COPY_FAIL(name_in, name_out)       fsl_logger_stringf("Failed to Copy Symlink '%s' -> '%s'\n", name_in, name_out)
 #define MSG_FILE_SYMLINK_COPY(name_in, name_out)            fsl_logger_stringf("Symlink Copied '%s' -> '%s'\n", name_in, name_out)
+#define MSG_FILE_MAP_REASON_FAIL(name, reason)              MSG_ACTION_SUBJECT_REASON_ERROR("Map File", name, reason)
+#define MSG_FILE_MAP(name, address, size)                   fsl_logger_stringf("File Mapped '%s'[%p][%"PRIu64"B]\n", name, address, size)
+#define MSG_FILE_UNMAP(address, size)                       fsl_logger_stringf("File Unmapped [%p][%"PRIu64"B]\n", address, size)
 #define MSG_DIR_CREATE(name)                                fsl_logger_stringf("Directory Created '%s'\n", name)
 #define MSG_DIR_CREATE_FAIL(name)                           MSG_ACTION_SUBJECT_ERROR("Create Directory", name)
 #define MSG_DIR_CHANGE(name)                                fsl_logger_stringf("Working Directory Changed to '%s'\n", name)
@@ -100,6 +113,7 @@
 #define MSG_MEM_REALLOC(name, address_old, address_new, size) fsl_logger_stringf("Memory Reallocated %s[%p -> %p][%"PRIu64"B]\n", name, address_old, address_new, size)
 #define MSG_MEM_MAP_REASON_FAIL(name, address, size, reason) fsl_logger_stringf("Failed to Map Memory %s[%p][%"PRIu64"B], %s\n", name, address, size, reason)
 #define MSG_MEM_MAP(name, address, size)                    fsl_logger_stringf("Memory Mapped %s[%p][%"PRIu64"B]\n", name, address, size)
+#define MSG_MEM_MAP_FALLBACK(name, size, reason)            fsl_logger_stringf("Memory Map %s[%"PRIu64"B] Falling Back to Regular Pages, %s\n", name, size, reason)
 #define MSG_MEM_COMMIT_REASON_FAIL(name, address_base, address_committed, size, reason) fsl_logger_stringf("Failed to Commit Memory %s[base: %p][commit: %p][%"PRIu64"B], %s\n", name, address_base, address_committed, size, reason)
 #define MSG_MEM_COMMIT(name, address_base, address_committed, size) fsl_logger_stringf("Memory Committed %s[base: %p][commit: %p][%"PRIu64"B]\n", name, address_base, address_committed, size)
 #define MSG_MEM_REMAP_REASON_FAIL(name, address, size, reason) fsl_logger_stringf("Failed to Remap Memory %s[%p][%"PRIu64"B], %s\n", name, address, size, reason)
@@ -20,13 +20,10 @@
  *  @brief math stuff.
  */
 
-#include "../common/config.h"
 #include "../common/diagnostics.h"
-#include "../common/limits.h"
+#include "../h/cpu.h"
 #include "../memory/memory.h"
 
-#include "../h/dir.h"
-
 #include "math.h"
 #include "math_implementation.h"
 #include "math_internal.h"
@@ -42,46 +39,18 @@ f32 *fsl_rand_tab = NULL;
 
 u32 noise_init_internal(void)
 {
-    str path[FSL_PATH_CAP] = {0};
-    f32 *file_contents = NULL;
-    u64 file_len = 0;
     u32 i = 0;
 
     if (fsl_mem_map((void*)&fsl_rand_tab, FSL_RAND_TAB_VOLUME * sizeof(f32),
                 "noise_init_internal().fsl_rand_tab") != FSL_ERR_SUCCESS)
-        goto cleanup;
-
-    snprintf(path, FSL_PATH_CAP, "%s%s", FSL_DIR_NAME_LOOKUPS, FSL_FILE_NAME_LOOKUP_RAND_TAB);
-
-    if (fsl_is_file_exists(path, FALSE) == FSL_ERR_SUCCESS)
-    {
-        file_len = fsl_get_file_contents(path, (void*)&file_contents, FALSE);
-        if (fsl_err != FSL_ERR_SUCCESS || file_contents == NULL)
-            goto cleanup;
+        return fsl_err;
 
-        for (i = 0; i < FSL_RAND_TAB_VOLUME; ++i)
-            fsl_rand_tab[i] = file_contents[i];
-
-        fsl_mem_free((void*)&file_contents, file_len,
-                "noise_init_internal().file_contents");
-    }
-    else
-    {
-        for (i = 0; i < FSL_RAND_TAB_VOLUME; ++i)
-            fsl_rand_tab[i] = sin((f64)(fsl_rand_u64(i) % 360));
-
-        if (fsl_write_file(path, FSL_RAND_TAB_VOLUME * sizeof(f32),
-                    fsl_rand_tab, TRUE, FALSE) != FSL_ERR_SUCCESS)
-            goto cleanup;
-    }
+    /* 360 distinct values, built in place, cheaper than reading a cached copy from disk */
+    for (i = 0; i < FSL_RAND_TAB_VOLUME; ++i)
+        fsl_rand_tab[i] = sin((f64)(fsl_rand_u64(i) % 360));
 
     fsl_err = FSL_ERR_SUCCESS;
     return fsl_err;
-
-cleanup:
-
-    noise_free_internal();
-    return fsl_err;
 }
 
 void noise_free_internal(void)
@@ -504,6 +473,31 @@ m2f64 fsl_outer_m2f64(v2f64 a, v2f64 b) OUTER_PRODUCT_M2_FUNC_IMPL(m2f64)
 m3f64 fsl_outer_m3f64(v3f64 a, v3f64 b) OUTER_PRODUCT_M3_FUNC_IMPL(m3f64)
 m4f64 fsl_outer_m4f64(v4f64 a, v4f64 b) OUTER_PRODUCT_M4_FUNC_IMPL(m4f64)
 
+void fsl_multiply_m4f32_ptr(const m4f32 *a, const m4f32 *b, m4f32 *dst)
+{
+    fsl_kernels.multiply_m4f32(a, b, dst);
+}
+
+void fsl_multiply_vector_m4f32_batch(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n)
+{
+    fsl_kernels.transform_v4f32(m, src, dst, n);
+}
+
+void fsl_transpose_m4f32_ptr(const m4f32 *m, m4f32 *dst)
+{
+    fsl_kernels.transpose_m4f32(m, dst);
+}
+
+f32 fsl_inverse_m4f32_ptr(const m4f32 *m, m4f32 *dst)
+{
+    return fsl_kernels.inverse_m4f32(m, dst);
+}
+
+void fsl_multiply_m4f64_ptr(const m4f64 *a, const m4f64 *b, m4f64 *dst) MULTIPLY_M4_PTR_FUNC_IMPL(f64)
+void fsl_multiply_vector_m4f64_batch(const m4f64 *m, const v4f64 *src, v4f64 *dst, u64 n) MULTIPLY_VECTOR_M4_BATCH_FUNC_IMPL(v4f64)
+void fsl_transpose_m4f64_ptr(const m4f64 *m, m4f64 *dst) TRANSPOSE_M4_PTR_FUNC_IMPL(f64)
+f64 fsl_inverse_m4f64_ptr(const m4f64 *m, m4f64 *dst) INVERSE_M4_PTR_FUNC_IMPL(f64)
+
 /* ---- section: trigonometry ----------------------------------------------- */
 
 angle_f32 fsl_angle_f32(f32 n)
@@ -526,6 +520,11 @@ angle_f64 fsl_angle_f64(f64 n)
     return angle;
 }
 
+void fsl_sincos_f32_batch(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n)
+{
+    fsl_kernels.sincos_f32(x, dst_sin, dst_cos, n);
+}
+
 /* ---- section: random ----------------------------------------------------- */
 
 #pragma GCC diagnostic push
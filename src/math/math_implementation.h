@@ -676,4 +676,105 @@
     return m; \
 }
 
+/* pointer variants, inputs are read whole before `dst` is written */
+
+#define MULTIPLY_M4_PTR_FUNC_IMPL(type) \
+{ \
+    const type *pa = &a->a11; \
+    const type *pb = &b->a11; \
+    type m[16]; \
+    u32 i = 0, j = 0; \
+ \
+    for (i = 0; i < 4; ++i) \
+        for (j = 0; j < 4; ++j) \
+            m[i * 4 + j] = \
+                pa[i * 4 + 0] * pb[0 * 4 + j] + \
+                pa[i * 4 + 1] * pb[1 * 4 + j] + \
+                pa[i * 4 + 2] * pb[2 * 4 + j] + \
+                pa[i * 4 + 3] * pb[3 * 4 + j]; \
+ \
+    for (i = 0; i < 16; ++i) \
+        (&dst->a11)[i] = m[i]; \
+}
+
+#define MULTIPLY_VECTOR_M4_BATCH_FUNC_IMPL(vtype) \
+{ \
+    vtype v = {0}; \
+    u64 i = 0; \
+ \
+    for (i = 0; i < n; ++i) \
+    { \
+        v = src[i]; \
+        dst[i].x = m->a11 * v.x + m->a12 * v.y + m->a13 * v.z + m->a14 * v.w; \
+        dst[i].y = m->a21 * v.x + m->a22 * v.y + m->a23 * v.z + m->a24 * v.w; \
+        dst[i].z = m->a31 * v.x + m->a32 * v.y + m->a33 * v.z + m->a34 * v.w; \
+        dst[i].w = m->a41 * v.x + m->a42 * v.y + m->a43 * v.z + m->a44 * v.w; \
+    } \
+}
+
+#define TRANSPOSE_M4_PTR_FUNC_IMPL(type) \
+{ \
+    const type *p = &m->a11; \
+    type t[16]; \
+    u32 i = 0, j = 0; \
+ \
+    for (i = 0; i < 4; ++i) \
+        for (j = 0; j < 4; ++j) \
+            t[j * 4 + i] = p[i * 4 + j]; \
+ \
+    for (i = 0; i < 16; ++i) \
+        (&dst->a11)[i] = t[i]; \
+}
+
+#define INVERSE_M4_PTR_FUNC_IMPL(type) \
+{ \
+    const type *p = &m->a11; \
+    type t[16]; \
+    type det = 0; \
+    u32 i = 0; \
+ \
+    /* cofactors, transposed into the adjugate as they're written */ \
+    t[0] = p[5] * p[10] * p[15] - p[5] * p[11] * p[14] - p[9] * p[6] * p[15] + \
+        p[9] * p[7] * p[14] + p[13] * p[6] * p[11] - p[13] * p[7] * p[10]; \
+    t[4] = -p[4] * p[10] * p[15] + p[4] * p[11] * p[14] + p[8] * p[6] * p[15] - \
+        p[8] * p[7] * p[14] - p[12] * p[6] * p[11] + p[12] * p[7] * p[10]; \
+    t[8] = p[4] * p[9] * p[15] - p[4] * p[11] * p[13] - p[8] * p[5] * p[15] + \
+        p[8] * p[7] * p[13] + p[12] * p[5] * p[11] - p[12] * p[7] * p[9]; \
+    t[12] = -p[4] * p[9] * p[14] + p[4] * p[10] * p[13] + p[8] * p[5] * p[14] - \
+        p[8] * p[6] * p[13] - p[12] * p[5] * p[10] + p[12] * p[6] * p[9]; \
+    t[1] = -p[1] * p[10] * p[15] + p[1] * p[11] * p[14] + p[9] * p[2] * p[15] - \
+        p[9] * p[3] * p[14] - p[13] * p[2] * p[11] + p[13] * p[3] * p[10]; \
+    t[5] = p[0] * p[10] * p[15] - p[0] * p[11] * p[14] - p[8] * p[2] * p[15] + \
+        p[8] * p[3] * p[14] + p[12] * p[2] * p[11] - p[12] * p[3] * p[10]; \
+    t[9] = -p[0] * p[9] * p[15] + p[0] * p[11] * p[13] + p[8] * p[1] * p[15] - \
+        p[8] * p[3] * p[13] - p[12] * p[1] * p[11] + p[12] * p[3] * p[9]; \
+    t[13] = p[0] * p[9] * p[14] - p[0] * p[10] * p[13] - p[8] * p[1] * p[14] + \
+        p[8] * p[2] * p[13] + p[12] * p[1] * p[10] - p[12] * p[2] * p[9]; \
+    t[2] = p[1] * p[6] * p[15] - p[1] * p[7] * p[14] - p[5] * p[2] * p[15] + \
+        p[5] * p[3] * p[14] + p[13] * p[2] * p[7] - p[13] * p[3] * p[6]; \
+    t[6] = -p[0] * p[6] * p[15] + p[0] * p[7] * p[14] + p[4] * p[2] * p[15] - \
+        p[4] * p[3] * p[14] - p[12] * p[2] * p[7] + p[12] * p[3] * p[6]; \
+    t[10] = p[0] * p[5] * p[15] - p[0] * p[7] * p[13] - p[4] * p[1] * p[15] + \
+        p[4] * p[3] * p[13] + p[12] * p[1] * p[7] - p[12] * p[3] * p[5]; \
+    t[14] = -p[0] * p[5] * p[14] + p[0] * p[6] * p[13] + p[4] * p[1] * p[14] - \
+        p[4] * p[2] * p[13] - p[12] * p[1] * p[6] + p[12] * p[2] * p[5]; \
+    t[3] = -p[1] * p[6] * p[11] + p[1] * p[7] * p[10] + p[5] * p[2] * p[11] - \
+        p[5] * p[3] * p[10] - p[9] * p[2] * p[7] + p[9] * p[3] * p[6]; \
+    t[7] = p[0] * p[6] * p[11] - p[0] * p[7] * p[10] - p[4] * p[2] * p[11] + \
+        p[4] * p[3] * p[10] + p[8] * p[2] * p[7] - p[8] * p[3] * p[6]; \
+    t[11] = -p[0] * p[5] * p[11] + p[0] * p[7] * p[9] + p[4] * p[1] * p[11] - \
+        p[4] * p[3] * p[9] - p[8] * p[1] * p[7] + p[8] * p[3] * p[5]; \
+    t[15] = p[0] * p[5] * p[10] - p[0] * p[6] * p[9] - p[4] * p[1] * p[10] + \
+        p[4] * p[2] * p[9] + p[8] * p[1] * p[6] - p[8] * p[2] * p[5]; \
+ \
+    det = p[0] * t[0] + p[1] * t[4] + p[2] * t[8] + p[3] * t[12]; \
+    if (det == 0) \
+        return det; \
+ \
+    for (i = 0; i < 16; ++i) \
+        (&dst->a11)[i] = t[i] / det; \
+ \
+    return det; \
+}
+
 #endif /* FSL_MATH_IMPLEMENTATION_H */
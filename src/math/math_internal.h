@@ -28,10 +28,7 @@
 /*!
  *  @internal
  *
- *  @brief initialize and allocate resources for @ref fsl_rand_tab.
- *
- *  allocate resources for @ref fsl_rand_tab and load its look-up from disk if found
- *  and build if not found.
+ *  @brief allocate and build @ref fsl_rand_tab, no file I/O.
  *
  *  @return non-zero on failure and @ref fsl_err is set accordingly.
  */
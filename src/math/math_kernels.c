@@ -0,0 +1,452 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file math_kernels.c
+ *
+ *  @brief math kernels per @ref fsl_cpu_level.
+ *
+ *  each SIMD kernel is compiled for its own instruction set with a `target`
+ *  attribute, so this file builds with baseline flags and nothing above the
+ *  baseline runs unless @ref fsl_cpu_init() picked it.
+ *
+ *  matrices are row-major (`a11, a12, a13, a14, a21, ...`), all kernels load
+ *  their inputs before storing, so outputs may alias inputs.
+ */
+
+#include "math_implementation.h"
+#include "math_kernels_internal.h"
+
+/*!
+ *  @brief sin/cos approximation shared by all levels, cephes' `sinf`/`cosf`
+ *  polynomials on [-pi/4, pi/4] after reducing by multiples of pi/4 (in three
+ *  parts for SIMD), within 2 ulp of libm for |x| < 8192.
+ */
+#define SINCOS_FOPI     1.27323954473516f   /* 4 / pi */
+#define SINCOS_PIO4     0.78539816339744830962
+#define SINCOS_DP1      0.78515625f
+#define SINCOS_DP2      2.4187564849853515625e-4f
+#define SINCOS_DP3      3.77489497744594108e-8f
+#define SINCOS_S0       -1.9515295891e-4f
+#define SINCOS_S1       8.3321608736e-3f
+#define SINCOS_S2       -1.6666654611e-1f
+#define SINCOS_C0       2.443315711809948e-5f
+#define SINCOS_C1       -1.388731625493765e-3f
+#define SINCOS_C2       4.166664568298827e-2f
+#define SINCOS_LANES    8
+
+/* ---- section: scalar ----------------------------------------------------- */
+
+void multiply_m4f32_scalar_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst) MULTIPLY_M4_PTR_FUNC_IMPL(f32)
+void transform_v4f32_scalar_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n) MULTIPLY_VECTOR_M4_BATCH_FUNC_IMPL(v4f32)
+void transpose_m4f32_scalar_internal(const m4f32 *m, m4f32 *dst) TRANSPOSE_M4_PTR_FUNC_IMPL(f32)
+f32 inverse_m4f32_scalar_internal(const m4f32 *m, m4f32 *dst) INVERSE_M4_PTR_FUNC_IMPL(f32)
+
+void sincos_f32_scalar_internal(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n)
+{
+    f32 a = 0.0f, z = 0.0f, ps = 0.0f, pc = 0.0f, sn = 0.0f, cs = 0.0f;
+    u32 j = 0;
+    u64 i = 0;
+
+    for (i = 0; i < n; ++i)
+    {
+        a = x[i] < 0.0f ? -x[i] : x[i];
+
+        /* octant, rounded up to even so the remainder lands in [-pi/4, pi/4],
+         * reduced in f64 since -Ofast would fold the three-part f32 reduction */
+        j = ((u32)(a * SINCOS_FOPI) + 1) & ~1u;
+        a = (f32)((f64)a - (f64)j * SINCOS_PIO4);
+
+        z = a * a;
+        ps = ((SINCOS_S0 * z + SINCOS_S1) * z + SINCOS_S2) * z * a + a;
+        pc = ((SINCOS_C0 * z + SINCOS_C1) * z + SINCOS_C2) * z * z - 0.5f * z + 1.0f;
+
+        sn = (j & 2) ? pc : ps;
+        cs = (j & 2) ? ps : pc;
+        if (((j & 4) != 0) != (x[i] < 0.0f))
+            sn = -sn;
+        if (!((j - 2) & 4))
+            cs = -cs;
+
+        dst_sin[i] = sn;
+        dst_cos[i] = cs;
+    }
+}
+
+#if defined(FSL_KERNELS_X86)
+
+/* ---- section: sse4.1 ----------------------------------------------------- */
+
+KERNEL_SSE41
+void multiply_m4f32_sse41_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst)
+{
+    const f32 *pa = &a->a11;
+    const f32 *pb = &b->a11;
+    __m128 b0 = _mm_loadu_ps(pb + 0);
+    __m128 b1 = _mm_loadu_ps(pb + 4);
+    __m128 b2 = _mm_loadu_ps(pb + 8);
+    __m128 b3 = _mm_loadu_ps(pb + 12);
+    __m128 r[4];
+    u32 i = 0;
+
+    /* row i of `dst` is row i of `a` weighing the rows of `b` */
+    for (i = 0; i < 4; ++i)
+        r[i] = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(pa[i * 4 + 0]), b0),
+                    _mm_mul_ps(_mm_set1_ps(pa[i * 4 + 1]), b1)),
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(pa[i * 4 + 2]), b2),
+                    _mm_mul_ps(_mm_set1_ps(pa[i * 4 + 3]), b3)));
+
+    for (i = 0; i < 4; ++i)
+        _mm_storeu_ps(&dst->a11 + i * 4, r[i]);
+}
+
+KERNEL_SSE41
+void transform_v4f32_sse41_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n)
+{
+    __m128 c0 = _mm_loadu_ps(&m->a11);
+    __m128 c1 = _mm_loadu_ps(&m->a21);
+    __m128 c2 = _mm_loadu_ps(&m->a31);
+    __m128 c3 = _mm_loadu_ps(&m->a41);
+    __m128 v, t;
+    u64 i = 0;
+
+    /* columns, so each vector is a sum of columns weighed by its components */
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    for (i = 0; i < n; ++i)
+    {
+        v = _mm_loadu_ps(&src[i].x);
+        t = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00)),
+                    _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55))),
+                _mm_add_ps(
+                    _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xaa)),
+                    _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xff))));
+        _mm_storeu_ps(&dst[i].x, t);
+    }
+}
+
+KERNEL_SSE41
+void transpose_m4f32_sse41_internal(const m4f32 *m, m4f32 *dst)
+{
+    __m128 r0 = _mm_loadu_ps(&m->a11);
+    __m128 r1 = _mm_loadu_ps(&m->a21);
+    __m128 r2 = _mm_loadu_ps(&m->a31);
+    __m128 r3 = _mm_loadu_ps(&m->a41);
+
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(&dst->a11, r0);
+    _mm_storeu_ps(&dst->a21, r1);
+    _mm_storeu_ps(&dst->a31, r2);
+    _mm_storeu_ps(&dst->a41, r3);
+}
+
+/*!
+ *  @brief 2x2 matrices packed `(a11, a12, a21, a22)` in one register, for the
+ *  block inverse below, `#` is the adjugate.
+ */
+#define SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, (x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define SWIZZLE(a, x, y, z, w) SHUFFLE(a, a, x, y, z, w)
+
+/* `a` * `b` */
+#define M2_MUL(a, b) _mm_add_ps(_mm_mul_ps(a, SWIZZLE(b, 0, 3, 0, 3)), \
+        _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)))
+
+/* `a#` * `b` */
+#define M2_ADJ_MUL(a, b) _mm_sub_ps(_mm_mul_ps(SWIZZLE(a, 3, 3, 0, 0), b), \
+        _mm_mul_ps(SWIZZLE(a, 1, 1, 2, 2), SWIZZLE(b, 2, 3, 0, 1)))
+
+/* `a` * `b#` */
+#define M2_MUL_ADJ(a, b) _mm_sub_ps(_mm_mul_ps(a, SWIZZLE(b, 3, 0, 3, 0)), \
+        _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)))
+
+KERNEL_SSE41
+f32 inverse_m4f32_sse41_internal(const m4f32 *m, m4f32 *dst)
+{
+    __m128 r0 = _mm_loadu_ps(&m->a11);
+    __m128 r1 = _mm_loadu_ps(&m->a21);
+    __m128 r2 = _mm_loadu_ps(&m->a31);
+    __m128 r3 = _mm_loadu_ps(&m->a41);
+    __m128 A, B, C, D, det_sub, det_a, det_b, det_c, det_d, det, tr;
+    __m128 ab, dc, x, y, z, w;
+    f32 d = 0.0f;
+
+    /* `m` as blocks | A B |, inverse is 1 / |m| * | X# Y# |#
+     *               | C D |                      | Z# W# | */
+    A = _mm_movelh_ps(r0, r1);
+    B = _mm_movehl_ps(r1, r0);
+    C = _mm_movelh_ps(r2, r3);
+    D = _mm_movehl_ps(r3, r2);
+
+    /* (|A|, |B|, |C|, |D|) */
+    det_sub = _mm_sub_ps(
+            _mm_mul_ps(SHUFFLE(r0, r2, 0, 2, 0, 2), SHUFFLE(r1, r3, 1, 3, 1, 3)),
+            _mm_mul_ps(SHUFFLE(r0, r2, 1, 3, 1, 3), SHUFFLE(r1, r3, 0, 2, 0, 2)));
+    det_a = SWIZZLE(det_sub, 0, 0, 0, 0);
+    det_b = SWIZZLE(det_sub, 1, 1, 1, 1);
+    det_c = SWIZZLE(det_sub, 2, 2, 2, 2);
+    det_d = SWIZZLE(det_sub, 3, 3, 3, 3);
+
+    dc = M2_ADJ_MUL(D, C);
+    ab = M2_ADJ_MUL(A, B);
+    x = _mm_sub_ps(_mm_mul_ps(det_d, A), M2_MUL(B, dc));
+    w = _mm_sub_ps(_mm_mul_ps(det_a, D), M2_MUL(C, ab));
+    y = _mm_sub_ps(_mm_mul_ps(det_b, C), M2_MUL_ADJ(D, ab));
+    z = _mm_sub_ps(_mm_mul_ps(det_c, B), M2_MUL_ADJ(A, dc));
+
+    /* |m| = |A||D| + |B||C| - tr(A#B D#C) */
+    tr = _mm_mul_ps(ab, SWIZZLE(dc, 0, 2, 1, 3));
+    tr = _mm_hadd_ps(tr, tr);
+    tr = _mm_hadd_ps(tr, tr);
+    det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+
+    d = _mm_cvtss_f32(det);
+    if (d == 0.0f)
+        return d;
+
+    det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, det);
+    y = _mm_mul_ps(y, det);
+    z = _mm_mul_ps(z, det);
+    w = _mm_mul_ps(w, det);
+
+    /* adjugate of each block and back to rows in one shuffle */
+    _mm_storeu_ps(&dst->a11, SHUFFLE(x, y, 3, 1, 3, 1));
+    _mm_storeu_ps(&dst->a21, SHUFFLE(x, y, 2, 0, 2, 0));
+    _mm_storeu_ps(&dst->a31, SHUFFLE(z, w, 3, 1, 3, 1));
+    _mm_storeu_ps(&dst->a41, SHUFFLE(z, w, 2, 0, 2, 0));
+
+    return d;
+}
+
+#undef M2_MUL_ADJ
+#undef M2_ADJ_MUL
+#undef M2_MUL
+#undef SWIZZLE
+#undef SHUFFLE
+
+/* ---- section: avx2 ------------------------------------------------------- */
+
+KERNEL_AVX2
+void multiply_m4f32_avx2_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst)
+{
+    const f32 *pa = &a->a11;
+    const f32 *pb = &b->a11;
+    __m256 a01 = _mm256_loadu_ps(pa);       /* rows 1, 2 */
+    __m256 a23 = _mm256_loadu_ps(pa + 8);   /* rows 3, 4 */
+    __m256 bk;
+    __m256i idx;
+    __m256 r01, r23;
+    u32 k = 0;
+
+    /* two rows per register, lane 0 is the upper row, lane 1 the lower */
+    idx = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+    bk = _mm256_broadcast_ps((const __m128*)pb);
+    r01 = _mm256_mul_ps(_mm256_permutevar8x32_ps(a01, idx), bk);
+    r23 = _mm256_mul_ps(_mm256_permutevar8x32_ps(a23, idx), bk);
+
+    for (k = 1; k < 4; ++k)
+    {
+        idx = _mm256_setr_epi32(k, k, k, k, k + 4, k + 4, k + 4, k + 4);
+        bk = _mm256_broadcast_ps((const __m128*)(pb + k * 4));
+        r01 = _mm256_fmadd_ps(_mm256_permutevar8x32_ps(a01, idx), bk, r01);
+        r23 = _mm256_fmadd_ps(_mm256_permutevar8x32_ps(a23, idx), bk, r23);
+    }
+
+    _mm256_storeu_ps(&dst->a11, r01);
+    _mm256_storeu_ps(&dst->a31, r23);
+}
+
+KERNEL_AVX2
+void transform_v4f32_avx2_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n)
+{
+    __m128 c0 = _mm_loadu_ps(&m->a11);
+    __m128 c1 = _mm_loadu_ps(&m->a21);
+    __m128 c2 = _mm_loadu_ps(&m->a31);
+    __m128 c3 = _mm_loadu_ps(&m->a41);
+    __m256 C0, C1, C2, C3, v, t;
+    __m128 v4, t4;
+    u64 i = 0;
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    C0 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+    C1 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+    C2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+    C3 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+
+    /* two vectors per register, component broadcasts stay within each lane */
+    for (i = 0; i + 2 <= n; i += 2)
+    {
+        v = _mm256_loadu_ps(&src[i].x);
+        t = _mm256_mul_ps(C0, _mm256_permute_ps(v, 0x00));
+        t = _mm256_fmadd_ps(C1, _mm256_permute_ps(v, 0x55), t);
+        t = _mm256_fmadd_ps(C2, _mm256_permute_ps(v, 0xaa), t);
+        t = _mm256_fmadd_ps(C3, _mm256_permute_ps(v, 0xff), t);
+        _mm256_storeu_ps(&dst[i].x, t);
+    }
+
+    if (i < n)
+    {
+        v4 = _mm_loadu_ps(&src[i].x);
+        t4 = _mm_mul_ps(c0, _mm_permute_ps(v4, 0x00));
+        t4 = _mm_fmadd_ps(c1, _mm_permute_ps(v4, 0x55), t4);
+        t4 = _mm_fmadd_ps(c2, _mm_permute_ps(v4, 0xaa), t4);
+        t4 = _mm_fmadd_ps(c3, _mm_permute_ps(v4, 0xff), t4);
+        _mm_storeu_ps(&dst[i].x, t4);
+    }
+}
+
+KERNEL_AVX2
+void sincos_f32_avx2_internal(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n)
+{
+    const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32((i32)0x80000000));
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i four = _mm256_set1_epi32(4);
+    f32 pad[3][SINCOS_LANES];
+    __m256 v, a, y, z, ps, pc, sn, cs, swap, sign_sin, sign_cos;
+    __m256i j;
+    u64 i = 0, k = 0, lanes = 0;
+
+    for (i = 0; i < n; i += SINCOS_LANES)
+    {
+        lanes = n - i < SINCOS_LANES ? n - i : SINCOS_LANES;
+        if (lanes < SINCOS_LANES)
+        {
+            for (k = 0; k < SINCOS_LANES; ++k)
+                pad[0][k] = k < lanes ? x[i + k] : 0.0f;
+            v = _mm256_loadu_ps(pad[0]);
+        }
+        else v = _mm256_loadu_ps(x + i);
+
+        sign_sin = _mm256_and_ps(v, sign_mask);
+        a = _mm256_andnot_ps(sign_mask, v);
+
+        j = _mm256_cvttps_epi32(_mm256_mul_ps(a, _mm256_set1_ps(SINCOS_FOPI)));
+        j = _mm256_andnot_si256(_mm256_set1_epi32(1), _mm256_add_epi32(j, _mm256_set1_epi32(1)));
+        y = _mm256_cvtepi32_ps(j);
+        a = _mm256_fnmadd_ps(y, _mm256_set1_ps(SINCOS_DP1), a);
+        a = _mm256_fnmadd_ps(y, _mm256_set1_ps(SINCOS_DP2), a);
+        a = _mm256_fnmadd_ps(y, _mm256_set1_ps(SINCOS_DP3), a);
+
+        z = _mm256_mul_ps(a, a);
+        ps = _mm256_fmadd_ps(_mm256_set1_ps(SINCOS_S0), z, _mm256_set1_ps(SINCOS_S1));
+        ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(SINCOS_S2));
+        ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, z), a, a);
+        pc = _mm256_fmadd_ps(_mm256_set1_ps(SINCOS_C0), z, _mm256_set1_ps(SINCOS_C1));
+        pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(SINCOS_C2));
+        pc = _mm256_mul_ps(_mm256_mul_ps(pc, z), z);
+        pc = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, pc), _mm256_set1_ps(1.0f));
+
+        /* octants 2 and 6 swap the polynomials, 4 to 7 flip sin, 2 to 5 flip cos */
+        swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, two), two));
+        sn = _mm256_blendv_ps(ps, pc, swap);
+        cs = _mm256_blendv_ps(pc, ps, swap);
+        sign_sin = _mm256_xor_ps(sign_sin,
+                _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, four), 29)));
+        sign_cos = _mm256_castsi256_ps(_mm256_slli_epi32(
+                    _mm256_andnot_si256(_mm256_sub_epi32(j, two), four), 29));
+        sn = _mm256_xor_ps(sn, sign_sin);
+        cs = _mm256_xor_ps(cs, sign_cos);
+
+        if (lanes < SINCOS_LANES)
+        {
+            _mm256_storeu_ps(pad[1], sn);
+            _mm256_storeu_ps(pad[2], cs);
+            for (k = 0; k < lanes; ++k)
+            {
+                dst_sin[i + k] = pad[1][k];
+                dst_cos[i + k] = pad[2][k];
+            }
+        }
+        else
+        {
+            _mm256_storeu_ps(dst_sin + i, sn);
+            _mm256_storeu_ps(dst_cos + i, cs);
+        }
+    }
+}
+
+/* ---- section: avx512 ----------------------------------------------------- */
+
+KERNEL_AVX512
+void multiply_m4f32_avx512_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst)
+{
+    const f32 *pb = &b->a11;
+    __m512 A = _mm512_loadu_ps(&a->a11);
+    __m512 r;
+    __m512i idx;
+    u32 k = 0;
+
+    /* whole matrix in one register, lane i is row i */
+    idx = _mm512_set_epi32(12, 12, 12, 12, 8, 8, 8, 8, 4, 4, 4, 4, 0, 0, 0, 0);
+    r = _mm512_mul_ps(_mm512_permutexvar_ps(idx, A),
+            _mm512_broadcast_f32x4(_mm_loadu_ps(pb)));
+
+    for (k = 1; k < 4; ++k)
+    {
+        idx = _mm512_set_epi32(
+                k + 12, k + 12, k + 12, k + 12, k + 8, k + 8, k + 8, k + 8,
+                k + 4, k + 4, k + 4, k + 4, k, k, k, k);
+        r = _mm512_fmadd_ps(_mm512_permutexvar_ps(idx, A),
+                _mm512_broadcast_f32x4(_mm_loadu_ps(pb + k * 4)), r);
+    }
+
+    _mm512_storeu_ps(&dst->a11, r);
+}
+
+KERNEL_AVX512
+void transform_v4f32_avx512_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n)
+{
+    __m128 c0 = _mm_loadu_ps(&m->a11);
+    __m128 c1 = _mm_loadu_ps(&m->a21);
+    __m128 c2 = _mm_loadu_ps(&m->a31);
+    __m128 c3 = _mm_loadu_ps(&m->a41);
+    __m512 C0, C1, C2, C3, v, t;
+    __mmask16 mask = 0;
+    u64 i = 0;
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    C0 = _mm512_broadcast_f32x4(c0);
+    C1 = _mm512_broadcast_f32x4(c1);
+    C2 = _mm512_broadcast_f32x4(c2);
+    C3 = _mm512_broadcast_f32x4(c3);
+
+    /* four vectors per register, the tail is masked */
+    for (i = 0; i < n; i += 4)
+    {
+        mask = n - i >= 4 ? 0xffff : (__mmask16)((1u << ((n - i) * 4)) - 1);
+        v = _mm512_maskz_loadu_ps(mask, &src[i].x);
+        t = _mm512_mul_ps(C0, _mm512_permute_ps(v, 0x00));
+        t = _mm512_fmadd_ps(C1, _mm512_permute_ps(v, 0x55), t);
+        t = _mm512_fmadd_ps(C2, _mm512_permute_ps(v, 0xaa), t);
+        t = _mm512_fmadd_ps(C3, _mm512_permute_ps(v, 0xff), t);
+        _mm512_mask_storeu_ps(&dst[i].x, mask, t);
+    }
+}
+
+KERNEL_AVX512
+void transpose_m4f32_avx512_internal(const m4f32 *m, m4f32 *dst)
+{
+    __m512i idx = _mm512_set_epi32(15, 11, 7, 3, 14, 10, 6, 2, 13, 9, 5, 1, 12, 8, 4, 0);
+
+    _mm512_storeu_ps(&dst->a11, _mm512_permutexvar_ps(idx, _mm512_loadu_ps(&m->a11)));
+}
+
+#endif /* FSL_KERNELS_X86 */
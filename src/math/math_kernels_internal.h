@@ -0,0 +1,158 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file math_kernels_internal.h
+ *
+ *  @brief per-level math kernels, dispatched through @ref fsl_kernels.
+ */
+
+#ifndef FSL_MATH_KERNELS_INTERNAL_H
+#define FSL_MATH_KERNELS_INTERNAL_H
+
+#include "../common/types.h"
+#include "matrix.h"
+#include "vector.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#   define FSL_KERNELS_X86
+#   include <immintrin.h>
+
+#   define KERNEL_SSE41     __attribute__((target("sse4.1")))
+#   define KERNEL_AVX2      __attribute__((target("avx2,fma")))
+#   define KERNEL_AVX512    __attribute__((target("avx512f")))
+#endif /* FSL_KERNELS_X86 */
+
+/*!
+ *  @internal
+ */
+void multiply_m4f32_scalar_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+void transform_v4f32_scalar_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n);
+
+/*!
+ *  @internal
+ */
+void transpose_m4f32_scalar_internal(const m4f32 *m, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+f32 inverse_m4f32_scalar_internal(const m4f32 *m, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+void sincos_f32_scalar_internal(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n);
+
+/*!
+ *  @internal
+ */
+void perlin_noise_1d_scalar_internal(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @internal
+ */
+void perlin_noise_2d_scalar_internal(const f32 *x, const f32 *y, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @internal
+ */
+void perlin_noise_3d_scalar_internal(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+#if defined(FSL_KERNELS_X86)
+
+/*!
+ *  @internal
+ */
+void multiply_m4f32_sse41_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+void transform_v4f32_sse41_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n);
+
+/*!
+ *  @internal
+ */
+void transpose_m4f32_sse41_internal(const m4f32 *m, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+f32 inverse_m4f32_sse41_internal(const m4f32 *m, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+void multiply_m4f32_avx2_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+void transform_v4f32_avx2_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n);
+
+/*!
+ *  @internal
+ */
+void sincos_f32_avx2_internal(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n);
+
+/*!
+ *  @internal
+ */
+void perlin_noise_1d_avx2_internal(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @internal
+ */
+void perlin_noise_2d_avx2_internal(const f32 *x, const f32 *y, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @internal
+ */
+void perlin_noise_3d_avx2_internal(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @internal
+ */
+void multiply_m4f32_avx512_internal(const m4f32 *a, const m4f32 *b, m4f32 *dst);
+
+/*!
+ *  @internal
+ */
+void transform_v4f32_avx512_internal(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n);
+
+/*!
+ *  @internal
+ */
+void transpose_m4f32_avx512_internal(const m4f32 *m, m4f32 *dst);
+
+#endif /* FSL_KERNELS_X86 */
+
+#endif /* FSL_MATH_KERNELS_INTERNAL_H */
@@ -77,6 +77,19 @@ typedef struct m4f64
         a41, a42, a43, a44;
 } m4f64;
 
+/*!
+ *  @brief @ref m4f32 on a cache line (one AVX-512 register), same layout, so
+ *  pointers convert freely, for matrices the pointer functions stream through.
+ *
+ *  @remark heap arrays need an aligned allocation, @ref fsl_mem_map() is page-aligned.
+ */
+typedef m4f32 FSL_ALIGN(64) m4f32_aligned;
+
+/*!
+ *  @brief @ref m4f64 on a cache line.
+ */
+typedef m4f64 FSL_ALIGN(64) m4f64_aligned;
+
 FSLAPI m2f32 fsl_identity_m2f32(void);
 FSLAPI m3f32 fsl_identity_m3f32(void);
 FSLAPI m4f32 fsl_identity_m4f32(void);
@@ -126,4 +139,40 @@ FSLAPI m2f64 fsl_outer_m2f64(v2f64 a, v2f64 b);
 FSLAPI m3f64 fsl_outer_m3f64(v3f64 a, v3f64 b);
 FSLAPI m4f64 fsl_outer_m4f64(v4f64 a, v4f64 b);
 
+/* ---- pointer variants ---------------------------------------------------- */
+
+/*
+ *  in/out through pointers, nothing is copied by value, `dst` may alias any input.
+ *
+ *  m4f32 variants are dispatched through @ref fsl_kernels and match their by-value
+ *  versions up to floating-point rounding, m4f64 variants are plain C.
+ *
+ *  the vector batches are the full matrix-vector product, unlike the by-value
+ *  @ref fsl_multiply_vector_m4f32(), which scales each row by one component.
+ */
+
+/*!
+ *  @brief `dst` = `a` * `b`.
+ */
+FSLAPI void fsl_multiply_m4f32_ptr(const m4f32 *a, const m4f32 *b, m4f32 *dst);
+FSLAPI void fsl_multiply_m4f64_ptr(const m4f64 *a, const m4f64 *b, m4f64 *dst);
+
+/*!
+ *  @brief `dst[i]` = `m` * `src[i]` for `n` column vectors, e.g. a batch of
+ *  points with `w` = 1.
+ */
+FSLAPI void fsl_multiply_vector_m4f32_batch(const m4f32 *m, const v4f32 *src, v4f32 *dst, u64 n);
+FSLAPI void fsl_multiply_vector_m4f64_batch(const m4f64 *m, const v4f64 *src, v4f64 *dst, u64 n);
+
+FSLAPI void fsl_transpose_m4f32_ptr(const m4f32 *m, m4f32 *dst);
+FSLAPI void fsl_transpose_m4f64_ptr(const m4f64 *m, m4f64 *dst);
+
+/*!
+ *  @brief `dst` = inverse of `m`.
+ *
+ *  @return determinant of `m`, if 0 `m` is singular and `dst` is left unchanged.
+ */
+FSLAPI f32 fsl_inverse_m4f32_ptr(const m4f32 *m, m4f32 *dst);
+FSLAPI f64 fsl_inverse_m4f64_ptr(const m4f64 *m, m4f64 *dst);
+
 #endif /* FSL_MATH_MATRIX_H */
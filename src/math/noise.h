@@ -173,4 +173,46 @@ FSLAPI f32 fsl_perlin_noise_2d_ex(f32 x, f32 y, f32 amplitude, f32 frequency,
 FSLAPI f32 fsl_perlin_noise_3d_ex(f32 x, f32 y, f32 z, f32 amplitude, f32 frequency,
         u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
 
+/*!
+ *  @brief get perlin-noise samples at `n` points, as @ref fsl_perlin_noise_1d_ex().
+ *
+ *  points are evaluated several at a time in SIMD lanes where the cpu allows,
+ *  all octaves of a group of points are summed before moving to the next group.
+ *
+ *  @param x points in 1D space to sample at.
+ *  @param dst results, may alias `x`.
+ *
+ *  @remark dispatched through @ref fsl_kernels, results match @ref fsl_perlin_noise_1d_ex()
+ *  up to floating-point rounding.
+ */
+FSLAPI void fsl_perlin_noise_1d_batch(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @brief get perlin-noise samples at `n` points, as @ref fsl_perlin_noise_2d_ex().
+ *
+ *  @param x x coordinates of points in 2D space to sample at.
+ *  @param y y coordinates of points in 2D space to sample at.
+ *  @param dst results, may alias `x` or `y`.
+ *
+ *  @remark see @ref fsl_perlin_noise_1d_batch().
+ */
+FSLAPI void fsl_perlin_noise_2d_batch(const f32 *x, const f32 *y, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
+/*!
+ *  @brief get perlin-noise samples at `n` points, as @ref fsl_perlin_noise_3d_ex().
+ *
+ *  @param x x coordinates of points in 3D space to sample at.
+ *  @param y y coordinates of points in 3D space to sample at.
+ *  @param z z coordinates of points in 3D space to sample at.
+ *  @param dst results, may alias `x`, `y` or `z`.
+ *
+ *  @remark see @ref fsl_perlin_noise_1d_batch().
+ */
+FSLAPI void fsl_perlin_noise_3d_batch(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed);
+
 #endif /* FSL_MATH_NOISE_H */
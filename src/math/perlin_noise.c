@@ -20,6 +20,9 @@
  *  @brief perlin noise functions and gradient samplers.
  */
 
+#include "../h/cpu.h"
+
+#include "math_kernels_internal.h"
 #include "noise.h"
 #include "vector.h"
 
@@ -46,6 +49,84 @@
 #define RAND_CONST_12 904023
 #define RAND_CONST_13 371769
 
+#if defined(FSL_KERNELS_X86)
+
+/* points per group in the batch kernels */
+#define PERLIN_LANES 8
+
+/*!
+ *  @internal
+ *
+ *  @brief `h * c` for 4 u64 lanes, wrapping like scalar u64 multiplication.
+ */
+KERNEL_AVX2
+static __m256i mul_u64_avx2_internal(__m256i h, u32 c);
+
+/*!
+ *  @internal
+ *
+ *  @brief sign-extend 8 i32 lattice hashes into two halves of 4 u64 lanes,
+ *  then mix them like the scalar gradient functions do (`h ^= h >> 16; h *= c`).
+ */
+KERNEL_AVX2
+static void hash_mix_avx2_internal(__m256i t, u32 c, __m256i *h0, __m256i *h1);
+
+/*!
+ *  @internal
+ *
+ *  @brief gather `fsl_rand_tab[(seed + h) % FSL_RAND_TAB_VOLUME]` for 4 u64 lanes.
+ *
+ *  the 64-bit modulo has no SIMD instruction, FSL_RAND_TAB_VOLUME being `4096 * 27`
+ *  it's split into the low 12 bits and a residue mod 27 built from 26-bit halves
+ *  (`2^26 % 27 = 13`), reduced exactly with a fixed-point reciprocal.
+ */
+KERNEL_AVX2
+static __m128 rand_tab_gather_avx2_internal(__m256i h, __m256i seed);
+
+/*!
+ *  @internal
+ *
+ *  @brief join two halves of 4 lanes into 8 lanes.
+ */
+KERNEL_AVX2
+static __m256 join_avx2_internal(__m128 lo, __m128 hi);
+
+/*!
+ *  @internal
+ *
+ *  @brief quintic fade curve, as in the scalar functions.
+ */
+KERNEL_AVX2
+static __m256 fade_avx2_internal(__m256 d);
+
+/*!
+ *  @internal
+ *
+ *  @brief as @ref fsl_gradient_1d(), `xf` is `x` as float.
+ */
+KERNEL_AVX2
+static __m256 gradient_1d_avx2_internal(__m256 v, __m256i x, __m256 xf, __m256i seed);
+
+/*!
+ *  @internal
+ *
+ *  @brief as @ref fsl_gradient_2d(), `xf`, `yf` are `x`, `y` as floats.
+ */
+KERNEL_AVX2
+static __m256 gradient_2d_avx2_internal(__m256 vx, __m256 vy,
+        __m256i x, __m256i y, __m256 xf, __m256 yf, __m256i seed);
+
+/*!
+ *  @internal
+ *
+ *  @brief as @ref fsl_gradient_3d(), `xf`, `yf`, `zf` are `x`, `y`, `z` as floats.
+ */
+KERNEL_AVX2
+static __m256 gradient_3d_avx2_internal(__m256 vx, __m256 vy, __m256 vz,
+        __m256i x, __m256i y, __m256i z, __m256 xf, __m256 yf, __m256 zf, __m256i seed);
+
+#endif /* FSL_KERNELS_X86 */
+
 f32 fsl_gradient_1d(f32 v, i32 x, u64 seed)
 {
     u64 h = x * RAND_CONST_0;
@@ -205,3 +286,424 @@ f32 fsl_perlin_noise_3d_ex(f32 x, f32 y, f32 z, f32 amplitude, f32 frequency,
     }
     return result;
 }
+
+void fsl_perlin_noise_1d_batch(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    fsl_kernels.perlin_noise_1d(x, dst, n, amplitude, frequency,
+            octaves, amplitude_persistence, frequency_persistence, seed);
+}
+
+void fsl_perlin_noise_2d_batch(const f32 *x, const f32 *y, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    fsl_kernels.perlin_noise_2d(x, y, dst, n, amplitude, frequency,
+            octaves, amplitude_persistence, frequency_persistence, seed);
+}
+
+void fsl_perlin_noise_3d_batch(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    fsl_kernels.perlin_noise_3d(x, y, z, dst, n, amplitude, frequency,
+            octaves, amplitude_persistence, frequency_persistence, seed);
+}
+
+/* ---- section: scalar kernels --------------------------------------------- */
+
+void perlin_noise_1d_scalar_internal(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    u64 i = 0;
+    for (i = 0; i < n; ++i)
+        dst[i] = fsl_perlin_noise_1d_ex(x[i], amplitude, frequency,
+                octaves, amplitude_persistence, frequency_persistence, seed);
+}
+
+void perlin_noise_2d_scalar_internal(const f32 *x, const f32 *y, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    u64 i = 0;
+    for (i = 0; i < n; ++i)
+        dst[i] = fsl_perlin_noise_2d_ex(x[i], y[i], amplitude, frequency,
+                octaves, amplitude_persistence, frequency_persistence, seed);
+}
+
+void perlin_noise_3d_scalar_internal(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    u64 i = 0;
+    for (i = 0; i < n; ++i)
+        dst[i] = fsl_perlin_noise_3d_ex(x[i], y[i], z[i], amplitude, frequency,
+                octaves, amplitude_persistence, frequency_persistence, seed);
+}
+
+#if defined(FSL_KERNELS_X86)
+
+/* ---- section: avx2 kernels ----------------------------------------------- */
+
+/*
+ * each group of PERLIN_LANES points is loaded once and kept in registers for
+ * all octaves, only frequency and amplitude change between octaves; lattice
+ * hashes are bit-exact with the scalar gradient functions, so the same seed
+ * gives the same terrain on every level.
+ */
+
+KERNEL_AVX2
+void perlin_noise_1d_avx2_internal(const f32 *x, f32 *dst, u64 n, f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    const __m256i s = _mm256_set1_epi64x((i64)seed);
+    const __m256i one = _mm256_set1_epi32(1);
+    f32 pad[PERLIN_LANES];
+    __m256 px, v, a, b, d, g0, g1, result;
+    __m256i ai, bi;
+    f32 amp = 0.0f, freq = 0.0f;
+    u64 i = 0, j = 0, lanes = 0;
+    u32 o = 0;
+
+    for (i = 0; i < n; i += PERLIN_LANES)
+    {
+        lanes = n - i < PERLIN_LANES ? n - i : PERLIN_LANES;
+        if (lanes < PERLIN_LANES)
+        {
+            for (j = 0; j < PERLIN_LANES; ++j)
+                pad[j] = j < lanes ? x[i + j] : 0.0f;
+            px = _mm256_loadu_ps(pad);
+        }
+        else px = _mm256_loadu_ps(x + i);
+
+        result = _mm256_setzero_ps();
+        amp = amplitude;
+        freq = frequency;
+        for (o = 0; o < octaves; ++o)
+        {
+            v = _mm256_mul_ps(px, _mm256_set1_ps(freq));
+            ai = _mm256_cvttps_epi32(_mm256_floor_ps(v));
+            bi = _mm256_add_epi32(ai, one);
+            a = _mm256_cvtepi32_ps(ai);
+            b = _mm256_cvtepi32_ps(bi);
+            d = fade_avx2_internal(_mm256_sub_ps(v, a));
+
+            g0 = gradient_1d_avx2_internal(v, ai, a, s);
+            g1 = gradient_1d_avx2_internal(v, bi, b, s);
+
+            result = _mm256_add_ps(result, _mm256_mul_ps(
+                        _mm256_add_ps(g0, _mm256_mul_ps(_mm256_sub_ps(g1, g0), d)),
+                        _mm256_set1_ps(amp)));
+            amp *= amplitude_persistence;
+            freq *= frequency_persistence;
+        }
+
+        if (lanes < PERLIN_LANES)
+        {
+            _mm256_storeu_ps(pad, result);
+            for (j = 0; j < lanes; ++j)
+                dst[i + j] = pad[j];
+        }
+        else _mm256_storeu_ps(dst + i, result);
+    }
+}
+
+KERNEL_AVX2
+void perlin_noise_2d_avx2_internal(const f32 *x, const f32 *y, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    const __m256i s = _mm256_set1_epi64x((i64)seed);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 unit = _mm256_set1_ps(1.0f);
+    f32 pad[2][PERLIN_LANES];
+    __m256 px, py, vx, vy, ax, ay, bx, by, dx, dy, wx, wy, g[4], sum, result;
+    __m256i axi, ayi, bxi, byi;
+    f32 amp = 0.0f, freq = 0.0f;
+    u64 i = 0, j = 0, lanes = 0;
+    u32 o = 0;
+
+    for (i = 0; i < n; i += PERLIN_LANES)
+    {
+        lanes = n - i < PERLIN_LANES ? n - i : PERLIN_LANES;
+        if (lanes < PERLIN_LANES)
+        {
+            for (j = 0; j < PERLIN_LANES; ++j)
+            {
+                pad[0][j] = j < lanes ? x[i + j] : 0.0f;
+                pad[1][j] = j < lanes ? y[i + j] : 0.0f;
+            }
+            px = _mm256_loadu_ps(pad[0]);
+            py = _mm256_loadu_ps(pad[1]);
+        }
+        else
+        {
+            px = _mm256_loadu_ps(x + i);
+            py = _mm256_loadu_ps(y + i);
+        }
+
+        result = _mm256_setzero_ps();
+        amp = amplitude;
+        freq = frequency;
+        for (o = 0; o < octaves; ++o)
+        {
+            vx = _mm256_mul_ps(px, _mm256_set1_ps(freq));
+            vy = _mm256_mul_ps(py, _mm256_set1_ps(freq));
+            axi = _mm256_cvttps_epi32(_mm256_floor_ps(vx));
+            ayi = _mm256_cvttps_epi32(_mm256_floor_ps(vy));
+            bxi = _mm256_add_epi32(axi, one);
+            byi = _mm256_add_epi32(ayi, one);
+            ax = _mm256_cvtepi32_ps(axi);
+            ay = _mm256_cvtepi32_ps(ayi);
+            bx = _mm256_cvtepi32_ps(bxi);
+            by = _mm256_cvtepi32_ps(byi);
+            dx = fade_avx2_internal(_mm256_sub_ps(vx, ax));
+            dy = fade_avx2_internal(_mm256_sub_ps(vy, ay));
+            wx = _mm256_sub_ps(unit, dx);
+            wy = _mm256_sub_ps(unit, dy);
+
+            g[0] = gradient_2d_avx2_internal(vx, vy, axi, ayi, ax, ay, s);
+            g[1] = gradient_2d_avx2_internal(vx, vy, bxi, ayi, bx, ay, s);
+            g[2] = gradient_2d_avx2_internal(vx, vy, axi, byi, ax, by, s);
+            g[3] = gradient_2d_avx2_internal(vx, vy, bxi, byi, bx, by, s);
+
+            sum = _mm256_mul_ps(_mm256_mul_ps(g[0], wx), wy);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(g[1], dx), wy));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(g[2], wx), dy));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(g[3], dx), dy));
+            result = _mm256_add_ps(result, _mm256_mul_ps(sum, _mm256_set1_ps(amp)));
+            amp *= amplitude_persistence;
+            freq *= frequency_persistence;
+        }
+
+        if (lanes < PERLIN_LANES)
+        {
+            _mm256_storeu_ps(pad[0], result);
+            for (j = 0; j < lanes; ++j)
+                dst[i + j] = pad[0][j];
+        }
+        else _mm256_storeu_ps(dst + i, result);
+    }
+}
+
+KERNEL_AVX2
+void perlin_noise_3d_avx2_internal(const f32 *x, const f32 *y, const f32 *z, f32 *dst, u64 n,
+        f32 amplitude, f32 frequency,
+        u32 octaves, f32 amplitude_persistence, f32 frequency_persistence, u64 seed)
+{
+    const __m256i s = _mm256_set1_epi64x((i64)seed);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 unit = _mm256_set1_ps(1.0f);
+    f32 pad[3][PERLIN_LANES];
+    __m256 px, py, pz, vx, vy, vz, ax, ay, az, bx, by, bz, dx, dy, dz, wx, wy, wz;
+    __m256 g[8], sum, result;
+    __m256i axi, ayi, azi, bxi, byi, bzi;
+    f32 amp = 0.0f, freq = 0.0f;
+    u64 i = 0, j = 0, lanes = 0;
+    u32 o = 0;
+
+    for (i = 0; i < n; i += PERLIN_LANES)
+    {
+        lanes = n - i < PERLIN_LANES ? n - i : PERLIN_LANES;
+        if (lanes < PERLIN_LANES)
+        {
+            for (j = 0; j < PERLIN_LANES; ++j)
+            {
+                pad[0][j] = j < lanes ? x[i + j] : 0.0f;
+                pad[1][j] = j < lanes ? y[i + j] : 0.0f;
+                pad[2][j] = j < lanes ? z[i + j] : 0.0f;
+            }
+            px = _mm256_loadu_ps(pad[0]);
+            py = _mm256_loadu_ps(pad[1]);
+            pz = _mm256_loadu_ps(pad[2]);
+        }
+        else
+        {
+            px = _mm256_loadu_ps(x + i);
+            py = _mm256_loadu_ps(y + i);
+            pz = _mm256_loadu_ps(z + i);
+        }
+
+        result = _mm256_setzero_ps();
+        amp = amplitude;
+        freq = frequency;
+        for (o = 0; o < octaves; ++o)
+        {
+            vx = _mm256_mul_ps(px, _mm256_set1_ps(freq));
+            vy = _mm256_mul_ps(py, _mm256_set1_ps(freq));
+            vz = _mm256_mul_ps(pz, _mm256_set1_ps(freq));
+            axi = _mm256_cvttps_epi32(_mm256_floor_ps(vx));
+            ayi = _mm256_cvttps_epi32(_mm256_floor_ps(vy));
+            azi = _mm256_cvttps_epi32(_mm256_floor_ps(vz));
+            bxi = _mm256_add_epi32(axi, one);
+            byi = _mm256_add_epi32(ayi, one);
+            bzi = _mm256_add_epi32(azi, one);
+            ax = _mm256_cvtepi32_ps(axi);
+            ay = _mm256_cvtepi32_ps(ayi);
+            az = _mm256_cvtepi32_ps(azi);
+            bx = _mm256_cvtepi32_ps(bxi);
+            by = _mm256_cvtepi32_ps(byi);
+            bz = _mm256_cvtepi32_ps(bzi);
+            dx = fade_avx2_internal(_mm256_sub_ps(vx, ax));
+            dy = fade_avx2_internal(_mm256_sub_ps(vy, ay));
+            dz = fade_avx2_internal(_mm256_sub_ps(vz, az));
+            wx = _mm256_sub_ps(unit, dx);
+            wy = _mm256_sub_ps(unit, dy);
+            wz = _mm256_sub_ps(unit, dz);
+
+            g[0] = gradient_3d_avx2_internal(vx, vy, vz, axi, ayi, azi, ax, ay, az, s);
+            g[1] = gradient_3d_avx2_internal(vx, vy, vz, bxi, ayi, azi, bx, ay, az, s);
+            g[2] = gradient_3d_avx2_internal(vx, vy, vz, axi, byi, azi, ax, by, az, s);
+            g[3] = gradient_3d_avx2_internal(vx, vy, vz, bxi, byi, azi, bx, by, az, s);
+            g[4] = gradient_3d_avx2_internal(vx, vy, vz, axi, ayi, bzi, ax, ay, bz, s);
+            g[5] = gradient_3d_avx2_internal(vx, vy, vz, bxi, ayi, bzi, bx, ay, bz, s);
+            g[6] = gradient_3d_avx2_internal(vx, vy, vz, axi, byi, bzi, ax, by, bz, s);
+            g[7] = gradient_3d_avx2_internal(vx, vy, vz, bxi, byi, bzi, bx, by, bz, s);
+
+            sum = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[0], wx), wy), wz);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[1], dx), wy), wz));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[2], wx), dy), wz));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[3], dx), dy), wz));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[4], wx), wy), dz));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[5], dx), wy), dz));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[6], wx), dy), dz));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(g[7], dx), dy), dz));
+            result = _mm256_add_ps(result, _mm256_mul_ps(sum, _mm256_set1_ps(amp)));
+            amp *= amplitude_persistence;
+            freq *= frequency_persistence;
+        }
+
+        if (lanes < PERLIN_LANES)
+        {
+            _mm256_storeu_ps(pad[0], result);
+            for (j = 0; j < lanes; ++j)
+                dst[i + j] = pad[0][j];
+        }
+        else _mm256_storeu_ps(dst + i, result);
+    }
+}
+
+KERNEL_AVX2
+static __m256i mul_u64_avx2_internal(__m256i h, u32 c)
+{
+    const __m256i k = _mm256_set1_epi64x(c);
+    return _mm256_add_epi64(_mm256_mul_epu32(h, k),
+            _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(h, 32), k), 32));
+}
+
+KERNEL_AVX2
+static void hash_mix_avx2_internal(__m256i t, u32 c, __m256i *h0, __m256i *h1)
+{
+    __m256i h = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(t));
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 16));
+    *h0 = mul_u64_avx2_internal(h, c);
+
+    h = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(t, 1));
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 16));
+    *h1 = mul_u64_avx2_internal(h, c);
+}
+
+KERNEL_AVX2
+static __m128 rand_tab_gather_avx2_internal(__m256i h, __m256i seed)
+{
+    __m256i v = _mm256_add_epi64(seed, h);
+    __m256i lo = _mm256_and_si256(v, _mm256_set1_epi64x(0xfff));
+    __m256i q = _mm256_srli_epi64(v, 12);
+    __m256i r, d;
+
+    /* q % 27, q < 2^52, r < 2^30 */
+    r = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(q, 26), _mm256_set1_epi64x(13)),
+            _mm256_and_si256(q, _mm256_set1_epi64x(0x3ffffff)));
+
+    /* r / 27 = (r * ceil(2^36 / 27)) >> 36, exact for r < 2^30 */
+    d = _mm256_srli_epi64(_mm256_mul_epu32(r, _mm256_set1_epi64x(2545165806)), 36);
+    r = _mm256_sub_epi64(r, _mm256_mul_epu32(d, _mm256_set1_epi64x(27)));
+
+    return _mm256_i64gather_ps(fsl_rand_tab,
+            _mm256_add_epi64(lo, _mm256_slli_epi64(r, 12)), 4);
+}
+
+KERNEL_AVX2
+static __m256 join_avx2_internal(__m128 lo, __m128 hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+KERNEL_AVX2
+static __m256 fade_avx2_internal(__m256 d)
+{
+    __m256 f = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(6.0f), d), _mm256_set1_ps(15.0f));
+    f = _mm256_add_ps(_mm256_mul_ps(d, f), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(d, d), d), f);
+}
+
+KERNEL_AVX2
+static __m256 gradient_1d_avx2_internal(__m256 v, __m256i x, __m256 xf, __m256i seed)
+{
+    __m256i h0, h1;
+    hash_mix_avx2_internal(_mm256_mullo_epi32(x, _mm256_set1_epi32(RAND_CONST_0)),
+            RAND_CONST_1, &h0, &h1);
+
+    return _mm256_mul_ps(_mm256_sub_ps(v, xf),
+            join_avx2_internal(
+                rand_tab_gather_avx2_internal(h0, seed),
+                rand_tab_gather_avx2_internal(h1, seed)));
+}
+
+KERNEL_AVX2
+static __m256 gradient_2d_avx2_internal(__m256 vx, __m256 vy,
+        __m256i x, __m256i y, __m256 xf, __m256 yf, __m256i seed)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    __m256i h0, h1;
+    __m256 gx, gy;
+
+    hash_mix_avx2_internal(_mm256_xor_si256(
+                _mm256_mullo_epi32(x, _mm256_set1_epi32(RAND_CONST_1)),
+                _mm256_mullo_epi32(y, _mm256_set1_epi32(RAND_CONST_2))),
+            RAND_CONST_0, &h0, &h1);
+
+    gx = join_avx2_internal(
+            rand_tab_gather_avx2_internal(_mm256_and_si256(h0, mask), seed),
+            rand_tab_gather_avx2_internal(_mm256_and_si256(h1, mask), seed));
+    gy = join_avx2_internal(
+            rand_tab_gather_avx2_internal(_mm256_srli_epi64(h0, 32), seed),
+            rand_tab_gather_avx2_internal(_mm256_srli_epi64(h1, 32), seed));
+
+    return _mm256_add_ps(
+            _mm256_mul_ps(_mm256_sub_ps(vx, xf), gx),
+            _mm256_mul_ps(_mm256_sub_ps(vy, yf), gy));
+}
+
+KERNEL_AVX2
+static __m256 gradient_3d_avx2_internal(__m256 vx, __m256 vy, __m256 vz,
+        __m256i x, __m256i y, __m256i z, __m256 xf, __m256 yf, __m256 zf, __m256i seed)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xfffff);
+    __m256i h0, h1;
+    __m256 gx, gy, gz;
+
+    hash_mix_avx2_internal(_mm256_xor_si256(_mm256_xor_si256(
+                    _mm256_mullo_epi32(x, _mm256_set1_epi32(RAND_CONST_5)),
+                    _mm256_mullo_epi32(y, _mm256_set1_epi32(RAND_CONST_6))),
+                _mm256_mullo_epi32(z, _mm256_set1_epi32(RAND_CONST_7))),
+            RAND_CONST_0, &h0, &h1);
+
+    gx = join_avx2_internal(
+            rand_tab_gather_avx2_internal(_mm256_and_si256(h0, mask), seed),
+            rand_tab_gather_avx2_internal(_mm256_and_si256(h1, mask), seed));
+    gy = join_avx2_internal(
+            rand_tab_gather_avx2_internal(_mm256_and_si256(_mm256_srli_epi64(h0, 20), mask), seed),
+            rand_tab_gather_avx2_internal(_mm256_and_si256(_mm256_srli_epi64(h1, 20), mask), seed));
+    gz = join_avx2_internal(
+            rand_tab_gather_avx2_internal(_mm256_and_si256(_mm256_srli_epi64(h0, 40), mask), seed),
+            rand_tab_gather_avx2_internal(_mm256_and_si256(_mm256_srli_epi64(h1, 40), mask), seed));
+
+    return _mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_sub_ps(vx, xf), gx),
+                _mm256_mul_ps(_mm256_sub_ps(vy, yf), gy)),
+            _mm256_mul_ps(_mm256_sub_ps(vz, zf), gz));
+}
+
+#endif /* FSL_KERNELS_X86 */
@@ -45,4 +45,16 @@ typedef struct angle_f64
 FSLAPI angle_f32 fsl_angle_f32(f32 n);
 FSLAPI angle_f64 fsl_angle_f64(f64 n);
 
+/*!
+ *  @brief sine and cosine of `n` angles in radians, by polynomial approximation.
+ *
+ *  within 2 ulp of `sinf()`/`cosf()` for |`x`| < 8192, precision drops beyond.
+ *
+ *  @param dst_sin results, may alias `x`.
+ *  @param dst_cos results, may alias `x`, not `dst_sin`.
+ *
+ *  @remark dispatched through @ref fsl_kernels.
+ */
+FSLAPI void fsl_sincos_f32_batch(const f32 *x, f32 *dst_sin, f32 *dst_cos, u64 n);
+
 #endif /* FSL_MATH_TRIGONOMETRY_H */
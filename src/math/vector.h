@@ -167,6 +167,11 @@ typedef struct v4f32
     f32 x, y, z, w;
 } v4f32;
 
+/*!
+ *  @brief @ref v4f32 on a 16-byte boundary, so SIMD loads never split a cache line.
+ */
+typedef v4f32 FSL_ALIGN(16) v4f32_aligned;
+
 typedef struct v4u64
 {
     u64 x, y, z, w;
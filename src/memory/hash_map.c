@@ -0,0 +1,342 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file hash_map.c
+ *
+ *  @brief open-addressing (robin hood) hash map.
+ *
+ *  slots are stored inline as `[hash][dist][value]`, where `dist` is the probe
+ *  distance from the slot's home bucket plus 1 (0 marks an empty slot).
+ *  inserts displace entries closer to their home bucket than the one being placed,
+ *  which keeps probe lengths short and lets lookups stop early, erase shifts
+ *  following entries back instead of leaving tombstones.
+ */
+
+#include "../common/diagnostics.h"
+#include "../logger/logger.h"
+#include "../logger/logger_messages_internal.h"
+
+#include "hash_map.h"
+#include "memory.h"
+
+#include <string.h>
+
+struct hash_map_slot
+{
+    u64 hash;
+    u64 dist;
+}; /* hash_map_slot */
+
+#define HASH_MAP_SLOT(base, i, size) \
+    ((struct hash_map_slot*)((u8*)(base) + (i) * (size)))
+
+#define HASH_MAP_SLOT_VAL(slot) \
+    ((void*)((struct hash_map_slot*)(slot) + 1))
+
+/*!
+ *  @internal
+ *
+ *  @brief swap slots `a` and `b` in place, `size` is a multiple of 8.
+ */
+static void slot_swap_internal(struct hash_map_slot *a, struct hash_map_slot *b, u64 size);
+
+/*!
+ *  @internal
+ *
+ *  @brief place a copy of `src` in `base` without checking for duplicates.
+ *
+ *  @param base slot buffer, the scratch slot at index `cap` is overwritten.
+ *
+ *  @return address of `src`'s value in its final slot.
+ */
+static void *slot_place_internal(void *base, u64 cap, u64 slot_size,
+        const struct hash_map_slot *src, u64 start, u64 dist);
+
+/*!
+ *  @internal
+ *
+ *  @brief double slot count and re-place all entries.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 grow_internal(fsl_hash_map *x);
+
+u32 fsl_hash_map_init(fsl_hash_map *x, fsl_mem_arena *arena, u64 cap, u64 val_size,
+        fsl_hash_map_key_eq key_eq)
+{
+    fsl_hash_map nomap = {0};
+    u64 cap_pow2 = FSL_HASH_MAP_CAP_MIN;
+
+    if (!x || !arena)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Initialize Hash Map"));
+        return fsl_err;
+    }
+
+    while (cap_pow2 < cap)
+        cap_pow2 <<= 1;
+
+    *x = nomap;
+    x->arena = arena;
+    x->cap = cap_pow2;
+    x->val_size = val_size;
+    x->slot_size = sizeof(struct hash_map_slot) + ((val_size + 7) & ~(u64)7);
+    x->key_eq = key_eq;
+
+    if (fsl_mem_arena_push(arena, &x->slot, (x->cap + 1) * x->slot_size,
+                "fsl_hash_map_init().x->slot") != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    fsl_hash_map_clear(x);
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+u32 fsl_hash_map_insert(fsl_hash_map *x, u64 hash, const void *key, const void *val, void **dst)
+{
+    void *base = NULL;
+    struct hash_map_slot *slot = NULL;
+    struct hash_map_slot *scratch = NULL;
+    void *result = NULL;
+    u64 mask = 0;
+    u64 i = 0;
+    u64 dist = 1;
+
+    /* look up before growing, so a duplicate insert never reallocates */
+    if ((result = fsl_hash_map_find(x, hash, key)))
+    {
+        if (dst)
+            *dst = result;
+        fsl_err = FSL_ERR_KEY_EXISTS;
+        return fsl_err;
+    }
+
+    if ((x->count + 1) * 8 > x->cap * 7 && grow_internal(x) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    base = fsl_mem_handle_get(x->slot);
+    mask = x->cap - 1;
+    i = hash & mask;
+
+    for (;; i = (i + 1) & mask, ++dist)
+    {
+        slot = HASH_MAP_SLOT(base, i, x->slot_size);
+        if (slot->dist < dist)
+            break;
+    }
+
+    scratch = HASH_MAP_SLOT(base, x->cap, x->slot_size);
+    scratch->hash = hash;
+    if (val)
+        memcpy(HASH_MAP_SLOT_VAL(scratch), val, x->val_size);
+    else
+        memset(HASH_MAP_SLOT_VAL(scratch), 0, x->val_size);
+
+    result = slot_place_internal(base, x->cap, x->slot_size, scratch, i, dist);
+    ++x->count;
+
+    if (dst)
+        *dst = result;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+void *fsl_hash_map_find(fsl_hash_map *x, u64 hash, const void *key)
+{
+    void *base = NULL;
+    struct hash_map_slot *slot = NULL;
+    u64 mask = 0;
+    u64 i = 0;
+    u64 dist = 1;
+
+    if (!x->count)
+        return NULL;
+
+    base = fsl_mem_handle_get(x->slot);
+    mask = x->cap - 1;
+    i = hash & mask;
+
+    for (;; i = (i + 1) & mask, ++dist)
+    {
+        slot = HASH_MAP_SLOT(base, i, x->slot_size);
+        if (slot->dist < dist)
+            return NULL;
+
+        if (slot->hash == hash && (!x->key_eq || !key || x->key_eq(HASH_MAP_SLOT_VAL(slot), key)))
+            return HASH_MAP_SLOT_VAL(slot);
+    }
+}
+
+b8 fsl_hash_map_erase(fsl_hash_map *x, u64 hash, const void *key)
+{
+    void *base = NULL;
+    struct hash_map_slot *slot = NULL;
+    struct hash_map_slot *next = NULL;
+    u64 mask = 0;
+    u64 i = 0;
+
+    if ((slot = fsl_hash_map_find(x, hash, key)) == NULL)
+        return FALSE;
+
+    --slot; /* value address to slot header */
+    base = fsl_mem_handle_get(x->slot);
+    mask = x->cap - 1;
+    i = (u64)((u8*)slot - (u8*)base) / x->slot_size;
+
+    for (;;)
+    {
+        i = (i + 1) & mask;
+        next = HASH_MAP_SLOT(base, i, x->slot_size);
+        if (next->dist <= 1)
+            break;
+
+        memcpy(slot, next, x->slot_size);
+        --slot->dist;
+        slot = next;
+    }
+
+    slot->dist = 0;
+    --x->count;
+    return TRUE;
+}
+
+b8 fsl_hash_map_next(fsl_hash_map *x, u64 *cursor, u64 *hash, void **val)
+{
+    void *base = fsl_mem_handle_get(x->slot);
+    struct hash_map_slot *slot = NULL;
+
+    for (; *cursor < x->cap; ++*cursor)
+    {
+        slot = HASH_MAP_SLOT(base, *cursor, x->slot_size);
+        if (!slot->dist)
+            continue;
+
+        if (hash)
+            *hash = slot->hash;
+        if (val)
+            *val = HASH_MAP_SLOT_VAL(slot);
+        ++*cursor;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+void fsl_hash_map_clear(fsl_hash_map *x)
+{
+    void *base = fsl_mem_handle_get(x->slot);
+    u64 i = 0;
+
+    if (!base)
+        return;
+
+    for (; i < x->cap; ++i)
+        HASH_MAP_SLOT(base, i, x->slot_size)->dist = 0;
+    x->count = 0;
+}
+
+void fsl_hash_map_free(fsl_hash_map *x)
+{
+    fsl_hash_map nomap = {0};
+
+    fsl_mem_arena_pop(&x->slot, "fsl_hash_map_free().x->slot");
+    *x = nomap;
+}
+
+static void slot_swap_internal(struct hash_map_slot *a, struct hash_map_slot *b, u64 size)
+{
+    u64 *pa = (u64*)a;
+    u64 *pb = (u64*)b;
+    u64 temp = 0;
+
+    for (size /= sizeof(u64); size; --size, ++pa, ++pb)
+    {
+        temp = *pa;
+        *pa = *pb;
+        *pb = temp;
+    }
+}
+
+static void *slot_place_internal(void *base, u64 cap, u64 slot_size,
+        const struct hash_map_slot *src, u64 start, u64 dist)
+{
+    struct hash_map_slot *scratch = HASH_MAP_SLOT(base, cap, slot_size);
+    struct hash_map_slot *slot = NULL;
+    void *result = NULL;
+    u64 mask = cap - 1;
+    u64 i = start;
+
+    if (src != scratch)
+        memcpy(scratch, src, slot_size);
+    scratch->dist = dist;
+
+    for (;; i = (i + 1) & mask, ++scratch->dist)
+    {
+        slot = HASH_MAP_SLOT(base, i, slot_size);
+        if (!slot->dist)
+        {
+            memcpy(slot, scratch, slot_size);
+            return result ? result : HASH_MAP_SLOT_VAL(slot);
+        }
+
+        if (slot->dist < scratch->dist)
+        {
+            slot_swap_internal(slot, scratch, slot_size);
+            if (!result)
+                result = HASH_MAP_SLOT_VAL(slot);
+        }
+    }
+}
+
+static u32 grow_internal(fsl_hash_map *x)
+{
+    fsl_mem_handle slot_new = {0};
+    void *base_old = NULL;
+    void *base_new = NULL;
+    struct hash_map_slot *slot = NULL;
+    u64 cap_new = x->cap * 2;
+    u64 i = 0;
+
+    if (fsl_mem_arena_push(x->arena, &slot_new, (cap_new + 1) * x->slot_size,
+                "fsl_hash_map_insert().x->slot") != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    /* fetch after push, arena may have moved */
+    base_old = fsl_mem_handle_get(x->slot);
+    base_new = fsl_mem_handle_get(slot_new);
+
+    for (i = 0; i < cap_new; ++i)
+        HASH_MAP_SLOT(base_new, i, x->slot_size)->dist = 0;
+
+    for (i = 0; i < x->cap; ++i)
+    {
+        slot = HASH_MAP_SLOT(base_old, i, x->slot_size);
+        if (slot->dist)
+            slot_place_internal(base_new, cap_new, x->slot_size,
+                    slot, slot->hash & (cap_new - 1), 1);
+    }
+
+    fsl_mem_arena_pop(&x->slot, "fsl_hash_map_insert().x->slot");
+    x->slot = slot_new;
+    x->cap = cap_new;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
@@ -0,0 +1,123 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file hash_map.h
+ *
+ *  @brief open-addressing (robin hood) hash map, backed by a memory arena.
+ */
+
+#ifndef FSL_HASH_MAP_H
+#define FSL_HASH_MAP_H
+
+#include "../common/api.h"
+#include "../common/types.h"
+
+#include "memory_types.h"
+
+/*!
+ *  @brief minimum slot count of a @ref fsl_hash_map, power of 2.
+ */
+#define FSL_HASH_MAP_CAP_MIN 16
+
+/*!
+ *  @brief full-key compare callback.
+ *
+ *  @param val stored value of a slot whose hash matched.
+ *  @param key key passed to the lookup.
+ *
+ *  @return `TRUE` if `val` belongs to `key`.
+ */
+typedef b8 (*fsl_hash_map_key_eq)(const void *val, const void *key);
+
+typedef struct fsl_hash_map fsl_hash_map;
+
+struct fsl_hash_map
+{
+    fsl_mem_arena *arena;       /* arena `slot` is pushed onto */
+    fsl_mem_handle slot;        /* slot buffer, `(cap + 1) * slot_size` bytes, last slot is scratch */
+    u64 cap;                    /* slot count, power of 2 */
+    u64 count;                  /* occupied slot count */
+    u64 val_size;               /* size of a stored value, in bytes */
+    u64 slot_size;              /* size of a slot (header + value, 8-byte aligned), in bytes */
+    fsl_hash_map_key_eq key_eq; /* optional, if `NULL` keys compare by hash only */
+}; /* fsl_hash_map */
+
+/*!
+ *  @brief initialize a hash map and push its slot buffer onto `arena`.
+ *
+ *  @param arena arena to allocate slots on, must be initialized.
+ *  @param cap initial slot count, rounded up to a power of 2 (at least @ref FSL_HASH_MAP_CAP_MIN).
+ *  @param val_size size of a stored value, in bytes.
+ *  @param key_eq optional full-key compare callback, to tell colliding hashes apart.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_hash_map_init(fsl_hash_map *x, fsl_mem_arena *arena, u64 cap, u64 val_size,
+        fsl_hash_map_key_eq key_eq);
+
+/*!
+ *  @brief insert `val` for `hash`, grow map if needed.
+ *
+ *  @param key full key passed to @ref fsl_hash_map.key_eq, can be `NULL`.
+ *  @param val value to copy into the map, if `NULL` the stored value is zeroed.
+ *  @param dst optional, recipient of the stored value's address, valid until the next insert or erase.
+ *
+ *  @remark if the key is already present, its value is left untouched, `dst` receives its
+ *  address and @ref FSL_ERR_KEY_EXISTS is returned.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_hash_map_insert(fsl_hash_map *x, u64 hash, const void *key, const void *val, void **dst);
+
+/*!
+ *  @param key full key passed to @ref fsl_hash_map.key_eq, can be `NULL`.
+ *
+ *  @return address of the stored value, or `NULL` if not found.
+ */
+FSLAPI void *fsl_hash_map_find(fsl_hash_map *x, u64 hash, const void *key);
+
+/*!
+ *  @param key full key passed to @ref fsl_hash_map.key_eq, can be `NULL`.
+ *
+ *  @return `TRUE` if the key was found and erased.
+ */
+FSLAPI b8 fsl_hash_map_erase(fsl_hash_map *x, u64 hash, const void *key);
+
+/*!
+ *  @brief iterate occupied slots.
+ *
+ *  @param cursor iteration state, set to 0 before the first call.
+ *  @param hash optional, recipient of the slot's hash.
+ *  @param val optional, recipient of the slot's value address.
+ *
+ *  @remark inserting or erasing while iterating invalidates `cursor`.
+ *
+ *  @return `FALSE` when there are no slots left.
+ */
+FSLAPI b8 fsl_hash_map_next(fsl_hash_map *x, u64 *cursor, u64 *hash, void **val);
+
+/*!
+ *  @brief remove all entries, keep capacity.
+ */
+FSLAPI void fsl_hash_map_clear(fsl_hash_map *x);
+
+/*!
+ *  @brief pop slot buffer off its arena and zero-out `x`.
+ */
+FSLAPI void fsl_hash_map_free(fsl_hash_map *x);
+
+#endif /* FSL_HASH_MAP_H */
@@ -33,6 +33,8 @@
 #include <string.h>
 
 #define MEM_ALLOC_SIZE_MIN 2
+#define SORT_MERGE_RUN 16 /* element count of insertion-sorted runs in `fsl_sort_merge()` */
+#define SORT_SWAP_CHUNK 64 /* stack buffer size of `sort_swap_internal()`, in bytes */
 
 struct fsl_mem_arena_handle
 {
@@ -40,6 +42,20 @@ struct fsl_mem_arena_handle
     u64 size;               /* handle's allocated size */
 }; /* fsl_mem_arena_handle */
 
+/*!
+ *  @internal
+ *
+ *  @brief copy one element of `size` bytes, elements may be unaligned and of any size.
+ */
+static void sort_copy_internal(u8 *dst, const u8 *src, u64 size);
+
+/*!
+ *  @internal
+ *
+ *  @brief swap two elements of `size` bytes through a stack buffer, @ref SORT_SWAP_CHUNK bytes at a time.
+ */
+static void sort_swap_internal(u8 *a, u8 *b, u64 size);
+
 fsl_mem_arena mem_arena_internal = {0};
 fsl_mem_arena mem_arena_sub_data_internal = {0};
 fsl_mem_arena mem_arena_name_internal = {0};
@@ -435,6 +451,12 @@ u32 fsl_mem_clear_internal(void *x, u64 size,
 
 u32 fsl_mem_arena_init_internal(fsl_mem_arena *x,
         const str *name, const str *src_file, u64 src_line)
+{
+    return fsl_mem_arena_init_ex_internal(x, 0, name, src_file, src_line);
+}
+
+u32 fsl_mem_arena_init_ex_internal(fsl_mem_arena *x, u32 flags,
+        const str *name, const str *src_file, u64 src_line)
 {
     u64 entry_cap = sizeof(fsl_mem_arena_handle) * 2;
     u64 freelist_cap = sizeof(fsl_mem_arena_handle) * 2;
@@ -454,7 +476,8 @@ u32 fsl_mem_arena_init_internal(fsl_mem_arena *x,
     if (
             fsl_mem_map_internal((void*)&x->entry, entry_cap, name, src_file, src_line) != FSL_ERR_SUCCESS ||
             fsl_mem_map_internal((void*)&x->freelist, freelist_cap, name, src_file, src_line) != FSL_ERR_SUCCESS ||
-            fsl_mem_map_internal((void*)&x->buf, buf_cap, name, src_file, src_line) != FSL_ERR_SUCCESS)
+            fsl_mem_map_ex_internal((void*)&x->buf, buf_cap, flags & ~FSL_FLAG_MEM_MAP_HUGE_TLB,
+                name, src_file, src_line) != FSL_ERR_SUCCESS)
     {
         LOGERROREX(FSL_ERR_MEM_ARENA_MAP_FAIL, 0,
                 src_file, src_line,
@@ -708,31 +731,216 @@ void fsl_swap_bits_u64(u64 *a, u64 *b)
     *a ^= *b;
 }
 
-#if 0
-void fsl_sort_buf(fsl_buf *buf) /* TODO: fucking fix this */
+void fsl_sort_radix_u32(u32 *key, u32 *index, u64 len, void *scratch)
+{
+    u64 count[4][256];
+    u32 *key_src = key;
+    u32 *key_dst = scratch;
+    u32 *index_src = index;
+    u32 *index_dst = (u32*)scratch + len;
+    u32 *swap = NULL;
+    u64 i = 0;
+    u64 pos = 0;
+    u64 sum = 0;
+    u32 pass = 0;
+    u32 digit = 0;
+
+    if (len < 2)
+        return;
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < len; ++i)
+        for (pass = 0; pass < 4; ++pass)
+            ++count[pass][(key[i] >> (pass * 8)) & 0xff];
+
+    for (pass = 0; pass < 4; ++pass)
+    {
+        if (count[pass][(key_src[0] >> (pass * 8)) & 0xff] == len)
+            continue;
+
+        for (sum = 0, i = 0; i < 256; ++i)
+        {
+            pos = count[pass][i];
+            count[pass][i] = sum;
+            sum += pos;
+        }
+
+        for (i = 0; i < len; ++i)
+        {
+            digit = (key_src[i] >> (pass * 8)) & 0xff;
+            pos = count[pass][digit]++;
+            key_dst[pos] = key_src[i];
+            if (index)
+                index_dst[pos] = index_src[i];
+        }
+
+        swap = key_src; key_src = key_dst; key_dst = swap;
+        swap = index_src; index_src = index_dst; index_dst = swap;
+    }
+
+    if (key_src != key)
+    {
+        memcpy(key, key_src, len * sizeof(u32));
+        if (index)
+            memcpy(index, index_src, len * sizeof(u32));
+    }
+}
+
+void fsl_sort_radix_u64(u64 *key, u32 *index, u64 len, void *scratch)
 {
-    for (u16 i = 0, smallest = 0; i < buf->memb - 1 && buf->i[i] != NULL; ++i)
+    u64 count[8][256];
+    u64 *key_src = key;
+    u64 *key_dst = scratch;
+    u64 *key_swap = NULL;
+    u32 *index_src = index;
+    u32 *index_dst = (u32*)((u64*)scratch + len);
+    u32 *index_swap = NULL;
+    u64 i = 0;
+    u64 pos = 0;
+    u64 sum = 0;
+    u32 pass = 0;
+    u32 digit = 0;
+
+    if (len < 2)
+        return;
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < len; ++i)
+        for (pass = 0; pass < 8; ++pass)
+            ++count[pass][(key[i] >> (pass * 8)) & 0xff];
+
+    for (pass = 0; pass < 8; ++pass)
     {
-        smallest = i;
-        for (u64 j = i + 1; j < buf->memb && buf->i[j] != NULL; ++j)
+        if (count[pass][(key_src[0] >> (pass * 8)) & 0xff] == len)
+            continue;
+
+        for (sum = 0, i = 0; i < 256; ++i)
         {
-            char cmp0 = tolower(buf->i[j] + 0);
-            char cmp1 = tolower(buf->i[smallest] + 0);
-            if (cmp0 < cmp1 && buf->i[j][0] && buf->i[smallest][0])
-                smallest = j;
-
-            if (cmp0 == cmp1 && buf->i[j] && cmp1)
-                for (u16 k = 1; k < FSL_ID_CAP - 1 && buf->i[j][k - 1] && buf->i[smallest][k - 1]; ++k)
-                {
-                    if (tolower(buf->i[j] + k) < tolower(buf->i[smallest] + k))
-                    {
-                        smallest = j;
-                        break;
-                    }
-                }
+            pos = count[pass][i];
+            count[pass][i] = sum;
+            sum += pos;
         }
 
-        swap_strings(buf->i[i], buf->i[smallest]);
+        for (i = 0; i < len; ++i)
+        {
+            digit = (key_src[i] >> (pass * 8)) & 0xff;
+            pos = count[pass][digit]++;
+            key_dst[pos] = key_src[i];
+            if (index)
+                index_dst[pos] = index_src[i];
+        }
+
+        key_swap = key_src; key_src = key_dst; key_dst = key_swap;
+        index_swap = index_src; index_src = index_dst; index_dst = index_swap;
+    }
+
+    if (key_src != key)
+    {
+        memcpy(key, key_src, len * sizeof(u64));
+        if (index)
+            memcpy(index, index_src, len * sizeof(u32));
+    }
+}
+
+void fsl_sort_merge(void *buf, u64 memb, u64 size, fsl_sort_cmp cmp, void *scratch)
+{
+    u8 *src = buf;
+    u8 *dst = scratch;
+    u8 *swap = NULL;
+    u64 width = 0;
+    u64 lo = 0;
+    u64 mid = 0;
+    u64 hi = 0;
+    u64 i = 0;
+    u64 j = 0;
+    u64 k = 0;
+
+    if (memb < 2)
+        return;
+
+    /* insertion sort short runs first, merging single elements is mostly overhead */
+
+    for (lo = 0; lo < memb; lo += SORT_MERGE_RUN)
+    {
+        hi = lo + SORT_MERGE_RUN < memb ? lo + SORT_MERGE_RUN : memb;
+        for (i = lo + 1; i < hi; ++i)
+            for (j = i; j > lo && cmp(src + (j - 1) * size, src + j * size) > 0; --j)
+            {
+                sort_swap_internal(src + (j - 1) * size, src + j * size, size);
+            }
+    }
+
+    for (width = SORT_MERGE_RUN; width < memb; width *= 2)
+    {
+        for (lo = 0; lo < memb; lo += width * 2)
+        {
+            mid = lo + width < memb ? lo + width : memb;
+            hi = lo + width * 2 < memb ? lo + width * 2 : memb;
+
+            /* already in order */
+            if (mid == hi || cmp(src + (mid - 1) * size, src + mid * size) <= 0)
+            {
+                memcpy(dst + lo * size, src + lo * size, (hi - lo) * size);
+                continue;
+            }
+
+            for (i = lo, j = mid, k = lo; i < mid && j < hi; ++k)
+            {
+                if (cmp(src + j * size, src + i * size) < 0)
+                    sort_copy_internal(dst + k * size, src + j++ * size, size);
+                else
+                    sort_copy_internal(dst + k * size, src + i++ * size, size);
+            }
+            if (i < mid)
+                memcpy(dst + k * size, src + i * size, (mid - i) * size);
+            if (j < hi)
+                memcpy(dst + k * size, src + j * size, (hi - j) * size);
+        }
+
+        swap = src; src = dst; dst = swap;
+    }
+
+    if (src != buf)
+        memcpy(buf, src, memb * size);
+}
+
+static void sort_copy_internal(u8 *dst, const u8 *src, u64 size)
+{
+    /* constant sizes compile to single loads and stores */
+    if (size == sizeof(u32))
+        memcpy(dst, src, sizeof(u32));
+    else if (size == sizeof(u64))
+        memcpy(dst, src, sizeof(u64));
+    else
+        memcpy(dst, src, size);
+}
+
+static void sort_swap_internal(u8 *a, u8 *b, u64 size)
+{
+    u8 temp[SORT_SWAP_CHUNK];
+    u64 chunk = 0;
+
+    /* constant sizes compile to single loads and stores */
+    if (size == sizeof(u32))
+    {
+        memcpy(temp, a, sizeof(u32));
+        memcpy(a, b, sizeof(u32));
+        memcpy(b, temp, sizeof(u32));
+        return;
+    }
+    if (size == sizeof(u64))
+    {
+        memcpy(temp, a, sizeof(u64));
+        memcpy(a, b, sizeof(u64));
+        memcpy(b, temp, sizeof(u64));
+        return;
+    }
+
+    for (; size; size -= chunk, a += chunk, b += chunk)
+    {
+        chunk = size < SORT_SWAP_CHUNK ? size : SORT_SWAP_CHUNK;
+        memcpy(temp, a, chunk);
+        memcpy(a, b, chunk);
+        memcpy(b, temp, chunk);
     }
 }
-#endif
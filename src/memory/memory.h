@@ -38,6 +38,32 @@
 
 #define FSL_OFFSET_INVALID FSL_U64_MAX
 
+/*!
+ *  @brief size of a huge page, used for @ref FSL_FLAG_MEM_MAP_HUGE_TLB mappings,
+ *  mapping sizes not a multiple of this fall back to @ref FSL_FLAG_MEM_MAP_HUGE_PAGE.
+ */
+#define FSL_MEM_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/*!
+ *  @brief scratch sizes, in bytes, for @ref fsl_sort_radix_u32(), @ref fsl_sort_radix_u64()
+ *  and @ref fsl_sort_merge().
+ */
+#define FSL_SORT_RADIX_U32_SCRATCH(len)     ((u64)(len) * (sizeof(u32) + sizeof(u32)))
+#define FSL_SORT_RADIX_U64_SCRATCH(len)     ((u64)(len) * (sizeof(u64) + sizeof(u32)))
+#define FSL_SORT_MERGE_SCRATCH(memb, size)  ((u64)(memb) * (size))
+
+/*!
+ *  @brief comparator for @ref fsl_sort_merge().
+ */
+typedef i32 (*fsl_sort_cmp)(const void *a, const void *b);
+
+enum fsl_mem_map_flag
+{
+    FSL_FLAG_MEM_MAP_HUGE_PAGE =    0x0001, /* advise transparent huge pages (linux: `MADV_HUGEPAGE`) */
+    FSL_FLAG_MEM_MAP_HUGE_TLB =     0x0002, /* request reserved huge pages (linux: `MAP_HUGETLB`), fall back to @ref FSL_FLAG_MEM_MAP_HUGE_PAGE */
+    FSL_FLAG_MEM_MAP_POPULATE =     0x0004  /* pre-fault pages on the mapping thread, so they land on its NUMA node */
+}; /* fsl_mem_map_flag */
+
 #define fsl_mem_array_init(x) \
     fsl_mem_array_init_internal(x)
 
@@ -80,6 +106,9 @@
 #define fsl_mem_map(x, size, name) \
     fsl_mem_map_internal(x, size, name, __BASE_FILE__, __LINE__)
 
+#define fsl_mem_map_ex(x, size, flags, name) \
+    fsl_mem_map_ex_internal(x, size, flags, name, __BASE_FILE__, __LINE__)
+
 #define fsl_mem_commit(x, offset, size, name) \
     fsl_mem_commit_internal(x, offset, size, name, __BASE_FILE__, __LINE__)
 
@@ -92,6 +121,9 @@
 #define fsl_mem_arena_init(x, name) \
     fsl_mem_arena_init_internal(x, name, __BASE_FILE__, __LINE__)
 
+#define fsl_mem_arena_init_ex(x, flags, name) \
+    fsl_mem_arena_init_ex_internal(x, flags, name, __BASE_FILE__, __LINE__)
+
 #define fsl_mem_arena_push(arena, handle, size, name) \
     fsl_mem_arena_push_internal(arena, handle, size, name, __BASE_FILE__, __LINE__)
 
@@ -283,6 +315,22 @@ FSLAPI u32 fsl_mem_clear_internal(void *x, u64 size,
 FSLAPI u32 fsl_mem_map_internal(void **x, u64 size,
         const str *name, const str *src_file, u64 src_line);
 
+/*!
+ *  @brief reserve a block of memory for `*x` with page backing hints.
+ *  implemented in `platform_<PLATFORM>.c`.
+ *
+ *  @param size size, in bytes.
+ *  @param flags enum @ref fsl_mem_map_flag.
+ *  @param name symbol name (for logging).
+ *
+ *  @remark flags are hints, if the system can't honor them the mapping falls
+ *  back to regular pages instead of failing.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_mem_map_ex_internal(void **x, u64 size, u32 flags,
+        const str *name, const str *src_file, u64 src_line);
+
 /*!
  *  @brief commit a block of mapped memory for `*x`.
  *  implemented in `platform_<PLATFORM>.c`.
@@ -328,6 +376,18 @@ FSLAPI void fsl_mem_unmap_internal(void **x, u64 size,
 FSLAPI u32 fsl_mem_arena_init_internal(fsl_mem_arena *x,
         const str *name, const str *src_file, u64 src_line);
 
+/*!
+ *  @brief allocate and initialize a memory arena with page backing hints for its buffer.
+ *
+ *  @param flags enum @ref fsl_mem_map_flag, @ref FSL_FLAG_MEM_MAP_HUGE_TLB is
+ *  ignored since arenas grow by arbitrary sizes.
+ *  @param name symbol name (for logging).
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_mem_arena_init_ex_internal(fsl_mem_arena *x, u32 flags,
+        const str *name, const str *src_file, u64 src_line);
+
 /*!
  *  @brief reserve a block of available memory in arena `x` and grow arena if needed and
  *  initialize `handle` metadata.
@@ -396,6 +456,35 @@ FSLAPI void fsl_swap_bits_u32(u32 *a, u32 *b);
  */
 FSLAPI void fsl_swap_bits_u64(u64 *a, u64 *b);
 
-FSLAPI void fsl_sort_buf(fsl_buf *buf);
+/*!
+ *  @brief stable LSD radix sort of `key`, 8 bits per pass.
+ *
+ *  @param index optional payload permuted alongside `key` (e.g. indices into the
+ *  sorted items), can be `NULL`.
+ *  @param len number of elements in `key` (and `index`).
+ *  @param scratch at least @ref FSL_SORT_RADIX_U32_SCRATCH(`len`) bytes, contents are clobbered.
+ *
+ *  @remark passes whose digit is the same for all keys are skipped.
+ */
+FSLAPI void fsl_sort_radix_u32(u32 *key, u32 *index, u64 len, void *scratch);
+
+/*!
+ *  @brief stable LSD radix sort of `key`, 8 bits per pass.
+ *
+ *  @param index optional payload permuted alongside `key`, can be `NULL`.
+ *  @param len number of elements in `key` (and `index`).
+ *  @param scratch at least @ref FSL_SORT_RADIX_U64_SCRATCH(`len`) bytes, contents are clobbered.
+ *
+ *  @remark passes whose digit is the same for all keys are skipped.
+ */
+FSLAPI void fsl_sort_radix_u64(u64 *key, u32 *index, u64 len, void *scratch);
+
+/*!
+ *  @brief stable bottom-up merge sort of `memb` elements of `size` bytes each.
+ *
+ *  @param cmp return negative if `a` goes before `b`, positive if after, 0 if equal.
+ *  @param scratch at least @ref FSL_SORT_MERGE_SCRATCH(`memb`, `size`) bytes, contents are clobbered.
+ */
+FSLAPI void fsl_sort_merge(void *buf, u64 memb, u64 size, fsl_sort_cmp cmp, void *scratch);
 
 #endif /* FSL_MEMORY_H */
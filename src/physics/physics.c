@@ -20,14 +20,50 @@
  *  @brief physics functions.
  */
 
+#include "../common/diagnostics.h"
+#include "../h/cpu.h"
+#include "../logger/logger.h"
+#include "../logger/logger_messages_internal.h"
 #include "../math/math.h"
 #include "../math/matrix.h"
+#include "../math/trigonometry.h"
+#include "../memory/memory.h"
 
 #include "physics_types.h"
 #include "transform.h"
 
 #include <math.h>
 
+/*!
+ *  @brief dirty transforms gathered per @ref fsl_sincos_f32_batch() call.
+ */
+#define TRANSFORM_BAKE_CHUNK 256
+
+/*!
+ *  @internal
+ *
+ *  @brief build the matrices of one half (base or delta) of a transform, roll
+ *  isn't part of the bake.
+ */
+static void bake_matrices_internal(const v3f64 *pos, const v3f64 *rot, const v3f64 *scale,
+        m4f32 *location, m4f32 *rotation_pitch, m4f32 *rotation_yaw, m4f32 *scale_dst);
+
+/*!
+ *  @internal
+ *
+ *  @brief bake the `n` transforms at `index`, `angle` holding pitch and yaw of
+ *  each, interleaved, in radians.
+ */
+static void soa_bake_chunk_internal(const fsl_transform_soa *soa, const u64 *index,
+        const f32 *angle, u64 n, m4f32 *dst);
+
+/*!
+ *  @internal
+ *
+ *  @return index of the lowest set bit of `bits`, `bits` non-zero.
+ */
+static u32 bit_lowest_internal(u64 bits);
+
 void fsl_position_set(fsl_transform_v3f64 *transform, f64 pos_x, f64 pos_y, f64 pos_z)
 {
     transform->pos.x = pos_x;
@@ -112,103 +148,174 @@ void fsl_scale_delta_add(fsl_transform_v3f64 *transform, f64 scale_x, f64 scale_
     transform->scale_delta.z += scale_z;
 }
 
-m4f32 fsl_transform_bake(const fsl_transform_v3f64 *transform)
+void fsl_transform_bake_batch(const fsl_transform_v3f64 *transform, m4f32 *dst, u64 n)
 {
-    f32 SROL = 0.0f;
-    f32 CROL = 0.0f;
-    f32 SPCH = 0.0f;
-    f32 CPCH = 0.0f;
-    f32 SYAW = 0.0f;
-    f32 CYAW = 0.0f;
-    m4f32 final = {0};
+    void (*multiply)(const m4f32*, const m4f32*, m4f32*) = fsl_kernels.multiply_m4f32;
     m4f32 location = {0};
-    m4f32 rotation_roll = {0};
     m4f32 rotation_pitch = {0};
     m4f32 rotation_yaw = {0};
     m4f32 scale = {0};
+    u64 i = 0;
 
-    location = fsl_identity_m4f32();
-    rotation_roll = fsl_identity_m4f32();
-    rotation_pitch = fsl_identity_m4f32();
-    rotation_yaw = fsl_identity_m4f32();
-    scale = fsl_identity_m4f32();
-
-    /* ---- transform base -------------------------------------------------- */
-
-    SROL = sinf(transform->rot.x * FSL_DEG2RAD);
-    CROL = sinf(transform->rot.x * FSL_DEG2RAD + FSL_HALF_PI);
-    SPCH = sinf(transform->rot.y * FSL_DEG2RAD);
-    CPCH = sinf(transform->rot.y * FSL_DEG2RAD + FSL_HALF_PI);
-    SYAW = sinf(transform->rot.z * FSL_DEG2RAD);
-    CYAW = sinf(transform->rot.z * FSL_DEG2RAD + FSL_HALF_PI);
-
-    location.a41 = transform->pos.x;
-    location.a42 = transform->pos.y;
-    location.a43 = transform->pos.z;
-
-    rotation_roll.a22 = CROL;
-    rotation_roll.a23 = -SROL;
-    rotation_roll.a32 = SROL;
-    rotation_roll.a33 = CROL;
-
-    rotation_pitch.a11 = CPCH;
-    rotation_pitch.a13 = -SPCH;
-    rotation_pitch.a31 = SPCH;
-    rotation_pitch.a33 = CPCH;
-
-    rotation_yaw.a11 = CYAW;
-    rotation_yaw.a12 = -SYAW;
-    rotation_yaw.a21 = SYAW;
-    rotation_yaw.a22 = CYAW;
-
-    scale.a11 = transform->scale.x;
-    scale.a22 = transform->scale.y;
-    scale.a33 = transform->scale.z;
-
-    final = fsl_multiply_m4f32(scale, location);
-    final = fsl_multiply_m4f32(rotation_pitch, final);
-    final = fsl_multiply_m4f32(rotation_yaw, final);
-
-    /* ---- transform delta ------------------------------------------------- */
-
-    SROL = sinf(transform->rot_delta.x * FSL_DEG2RAD);
-    CROL = sinf(transform->rot_delta.x * FSL_DEG2RAD + FSL_HALF_PI);
-    SPCH = sinf(transform->rot_delta.y * FSL_DEG2RAD);
-    CPCH = sinf(transform->rot_delta.y * FSL_DEG2RAD + FSL_HALF_PI);
-    SYAW = sinf(transform->rot_delta.z * FSL_DEG2RAD);
-    CYAW = sinf(transform->rot_delta.z * FSL_DEG2RAD + FSL_HALF_PI);
-
-    location.a41 = transform->pos_delta.x;
-    location.a42 = transform->pos_delta.y;
-    location.a43 = transform->pos_delta.z;
-
-    rotation_roll.a22 = CROL;
-    rotation_roll.a23 = -SROL;
-    rotation_roll.a32 = SROL;
-    rotation_roll.a33 = CROL;
-
-    rotation_pitch.a11 = CPCH;
-    rotation_pitch.a13 = -SPCH;
-    rotation_pitch.a31 = SPCH;
-    rotation_pitch.a33 = CPCH;
-
-    rotation_yaw.a11 = CYAW;
-    rotation_yaw.a12 = -SYAW;
-    rotation_yaw.a21 = SYAW;
-    rotation_yaw.a22 = CYAW;
-
-    scale.a11 = transform->scale_delta.x;
-    scale.a22 = transform->scale_delta.y;
-    scale.a33 = transform->scale_delta.z;
-
-    final = fsl_multiply_m4f32(scale, final);
-    final = fsl_multiply_m4f32(location, final);
-    final = fsl_multiply_m4f32(rotation_pitch, final);
-    final = fsl_multiply_m4f32(rotation_yaw, final);
+    for (i = 0; i < n; ++i)
+    {
+        bake_matrices_internal(&transform[i].pos, &transform[i].rot, &transform[i].scale,
+                &location, &rotation_pitch, &rotation_yaw, &scale);
+        multiply(&scale, &location, &dst[i]);
+        multiply(&rotation_pitch, &dst[i], &dst[i]);
+        multiply(&rotation_yaw, &dst[i], &dst[i]);
+
+        bake_matrices_internal(&transform[i].pos_delta, &transform[i].rot_delta,
+                &transform[i].scale_delta, &location, &rotation_pitch, &rotation_yaw, &scale);
+        multiply(&scale, &dst[i], &dst[i]);
+        multiply(&location, &dst[i], &dst[i]);
+        multiply(&rotation_pitch, &dst[i], &dst[i]);
+        multiply(&rotation_yaw, &dst[i], &dst[i]);
+    }
+}
 
+m4f32 fsl_transform_bake(const fsl_transform_v3f64 *transform)
+{
+    m4f32 final = {0};
+    fsl_transform_bake_batch(transform, &final, 1);
     return final;
 }
 
+u32 fsl_transform_soa_init(fsl_transform_soa *soa, u64 len)
+{
+    u64 words = 0, i = 0;
+    u32 j = 0;
+
+    if (!soa)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_POINTER_NULL_ACTION("Initialize Transform SoA"));
+        return fsl_err;
+    }
+
+    if (soa->initialized)
+        fsl_transform_soa_free(soa);
+
+    if (!len)
+    {
+        LOGERROR(FSL_ERR_OUT_OF_BOUNDS, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_REASON_ERROR("Initialize Transform SoA", "Length Out of Bounds"));
+        return fsl_err;
+    }
+
+    /* one mapping, 9 component arrays followed by the bitset, arrays padded
+     * to whole bitset words to stay aligned */
+    words = (len + 63) / 64;
+    if (fsl_mem_map((void*)&soa->pos[0], words * (64 * 9 * sizeof(f32) + sizeof(u64)),
+                "transform_soa_init().soa") != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    for (j = 0; j < 3; ++j)
+    {
+        soa->pos[j] = soa->pos[0] + words * 64 * j;
+        soa->rot[j] = soa->pos[0] + words * 64 * (3 + j);
+        soa->scale[j] = soa->pos[0] + words * 64 * (6 + j);
+    }
+    soa->dirty = (u64*)(soa->pos[0] + words * 64 * 9);
+    soa->len = len;
+    soa->initialized = TRUE;
+
+    for (i = 0; i < len; ++i)
+    {
+        soa->scale[0][i] = 1.0f;
+        soa->scale[1][i] = 1.0f;
+        soa->scale[2][i] = 1.0f;
+    }
+
+    for (i = 0; i < len / 64; ++i)
+        soa->dirty[i] = ~(u64)0;
+    if (len % 64)
+        soa->dirty[i] = ((u64)1 << (len % 64)) - 1;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+void fsl_transform_soa_free(fsl_transform_soa *soa)
+{
+    fsl_transform_soa nosoa = {0};
+
+    if (!soa || !soa->initialized)
+        return;
+
+    fsl_mem_unmap((void*)&soa->pos[0], (soa->len + 63) / 64 * (64 * 9 * sizeof(f32) + sizeof(u64)),
+            "transform_soa_free().soa");
+
+    *soa = nosoa;
+}
+
+void fsl_transform_soa_position_set(fsl_transform_soa *soa, u64 i, f32 pos_x, f32 pos_y, f32 pos_z)
+{
+    soa->pos[0][i] = pos_x;
+    soa->pos[1][i] = pos_y;
+    soa->pos[2][i] = pos_z;
+    soa->dirty[i / 64] |= (u64)1 << (i % 64);
+}
+
+void fsl_transform_soa_rotation_set(fsl_transform_soa *soa, u64 i, f32 roll, f32 pitch, f32 yaw)
+{
+    soa->rot[0][i] = roll;
+    soa->rot[1][i] = pitch;
+    soa->rot[2][i] = yaw;
+    soa->dirty[i / 64] |= (u64)1 << (i % 64);
+}
+
+void fsl_transform_soa_scale_set(fsl_transform_soa *soa, u64 i, f32 scale_x, f32 scale_y, f32 scale_z)
+{
+    soa->scale[0][i] = scale_x;
+    soa->scale[1][i] = scale_y;
+    soa->scale[2][i] = scale_z;
+    soa->dirty[i / 64] |= (u64)1 << (i % 64);
+}
+
+void fsl_transform_soa_dirty_set(fsl_transform_soa *soa, u64 i)
+{
+    soa->dirty[i / 64] |= (u64)1 << (i % 64);
+}
+
+u64 fsl_transform_soa_bake(fsl_transform_soa *soa, m4f32 *dst)
+{
+    u64 index[TRANSFORM_BAKE_CHUNK];
+    f32 angle[TRANSFORM_BAKE_CHUNK * 2];
+    u64 bits = 0, i = 0, w = 0, n = 0, baked = 0;
+
+    for (w = 0; w < (soa->len + 63) / 64; ++w)
+    {
+        bits = soa->dirty[w];
+        soa->dirty[w] = 0;
+
+        while (bits)
+        {
+            i = w * 64 + bit_lowest_internal(bits);
+            bits &= bits - 1;
+
+            index[n] = i;
+            angle[n * 2 + 0] = soa->rot[1][i] * (f32)FSL_DEG2RAD;
+            angle[n * 2 + 1] = soa->rot[2][i] * (f32)FSL_DEG2RAD;
+
+            if (++n == TRANSFORM_BAKE_CHUNK)
+            {
+                soa_bake_chunk_internal(soa, index, angle, n, dst);
+                baked += n;
+                n = 0;
+            }
+        }
+    }
+
+    if (n)
+    {
+        soa_bake_chunk_internal(soa, index, angle, n, dst);
+        baked += n;
+    }
+
+    return baked;
+}
+
 fsl_physics_material fsl_physics_material_init(f64 friction_x, f64 friction_y, f64 friction_z,
     f64 drag_x, f64 drag_y, f64 drag_z, f64 bounciness)
 {
@@ -257,3 +364,92 @@ v3f64 fsl_kinematics_velocity_get(const fsl_kinematics *kn, u64 len)
     }
     return velocity;
 }
+
+static void bake_matrices_internal(const v3f64 *pos, const v3f64 *rot, const v3f64 *scale,
+        m4f32 *location, m4f32 *rotation_pitch, m4f32 *rotation_yaw, m4f32 *scale_dst)
+{
+    f32 SPCH = sinf(rot->y * FSL_DEG2RAD);
+    f32 CPCH = sinf(rot->y * FSL_DEG2RAD + FSL_HALF_PI);
+    f32 SYAW = sinf(rot->z * FSL_DEG2RAD);
+    f32 CYAW = sinf(rot->z * FSL_DEG2RAD + FSL_HALF_PI);
+
+    *location = fsl_identity_m4f32();
+    location->a41 = pos->x;
+    location->a42 = pos->y;
+    location->a43 = pos->z;
+
+    *rotation_pitch = fsl_identity_m4f32();
+    rotation_pitch->a11 = CPCH;
+    rotation_pitch->a13 = -SPCH;
+    rotation_pitch->a31 = SPCH;
+    rotation_pitch->a33 = CPCH;
+
+    *rotation_yaw = fsl_identity_m4f32();
+    rotation_yaw->a11 = CYAW;
+    rotation_yaw->a12 = -SYAW;
+    rotation_yaw->a21 = SYAW;
+    rotation_yaw->a22 = CYAW;
+
+    *scale_dst = fsl_identity_m4f32();
+    scale_dst->a11 = scale->x;
+    scale_dst->a22 = scale->y;
+    scale_dst->a33 = scale->z;
+}
+
+static void soa_bake_chunk_internal(const fsl_transform_soa *soa, const u64 *index,
+        const f32 *angle, u64 n, m4f32 *dst)
+{
+    f32 sine[TRANSFORM_BAKE_CHUNK * 2];
+    f32 cosine[TRANSFORM_BAKE_CHUNK * 2];
+    f32 SPCH = 0.0f, CPCH = 0.0f, SYAW = 0.0f, CYAW = 0.0f;
+    f32 sx = 0.0f, sy = 0.0f, sz = 0.0f;
+    m4f32 *m = NULL;
+    u64 i = 0, k = 0;
+
+    fsl_sincos_f32_batch(angle, sine, cosine, n * 2);
+
+    /* yaw * pitch * scale * location, expanded, the zeros of each factor
+     * leave 9 products and the translation */
+    for (k = 0; k < n; ++k)
+    {
+        i = index[k];
+        m = &dst[i];
+        SPCH = sine[k * 2 + 0];
+        CPCH = cosine[k * 2 + 0];
+        SYAW = sine[k * 2 + 1];
+        CYAW = cosine[k * 2 + 1];
+        sx = soa->scale[0][i];
+        sy = soa->scale[1][i];
+        sz = soa->scale[2][i];
+
+        m->a11 = CYAW * CPCH * sx;
+        m->a12 = -SYAW * sy;
+        m->a13 = -CYAW * SPCH * sz;
+        m->a14 = 0.0f;
+        m->a21 = SYAW * CPCH * sx;
+        m->a22 = CYAW * sy;
+        m->a23 = -SYAW * SPCH * sz;
+        m->a24 = 0.0f;
+        m->a31 = SPCH * sx;
+        m->a32 = 0.0f;
+        m->a33 = CPCH * sz;
+        m->a34 = 0.0f;
+        m->a41 = soa->pos[0][i];
+        m->a42 = soa->pos[1][i];
+        m->a43 = soa->pos[2][i];
+        m->a44 = 1.0f;
+    }
+}
+
+static u32 bit_lowest_internal(u64 bits)
+{
+    static const u8 debruijn[64] =
+    {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6,
+    };
+
+    return debruijn[((bits & (~bits + 1)) * 0x03f79d71b4cb0a89) >> 58];
+}
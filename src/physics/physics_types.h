@@ -69,6 +69,25 @@ typedef struct fsl_transform_v3f64
     v3f64 scale_delta;
 } fsl_transform_v3f64;
 
+/*!
+ *  @brief transforms stored per component (structure of arrays), with a dirty
+ *  bit per transform so a bake only rebuilds the ones that changed.
+ *
+ *  components are f32 `len`-long arrays, 256-byte aligned, rotations in degrees
+ *  (roll, pitch, yaw); deltas aren't stored, a baked transform is
+ *  @ref fsl_transform_bake() with zero position/rotation delta and unit scale delta.
+ */
+typedef struct fsl_transform_soa
+{
+    f32 *pos[3];
+    f32 *rot[3];
+    f32 *scale[3];
+    u64 *dirty;     /* bitset, bit `i % 64` of word `i / 64` */
+    u64 len;
+
+    b8 initialized;
+} fsl_transform_soa;
+
 typedef struct fsl_physics_material
 {
     v3f64 friction;
@@ -43,6 +43,48 @@ FSLAPI void fsl_scale_add(fsl_transform_v3f64 *transform, f64 scale_x, f64 scale
 FSLAPI void fsl_scale_delta_add(fsl_transform_v3f64 *transform, f64 scale_x, f64 scale_y, f64 scale_z);
 FSLAPI m4f32 fsl_transform_bake(const fsl_transform_v3f64 *transform);
 
+/*!
+ *  @brief bake `n` transforms into `dst`, as @ref fsl_transform_bake(), chaining
+ *  each matrix in place through @ref fsl_kernels.
+ */
+FSLAPI void fsl_transform_bake_batch(const fsl_transform_v3f64 *transform, m4f32 *dst, u64 n);
+
+/*!
+ *  @brief allocate `len` transforms at zero position and rotation and unit
+ *  scale, all dirty.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_transform_soa_init(fsl_transform_soa *soa, u64 len);
+
+FSLAPI void fsl_transform_soa_free(fsl_transform_soa *soa);
+
+/*!
+ *  @brief set a component of transform `i` and mark it dirty.
+ */
+FSLAPI void fsl_transform_soa_position_set(fsl_transform_soa *soa, u64 i, f32 pos_x, f32 pos_y, f32 pos_z);
+FSLAPI void fsl_transform_soa_rotation_set(fsl_transform_soa *soa, u64 i, f32 roll, f32 pitch, f32 yaw);
+FSLAPI void fsl_transform_soa_scale_set(fsl_transform_soa *soa, u64 i, f32 scale_x, f32 scale_y, f32 scale_z);
+
+/*!
+ *  @brief mark transform `i` dirty, after writing its components directly.
+ */
+FSLAPI void fsl_transform_soa_dirty_set(fsl_transform_soa *soa, u64 i);
+
+/*!
+ *  @brief bake dirty transforms into `dst` and clear their bits.
+ *
+ *  dirty transforms are gathered in chunks, the sines and cosines of a chunk
+ *  come from one @ref fsl_sincos_f32_batch() call, and each matrix is written
+ *  in closed form, no matrix multiplies.
+ *
+ *  @param dst `soa->len` matrices, only entries of dirty transforms are written,
+ *  so `dst` can persist between bakes, e.g. a mapped instance buffer.
+ *
+ *  @return number of transforms baked.
+ */
+FSLAPI u64 fsl_transform_soa_bake(fsl_transform_soa *soa, m4f32 *dst);
+
 /*!
  *  @brief initialize a physics material.
  */
@@ -30,10 +30,28 @@
 #include "h/dir.h"
 #include "h/process.h"
 
+#include <fcntl.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <errno.h>
+#include <poll.h>
+#include <spawn.h>
+
+/*!
+ *  @internal
+ *
+ *  @brief read what's available from `x->fd_out` into `x->out`, close it on end of file.
+ *
+ *  @param wait if `TRUE`, block until end of file.
+ */
+static void process_drain_internal(fsl_process *x, b8 wait);
 
 u32 fsl_get_path_absolute_internal(const fsl_fs_path *path, str *dst)
 {
@@ -64,75 +82,234 @@ u32 fsl_get_path_bin_root_internal(str *dst)
 
 u32 fsl_exec(fsl_buf *cmd, str *cmd_name)
 {
-    pid_t pid = fork();
-    int status = 0;
-    int exit_code = 0;
-    int sig = 0;
+    fsl_process process = {0};
+
+    if (fsl_spawn(&process, cmd, cmd_name, 0) != FSL_ERR_SUCCESS)
+        return fsl_err;
 
-    if (!cmd->loaded || !cmd->buf)
+    fsl_process_poll(&process, TRUE);
+    fsl_process_free(&process);
+    fsl_err = process.result;
+    return fsl_err;
+}
+
+u32 fsl_spawn(fsl_process *x, fsl_buf *cmd, const str *cmd_name, u32 flags)
+{
+    fsl_process noprocess = {0};
+    posix_spawn_file_actions_t actions;
+    int pipe_fd[2] = {-1, -1};
+    pid_t pid = 0;
+    int result = 0;
+
+    if (!x || !cmd || !cmd->loaded || !cmd->buf)
     {
         LOGERROR(FSL_ERR_BUFFER_EMPTY, 0,
                 MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`cmd` Empty"));
         return fsl_err;
     }
 
-    if (pid < 0)
+    *x = noprocess;
+    x->fd_out = -1;
+    snprintf(x->name, FSL_ID_CAP, "%s", cmd_name);
+
+    posix_spawn_file_actions_init(&actions);
+
+    if (flags & (FSL_FLAG_SPAWN_CAPTURE_STDOUT | FSL_FLAG_SPAWN_CAPTURE_STDERR))
     {
-        LOGERROR(FSL_ERR_PROCESS_FORK_FAIL, 0,
-                MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`fork()` Failed"));
-        return fsl_err;
+        if (pipe2(pipe_fd, O_CLOEXEC) != 0)
+        {
+            posix_spawn_file_actions_destroy(&actions);
+            LOGERROR(FSL_ERR_PROCESS_FORK_FAIL, 0,
+                    MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`pipe2()` Failed"));
+            return fsl_err;
+        }
+
+        /* `dup2()` clears `O_CLOEXEC` on the child's copies only */
+        if (flags & FSL_FLAG_SPAWN_CAPTURE_STDOUT)
+            posix_spawn_file_actions_adddup2(&actions, pipe_fd[1], STDOUT_FILENO);
+        if (flags & FSL_FLAG_SPAWN_CAPTURE_STDERR)
+            posix_spawn_file_actions_adddup2(&actions, pipe_fd[1], STDERR_FILENO);
     }
-    else if (pid == 0)
+
+    /* glibc spawns with `clone(CLONE_VM | CLONE_VFORK)`, and reports `exec` failures here */
+    result = posix_spawnp(&pid, (const str*)cmd->i[0], &actions, NULL, (str *const *)cmd->i, environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (pipe_fd[1] >= 0)
+        close(pipe_fd[1]);
+
+    if (result != 0)
     {
-        execvp((const str*)cmd->i[0], (str *const *)cmd->i);
+        if (pipe_fd[0] >= 0)
+            close(pipe_fd[0]);
         LOGERROR(FSL_ERR_EXEC_FAIL, 0,
-                MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`execvp()` Failed"));
+                MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`posix_spawnp()` Failed"));
         return fsl_err;
     }
 
-    if (waitpid(pid, &status, 0) == -1)
+    if (pipe_fd[0] >= 0)
+        fcntl(pipe_fd[0], F_SETFL, O_NONBLOCK);
+
+    x->pid = pid;
+    x->fd_out = pipe_fd[0];
+    x->state = FSL_PROCESS_STATE_RUNNING;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+b8 fsl_process_poll(fsl_process *x, b8 wait)
+{
+    int status = 0;
+    pid_t result = 0;
+
+    if (!x || x->state != FSL_PROCESS_STATE_RUNNING)
+        return x && x->state == FSL_PROCESS_STATE_DONE;
+
+    /* drain before a blocking `waitpid()`, a child blocked on a full pipe never exits */
+    if (x->fd_out >= 0)
+        process_drain_internal(x, wait);
+
+    do result = waitpid((pid_t)x->pid, &status, wait ? 0 : WNOHANG);
+    while (result < 0 && errno == EINTR);
+
+    if (result == 0)
+        return FALSE;
+
+    if (x->fd_out >= 0)
+    {
+        process_drain_internal(x, FALSE);
+        close(x->fd_out);
+        x->fd_out = -1;
+    }
+
+    x->state = FSL_PROCESS_STATE_DONE;
+
+    if (result < 0)
     {
         LOGERROR(FSL_ERR_WAITPID_FAIL, 0,
-                MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`waitpid()` Failed"));
-        return fsl_err;
+                MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", x->name, "`waitpid()` Failed"));
+        x->result = fsl_err;
+        return TRUE;
     }
 
     if (WIFEXITED(status))
     {
-        exit_code = WEXITSTATUS(status);
-        if (exit_code == 0)
+        x->exit_code = WEXITSTATUS(status);
+        if (x->exit_code == 0)
+        {
             LOGSUCCESS(FSL_FLAG_LOG_NO_VERBOSE,
-                    MSG_EXEC(cmd_name, exit_code));
+                    MSG_EXEC(x->name, x->exit_code));
+            fsl_err = FSL_ERR_SUCCESS;
+        }
         else
         {
             LOGDEBUG(FSL_FLAG_LOG_NO_VERBOSE,
-                    MSG_EXEC(cmd_name, exit_code));
+                    MSG_EXEC(x->name, x->exit_code));
             fsl_err = FSL_ERR_EXEC_PROCESS_NON_ZERO;
-            return fsl_err;
         }
     }
     else if (WIFSIGNALED(status))
     {
-        sig = WTERMSIG(status);
+        x->exit_code = WTERMSIG(status);
         LOGERROR(FSL_ERR_EXEC_SIGTERM, 0,
-                MSG_EXEC_SIGTERM(cmd_name, sig));
-        return fsl_err;
+                MSG_EXEC_SIGTERM(x->name, x->exit_code));
     }
     else
     {
         LOGERROR(FSL_ERR_EXEC_ABNORMAL_EXIT, 0,
-                MSG_EXEC_ABNORMAL_EXIT(cmd_name));
-        return fsl_err;
+                MSG_EXEC_ABNORMAL_EXIT(x->name));
     }
 
-    fsl_err = FSL_ERR_SUCCESS;
-    return fsl_err;
+    x->result = fsl_err;
+    return TRUE;
+}
+
+void fsl_process_free(fsl_process *x)
+{
+    fsl_process noprocess = {0};
+
+    if (!x)
+        return;
+
+    if (x->state == FSL_PROCESS_STATE_RUNNING)
+        fsl_process_poll(x, TRUE);
+
+    if (x->fd_out >= 0)
+        close(x->fd_out);
+
+    if (x->out)
+        fsl_mem_free((void*)&x->out, x->out_cap, "fsl_process_free().x->out");
+
+    noprocess.result = x->result;
+    noprocess.exit_code = x->exit_code;
+    noprocess.state = x->state == FSL_PROCESS_STATE_DONE ? FSL_PROCESS_STATE_DONE : FSL_PROCESS_STATE_IDLE;
+    noprocess.fd_out = -1;
+    *x = noprocess;
+}
+
+static void process_drain_internal(fsl_process *x, b8 wait)
+{
+    struct pollfd pfd = {0};
+    i64 len = 0;
+
+    pfd.fd = x->fd_out;
+    pfd.events = POLLIN;
+
+    for (;;)
+    {
+        if (x->out_cap - x->out_len < 2)
+        {
+            if (!x->out)
+            {
+                if (fsl_mem_alloc((void*)&x->out, FSL_PROCESS_OUT_CAP_MIN,
+                            "fsl_process_poll().x->out") != FSL_ERR_SUCCESS)
+                    return;
+                x->out_cap = FSL_PROCESS_OUT_CAP_MIN;
+            }
+            else
+            {
+                if (fsl_mem_realloc((void*)&x->out, x->out_cap * 2,
+                            "fsl_process_poll().x->out") != FSL_ERR_SUCCESS)
+                    return;
+                x->out_cap *= 2;
+            }
+        }
+
+        len = read(x->fd_out, x->out + x->out_len, x->out_cap - x->out_len - 1);
+        if (len > 0)
+        {
+            x->out_len += len;
+            x->out[x->out_len] = 0;
+            continue;
+        }
+
+        if (len == 0)
+        {
+            close(x->fd_out);
+            x->fd_out = -1;
+            return;
+        }
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno != EAGAIN || !wait || poll(&pfd, 1, -1) < 0)
+            return;
+    }
 }
 
 u32 fsl_mem_map_internal(void **x, u64 size,
         const str *name, const str *file, u64 line)
 {
-    void *temp = NULL;
+    return fsl_mem_map_ex_internal(x, size, 0, name, file, line);
+}
+
+u32 fsl_mem_map_ex_internal(void **x, u64 size, u32 flags,
+        const str *name, const str *file, u64 line)
+{
+    void *temp = MAP_FAILED;
+    int map_flags = MAP_PRIVATE | MAP_ANONYMOUS;
 
     if (!x)
     {
@@ -157,14 +334,37 @@ u32 fsl_mem_map_internal(void **x, u64 size,
         return fsl_err;
     }
 
-    temp = mmap(NULL, size,
-            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
+    if (flags & FSL_FLAG_MEM_MAP_POPULATE)
+        map_flags |= MAP_POPULATE;
+
+    /* reserved huge pages are usually not configured, so fall back quietly */
+    if ((flags & FSL_FLAG_MEM_MAP_HUGE_TLB) && size % FSL_MEM_HUGE_PAGE_SIZE == 0)
+    {
+        temp = mmap(NULL, size,
+                PROT_READ | PROT_WRITE, map_flags | MAP_HUGETLB, -1, 0);
+        if (temp == MAP_FAILED)
+            LOGTRACEEX(0,
+                    file, line,
+                    MSG_MEM_MAP_FALLBACK(name, size, "`MAP_HUGETLB` Failed"));
+    }
+
     if (temp == MAP_FAILED)
     {
-        LOGERROREX(FSL_ERR_MEM_MAP_FAIL, 0,
-                file, line,
-                MSG_MEM_MAP_REASON_FAIL(name, *x, size, "`mmap()` Failed"));
-        return fsl_err;
+        temp = mmap(NULL, size,
+                PROT_READ | PROT_WRITE, map_flags, -1, 0);
+        if (temp == MAP_FAILED)
+        {
+            LOGERROREX(FSL_ERR_MEM_MAP_FAIL, 0,
+                    file, line,
+                    MSG_MEM_MAP_REASON_FAIL(name, *x, size, "`mmap()` Failed"));
+            return fsl_err;
+        }
+
+        if ((flags & (FSL_FLAG_MEM_MAP_HUGE_PAGE | FSL_FLAG_MEM_MAP_HUGE_TLB)) &&
+                madvise(temp, size, MADV_HUGEPAGE) != 0)
+            LOGTRACEEX(0,
+                    file, line,
+                    MSG_MEM_MAP_FALLBACK(name, size, "`madvise(MADV_HUGEPAGE)` Failed"));
     }
 
     LOGTRACEEX(0,
@@ -264,3 +464,320 @@ void fsl_mem_arena_free_internal(fsl_mem_arena *x,
     munmap(x->entry, x->entry_cap);
     *x = nomem_arena;
 }
+
+u32 fsl_file_map(const fsl_fs_path *path, void **dst, u64 *size, u32 flags)
+{
+    struct stat stats = {0};
+    void *temp = MAP_FAILED;
+    int fd = -1;
+
+    if (!dst || !size)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "Pointer `NULL`"));
+        return fsl_err;
+    }
+
+    if (*dst)
+    {
+        LOGERROR(FSL_ERR_POINTER_NOT_NULL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "Pointer Not `NULL`"));
+        return fsl_err;
+    }
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+    {
+        LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0,
+                MSG_FILE_OPEN_FAIL(path));
+        return fsl_err;
+    }
+
+    if (fstat(fd, &stats) != 0)
+    {
+        LOGERROR(FSL_ERR_FILE_STAT_FAIL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "`fstat()` Failed"));
+        goto cleanup;
+    }
+
+    if (!S_ISREG(stats.st_mode))
+    {
+        LOGERROR(FSL_ERR_IS_NOT_FILE, 0,
+                MSG_IS_NOT_FILE(path));
+        goto cleanup;
+    }
+
+    if (stats.st_size == 0)
+    {
+        LOGERROR(FSL_ERR_SIZE_TOO_SMALL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "File Empty"));
+        goto cleanup;
+    }
+
+    temp = mmap(NULL, stats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (temp == MAP_FAILED)
+    {
+        LOGERROR(FSL_ERR_MEM_MAP_FAIL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "`mmap()` Failed"));
+        goto cleanup;
+    }
+
+    /* the mapping keeps its own reference to the file */
+    close(fd);
+
+    /* hints only, mapping is usable either way */
+    if (flags & FSL_FLAG_FILE_MAP_SEQUENTIAL)
+        madvise(temp, stats.st_size, MADV_SEQUENTIAL);
+    else if (flags & FSL_FLAG_FILE_MAP_RANDOM)
+        madvise(temp, stats.st_size, MADV_RANDOM);
+    if (flags & FSL_FLAG_FILE_MAP_WILLNEED)
+        madvise(temp, stats.st_size, MADV_WILLNEED);
+
+    LOGTRACE(0,
+            MSG_FILE_MAP(path, temp, (u64)stats.st_size));
+
+    *dst = temp;
+    *size = stats.st_size;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    close(fd);
+    return fsl_err;
+}
+
+void fsl_file_unmap(void **x, u64 size)
+{
+    if (!x || !*x)
+        return;
+
+    LOGTRACE(0,
+            MSG_FILE_UNMAP(*x, size));
+
+    munmap(*x, size);
+    *x = NULL;
+}
+
+u32 fsl_copy_file_kernel_internal(int fd_in, int fd_out, u64 size, u64 *len,
+        const fsl_fs_path *src, const fsl_fs_path *dst)
+{
+    ssize_t result = 0;
+
+    *len = 0;
+
+    /* reflinks and server-side copies, no user-space copy */
+    while (*len < size)
+    {
+        result = copy_file_range(fd_in, NULL, fd_out, NULL, size - *len, 0);
+        if (result <= 0)
+            break;
+        *len += result;
+    }
+
+    /* zero means the file shrank, the caller's read loop finds its end */
+    if (*len >= size || result == 0)
+        goto done;
+
+    if (errno != ENOSYS && errno != EXDEV && errno != EINVAL &&
+            errno != EOPNOTSUPP && errno != EBADF && errno != EPERM)
+        goto cleanup;
+
+    LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
+            MSG_FILE_COPY_FALLBACK(src, dst, "`copy_file_range()` Unsupported"));
+
+    while (*len < size)
+    {
+        result = sendfile(fd_out, fd_in, NULL, size - *len);
+        if (result <= 0)
+            break;
+        *len += result;
+    }
+
+    if (*len >= size || result == 0)
+        goto done;
+
+    if (errno != ENOSYS && errno != EINVAL)
+        goto cleanup;
+
+    LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
+            MSG_FILE_COPY_FALLBACK(src, dst, "`sendfile()` Unsupported"));
+
+done:
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    LOGERROR(FSL_ERR_FILE_COPY_FAIL, 0,
+            MSG_FILE_COPY_REASON_FAIL(src, dst, strerror(errno)));
+    return fsl_err;
+}
+
+int fsl_file_open_at_internal(const fsl_dir_handle *dir, const str *name, int flags, u32 mode)
+{
+    return openat(dir ? dir->fd : AT_FDCWD, name, flags | O_CLOEXEC, (mode_t)mode);
+}
+
+void fsl_file_mode_copy_at_internal(const fsl_dir_handle *dir, const str *name, int fd)
+{
+    struct stat stats = {0};
+
+    /* the mode given to `open()` is masked by the umask, set it after */
+    if (fstatat(dir ? dir->fd : AT_FDCWD, name, &stats, 0) == 0)
+        fchmod(fd, stats.st_mode & 07777);
+}
+
+u32 fsl_file_flush_internal(int fd, b8 wait)
+{
+    if (!wait)
+    {
+        sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+        fsl_err = FSL_ERR_SUCCESS;
+        return fsl_err;
+    }
+
+    fsl_err = fdatasync(fd) == 0 ? FSL_ERR_SUCCESS : FSL_ERR_FILE_WRITE_FAIL;
+    return fsl_err;
+}
+
+u32 fsl_file_rename_at_internal(const fsl_dir_handle *dir, const str *src, const str *dst)
+{
+    int dir_fd = dir ? dir->fd : AT_FDCWD;
+
+    fsl_err = renameat(dir_fd, src, dir_fd, dst) == 0 ? FSL_ERR_SUCCESS : FSL_ERR_FILE_WRITE_FAIL;
+    return fsl_err;
+}
+
+u32 fsl_file_remove_at_internal(const fsl_dir_handle *dir, const str *name)
+{
+    fsl_err = unlinkat(dir ? dir->fd : AT_FDCWD, name, 0) == 0 ?
+        FSL_ERR_SUCCESS : FSL_ERR_FILE_WRITE_FAIL;
+    return fsl_err;
+}
+
+u32 fsl_dir_sync_at_internal(const fsl_dir_handle *dir, const str *name)
+{
+    int fd = openat(dir ? dir->fd : AT_FDCWD, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (fd < 0 || fsync(fd) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        fsl_err = FSL_ERR_FILE_WRITE_FAIL;
+        return fsl_err;
+    }
+
+    close(fd);
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+u32 fsl_dir_handle_open(fsl_dir_handle *x, const fsl_fs_path *path, u32 flags, b8 log)
+{
+    str parent[FSL_PATH_CAP] = {0};
+
+    if (!x || !path)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Open Directory"));
+        return fsl_err;
+    }
+
+    fsl_dir_handle_close(x);
+
+    x->fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (x->fd < 0)
+    {
+        if (log)
+            LOGERROR(FSL_ERR_DIR_OPEN_FAIL, 0,
+                    MSG_ACTION_SUBJECT_ERROR("Open Directory", path));
+        else
+            fsl_err = FSL_ERR_DIR_OPEN_FAIL;
+        return fsl_err;
+    }
+
+    snprintf(x->path, FSL_PATH_CAP, "%s", path);
+    fsl_check_slash(x->path);
+    if (flags & FSL_FLAG_DIR_HANDLE_SWEEP_TEMP)
+        fsl_write_temp_sweep_internal(x);
+
+    /* watch the parent, the directory's own `IN_DELETE_SELF` only fires once
+     * its last reference is gone, and `x->fd` is one */
+    snprintf(parent, FSL_PATH_CAP, "%s..", x->path);
+    x->watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (x->watch_fd >= 0 &&
+            inotify_add_watch(x->watch_fd, parent,
+                IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR) < 0)
+    {
+        close(x->watch_fd);
+        x->watch_fd = -1;
+    }
+
+    if (x->watch_fd < 0)
+        LOGTRACE(0,
+                MSG_DIR_WATCH_FALLBACK(path));
+    x->loaded = TRUE;
+    x->valid = TRUE;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+b8 fsl_dir_handle_is_valid(fsl_dir_handle *x)
+{
+    u64 buf[(sizeof(struct inotify_event) + FSL_PATH_CAP) / sizeof(u64)];
+    struct inotify_event *event = NULL;
+    struct stat stats = {0};
+    str name[FSL_PATH_CAP] = {0};
+    str *cursor = NULL;
+    i64 len = 0;
+    i64 i = 0;
+
+    if (!x || !x->loaded || !x->valid)
+        return FALSE;
+
+    if (x->watch_fd < 0)
+    {
+        if (fstat(x->fd, &stats) != 0 || !stats.st_nlink)
+            x->valid = FALSE;
+        return x->valid;
+    }
+
+    /* events are rare (siblings changing), the common case is one `read()` hitting `EAGAIN` */
+    while ((len = read(x->watch_fd, buf, sizeof(buf))) > 0)
+    {
+        if (!*name)
+        {
+            /* last component of `x->path`, without its trailing slash */
+            snprintf(name, FSL_PATH_CAP, "%s", x->path);
+            name[strlen(name) - 1] = 0;
+            cursor = strrchr(name, '/');
+            if (cursor)
+                memmove(name, cursor + 1, strlen(cursor));
+        }
+
+        for (i = 0; i < len; i += sizeof(struct inotify_event) + event->len)
+        {
+            event = (struct inotify_event*)((u8*)buf + i);
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED | IN_Q_OVERFLOW) ||
+                    (event->len && !strcmp(event->name, name)))
+                x->valid = FALSE;
+        }
+    }
+
+    return x->valid;
+}
+
+void fsl_dir_handle_close(fsl_dir_handle *x)
+{
+    if (!x || !x->loaded)
+        return;
+
+    if (x->watch_fd >= 0)
+        close(x->watch_fd);
+    close(x->fd);
+    memset(x, 0, sizeof(*x));
+}
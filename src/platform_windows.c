@@ -31,10 +31,24 @@
 #include "h/dir.h"
 #include "h/process.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <windows.h>
 #include <direct.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+
+/*!
+ *  @internal
+ *
+ *  @brief join `name` onto the path of `dir` into `dst`, `name` alone if `dir` is
+ *  `NULL` or `name` is absolute.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+static u32 path_at_internal(const fsl_dir_handle *dir, const str *name, str *dst);
 
 u32 fsl_get_path_absolute_internal(const fsl_fs_path *fs_path, str *dst)
 {
@@ -70,68 +84,209 @@ u32 fsl_get_path_bin_root_internal(str *dst)
 
 u32 fsl_exec(fsl_buf *cmd, str *cmd_name)
 {
+    fsl_process process = {0};
+
+    if (fsl_spawn(&process, cmd, cmd_name, 0) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    fsl_process_poll(&process, TRUE);
+    fsl_process_free(&process);
+    fsl_err = process.result;
+    return fsl_err;
+}
+
+u32 fsl_spawn(fsl_process *x, fsl_buf *cmd, const str *cmd_name, u32 flags)
+{
+    fsl_process noprocess = {0};
     STARTUPINFOA startup_info = {0};
     PROCESS_INFORMATION process_info = {0};
-    DWORD exit_code = 0;
+    SECURITY_ATTRIBUTES security = {0};
+    HANDLE pipe_read = NULL;
+    HANDLE pipe_write = NULL;
     str *cmd_cat = NULL;
     u32 i = 0;
+    BOOL result = FALSE;
 
-    ZeroMemory(&startup_info, sizeof(startup_info));
-    startup_info.cb = sizeof(startup_info);
-
-    if (!cmd->loaded || !cmd->buf)
+    if (!x || !cmd || !cmd->loaded || !cmd->buf)
     {
         LOGERROR(FSL_ERR_BUFFER_EMPTY, 0,
                 MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`cmd` Empty"));
         return fsl_err;
     }
 
+    *x = noprocess;
+    x->fd_out = -1;
+    snprintf(x->name, FSL_ID_CAP, "%s", cmd_name);
+
+    ZeroMemory(&startup_info, sizeof(startup_info));
+    startup_info.cb = sizeof(startup_info);
+
+    if (flags & (FSL_FLAG_SPAWN_CAPTURE_STDOUT | FSL_FLAG_SPAWN_CAPTURE_STDERR))
+    {
+        security.nLength = sizeof(security);
+        security.bInheritHandle = TRUE;
+        if (!CreatePipe(&pipe_read, &pipe_write, &security, 0))
+        {
+            LOGERROR(FSL_ERR_PROCESS_FORK_FAIL, 0,
+                    MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`CreatePipe()` Failed"));
+            return fsl_err;
+        }
+        SetHandleInformation(pipe_read, HANDLE_FLAG_INHERIT, 0);
+
+        startup_info.dwFlags |= STARTF_USESTDHANDLES;
+        startup_info.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        startup_info.hStdOutput = flags & FSL_FLAG_SPAWN_CAPTURE_STDOUT ?
+            pipe_write : GetStdHandle(STD_OUTPUT_HANDLE);
+        startup_info.hStdError = flags & FSL_FLAG_SPAWN_CAPTURE_STDERR ?
+            pipe_write : GetStdHandle(STD_ERROR_HANDLE);
+    }
+
     if (fsl_mem_alloc((void*)&cmd_cat, cmd->size * cmd->memb,
             stringf_internal("exec().%s", cmd_name)) != FSL_ERR_SUCCESS)
-        return fsl_err;
+        goto cleanup;
 
-    for (i = 0; i < cmd->memb; ++i)
+    for (i = 0; i < cmd->memb && cmd->i[i]; ++i)
         strncat(cmd_cat, stringf_internal("%s ", cmd->i[i]), cmd->size);
 
-    if(!CreateProcessA(NULL, cmd_cat, NULL, NULL, FALSE, 0, NULL, NULL,
-                &startup_info, &process_info))
+    result = CreateProcessA(NULL, cmd_cat, NULL, NULL, pipe_write != NULL, 0, NULL, NULL,
+            &startup_info, &process_info);
+    fsl_mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf_internal("exec().%s", cmd_name));
+
+    if (!result)
     {
-        LOGFATAL(FSL_ERR_PROCESS_FORK_FAIL, 0,
+        LOGERROR(FSL_ERR_PROCESS_FORK_FAIL, 0,
                 MSG_ACTION_SUBJECT_REASON_ERROR("Execute CMD", cmd_name, "`CreateProcessA()` Failed"));
         goto cleanup;
     }
 
-    WaitForSingleObject(process_info.hProcess, INFINITE);
-    GetExitCodeProcess(process_info.hProcess, &exit_code);
-    CloseHandle(process_info.hProcess);
+    if (pipe_write)
+        CloseHandle(pipe_write);
     CloseHandle(process_info.hThread);
 
+    x->pid = process_info.dwProcessId;
+    x->handle = process_info.hProcess;
+    x->pipe_out = pipe_read;
+    x->state = FSL_PROCESS_STATE_RUNNING;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    if (pipe_read)
+        CloseHandle(pipe_read);
+    if (pipe_write)
+        CloseHandle(pipe_write);
+    return fsl_err;
+}
+
+b8 fsl_process_poll(fsl_process *x, b8 wait)
+{
+    DWORD exit_code = 0;
+    DWORD available = 0;
+    DWORD len = 0;
+
+    if (!x || x->state != FSL_PROCESS_STATE_RUNNING)
+        return x && x->state == FSL_PROCESS_STATE_DONE;
+
+    /* drain before waiting, a child blocked on a full pipe never exits */
+    while (x->pipe_out)
+    {
+        if (!PeekNamedPipe(x->pipe_out, NULL, 0, NULL, &available, NULL))
+        {
+            CloseHandle(x->pipe_out);
+            x->pipe_out = NULL;
+            break;
+        }
+
+        if (!available)
+        {
+            if (!wait)
+                break;
+            if (WaitForSingleObject(x->handle, 1) == WAIT_OBJECT_0)
+                wait = FALSE; /* exited, take what's left and stop */
+            continue;
+        }
+
+        if (x->out_cap - x->out_len < available + 1)
+        {
+            while (x->out_cap - x->out_len < available + 1)
+                x->out_cap = x->out_cap ? x->out_cap * 2 : FSL_PROCESS_OUT_CAP_MIN;
+            if ((x->out ? fsl_mem_realloc((void*)&x->out, x->out_cap, "fsl_process_poll().x->out") :
+                        fsl_mem_alloc((void*)&x->out, x->out_cap, "fsl_process_poll().x->out")) != FSL_ERR_SUCCESS)
+                break;
+        }
+
+        if (!ReadFile(x->pipe_out, x->out + x->out_len, available, &len, NULL))
+            break;
+        x->out_len += len;
+        x->out[x->out_len] = 0;
+    }
+
+    if (WaitForSingleObject(x->handle, wait ? INFINITE : 0) != WAIT_OBJECT_0)
+        return FALSE;
+
+    GetExitCodeProcess(x->handle, &exit_code);
+    CloseHandle(x->handle);
+    x->handle = NULL;
+    if (x->pipe_out)
+    {
+        CloseHandle(x->pipe_out);
+        x->pipe_out = NULL;
+    }
+
+    x->state = FSL_PROCESS_STATE_DONE;
+    x->exit_code = (i32)exit_code;
+
     if (exit_code == 0)
+    {
         LOGSUCCESS(FSL_FLAG_LOG_NO_VERBOSE,
-                MSG_EXEC(cmd_name, exit_code));
+                MSG_EXEC(x->name, x->exit_code));
+        fsl_err = FSL_ERR_SUCCESS;
+    }
     else
     {
         LOGDEBUG(FSL_FLAG_LOG_NO_VERBOSE,
-                MSG_EXEC(cmd_name, exit_code));
+                MSG_EXEC(x->name, x->exit_code));
         fsl_err = FSL_ERR_EXEC_PROCESS_NON_ZERO;
-        goto cleanup;
     }
 
-    fsl_mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf("exec().%s", cmd_name));
+    x->result = fsl_err;
+    return TRUE;
+}
 
-    fsl_err = FSL_ERR_SUCCESS;
-    return fsl_err;
+void fsl_process_free(fsl_process *x)
+{
+    fsl_process noprocess = {0};
 
-cleanup:
+    if (!x)
+        return;
 
-    fsl_mem_free((void*)&cmd_cat, cmd->memb * cmd->size, stringf("exec().%s", cmd_name));
-    return fsl_err;
+    if (x->state == FSL_PROCESS_STATE_RUNNING)
+        fsl_process_poll(x, TRUE);
+
+    if (x->out)
+        fsl_mem_free((void*)&x->out, x->out_cap, "fsl_process_free().x->out");
+
+    noprocess.result = x->result;
+    noprocess.exit_code = x->exit_code;
+    noprocess.state = x->state == FSL_PROCESS_STATE_DONE ? FSL_PROCESS_STATE_DONE : FSL_PROCESS_STATE_IDLE;
+    noprocess.fd_out = -1;
+    *x = noprocess;
 }
 
 u32 fsl_mem_map_internal(void **x, u64 size,
         const str *name, const str *file, u64 line)
+{
+    return fsl_mem_map_ex_internal(x, size, 0, name, file, line);
+}
+
+u32 fsl_mem_map_ex_internal(void **x, u64 size, u32 flags,
+        const str *name, const str *file, u64 line)
 {
     void *temp = NULL;
+    u64 large_page_size = 0;
+    u64 i = 0;
 
     if (!x)
     {
@@ -148,13 +303,36 @@ u32 fsl_mem_map_internal(void **x, u64 size,
         return fsl_err;
     }
 
-    temp = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    /* large pages need 'SeLockMemoryPrivilege', without it fall back quietly */
+    if (flags & FSL_FLAG_MEM_MAP_HUGE_TLB)
+    {
+        large_page_size = (u64)GetLargePageMinimum();
+        if (large_page_size && size % large_page_size == 0)
+        {
+            temp = VirtualAlloc(NULL, size,
+                    MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (!temp)
+                LOGTRACEEX(0,
+                        file, line,
+                        MSG_MEM_MAP_FALLBACK(name, size, "`VirtualAlloc(MEM_LARGE_PAGES)` Failed"));
+        }
+    }
+
     if (!temp)
     {
-        LOGERROREX(FSL_ERR_MEM_MAP_FAIL, 0,
-                file, line,
-                MSG_MEM_MAP_REASON_FAIL(name, *x, size, "`VirtualAlloc()` Failed"));
-        return fsl_err;
+        temp = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (!temp)
+        {
+            LOGERROREX(FSL_ERR_MEM_MAP_FAIL, 0,
+                    file, line,
+                    MSG_MEM_MAP_REASON_FAIL(name, *x, size, "`VirtualAlloc()` Failed"));
+            return fsl_err;
+        }
+
+        /* no transparent huge pages here, @ref FSL_FLAG_MEM_MAP_HUGE_PAGE is advisory only */
+        if (flags & FSL_FLAG_MEM_MAP_POPULATE)
+            for (i = 0; i < size; i += 4096)
+                ((volatile u8*)temp)[i] = 0;
     }
 
     LOGTRACEEX(0,
@@ -255,3 +433,243 @@ void fsl_mem_arena_free_internal(fsl_mem_arena *x,
     VirtualFree(x->entry, 0, MEM_RELEASE);
     *x = nomem_arena;
 }
+
+u32 fsl_file_map(const fsl_fs_path *path, void **dst, u64 *size, u32 flags)
+{
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    LARGE_INTEGER file_size = {0};
+    DWORD access_hint = 0;
+    void *temp = NULL;
+
+    if (!dst || !size)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "Pointer `NULL`"));
+        return fsl_err;
+    }
+
+    if (*dst)
+    {
+        LOGERROR(FSL_ERR_POINTER_NOT_NULL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "Pointer Not `NULL`"));
+        return fsl_err;
+    }
+
+    if (flags & FSL_FLAG_FILE_MAP_SEQUENTIAL)
+        access_hint = FILE_FLAG_SEQUENTIAL_SCAN;
+    else if (flags & FSL_FLAG_FILE_MAP_RANDOM)
+        access_hint = FILE_FLAG_RANDOM_ACCESS;
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | access_hint, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0,
+                MSG_FILE_OPEN_FAIL(path));
+        return fsl_err;
+    }
+
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        LOGERROR(FSL_ERR_FILE_STAT_FAIL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "`GetFileSizeEx()` Failed"));
+        goto cleanup;
+    }
+
+    if (file_size.QuadPart == 0)
+    {
+        LOGERROR(FSL_ERR_SIZE_TOO_SMALL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "File Empty"));
+        goto cleanup;
+    }
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+        temp = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!temp)
+    {
+        LOGERROR(FSL_ERR_MEM_MAP_FAIL, 0,
+                MSG_FILE_MAP_REASON_FAIL(path, "`MapViewOfFile()` Failed"));
+        goto cleanup;
+    }
+
+    /* the view keeps its own references to the file and mapping */
+    CloseHandle(mapping);
+    CloseHandle(file);
+
+    LOGTRACE(0,
+            MSG_FILE_MAP(path, temp, (u64)file_size.QuadPart));
+
+    *dst = temp;
+    *size = (u64)file_size.QuadPart;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    if (mapping)
+        CloseHandle(mapping);
+    CloseHandle(file);
+    return fsl_err;
+}
+
+void fsl_file_unmap(void **x, u64 size)
+{
+    if (!x || !*x)
+        return;
+
+    LOGTRACE(0,
+            MSG_FILE_UNMAP(*x, size));
+
+    UnmapViewOfFile(*x);
+    *x = NULL;
+}
+
+u32 fsl_copy_file_kernel_internal(int fd_in, int fd_out, u64 size, u64 *len,
+        const fsl_fs_path *src, const fsl_fs_path *dst)
+{
+    (void)fd_in;
+    (void)fd_out;
+    (void)size;
+    (void)src;
+    (void)dst;
+
+    /* no kernel-side copy between descriptors, the caller's read loop copies it all */
+    *len = 0;
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+int fsl_file_open_at_internal(const fsl_dir_handle *dir, const str *name, int flags, u32 mode)
+{
+    str path[FSL_PATH_CAP] = {0};
+
+    if (path_at_internal(dir, name, path) != FSL_ERR_SUCCESS)
+        return -1;
+
+    /* only the owner's write bit means anything, it clears the read-only attribute */
+    return _open(path, flags | _O_BINARY, _S_IREAD | (mode & 0200 ? _S_IWRITE : 0));
+}
+
+void fsl_file_mode_copy_at_internal(const fsl_dir_handle *dir, const str *name, int fd)
+{
+    (void)dir;
+    (void)name;
+    (void)fd;
+}
+
+u32 fsl_file_flush_internal(int fd, b8 wait)
+{
+    HANDLE file = (HANDLE)_get_osfhandle(fd);
+
+    if (!wait)
+    {
+        fsl_err = FSL_ERR_SUCCESS;
+        return fsl_err;
+    }
+
+    fsl_err = file != INVALID_HANDLE_VALUE && FlushFileBuffers(file) ?
+        FSL_ERR_SUCCESS : FSL_ERR_FILE_WRITE_FAIL;
+    return fsl_err;
+}
+
+u32 fsl_file_rename_at_internal(const fsl_dir_handle *dir, const str *src, const str *dst)
+{
+    str path_src[FSL_PATH_CAP] = {0};
+    str path_dst[FSL_PATH_CAP] = {0};
+
+    if (path_at_internal(dir, src, path_src) != FSL_ERR_SUCCESS ||
+            path_at_internal(dir, dst, path_dst) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    /* write through, so the rename is on disk when it returns, there's no directory flush */
+    fsl_err = MoveFileExA(path_src, path_dst, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ?
+        FSL_ERR_SUCCESS : FSL_ERR_FILE_WRITE_FAIL;
+    return fsl_err;
+}
+
+u32 fsl_file_remove_at_internal(const fsl_dir_handle *dir, const str *name)
+{
+    str path[FSL_PATH_CAP] = {0};
+
+    if (path_at_internal(dir, name, path) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    fsl_err = DeleteFileA(path) ? FSL_ERR_SUCCESS : FSL_ERR_FILE_WRITE_FAIL;
+    return fsl_err;
+}
+
+u32 fsl_dir_sync_at_internal(const fsl_dir_handle *dir, const str *name)
+{
+    (void)dir;
+    (void)name;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+u32 fsl_dir_handle_open(fsl_dir_handle *x, const fsl_fs_path *path, u32 flags, b8 log)
+{
+    if (!x || !path)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, 0,
+                MSG_POINTER_NULL_ACTION("Open Directory"));
+        return fsl_err;
+    }
+
+    fsl_dir_handle_close(x);
+
+    if (fsl_is_dir_exists(path, log) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    /* no directory descriptors or inotify, validity falls back to checking the path */
+    x->fd = -1;
+    x->watch_fd = -1;
+    snprintf(x->path, FSL_PATH_CAP, "%s", path);
+    fsl_check_slash(x->path);
+    if (flags & FSL_FLAG_DIR_HANDLE_SWEEP_TEMP)
+        fsl_write_temp_sweep_internal(x);
+    x->loaded = TRUE;
+    x->valid = TRUE;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+b8 fsl_dir_handle_is_valid(fsl_dir_handle *x)
+{
+    DWORD attributes = 0;
+
+    if (!x || !x->loaded || !x->valid)
+        return FALSE;
+
+    attributes = GetFileAttributesA(x->path);
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+        x->valid = FALSE;
+
+    return x->valid;
+}
+
+void fsl_dir_handle_close(fsl_dir_handle *x)
+{
+    if (!x || !x->loaded)
+        return;
+
+    memset(x, 0, sizeof(*x));
+}
+
+static u32 path_at_internal(const fsl_dir_handle *dir, const str *name, str *dst)
+{
+    b8 absolute = name[0] == '/' || name[0] == '\\' || (name[0] && name[1] == ':');
+
+    if (snprintf(dst, FSL_PATH_CAP, "%s%s", dir && !absolute ? dir->path : "", name) >= FSL_PATH_CAP)
+    {
+        fsl_err = FSL_ERR_PATH_TOO_LONG;
+        return fsl_err;
+    }
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
@@ -0,0 +1,584 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file noise_graph.c
+ *
+ *  @brief noise composition graph, compiled into a flat instruction array that is
+ *  evaluated one instruction at a time over a batch of points, so each instruction
+ *  is a tight loop over @ref FSL_NOISE_GRAPH_LANES values instead of a call per node
+ *  per point.
+ */
+
+#include "../../../logger/logger.h"
+#include "../../../logger/logger_messages_internal.h"
+
+#include "../../../common/diagnostics.h"
+
+#include "noise_graph.h"
+
+#include <string.h>
+
+/*
+ *  a graph must compute what the formula it replaces computes as written, bit for bit,
+ *  so no reassociation or reciprocals here, whatever the build optimization level.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC optimize ("no-fast-math")
+#endif
+
+/* inputs read per op, unused inputs are kept at 0 so identical nodes compare equal */
+static const u32 op_arity[FSL_NOISE_OP_COUNT] =
+{
+    0,  /* CONST */
+    0,  /* SOURCE */
+    1,  /* SCALE */
+    1,  /* DIV */
+    1,  /* OFFSET */
+    2,  /* ADD */
+    2,  /* MUL */
+    2,  /* WARP */
+    1,  /* RIDGE */
+    3,  /* BLEND */
+    1,  /* CLAMP */
+    1,  /* FADE */
+    1,  /* SPLINE */
+};
+
+/*!
+ *  @internal
+ *
+ *  @brief push a node, or return the id of an identical one.
+ *
+ *  @return node id or @ref FSL_NOISE_NODE_NONE if an input is invalid or the graph is full.
+ */
+static u32 node_push_internal(fsl_noise_graph *graph, u32 op,
+        u32 a, u32 b, u32 c, u32 index, f64 param_0, f64 param_1);
+
+/*!
+ *  @internal
+ *
+ *  @return TRUE if `a` and `b` compute the same value.
+ */
+static b8 node_equal_internal(const fsl_noise_node *a, const fsl_noise_node *b);
+
+/*!
+ *  @internal
+ *
+ *  @brief evaluate a pure op (not source or warp) on scalar inputs `v`.
+ */
+static f64 op_eval_internal(const fsl_noise_graph *graph, const fsl_noise_node *node, const f64 *v);
+
+/*!
+ *  @internal
+ *
+ *  @brief evaluate a compiled graph for a single point, the batch loops cost more
+ *  than the ops at one lane.
+ */
+static f64 eval_point_internal(const fsl_noise_graph *graph,
+        const fsl_noise_graph_input *input);
+
+/*!
+ *  @internal
+ */
+static f64 fade_internal(f64 t);
+
+/*!
+ *  @internal
+ */
+static f64 spline_eval_internal(const fsl_noise_spline *spline, f64 t);
+
+void fsl_noise_graph_init(fsl_noise_graph *graph)
+{
+    memset(graph, 0, sizeof(*graph));
+}
+
+u32 fsl_noise_graph_const(fsl_noise_graph *graph, f64 value)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_CONST, 0, 0, 0, 0, value, 0.0);
+}
+
+u32 fsl_noise_graph_source(fsl_noise_graph *graph, u32 index)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_SOURCE, 0, 0, 0, index, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_scale(fsl_noise_graph *graph, u32 a, f64 scale)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_SCALE, a, 0, 0, 0, scale, 0.0);
+}
+
+u32 fsl_noise_graph_div(fsl_noise_graph *graph, u32 a, f64 divisor)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_DIV, a, 0, 0, 0, divisor, 0.0);
+}
+
+u32 fsl_noise_graph_offset(fsl_noise_graph *graph, u32 a, f64 offset)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_OFFSET, a, 0, 0, 0, offset, 0.0);
+}
+
+u32 fsl_noise_graph_add(fsl_noise_graph *graph, u32 a, u32 b)
+{
+    /* commutative, ordered so `a + b` and `b + a` share a node */
+    if (a > b && b != FSL_NOISE_NODE_NONE)
+        return node_push_internal(graph, FSL_NOISE_OP_ADD, b, a, 0, 0, 0.0, 0.0);
+    return node_push_internal(graph, FSL_NOISE_OP_ADD, a, b, 0, 0, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_mul(fsl_noise_graph *graph, u32 a, u32 b)
+{
+    if (a > b && b != FSL_NOISE_NODE_NONE)
+        return node_push_internal(graph, FSL_NOISE_OP_MUL, b, a, 0, 0, 0.0, 0.0);
+    return node_push_internal(graph, FSL_NOISE_OP_MUL, a, b, 0, 0, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_warp(fsl_noise_graph *graph, u32 index, u32 dx, u32 dy)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_WARP, dx, dy, 0, index, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_ridge(fsl_noise_graph *graph, u32 a)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_RIDGE, a, 0, 0, 0, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_blend(fsl_noise_graph *graph, u32 a, u32 b, u32 t)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_BLEND, a, b, t, 0, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_clamp(fsl_noise_graph *graph, u32 a, f64 min, f64 max)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_CLAMP, a, 0, 0, 0, min, max);
+}
+
+u32 fsl_noise_graph_fade(fsl_noise_graph *graph, u32 a)
+{
+    return node_push_internal(graph, FSL_NOISE_OP_FADE, a, 0, 0, 0, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_spline(fsl_noise_graph *graph, u32 a,
+        u32 len, const f64 *x, const f64 *y)
+{
+    fsl_noise_spline *spline = NULL;
+    u32 i = 0;
+
+    if (!len || len > FSL_NOISE_GRAPH_SPLINE_POINTS)
+    {
+        LOGERROR(FSL_ERR_OUT_OF_BOUNDS, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_REASON_ERROR("Add Noise Graph Spline", "Point Count Out of Bounds"));
+        return FSL_NOISE_NODE_NONE;
+    }
+
+    /* share identical splines, so identical spline nodes share too */
+    for (i = 0; i < graph->spline_len; ++i)
+    {
+        spline = &graph->spline[i];
+        if (spline->len == len &&
+                !memcmp(spline->x, x, len * sizeof(f64)) &&
+                !memcmp(spline->y, y, len * sizeof(f64)))
+            break;
+    }
+
+    if (i == graph->spline_len)
+    {
+        if (graph->spline_len >= FSL_NOISE_GRAPH_SPLINE_MAX)
+        {
+            LOGERROR(FSL_ERR_BUFFER_FULL, FSL_FLAG_LOG_NO_VERBOSE,
+                    MSG_ACTION_REASON_ERROR("Add Noise Graph Spline", "Graph Full"));
+            return FSL_NOISE_NODE_NONE;
+        }
+
+        spline = &graph->spline[graph->spline_len++];
+        memset(spline, 0, sizeof(*spline));
+        spline->len = len;
+        memcpy(spline->x, x, len * sizeof(f64));
+        memcpy(spline->y, y, len * sizeof(f64));
+    }
+
+    return node_push_internal(graph, FSL_NOISE_OP_SPLINE, a, 0, 0, i, 0.0, 0.0);
+}
+
+u32 fsl_noise_graph_compile(fsl_noise_graph *graph, u32 output)
+{
+    b8 live[FSL_NOISE_GRAPH_NODE_MAX] = {0};
+    u32 reg[FSL_NOISE_GRAPH_NODE_MAX] = {0};
+    f64 v[3] = {0};
+    f64 unit = 0.0;
+    fsl_noise_node ins = {0};
+    fsl_noise_node *code = graph->code;
+    u32 arity = 0;
+    b8 folds = FALSE;
+    u32 i = 0, j = 0, k = 0;
+
+    graph->compiled = FALSE;
+    graph->code_len = 0;
+
+    if (output >= graph->node_len)
+    {
+        LOGERROR(FSL_ERR_OUT_OF_BOUNDS, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_REASON_ERROR("Compile Noise Graph", "Output Node Invalid"));
+        return fsl_err;
+    }
+
+    /* nodes only reference earlier nodes, so one backward pass marks all dependencies */
+    live[output] = TRUE;
+    for (i = output + 1; i--;)
+    {
+        if (!live[i])
+            continue;
+        for (j = 0; j < op_arity[graph->node[i].op]; ++j)
+            live[graph->node[i].in[j]] = TRUE;
+    }
+
+    for (i = 0; i <= output; ++i)
+    {
+        if (!live[i])
+            continue;
+
+        ins = graph->node[i];
+        arity = op_arity[ins.op];
+        folds = ins.op != FSL_NOISE_OP_SOURCE && ins.op != FSL_NOISE_OP_WARP;
+        for (j = 0; j < arity; ++j)
+        {
+            ins.in[j] = reg[ins.in[j]];
+            if (code[ins.in[j]].op == FSL_NOISE_OP_CONST)
+                v[j] = code[ins.in[j]].param[0];
+            else
+                folds = FALSE;
+        }
+
+        if (folds && ins.op != FSL_NOISE_OP_CONST)
+        {
+            ins.param[0] = op_eval_internal(graph, &ins, v);
+            ins.op = FSL_NOISE_OP_CONST;
+            ins.in[0] = ins.in[1] = ins.in[2] = 0;
+            ins.index = 0;
+            ins.param[1] = 0.0;
+        }
+
+        /* identities, the node becomes its input's register */
+        if (((ins.op == FSL_NOISE_OP_SCALE || ins.op == FSL_NOISE_OP_DIV) && ins.param[0] == 1.0) ||
+                (ins.op == FSL_NOISE_OP_OFFSET && ins.param[0] == 0.0))
+        {
+            reg[i] = ins.in[0];
+            continue;
+        }
+        if (ins.op == FSL_NOISE_OP_ADD || ins.op == FSL_NOISE_OP_MUL)
+        {
+            unit = ins.op == FSL_NOISE_OP_ADD ? 0.0 : 1.0;
+            if (code[ins.in[0]].op == FSL_NOISE_OP_CONST && code[ins.in[0]].param[0] == unit)
+            {
+                reg[i] = ins.in[1];
+                continue;
+            }
+            if (code[ins.in[1]].op == FSL_NOISE_OP_CONST && code[ins.in[1]].param[0] == unit)
+            {
+                reg[i] = ins.in[0];
+                continue;
+            }
+        }
+
+        /* folding and identities can make distinct nodes identical */
+        for (j = 0; j < graph->code_len; ++j)
+            if (node_equal_internal(&code[j], &ins))
+                break;
+
+        if (j == graph->code_len)
+            code[graph->code_len++] = ins;
+        reg[i] = j;
+    }
+
+    /* constants only read by folded nodes are dead now, compact them out */
+    memset(live, 0, sizeof(live));
+    live[reg[output]] = TRUE;
+    for (i = graph->code_len; i--;)
+    {
+        if (!live[i])
+            continue;
+        for (j = 0; j < op_arity[code[i].op]; ++j)
+            live[code[i].in[j]] = TRUE;
+    }
+
+    for (i = 0, j = 0; i < graph->code_len; ++i)
+    {
+        if (!live[i])
+            continue;
+        ins = code[i];
+        for (k = 0; k < op_arity[ins.op]; ++k)
+            ins.in[k] = reg[ins.in[k]];
+        code[j] = ins;
+        reg[i] = j++;
+    }
+
+    /* nothing after the output is live, so it is the last instruction */
+    graph->output = j - 1;
+    graph->code_len = j;
+    graph->compiled = TRUE;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+void fsl_noise_graph_eval(const fsl_noise_graph *graph,
+        const fsl_noise_graph_input *input, f64 *dst, u64 n)
+{
+    f64 reg[FSL_NOISE_GRAPH_NODE_MAX][FSL_NOISE_GRAPH_LANES];
+    const fsl_noise_node *ins = NULL;
+    const fsl_noise_spline *spline = NULL;
+    const f64 *a = NULL, *b = NULL, *c = NULL;
+    f64 *r = NULL;
+    f64 t = 0.0;
+    u64 base = 0;
+    u32 lanes = 0;
+    u32 i = 0, j = 0;
+
+    if (n == 1)
+    {
+        *dst = eval_point_internal(graph, input);
+        return;
+    }
+
+    for (base = 0; base < n; base += lanes)
+    {
+        lanes = n - base < FSL_NOISE_GRAPH_LANES ? (u32)(n - base) : FSL_NOISE_GRAPH_LANES;
+
+        for (i = 0; i < graph->code_len; ++i)
+        {
+            ins = &graph->code[i];
+            r = reg[i];
+            a = reg[ins->in[0]];
+            b = reg[ins->in[1]];
+            c = reg[ins->in[2]];
+
+            switch (ins->op)
+            {
+                case FSL_NOISE_OP_CONST:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = ins->param[0];
+                    break;
+
+                case FSL_NOISE_OP_SOURCE:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = input->noise[(base + j) * input->noise_len + ins->index];
+                    break;
+
+                case FSL_NOISE_OP_SCALE:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = a[j] * ins->param[0];
+                    break;
+
+                case FSL_NOISE_OP_DIV:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = a[j] / ins->param[0];
+                    break;
+
+                case FSL_NOISE_OP_OFFSET:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = a[j] + ins->param[0];
+                    break;
+
+                case FSL_NOISE_OP_ADD:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = a[j] + b[j];
+                    break;
+
+                case FSL_NOISE_OP_MUL:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = a[j] * b[j];
+                    break;
+
+                case FSL_NOISE_OP_WARP:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = input->sample_func(input->user, ins->index,
+                                input->x[base + j] + a[j], input->y[base + j] + b[j]);
+                    break;
+
+                case FSL_NOISE_OP_RIDGE:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = 1.0 - (a[j] < 0.0 ? -a[j] : a[j]);
+                    break;
+
+                case FSL_NOISE_OP_BLEND:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = a[j] + (b[j] - a[j]) * c[j];
+                    break;
+
+                case FSL_NOISE_OP_CLAMP:
+                    for (j = 0; j < lanes; ++j)
+                    {
+                        t = a[j] < ins->param[0] ? ins->param[0] : a[j];
+                        r[j] = t > ins->param[1] ? ins->param[1] : t;
+                    }
+                    break;
+
+                case FSL_NOISE_OP_FADE:
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = fade_internal(a[j]);
+                    break;
+
+                case FSL_NOISE_OP_SPLINE:
+                    spline = &graph->spline[ins->index];
+                    for (j = 0; j < lanes; ++j)
+                        r[j] = spline_eval_internal(spline, a[j]);
+                    break;
+            }
+        }
+
+        r = reg[graph->output];
+        for (j = 0; j < lanes; ++j)
+            dst[base + j] = r[j];
+    }
+}
+
+static u32 node_push_internal(fsl_noise_graph *graph, u32 op,
+        u32 a, u32 b, u32 c, u32 index, f64 param_0, f64 param_1)
+{
+    fsl_noise_node node = {0};
+    u32 i = 0;
+
+    node.op = op;
+    node.in[0] = a;
+    node.in[1] = b;
+    node.in[2] = c;
+    node.index = index;
+    node.param[0] = param_0;
+    node.param[1] = param_1;
+
+    for (i = 0; i < op_arity[op]; ++i)
+        if (node.in[i] >= graph->node_len)
+            return FSL_NOISE_NODE_NONE;
+
+    for (i = 0; i < graph->node_len; ++i)
+        if (node_equal_internal(&graph->node[i], &node))
+            return i;
+
+    if (graph->node_len >= FSL_NOISE_GRAPH_NODE_MAX)
+    {
+        LOGERROR(FSL_ERR_BUFFER_FULL, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_REASON_ERROR("Add Noise Graph Node", "Graph Full"));
+        return FSL_NOISE_NODE_NONE;
+    }
+
+    graph->node[graph->node_len] = node;
+    graph->compiled = FALSE;
+    return graph->node_len++;
+}
+
+static b8 node_equal_internal(const fsl_noise_node *a, const fsl_noise_node *b)
+{
+    return a->op == b->op &&
+        a->in[0] == b->in[0] && a->in[1] == b->in[1] && a->in[2] == b->in[2] &&
+        a->index == b->index &&
+        a->param[0] == b->param[0] && a->param[1] == b->param[1];
+}
+
+static f64 op_eval_internal(const fsl_noise_graph *graph, const fsl_noise_node *node, const f64 *v)
+{
+    switch (node->op)
+    {
+        case FSL_NOISE_OP_CONST:
+            return node->param[0];
+
+        case FSL_NOISE_OP_SCALE:
+            return v[0] * node->param[0];
+
+        case FSL_NOISE_OP_DIV:
+            return v[0] / node->param[0];
+
+        case FSL_NOISE_OP_OFFSET:
+            return v[0] + node->param[0];
+
+        case FSL_NOISE_OP_ADD:
+            return v[0] + v[1];
+
+        case FSL_NOISE_OP_MUL:
+            return v[0] * v[1];
+
+        case FSL_NOISE_OP_RIDGE:
+            return 1.0 - (v[0] < 0.0 ? -v[0] : v[0]);
+
+        case FSL_NOISE_OP_BLEND:
+            return v[0] + (v[1] - v[0]) * v[2];
+
+        case FSL_NOISE_OP_CLAMP:
+            return v[0] < node->param[0] ? node->param[0] :
+                v[0] > node->param[1] ? node->param[1] : v[0];
+
+        case FSL_NOISE_OP_FADE:
+            return fade_internal(v[0]);
+
+        case FSL_NOISE_OP_SPLINE:
+            return spline_eval_internal(&graph->spline[node->index], v[0]);
+    }
+
+    return 0.0;
+}
+
+static f64 eval_point_internal(const fsl_noise_graph *graph,
+        const fsl_noise_graph_input *input)
+{
+    f64 reg[FSL_NOISE_GRAPH_NODE_MAX];
+    f64 v[3] = {0};
+    const fsl_noise_node *ins = NULL;
+    u32 i = 0;
+
+    for (i = 0; i < graph->code_len; ++i)
+    {
+        ins = &graph->code[i];
+        switch (ins->op)
+        {
+            case FSL_NOISE_OP_SOURCE:
+                reg[i] = input->noise[ins->index];
+                break;
+
+            case FSL_NOISE_OP_WARP:
+                reg[i] = input->sample_func(input->user, ins->index,
+                        input->x[0] + reg[ins->in[0]], input->y[0] + reg[ins->in[1]]);
+                break;
+
+            default:
+                v[0] = reg[ins->in[0]];
+                v[1] = reg[ins->in[1]];
+                v[2] = reg[ins->in[2]];
+                reg[i] = op_eval_internal(graph, ins, v);
+        }
+    }
+
+    return reg[graph->output];
+}
+
+static f64 fade_internal(f64 t)
+{
+    return t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+}
+
+static f64 spline_eval_internal(const fsl_noise_spline *spline, f64 t)
+{
+    u32 i = 1;
+
+    if (t <= spline->x[0])
+        return spline->y[0];
+    if (t >= spline->x[spline->len - 1])
+        return spline->y[spline->len - 1];
+
+    while (t > spline->x[i])
+        ++i;
+
+    t = fade_internal((t - spline->x[i - 1]) / (spline->x[i] - spline->x[i - 1]));
+    return spline->y[i - 1] + (spline->y[i] - spline->y[i - 1]) * t;
+}
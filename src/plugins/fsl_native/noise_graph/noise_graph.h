@@ -0,0 +1,177 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file noise_graph.h
+ *
+ *  @brief noise composition graph; nodes combine baked noise values (e.g. from
+ *  @ref fsl_noise_buffer.noise_dst_buf) into a single value, the graph is compiled
+ *  into a flat instruction array and evaluated for batches of points.
+ *
+ *  building a graph:
+ *  1. call the node functions, each returns a node id to pass into later nodes,
+ *     identical nodes are shared (called twice, same id).
+ *  2. call @ref fsl_noise_graph_compile() with the output node, constants are folded
+ *     and unused nodes dropped.
+ *  3. call @ref fsl_noise_graph_eval() per batch.
+ *
+ *  a node function given an invalid input returns @ref FSL_NOISE_NODE_NONE, which
+ *  propagates into dependent nodes and fails @ref fsl_noise_graph_compile(), so
+ *  errors only need to be checked once.
+ */
+
+#ifndef FSL_NOISE_GRAPH_H
+#define FSL_NOISE_GRAPH_H
+
+#include "../../../common/api.h"
+#include "../../../common/types.h"
+
+#define FSL_NOISE_GRAPH_NODE_MAX        64
+#define FSL_NOISE_GRAPH_SPLINE_MAX      8   /* splines per graph */
+#define FSL_NOISE_GRAPH_SPLINE_POINTS   8   /* control points per spline */
+
+/*!
+ *  @brief points evaluated per instruction, larger batches are split.
+ */
+#define FSL_NOISE_GRAPH_LANES           16
+
+#define FSL_NOISE_NODE_NONE             (~0u)
+
+enum fsl_noise_op
+{
+    FSL_NOISE_OP_CONST,     /* `param[0]` */
+    FSL_NOISE_OP_SOURCE,    /* baked noise `index` */
+    FSL_NOISE_OP_SCALE,     /* `a` * `param[0]` */
+    FSL_NOISE_OP_DIV,       /* `a` / `param[0]`, exact where a reciprocal scale would round */
+    FSL_NOISE_OP_OFFSET,    /* `a` + `param[0]` */
+    FSL_NOISE_OP_ADD,       /* `a` + `b` */
+    FSL_NOISE_OP_MUL,       /* `a` * `b` */
+    FSL_NOISE_OP_WARP,      /* noise `index` sampled at point + (`a`, `b`) */
+    FSL_NOISE_OP_RIDGE,     /* 1 - |`a`| */
+    FSL_NOISE_OP_BLEND,     /* `a` + (`b` - `a`) * `c` */
+    FSL_NOISE_OP_CLAMP,     /* `a` clamped to [`param[0]`, `param[1]`] */
+    FSL_NOISE_OP_FADE,      /* quintic fade of `a`, as in the noise functions */
+    FSL_NOISE_OP_SPLINE,    /* `a` mapped through spline `index` */
+    FSL_NOISE_OP_COUNT
+}; /* fsl_noise_op */
+
+/*!
+ *  @brief graph node, or instruction once compiled (inputs then index registers).
+ */
+typedef struct fsl_noise_node
+{
+    u32 op;         /* enum @ref fsl_noise_op */
+    u32 in[3];      /* `a`, `b`, `c` */
+    u32 index;
+    f64 param[2];
+} fsl_noise_node;
+
+/*!
+ *  @brief control points, ascending in `x`, eased between points with a quintic
+ *  fade and held flat beyond the first and last.
+ */
+typedef struct fsl_noise_spline
+{
+    u32 len;
+    f64 x[FSL_NOISE_GRAPH_SPLINE_POINTS];
+    f64 y[FSL_NOISE_GRAPH_SPLINE_POINTS];
+} fsl_noise_spline;
+
+typedef struct fsl_noise_graph
+{
+    fsl_noise_node node[FSL_NOISE_GRAPH_NODE_MAX];
+    u32 node_len;
+
+    fsl_noise_spline spline[FSL_NOISE_GRAPH_SPLINE_MAX];
+    u32 spline_len;
+
+    /*!
+     *  @brief compiled instructions, instruction `i` writes register `i`.
+     */
+    fsl_noise_node code[FSL_NOISE_GRAPH_NODE_MAX];
+    u32 code_len;
+    u32 output;     /* register holding the result */
+
+    b8 compiled;
+} fsl_noise_graph;
+
+/*!
+ *  @brief sample noise `index` at (`x`, `y`), for warp nodes.
+ */
+typedef f64 (*fsl_noise_graph_sample_func)(void *user, u32 index, f64 x, f64 y);
+
+typedef struct fsl_noise_graph_input
+{
+    /*!
+     *  @brief baked noise values, `noise_len` per point, read by source nodes.
+     */
+    const f64 *noise;
+    u64 noise_len;
+
+    /*!
+     *  @brief point positions and sampler, read by warp nodes only, may be `NULL` otherwise.
+     */
+    const f64 *x;
+    const f64 *y;
+    fsl_noise_graph_sample_func sample_func;
+    void *user;
+} fsl_noise_graph_input;
+
+/*!
+ *  @brief clear all nodes, splines and compiled code.
+ */
+FSLAPI void fsl_noise_graph_init(fsl_noise_graph *graph);
+
+FSLAPI u32 fsl_noise_graph_const(fsl_noise_graph *graph, f64 value);
+FSLAPI u32 fsl_noise_graph_source(fsl_noise_graph *graph, u32 index);
+FSLAPI u32 fsl_noise_graph_scale(fsl_noise_graph *graph, u32 a, f64 scale);
+FSLAPI u32 fsl_noise_graph_div(fsl_noise_graph *graph, u32 a, f64 divisor);
+FSLAPI u32 fsl_noise_graph_offset(fsl_noise_graph *graph, u32 a, f64 offset);
+FSLAPI u32 fsl_noise_graph_add(fsl_noise_graph *graph, u32 a, u32 b);
+FSLAPI u32 fsl_noise_graph_mul(fsl_noise_graph *graph, u32 a, u32 b);
+FSLAPI u32 fsl_noise_graph_warp(fsl_noise_graph *graph, u32 index, u32 dx, u32 dy);
+FSLAPI u32 fsl_noise_graph_ridge(fsl_noise_graph *graph, u32 a);
+FSLAPI u32 fsl_noise_graph_blend(fsl_noise_graph *graph, u32 a, u32 b, u32 t);
+FSLAPI u32 fsl_noise_graph_clamp(fsl_noise_graph *graph, u32 a, f64 min, f64 max);
+FSLAPI u32 fsl_noise_graph_fade(fsl_noise_graph *graph, u32 a);
+
+/*!
+ *  @param len number of control points, 1 to @ref FSL_NOISE_GRAPH_SPLINE_POINTS.
+ *  @param x control point inputs, ascending.
+ *  @param y control point outputs.
+ */
+FSLAPI u32 fsl_noise_graph_spline(fsl_noise_graph *graph, u32 a,
+        u32 len, const f64 *x, const f64 *y);
+
+/*!
+ *  @brief compile the nodes `output` depends on into @ref fsl_noise_graph.code.
+ *
+ *  nodes without source or warp inputs are folded into constants, then identical
+ *  instructions are merged and unused ones dropped.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_noise_graph_compile(fsl_noise_graph *graph, u32 output);
+
+/*!
+ *  @brief evaluate a compiled graph for `n` points into `dst`.
+ *
+ *  @remark `graph` must be compiled, see @ref fsl_noise_graph_compile().
+ */
+FSLAPI void fsl_noise_graph_eval(const fsl_noise_graph *graph,
+        const fsl_noise_graph_input *input, f64 *dst, u64 n);
+
+#endif /* FSL_NOISE_GRAPH_H */
@@ -92,6 +92,7 @@ u32 fsl_noise_sampler_init(fsl_noise_sampler *sampler,
     sampler->noise_buf.sample_len = sample_count;
 
     sampler->initialized = TRUE;
+    fsl_noise_sampler_set_type(sampler, FSL_NOISE_TYPE_PERLIN);
     LOGTRACE(FSL_FLAG_LOG_NO_VERBOSE,
             fsl_logger_stringf("Sampler Initialized [noise_count: %"PRIu64"][sample_count: %"PRIu64"]\n", noise_count, sample_count));
 
@@ -104,6 +105,44 @@ cleanup:
     return fsl_err;
 }
 
+u32 fsl_noise_sampler_set_type(fsl_noise_sampler *sampler, u32 type)
+{
+    if (!sampler)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_POINTER_NULL_ACTION("Set Noise Sampler Type"));
+        return fsl_err;
+    }
+
+    switch (type)
+    {
+        case FSL_NOISE_TYPE_PERLIN:
+            sampler->noise_sample_make_2d_func = fsl_noise_sample_make_2d;
+            sampler->noise_sample_make_3d_func = fsl_noise_sample_make_3d;
+            break;
+
+        case FSL_NOISE_TYPE_SIMPLEX:
+            sampler->noise_sample_make_2d_func = fsl_noise_sample_make_simplex_2d;
+            sampler->noise_sample_make_3d_func = fsl_noise_sample_make_simplex_3d;
+            break;
+
+        case FSL_NOISE_TYPE_OPENSIMPLEX2:
+            sampler->noise_sample_make_2d_func = fsl_noise_sample_make_opensimplex2_2d;
+            sampler->noise_sample_make_3d_func = fsl_noise_sample_make_opensimplex2_3d;
+            break;
+
+        default:
+            LOGERROR(FSL_ERR_OUT_OF_BOUNDS, FSL_FLAG_LOG_NO_VERBOSE,
+                    MSG_ACTION_REASON_ERROR("Set Noise Sampler Type", "Type Unknown"));
+            return fsl_err;
+    }
+
+    sampler->noise_type = type;
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
 void fsl_noise_sampler_free(fsl_noise_sampler *sampler)
 {
     fsl_noise_sampler nosampler = {0};
@@ -28,8 +28,17 @@
 #include "../../../common/api.h"
 #include "../../../common/types.h"
 
+#include "noise_sampler_cache.h"
 #include "noise_sampler_sample.h"
 
+enum fsl_noise_type
+{
+    FSL_NOISE_TYPE_PERLIN,          /* gradient noise, 2^N corners with lerps, default */
+    FSL_NOISE_TYPE_SIMPLEX,         /* N + 1 corners, cheapest */
+    FSL_NOISE_TYPE_OPENSIMPLEX2,    /* simplex-like, even gradients in 2D, fewer grid artifacts in 3D */
+    FSL_NOISE_TYPE_COUNT
+}; /* fsl_noise_type */
+
 typedef struct fsl_noise_buffer
 {
     u64 noise_len;  /* number of noise maps per sampler context */
@@ -80,6 +89,19 @@ typedef struct fsl_noise_sampler
      */
     fsl_noise_buffer noise_buf;
 
+    u32 noise_type; /* enum @ref fsl_noise_type */
+    fsl_noise_sample_make_func noise_sample_make_2d_func;
+    fsl_noise_sample_make_func noise_sample_make_3d_func;
+
+    /*!
+     *  @brief optional, set by the caller, for @ref fsl_noise_sample_make_2d_cached()
+     *  and @ref fsl_noise_sample_make_3d_cached() while @ref noise_type is
+     *  @ref FSL_NOISE_TYPE_PERLIN.
+     *
+     *  @remark not owned, @ref fsl_noise_sampler_free() only clears the pointer.
+     */
+    fsl_noise_lattice_cache *lattice_cache;
+
     b8 initialized;
 
 } fsl_noise_sampler;
@@ -147,6 +169,19 @@ FSLAPI u32 fsl_noise_sampler_init(fsl_noise_sampler *sampler,
         f64 map_diameter_x, f64 map_diameter_y, f64 map_diameter_z,
         f64 map_margin_x, f64 map_margin_y, f64 map_margin_z);
 
+/*!
+ *  @brief select the noise algorithm of `sampler`, used through
+ *  @ref fsl_noise_sampler.noise_sample_make_2d_func and
+ *  @ref fsl_noise_sampler.noise_sample_make_3d_func.
+ *
+ *  @param type enum @ref fsl_noise_type.
+ *
+ *  @remark @ref fsl_noise_sampler_init() resets it to @ref FSL_NOISE_TYPE_PERLIN.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_noise_sampler_set_type(fsl_noise_sampler *sampler, u32 type);
+
 /*!
  *  @brief free noise sampler buffers.
  */
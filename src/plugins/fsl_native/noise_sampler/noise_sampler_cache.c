@@ -0,0 +1,293 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file noise_sampler_cache.c
+ *
+ *  @brief bounded LRU cache of lattice cell corner gradients.
+ *
+ *  entries live in one flat array, chained per hash bucket and linked in
+ *  recency order through indices, a miss on a full cache reuses the tail entry.
+ */
+
+#include "../../../logger/logger.h"
+#include "../../../logger/logger_messages_internal.h"
+#include "../../../memory/memory.h"
+
+#include "../../../common/diagnostics.h"
+
+#include "noise_sampler_cache.h"
+
+/*!
+ *  @internal
+ *
+ *  @return entry holding the corner gradients of the cell at `cell`, filled on a miss.
+ */
+static fsl_noise_lattice_entry *entry_get_internal(fsl_noise_lattice_cache *cache,
+        const i64 *cell, u64 seed, u32 dimensions);
+
+/*!
+ *  @internal
+ */
+static u32 bucket_index_internal(const fsl_noise_lattice_cache *cache,
+        const i64 *cell, u64 seed, u32 dimensions);
+
+/*!
+ *  @internal
+ *
+ *  @brief unlink entry `i` from the recency list.
+ */
+static void lru_unlink_internal(fsl_noise_lattice_cache *cache, u32 i);
+
+/*!
+ *  @internal
+ *
+ *  @brief link entry `i` at the head of the recency list.
+ */
+static void lru_push_internal(fsl_noise_lattice_cache *cache, u32 i);
+
+u32 fsl_noise_lattice_cache_init(fsl_noise_lattice_cache *cache, u32 capacity)
+{
+    u32 size = 1;
+
+    if (!cache)
+    {
+        LOGERROR(FSL_ERR_POINTER_NULL, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_POINTER_NULL_ACTION("Initialize Noise Lattice Cache"));
+        return fsl_err;
+    }
+
+    if (cache->initialized)
+        fsl_noise_lattice_cache_free(cache);
+
+    if (!capacity || capacity > (FSL_NOISE_LATTICE_NONE >> 2))
+    {
+        LOGERROR(FSL_ERR_OUT_OF_BOUNDS, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_REASON_ERROR("Initialize Noise Lattice Cache", "Capacity Out of Bounds"));
+        return fsl_err;
+    }
+
+    while (size < capacity)
+        size <<= 1;
+
+    if (fsl_mem_map((void*)&cache->entry, size * sizeof(fsl_noise_lattice_entry),
+                "noise_lattice_cache_init().cache->entry") != FSL_ERR_SUCCESS)
+        goto cleanup;
+
+    if (fsl_mem_map((void*)&cache->bucket, size * 2 * sizeof(u32),
+                "noise_lattice_cache_init().cache->bucket") != FSL_ERR_SUCCESS)
+        goto cleanup;
+
+    cache->capacity = size;
+    cache->initialized = TRUE;
+    fsl_noise_lattice_cache_clear(cache);
+
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+
+cleanup:
+
+    cache->capacity = size;
+    cache->initialized = TRUE;
+    fsl_noise_lattice_cache_free(cache);
+    return fsl_err;
+}
+
+void fsl_noise_lattice_cache_clear(fsl_noise_lattice_cache *cache)
+{
+    u32 i = 0;
+
+    for (i = 0; i < cache->capacity * 2; ++i)
+        cache->bucket[i] = FSL_NOISE_LATTICE_NONE;
+
+    cache->len = 0;
+    cache->head = FSL_NOISE_LATTICE_NONE;
+    cache->tail = FSL_NOISE_LATTICE_NONE;
+    cache->hit = 0;
+    cache->miss = 0;
+}
+
+void fsl_noise_lattice_cache_free(fsl_noise_lattice_cache *cache)
+{
+    fsl_noise_lattice_cache nocache = {0};
+
+    if (!cache || !cache->initialized)
+        return;
+
+    fsl_mem_unmap((void*)&cache->entry, cache->capacity * sizeof(fsl_noise_lattice_entry),
+            "noise_lattice_cache_free().cache->entry");
+    fsl_mem_unmap((void*)&cache->bucket, cache->capacity * 2 * sizeof(u32),
+            "noise_lattice_cache_free().cache->bucket");
+
+    *cache = nocache;
+}
+
+f64 fsl_noise_sample_make_2d_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample *s, f64 amplitude, u64 seed)
+{
+    i64 cell[3] = {0};
+
+    cell[0] = s->a[0];
+    cell[1] = s->a[1];
+
+    return fsl_noise_sample_blend_2d(s,
+            entry_get_internal(cache, cell, seed, 2)->g.g2, amplitude);
+}
+
+f64 fsl_noise_sample_make_3d_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample *s, f64 amplitude, u64 seed)
+{
+    return fsl_noise_sample_blend_3d(s,
+            entry_get_internal(cache, s->a, seed, 3)->g.g3, amplitude);
+}
+
+f32 fsl_noise_sample_make_2d_f32_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed)
+{
+    i64 cell[3] = {0};
+
+    cell[0] = s->a[0];
+    cell[1] = s->a[1];
+
+    return fsl_noise_sample_blend_2d_f32(s,
+            entry_get_internal(cache, cell, seed, 2)->g.g2, amplitude);
+}
+
+f32 fsl_noise_sample_make_3d_f32_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed)
+{
+    i64 cell[3] = {0};
+
+    cell[0] = s->a[0];
+    cell[1] = s->a[1];
+    cell[2] = s->a[2];
+
+    return fsl_noise_sample_blend_3d_f32(s,
+            entry_get_internal(cache, cell, seed, 3)->g.g3, amplitude);
+}
+
+static fsl_noise_lattice_entry *entry_get_internal(fsl_noise_lattice_cache *cache,
+        const i64 *cell, u64 seed, u32 dimensions)
+{
+    fsl_noise_lattice_entry *e = NULL;
+    u32 bucket = bucket_index_internal(cache, cell, seed, dimensions);
+    u32 hash = fsl_noise_sample_hash_get();
+    u32 *link = NULL;
+    u32 i = 0;
+
+    for (i = cache->bucket[bucket]; i != FSL_NOISE_LATTICE_NONE; i = e->chain)
+    {
+        e = &cache->entry[i];
+        if (e->cell[0] == cell[0] && e->cell[1] == cell[1] && e->cell[2] == cell[2] &&
+                e->seed == seed && e->dimensions == dimensions && e->hash == hash)
+        {
+            if (i != cache->head)
+            {
+                lru_unlink_internal(cache, i);
+                lru_push_internal(cache, i);
+            }
+            ++cache->hit;
+            return e;
+        }
+    }
+
+    ++cache->miss;
+
+    if (cache->len < cache->capacity)
+        i = cache->len++;
+    else
+    {
+        /* evict the tail, unchaining it from its own bucket */
+        i = cache->tail;
+        e = &cache->entry[i];
+        link = &cache->bucket[bucket_index_internal(cache, e->cell, e->seed, e->dimensions)];
+        while (*link != i)
+            link = &cache->entry[*link].chain;
+        *link = e->chain;
+        lru_unlink_internal(cache, i);
+    }
+
+    e = &cache->entry[i];
+    e->cell[0] = cell[0];
+    e->cell[1] = cell[1];
+    e->cell[2] = cell[2];
+    e->seed = seed;
+    e->dimensions = dimensions;
+    e->hash = hash;
+    e->chain = cache->bucket[bucket];
+    cache->bucket[bucket] = i;
+    lru_push_internal(cache, i);
+
+    if (dimensions == 2)
+    {
+        e->g.g2[0] = fsl_noise_sample_gradient_2d(cell[0], cell[1], seed);
+        e->g.g2[1] = fsl_noise_sample_gradient_2d(cell[0] + 1, cell[1], seed);
+        e->g.g2[2] = fsl_noise_sample_gradient_2d(cell[0], cell[1] + 1, seed);
+        e->g.g2[3] = fsl_noise_sample_gradient_2d(cell[0] + 1, cell[1] + 1, seed);
+    }
+    else
+    {
+        e->g.g3[0] = fsl_noise_sample_gradient_3d(cell[0], cell[1], cell[2], seed);
+        e->g.g3[1] = fsl_noise_sample_gradient_3d(cell[0] + 1, cell[1], cell[2], seed);
+        e->g.g3[2] = fsl_noise_sample_gradient_3d(cell[0], cell[1] + 1, cell[2], seed);
+        e->g.g3[3] = fsl_noise_sample_gradient_3d(cell[0] + 1, cell[1] + 1, cell[2], seed);
+        e->g.g3[4] = fsl_noise_sample_gradient_3d(cell[0], cell[1], cell[2] + 1, seed);
+        e->g.g3[5] = fsl_noise_sample_gradient_3d(cell[0] + 1, cell[1], cell[2] + 1, seed);
+        e->g.g3[6] = fsl_noise_sample_gradient_3d(cell[0], cell[1] + 1, cell[2] + 1, seed);
+        e->g.g3[7] = fsl_noise_sample_gradient_3d(cell[0] + 1, cell[1] + 1, cell[2] + 1, seed);
+    }
+
+    return e;
+}
+
+static u32 bucket_index_internal(const fsl_noise_lattice_cache *cache,
+        const i64 *cell, u64 seed, u32 dimensions)
+{
+    u64 h =
+        ((u64)cell[0] * 73856093) ^
+        ((u64)cell[1] * 19349663) ^
+        ((u64)cell[2] * 83492791) ^
+        ((seed + dimensions) * 2654435761u);
+
+    return (u32)(h ^ (h >> 17)) & (cache->capacity * 2 - 1);
+}
+
+static void lru_unlink_internal(fsl_noise_lattice_cache *cache, u32 i)
+{
+    fsl_noise_lattice_entry *e = &cache->entry[i];
+
+    if (e->prev != FSL_NOISE_LATTICE_NONE)
+        cache->entry[e->prev].next = e->next;
+    else cache->head = e->next;
+
+    if (e->next != FSL_NOISE_LATTICE_NONE)
+        cache->entry[e->next].prev = e->prev;
+    else cache->tail = e->prev;
+}
+
+static void lru_push_internal(fsl_noise_lattice_cache *cache, u32 i)
+{
+    fsl_noise_lattice_entry *e = &cache->entry[i];
+
+    e->prev = FSL_NOISE_LATTICE_NONE;
+    e->next = cache->head;
+
+    if (cache->head != FSL_NOISE_LATTICE_NONE)
+        cache->entry[cache->head].prev = i;
+    else cache->tail = i;
+
+    cache->head = i;
+}
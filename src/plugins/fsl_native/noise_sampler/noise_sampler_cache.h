@@ -0,0 +1,116 @@
+/*!
+ *  Copyright 2026 Lily Awertnex
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*!
+ *  @file noise_sampler_cache.h
+ *
+ *  @brief bounded LRU cache of lattice cell corner gradients for the perlin samples,
+ *  keyed by seed and cell, so low-frequency noises whose cells span many chunks
+ *  hash and look up their corners once per cell instead of once per sample.
+ *
+ *  the cache holds no per-sample values, results are bit-identical to
+ *  @ref fsl_noise_sample_make_2d() and @ref fsl_noise_sample_make_3d(), and their
+ *  f32 versions.
+ *
+ *  @remark not thread-safe, use one cache per thread.
+ */
+
+#ifndef FSL_NOISE_SAMPLER_CACHE_H
+#define FSL_NOISE_SAMPLER_CACHE_H
+
+#include "../../../common/api.h"
+#include "../../../common/types.h"
+
+#include "noise_sampler_sample.h"
+
+#define FSL_NOISE_LATTICE_NONE  (~0u)
+
+typedef struct fsl_noise_lattice_entry
+{
+    i64 cell[3];    /* lower corner, `cell[2]` is 0 for 2D cells */
+    u64 seed;
+    u32 dimensions; /* 2 or 3, 2D and 3D cells never share an entry */
+    u32 hash;       /* enum @ref fsl_noise_hash the gradients came from */
+
+    u32 chain;      /* next entry in the same bucket */
+    u32 prev;       /* more recently used */
+    u32 next;       /* less recently used */
+
+    /*!
+     *  @brief corner gradients, `v2f64[4]` for 2D cells, `v3f64[8]` for 3D,
+     *  see @ref fsl_noise_sample_blend_2d() for order.
+     */
+    union
+    {
+        v2f64 g2[4];
+        v3f64 g3[8];
+    } g;
+} fsl_noise_lattice_entry;
+
+typedef struct fsl_noise_lattice_cache
+{
+    fsl_noise_lattice_entry *entry;
+    u32 *bucket;    /* first entry per bucket, `bucket_len` = `capacity` * 2 */
+    u32 capacity;   /* power of 2 */
+    u32 len;
+    u32 head;       /* most recently used */
+    u32 tail;       /* least recently used, evicted first */
+
+    u64 hit;
+    u64 miss;
+
+    b8 initialized;
+} fsl_noise_lattice_cache;
+
+/*!
+ *  @param capacity max cells held, rounded up to a power of 2.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_noise_lattice_cache_init(fsl_noise_lattice_cache *cache, u32 capacity);
+
+/*!
+ *  @brief drop all cells and reset hit and miss counts, keep allocations.
+ */
+FSLAPI void fsl_noise_lattice_cache_clear(fsl_noise_lattice_cache *cache);
+
+FSLAPI void fsl_noise_lattice_cache_free(fsl_noise_lattice_cache *cache);
+
+/*!
+ *  @brief @ref fsl_noise_sample_make_2d(), corner gradients read through `cache`.
+ */
+FSLAPI f64 fsl_noise_sample_make_2d_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample *s, f64 amplitude, u64 seed);
+
+/*!
+ *  @brief @ref fsl_noise_sample_make_3d(), corner gradients read through `cache`.
+ */
+FSLAPI f64 fsl_noise_sample_make_3d_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample *s, f64 amplitude, u64 seed);
+
+/*!
+ *  @brief @ref fsl_noise_sample_make_2d_f32(), corner gradients read through `cache`.
+ */
+FSLAPI f32 fsl_noise_sample_make_2d_f32_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed);
+
+/*!
+ *  @brief @ref fsl_noise_sample_make_3d_f32(), corner gradients read through `cache`.
+ */
+FSLAPI f32 fsl_noise_sample_make_3d_f32_cached(fsl_noise_lattice_cache *cache,
+        const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed);
+
+#endif /* FSL_NOISE_SAMPLER_CACHE_H */
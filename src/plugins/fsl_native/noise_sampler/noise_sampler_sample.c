@@ -20,8 +20,12 @@
  *  @brief general noise functions used to parse samples.
  */
 
+#include "../../../logger/logger.h"
+#include "../../../logger/logger_messages_internal.h"
 #include "../../../math/noise.h"
 
+#include "../../../common/diagnostics.h"
+
 #include "noise_sampler_sample.h"
 
 #include <math.h>
@@ -47,6 +51,109 @@
 #define RAND_CONST_12 904023
 #define RAND_CONST_13 371769
 
+#define SIMPLEX_F2  0.36602540378443864676  /* (sqrt(3) - 1) / 2 */
+#define SIMPLEX_G2  0.21132486540518711775  /* (3 - sqrt(3)) / 6 */
+#define SIMPLEX_F3  (1.0 / 3.0)
+#define SIMPLEX_G3  (1.0 / 6.0)
+
+/*!
+ *  @brief squared kernel radius per corner, contributions must fade to zero before
+ *  a corner drops out of the evaluated set, larger radii (e.g. the common 0.6 in 3D)
+ *  leave seams.
+ */
+#define SIMPLEX_R2_2D   0.5
+#define SIMPLEX_R2_3D   0.5
+
+/*!
+ *  @brief output scales, so that results spread like the perlin samples do for the
+ *  same `amplitude` (measured standard deviation ~0.21 with @ref fsl_rand_tab gradients,
+ *  and with the unit gradients of OpenSimplex2 2D), switching noise types keeps terrain
+ *  heights in the same range.
+ */
+#define SIMPLEX_SCALE_2D        40.0
+#define SIMPLEX_SCALE_3D        50.0
+#define OPENSIMPLEX2_SCALE_2D   40.0
+#define OPENSIMPLEX2_SCALE_3D   50.0
+
+/* second lattice copy of OpenSimplex2 3D samples its own gradients */
+#define OPENSIMPLEX2_SEED_FLIP_3D RAND_CONST_13
+
+#define OPENSIMPLEX2_GRAD_COUNT_2D 24
+
+/*!
+ *  @brief xxHash64 primes, for @ref FSL_NOISE_HASH_MIX.
+ */
+#define HASH_P1 0x9e3779b185ebca87
+#define HASH_P2 0xc2b2ae3d27d4eb4f
+#define HASH_P3 0x165667b19e3779f9
+#define HASH_P5 0x27d4eb2f165667c5
+
+/*!
+ *  @brief map the low 32 bits of `h` onto all of @ref fsl_rand_tab by multiply-shift,
+ *  for @ref FSL_NOISE_HASH_MIX, no modulo and no entries left out.
+ */
+#define HASH_MIX_INDEX(h) ((u32)(((u64)(u32)(h) * FSL_RAND_TAB_VOLUME) >> 32))
+
+static u32 noise_hash = FSL_NOISE_HASH_TABLE;
+
+/*!
+ *  @brief OpenSimplex2 2D gradients, 24 unit vectors at 7.5 + 15n degrees, none along
+ *  an axis or a diagonal of the lattice, so no direction is favored over its neighbors
+ *  as random gradients favor some by chance.
+ */
+static const f64 opensimplex2_grad_2d[OPENSIMPLEX2_GRAD_COUNT_2D][2] =
+{
+    { 0.991444861373810,  0.130526192220052}, { 0.923879532511287,  0.382683432365090},
+    { 0.793353340291235,  0.608761429008721}, { 0.608761429008721,  0.793353340291235},
+    { 0.382683432365090,  0.923879532511287}, { 0.130526192220052,  0.991444861373810},
+    {-0.130526192220052,  0.991444861373810}, {-0.382683432365090,  0.923879532511287},
+    {-0.608761429008721,  0.793353340291235}, {-0.793353340291235,  0.608761429008721},
+    {-0.923879532511287,  0.382683432365090}, {-0.991444861373810,  0.130526192220052},
+    {-0.991444861373810, -0.130526192220052}, {-0.923879532511287, -0.382683432365090},
+    {-0.793353340291235, -0.608761429008721}, {-0.608761429008721, -0.793353340291235},
+    {-0.382683432365090, -0.923879532511287}, {-0.130526192220052, -0.991444861373810},
+    { 0.130526192220052, -0.991444861373810}, { 0.382683432365090, -0.923879532511287},
+    { 0.608761429008721, -0.793353340291235}, { 0.793353340291235, -0.608761429008721},
+    { 0.923879532511287, -0.382683432365090}, { 0.991444861373810, -0.130526192220052},
+};
+
+/*!
+ *  @internal
+ *
+ *  @brief fold one lattice coordinate into `h`, as xxHash64 folds a 4-byte input.
+ */
+static u64 hash_mix_internal(u64 h, i32 v);
+
+/*!
+ *  @internal
+ *
+ *  @brief xxHash64 final avalanche.
+ */
+static u64 hash_avalanche_internal(u64 h);
+
+/*!
+ *  @internal
+ *
+ *  @brief contribution of a single simplex corner at offset (`x`, `y`) from lattice
+ *  point (`i`, `j`), `a` = r^2 - |offset|^2, zero outside the kernel.
+ */
+static f64 corner_2d_internal(f64 a, f64 x, f64 y, i64 i, i64 j, u64 seed);
+
+/*!
+ *  @internal
+ *
+ *  @brief 3D version of @ref corner_2d_internal().
+ */
+static f64 corner_3d_internal(f64 a, f64 x, f64 y, f64 z, i64 i, i64 j, i64 k, u64 seed);
+
+/*!
+ *  @internal
+ *
+ *  @brief @ref corner_2d_internal() with a gradient of @ref opensimplex2_grad_2d, picked
+ *  by the hash of @ref fsl_noise_sample_hash_set().
+ */
+static f64 opensimplex2_corner_2d_internal(f64 a, f64 x, f64 y, i64 i, i64 j, u64 seed);
+
 f64 fsl_noise_sample_nolerp(const f64 *n, const f64 *t)
 {
     (void)t;
@@ -87,10 +194,39 @@ f64 fsl_noise_sample_trilerp(const f64 *n, const f64 *t)
         n[7] * t[0] * t[1] * t[2];
 }
 
+u32 fsl_noise_sample_hash_set(u32 hash)
+{
+    if (hash >= FSL_NOISE_HASH_COUNT)
+    {
+        LOGERROR(FSL_ERR_OUT_OF_BOUNDS, FSL_FLAG_LOG_NO_VERBOSE,
+                MSG_ACTION_REASON_ERROR("Set Noise Hash", "Hash Out of Bounds"));
+        return fsl_err;
+    }
+
+    noise_hash = hash;
+    fsl_err = FSL_ERR_SUCCESS;
+    return fsl_err;
+}
+
+u32 fsl_noise_sample_hash_get(void)
+{
+    return noise_hash;
+}
+
 v2f64 fsl_noise_sample_gradient_2d(i32 x, i32 y, u64 seed)
 {
     v2f64 v = {0};
     u64 h = {0};
+
+    if (noise_hash == FSL_NOISE_HASH_MIX)
+    {
+        h = hash_mix_internal(hash_mix_internal(seed + HASH_P5, x), y);
+        h = hash_avalanche_internal(h);
+        v.x = fsl_rand_tab[HASH_MIX_INDEX(h)];
+        v.y = fsl_rand_tab[HASH_MIX_INDEX(h >> 32)];
+        return v;
+    }
+
     h = x * RAND_CONST_1;
     h ^= y * RAND_CONST_2;
     h ^= h >> 16;
@@ -105,6 +241,18 @@ v3f64 fsl_noise_sample_gradient_3d(i32 x, i32 y, i32 z, u64 seed)
 {
     v3f64 v = {0};
     u64 h = {0};
+
+    if (noise_hash == FSL_NOISE_HASH_MIX)
+    {
+        h = hash_mix_internal(hash_mix_internal(hash_mix_internal(seed + HASH_P5, x), y), z);
+        h = hash_avalanche_internal(h);
+        v.x = fsl_rand_tab[HASH_MIX_INDEX(h)];
+        v.y = fsl_rand_tab[HASH_MIX_INDEX(h >> 32)];
+        /* 64 bits hold two indices, an odd multiply gives a third from the high bits */
+        v.z = fsl_rand_tab[HASH_MIX_INDEX((h * HASH_P2) >> 32)];
+        return v;
+    }
+
     h = x * RAND_CONST_1;
     h ^= y * RAND_CONST_2;
     h ^= z * RAND_CONST_3;
@@ -119,7 +267,7 @@ v3f64 fsl_noise_sample_gradient_3d(i32 x, i32 y, i32 z, u64 seed)
 void fsl_noise_sample_axis_init(fsl_noise_sample *s, u8 axis, f64 pos, f64 frequency)
 {
     f64 v = pos * frequency;
-    i64 a = (i64)floorf(v);
+    i64 a = (i64)floor(v);
     i64 b = a + 1;
     f64 d = v - (f64)a;
     d = d * d * d * (d * (d * 6.0f - 15.0f) + 10.0f);
@@ -135,11 +283,6 @@ void fsl_noise_sample_axis_init(fsl_noise_sample *s, u8 axis, f64 pos, f64 frequ
 
 f64 fsl_noise_sample_make_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
 {
-    const f64 dx = s->dv[0];
-    const f64 dy = s->dv[1];
-    const f64 wx = s->dw[0];
-    const f64 wy = s->dw[1];
-    f64 n[4] = {0};
     v2f64 g[4] = {0};
 
     g[0] = fsl_noise_sample_gradient_2d(s->a[0], s->a[1], seed);
@@ -147,6 +290,17 @@ f64 fsl_noise_sample_make_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
     g[2] = fsl_noise_sample_gradient_2d(s->a[0], s->b[1], seed);
     g[3] = fsl_noise_sample_gradient_2d(s->b[0], s->b[1], seed);
 
+    return fsl_noise_sample_blend_2d(s, g, amplitude);
+}
+
+f64 fsl_noise_sample_blend_2d(const fsl_noise_sample *s, const v2f64 *g, f64 amplitude)
+{
+    const f64 dx = s->dv[0];
+    const f64 dy = s->dv[1];
+    const f64 wx = s->dw[0];
+    const f64 wy = s->dw[1];
+    f64 n[4] = {0};
+
     n[0] = s->da[0] * g[0].x + s->da[1] * g[0].y;
     n[1] = s->db[0] * g[1].x + s->da[1] * g[1].y;
     n[2] = s->da[0] * g[2].x + s->db[1] * g[2].y;
@@ -161,13 +315,6 @@ f64 fsl_noise_sample_make_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
 
 f64 fsl_noise_sample_make_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
 {
-    const f64 dx = s->dv[0];
-    const f64 dy = s->dv[1];
-    const f64 dz = s->dv[2];
-    const f64 wx = s->dw[0];
-    const f64 wy = s->dw[1];
-    const f64 wz = s->dw[2];
-    f64 n[8] = {0};
     v3f64 g[8] = {0};
 
     g[0] = fsl_noise_sample_gradient_3d(s->a[0], s->a[1], s->a[2], seed);
@@ -179,6 +326,19 @@ f64 fsl_noise_sample_make_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
     g[6] = fsl_noise_sample_gradient_3d(s->a[0], s->b[1], s->b[2], seed);
     g[7] = fsl_noise_sample_gradient_3d(s->b[0], s->b[1], s->b[2], seed);
 
+    return fsl_noise_sample_blend_3d(s, g, amplitude);
+}
+
+f64 fsl_noise_sample_blend_3d(const fsl_noise_sample *s, const v3f64 *g, f64 amplitude)
+{
+    const f64 dx = s->dv[0];
+    const f64 dy = s->dv[1];
+    const f64 dz = s->dv[2];
+    const f64 wx = s->dw[0];
+    const f64 wy = s->dw[1];
+    const f64 wz = s->dw[2];
+    f64 n[8] = {0};
+
     n[0] = s->da[0] * g[0].x + s->da[1] * g[0].y + s->da[2] * g[0].z;
     n[1] = s->db[0] * g[1].x + s->da[1] * g[1].y + s->da[2] * g[1].z;
     n[2] = s->da[0] * g[2].x + s->db[1] * g[2].y + s->da[2] * g[2].z;
@@ -198,3 +358,346 @@ f64 fsl_noise_sample_make_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
          n[6] * wx * dy * dz +
          n[7] * dx * dy * dz) * amplitude;
 }
+
+void fsl_noise_sample_axis_init_f32(fsl_noise_sample_f32 *s, u8 axis,
+        i64 origin, f32 offset, f64 frequency)
+{
+    f64 v = (f64)origin * frequency + (f64)offset * frequency;
+    i64 a = (i64)v;
+    f32 d = 0.0f;
+
+    /* floor by truncation, cheaper than libm here */
+    a -= v < (f64)a;
+    d = (f32)(v - (f64)a);
+
+    s->a[axis] = (i32)a;
+    s->b[axis] = (i32)a + 1;
+    s->da[axis] = d;
+    s->db[axis] = d - 1.0f;
+    s->dv[axis] = d * d * d * (d * (d * 6.0f - 15.0f) + 10.0f);
+    s->dw[axis] = 1.0f - s->dv[axis];
+}
+
+f32 fsl_noise_sample_make_2d_f32(const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed)
+{
+    v2f64 g[4] = {0};
+
+    g[0] = fsl_noise_sample_gradient_2d(s->a[0], s->a[1], seed);
+    g[1] = fsl_noise_sample_gradient_2d(s->b[0], s->a[1], seed);
+    g[2] = fsl_noise_sample_gradient_2d(s->a[0], s->b[1], seed);
+    g[3] = fsl_noise_sample_gradient_2d(s->b[0], s->b[1], seed);
+
+    return fsl_noise_sample_blend_2d_f32(s, g, amplitude);
+}
+
+f32 fsl_noise_sample_blend_2d_f32(const fsl_noise_sample_f32 *s, const v2f64 *g, f32 amplitude)
+{
+    f32 n[4] = {0};
+
+    /* gradients come from the f32 table, the casts are exact */
+    n[0] = s->da[0] * (f32)g[0].x + s->da[1] * (f32)g[0].y;
+    n[1] = s->db[0] * (f32)g[1].x + s->da[1] * (f32)g[1].y;
+    n[2] = s->da[0] * (f32)g[2].x + s->db[1] * (f32)g[2].y;
+    n[3] = s->db[0] * (f32)g[3].x + s->db[1] * (f32)g[3].y;
+
+    return
+        (n[0] * s->dw[0] * s->dw[1] +
+         n[1] * s->dv[0] * s->dw[1] +
+         n[2] * s->dw[0] * s->dv[1] +
+         n[3] * s->dv[0] * s->dv[1]) * amplitude;
+}
+
+f32 fsl_noise_sample_make_3d_f32(const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed)
+{
+    v3f64 g[8] = {0};
+
+    g[0] = fsl_noise_sample_gradient_3d(s->a[0], s->a[1], s->a[2], seed);
+    g[1] = fsl_noise_sample_gradient_3d(s->b[0], s->a[1], s->a[2], seed);
+    g[2] = fsl_noise_sample_gradient_3d(s->a[0], s->b[1], s->a[2], seed);
+    g[3] = fsl_noise_sample_gradient_3d(s->b[0], s->b[1], s->a[2], seed);
+    g[4] = fsl_noise_sample_gradient_3d(s->a[0], s->a[1], s->b[2], seed);
+    g[5] = fsl_noise_sample_gradient_3d(s->b[0], s->a[1], s->b[2], seed);
+    g[6] = fsl_noise_sample_gradient_3d(s->a[0], s->b[1], s->b[2], seed);
+    g[7] = fsl_noise_sample_gradient_3d(s->b[0], s->b[1], s->b[2], seed);
+
+    return fsl_noise_sample_blend_3d_f32(s, g, amplitude);
+}
+
+f32 fsl_noise_sample_blend_3d_f32(const fsl_noise_sample_f32 *s, const v3f64 *g, f32 amplitude)
+{
+    const f32 dx = s->dv[0];
+    const f32 dy = s->dv[1];
+    const f32 dz = s->dv[2];
+    const f32 wx = s->dw[0];
+    const f32 wy = s->dw[1];
+    const f32 wz = s->dw[2];
+    f32 n[8] = {0};
+
+    n[0] = s->da[0] * (f32)g[0].x + s->da[1] * (f32)g[0].y + s->da[2] * (f32)g[0].z;
+    n[1] = s->db[0] * (f32)g[1].x + s->da[1] * (f32)g[1].y + s->da[2] * (f32)g[1].z;
+    n[2] = s->da[0] * (f32)g[2].x + s->db[1] * (f32)g[2].y + s->da[2] * (f32)g[2].z;
+    n[3] = s->db[0] * (f32)g[3].x + s->db[1] * (f32)g[3].y + s->da[2] * (f32)g[3].z;
+    n[4] = s->da[0] * (f32)g[4].x + s->da[1] * (f32)g[4].y + s->db[2] * (f32)g[4].z;
+    n[5] = s->db[0] * (f32)g[5].x + s->da[1] * (f32)g[5].y + s->db[2] * (f32)g[5].z;
+    n[6] = s->da[0] * (f32)g[6].x + s->db[1] * (f32)g[6].y + s->db[2] * (f32)g[6].z;
+    n[7] = s->db[0] * (f32)g[7].x + s->db[1] * (f32)g[7].y + s->db[2] * (f32)g[7].z;
+
+    return
+        (n[0] * wx * wy * wz +
+         n[1] * dx * wy * wz +
+         n[2] * wx * dy * wz +
+         n[3] * dx * dy * wz +
+         n[4] * wx * wy * dz +
+         n[5] * dx * wy * dz +
+         n[6] * wx * dy * dz +
+         n[7] * dx * dy * dz) * amplitude;
+}
+
+f64 fsl_noise_sample_make_simplex_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
+{
+    const f64 x = s->v[0];
+    const f64 y = s->v[1];
+    f64 skew = (x + y) * SIMPLEX_F2;
+    i64 i = (i64)floor(x + skew);
+    i64 j = (i64)floor(y + skew);
+    f64 unskew = (f64)(i + j) * SIMPLEX_G2;
+    f64 x0 = x - ((f64)i - unskew);
+    f64 y0 = y - ((f64)j - unskew);
+    i64 i1 = x0 > y0;   /* lower triangle: (1, 0), upper: (0, 1) */
+    i64 j1 = !i1;
+    f64 x1 = x0 - (f64)i1 + SIMPLEX_G2;
+    f64 y1 = y0 - (f64)j1 + SIMPLEX_G2;
+    f64 x2 = x0 - 1.0 + 2.0 * SIMPLEX_G2;
+    f64 y2 = y0 - 1.0 + 2.0 * SIMPLEX_G2;
+
+    return
+        (corner_2d_internal(SIMPLEX_R2_2D - x0 * x0 - y0 * y0, x0, y0, i, j, seed) +
+         corner_2d_internal(SIMPLEX_R2_2D - x1 * x1 - y1 * y1, x1, y1, i + i1, j + j1, seed) +
+         corner_2d_internal(SIMPLEX_R2_2D - x2 * x2 - y2 * y2, x2, y2, i + 1, j + 1, seed)) *
+        SIMPLEX_SCALE_2D * amplitude;
+}
+
+f64 fsl_noise_sample_make_simplex_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
+{
+    const f64 x = s->v[0];
+    const f64 y = s->v[1];
+    const f64 z = s->v[2];
+    f64 skew = (x + y + z) * SIMPLEX_F3;
+    i64 i = (i64)floor(x + skew);
+    i64 j = (i64)floor(y + skew);
+    i64 k = (i64)floor(z + skew);
+    f64 unskew = (f64)(i + j + k) * SIMPLEX_G3;
+    f64 x0 = x - ((f64)i - unskew);
+    f64 y0 = y - ((f64)j - unskew);
+    f64 z0 = z - ((f64)k - unskew);
+    f64 x1, y1, z1, x2, y2, z2, x3, y3, z3;
+    i64 i1, j1, k1, i2, j2, k2;
+
+    /* walk the cube diagonal along the axes in descending order of offset */
+    if (x0 >= y0)
+    {
+        if (y0 >= z0)       { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+        else if (x0 >= z0)  { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1; }
+        else                { i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1; }
+    }
+    else
+    {
+        if (y0 < z0)        { i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1; }
+        else if (x0 < z0)   { i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1; }
+        else                { i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+    }
+
+    x1 = x0 - (f64)i1 + SIMPLEX_G3;
+    y1 = y0 - (f64)j1 + SIMPLEX_G3;
+    z1 = z0 - (f64)k1 + SIMPLEX_G3;
+    x2 = x0 - (f64)i2 + 2.0 * SIMPLEX_G3;
+    y2 = y0 - (f64)j2 + 2.0 * SIMPLEX_G3;
+    z2 = z0 - (f64)k2 + 2.0 * SIMPLEX_G3;
+    x3 = x0 - 1.0 + 3.0 * SIMPLEX_G3;
+    y3 = y0 - 1.0 + 3.0 * SIMPLEX_G3;
+    z3 = z0 - 1.0 + 3.0 * SIMPLEX_G3;
+
+    return
+        (corner_3d_internal(SIMPLEX_R2_3D - x0 * x0 - y0 * y0 - z0 * z0,
+                            x0, y0, z0, i, j, k, seed) +
+         corner_3d_internal(SIMPLEX_R2_3D - x1 * x1 - y1 * y1 - z1 * z1,
+                            x1, y1, z1, i + i1, j + j1, k + k1, seed) +
+         corner_3d_internal(SIMPLEX_R2_3D - x2 * x2 - y2 * y2 - z2 * z2,
+                            x2, y2, z2, i + i2, j + j2, k + k2, seed) +
+         corner_3d_internal(SIMPLEX_R2_3D - x3 * x3 - y3 * y3 - z3 * z3,
+                            x3, y3, z3, i + 1, j + 1, k + 1, seed)) *
+        SIMPLEX_SCALE_3D * amplitude;
+}
+
+f64 fsl_noise_sample_make_opensimplex2_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
+{
+    const f64 unskew = -SIMPLEX_G2;
+    f64 skew = (s->v[0] + s->v[1]) * SIMPLEX_F2;
+    f64 xs = s->v[0] + skew;
+    f64 ys = s->v[1] + skew;
+    i64 i = (i64)floor(xs);
+    i64 j = (i64)floor(ys);
+    f64 xi = xs - (f64)i;
+    f64 yi = ys - (f64)j;
+    f64 t = (xi + yi) * unskew;
+    f64 x0 = xi + t;
+    f64 y0 = yi + t;
+    f64 x1, y1, x2, y2, a0, a1, a2;
+    f64 value = 0.0;
+
+    a0 = SIMPLEX_R2_2D - x0 * x0 - y0 * y0;
+    value += opensimplex2_corner_2d_internal(a0, x0, y0, i, j, seed);
+
+    /* far corner falloff, derived from `a0` instead of recomputing distance */
+    a1 = (2.0 * (1.0 + 2.0 * unskew) * (1.0 / unskew + 2.0)) * t +
+        ((-2.0 * (1.0 + 2.0 * unskew) * (1.0 + 2.0 * unskew)) + a0);
+    x1 = x0 - (1.0 + 2.0 * unskew);
+    y1 = y0 - (1.0 + 2.0 * unskew);
+    value += opensimplex2_corner_2d_internal(a1, x1, y1, i + 1, j + 1, seed);
+
+    if (y0 > x0)
+    {
+        x2 = x0 - unskew;
+        y2 = y0 - (unskew + 1.0);
+        a2 = SIMPLEX_R2_2D - x2 * x2 - y2 * y2;
+        value += opensimplex2_corner_2d_internal(a2, x2, y2, i, j + 1, seed);
+    }
+    else
+    {
+        x2 = x0 - (unskew + 1.0);
+        y2 = y0 - unskew;
+        a2 = SIMPLEX_R2_2D - x2 * x2 - y2 * y2;
+        value += opensimplex2_corner_2d_internal(a2, x2, y2, i + 1, j, seed);
+    }
+
+    return value * OPENSIMPLEX2_SCALE_2D * amplitude;
+}
+
+f64 fsl_noise_sample_make_opensimplex2_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed)
+{
+    /* rotate so the XY plane (terrain) gets the better-looking lattice slices */
+    f64 xy = s->v[0] + s->v[1];
+    f64 s2 = xy * -0.211324865405187;   /* 1/2 - sqrt(3)/3 */
+    f64 zz = s->v[2] * 0.577350269189626; /* sqrt(3)/3 */
+    f64 xr = s->v[0] + s2 + zz;
+    f64 yr = s->v[1] + s2 + zz;
+    f64 zr = xy * -0.577350269189626 + zz;
+    i64 i = (i64)floor(xr + 0.5);
+    i64 j = (i64)floor(yr + 0.5);
+    i64 k = (i64)floor(zr + 0.5);
+    f64 x0 = xr - (f64)i;
+    f64 y0 = yr - (f64)j;
+    f64 z0 = zr - (f64)k;
+    i32 x_sign = (i32)(-1.0 - x0) | 1;  /* -1 if offset is positive, 1 otherwise */
+    i32 y_sign = (i32)(-1.0 - y0) | 1;
+    i32 z_sign = (i32)(-1.0 - z0) | 1;
+    f64 ax = x_sign * -x0;
+    f64 ay = y_sign * -y0;
+    f64 az = z_sign * -z0;
+    f64 a = (SIMPLEX_R2_3D - x0 * x0) - (y0 * y0 + z0 * z0);
+    f64 value = 0.0;
+    u32 l = 0;
+
+    /* two offset cubic lattices (BCC), closest and second-closest point on each */
+    for (l = 0; ; ++l)
+    {
+        value += corner_3d_internal(a, x0, y0, z0, i, j, k, seed);
+
+        if (ax >= ay && ax >= az)
+            value += corner_3d_internal(a + ax + ax - 1.0,
+                    x0 + x_sign, y0, z0, i - x_sign, j, k, seed);
+        else if (ay > ax && ay >= az)
+            value += corner_3d_internal(a + ay + ay - 1.0,
+                    x0, y0 + y_sign, z0, i, j - y_sign, k, seed);
+        else
+            value += corner_3d_internal(a + az + az - 1.0,
+                    x0, y0, z0 + z_sign, i, j, k - z_sign, seed);
+
+        if (l == 1)
+            break;
+
+        ax = 0.5 - ax;
+        ay = 0.5 - ay;
+        az = 0.5 - az;
+        x0 = x_sign * ax;
+        y0 = y_sign * ay;
+        z0 = z_sign * az;
+        a += (0.75 - ax) - (ay + az);
+        i += (x_sign >> 1) & 1;
+        j += (y_sign >> 1) & 1;
+        k += (z_sign >> 1) & 1;
+        x_sign = -x_sign;
+        y_sign = -y_sign;
+        z_sign = -z_sign;
+        seed ^= OPENSIMPLEX2_SEED_FLIP_3D;
+    }
+
+    return value * OPENSIMPLEX2_SCALE_3D * amplitude;
+}
+
+static u64 hash_mix_internal(u64 h, i32 v)
+{
+    h ^= (u64)(u32)v * HASH_P1;
+    h = (h << 23 | h >> 41) * HASH_P2 + HASH_P3;
+    return h;
+}
+
+static u64 hash_avalanche_internal(u64 h)
+{
+    h ^= h >> 33;
+    h *= HASH_P2;
+    h ^= h >> 29;
+    h *= HASH_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+static f64 corner_2d_internal(f64 a, f64 x, f64 y, i64 i, i64 j, u64 seed)
+{
+    v2f64 g = {0};
+
+    if (a <= 0.0)
+        return 0.0;
+
+    g = fsl_noise_sample_gradient_2d((i32)i, (i32)j, seed);
+    a *= a;
+    return a * a * (g.x * x + g.y * y);
+}
+
+static f64 opensimplex2_corner_2d_internal(f64 a, f64 x, f64 y, i64 i, i64 j, u64 seed)
+{
+    const f64 *g = NULL;
+    u64 h = 0;
+
+    if (a <= 0.0)
+        return 0.0;
+
+    if (noise_hash == FSL_NOISE_HASH_MIX)
+    {
+        h = hash_avalanche_internal(hash_mix_internal(hash_mix_internal(seed + HASH_P5, (i32)i), (i32)j));
+        g = opensimplex2_grad_2d[((h & 0xffffffff) * OPENSIMPLEX2_GRAD_COUNT_2D) >> 32];
+    }
+    else
+    {
+        h = (u64)(u32)i * RAND_CONST_1;
+        h ^= (u64)(u32)j * RAND_CONST_2;
+        h ^= h >> 16;
+        h *= RAND_CONST_0;
+        g = opensimplex2_grad_2d[(seed + (h >> 8)) % OPENSIMPLEX2_GRAD_COUNT_2D];
+    }
+
+    a *= a;
+    return a * a * (g[0] * x + g[1] * y);
+}
+
+static f64 corner_3d_internal(f64 a, f64 x, f64 y, f64 z, i64 i, i64 j, i64 k, u64 seed)
+{
+    v3f64 g = {0};
+
+    if (a <= 0.0)
+        return 0.0;
+
+    g = fsl_noise_sample_gradient_3d((i32)i, (i32)j, (i32)k, seed);
+    a *= a;
+    return a * a * (g.x * x + g.y * y + g.z * z);
+}
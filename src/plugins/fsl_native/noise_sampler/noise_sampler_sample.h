@@ -38,16 +38,143 @@ typedef struct fsl_noise_sample
     f64 db[3];  /* `b` delta */
 } fsl_noise_sample;
 
+/*!
+ *  @brief gradient hash, maps a lattice point and seed to a gradient, see
+ *  @ref fsl_noise_sample_hash_set().
+ */
+enum fsl_noise_hash
+{
+    /*!
+     *  @brief multiplicative hash offset by seed into @ref fsl_rand_tab, modulo its
+     *  volume, default, kept for existing worlds.
+     */
+    FSL_NOISE_HASH_TABLE,
+
+    /*!
+     *  @brief xxHash64-style mixing of seed and lattice point, indices into
+     *  @ref fsl_rand_tab are mapped by multiply-shift instead of divided, and nearby
+     *  seeds give unrelated gradients.
+     */
+    FSL_NOISE_HASH_MIX,
+    FSL_NOISE_HASH_COUNT
+}; /* fsl_noise_hash */
+
+/*!
+ *  @brief perlin sample in f32, the lattice cell is kept as an integer and only
+ *  the position within the cell is f32, so precision doesn't drop with distance
+ *  from the world origin.
+ */
+typedef struct fsl_noise_sample_f32
+{
+    i32 a[3];   /* lattice cell */
+    i32 b[3];   /* `a` + 1 */
+    f32 dv[3];  /* `da` faded */
+    f32 dw[3];  /* 1 - `dv` */
+    f32 da[3];  /* position within cell, [0.0, 1.0) */
+    f32 db[3];  /* `da` - 1 */
+} fsl_noise_sample_f32;
+
 typedef f64 (*fsl_noise_sample_lerp_func)(const f64 *n, const f64 *t);
 
+/*!
+ *  @brief make a final sample value from a sample's base data, see @ref fsl_noise_type.
+ */
+typedef f64 (*fsl_noise_sample_make_func)(const fsl_noise_sample *s, f64 amplitude, u64 seed);
+
 FSLAPI f64 fsl_noise_sample_nolerp(const f64 *n, const f64 *t);
 FSLAPI f64 fsl_noise_sample_lerp(const f64 *n, const f64 *t);
 FSLAPI f64 fsl_noise_sample_bilerp(const f64 *n, const f64 *t);
 FSLAPI f64 fsl_noise_sample_trilerp(const f64 *n, const f64 *t);
+/*!
+ *  @brief select the gradient hash of all samples, a world picks one alongside its
+ *  seed and must keep it for the same terrain.
+ *
+ *  @param hash enum @ref fsl_noise_hash.
+ *
+ *  @remark global, set before sampling, not while other threads sample.
+ *  @remark lattice caches key their cells by hash, no need to clear them.
+ *
+ *  @return non-zero on failure and @ref fsl_err is set accordingly.
+ */
+FSLAPI u32 fsl_noise_sample_hash_set(u32 hash);
+
+/*!
+ *  @return enum @ref fsl_noise_hash in use.
+ */
+FSLAPI u32 fsl_noise_sample_hash_get(void);
+
 FSLAPI v2f64 fsl_noise_sample_gradient_2d(i32 x, i32 y, u64 seed);
 FSLAPI v3f64 fsl_noise_sample_gradient_3d(i32 x, i32 y, i32 z, u64 seed);
 FSLAPI void fsl_noise_sample_axis_init(fsl_noise_sample *s, u8 axis, f64 pos, f64 frequency);
 FSLAPI f64 fsl_noise_sample_make_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed);
 FSLAPI f64 fsl_noise_sample_make_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed);
 
+/*!
+ *  @brief the perlin half of @ref fsl_noise_sample_make_2d(), from the corner
+ *  gradients of the sample's cell.
+ *
+ *  @param g corner gradients, ordered (a, a), (b, a), (a, b), (b, b).
+ */
+FSLAPI f64 fsl_noise_sample_blend_2d(const fsl_noise_sample *s, const v2f64 *g, f64 amplitude);
+
+/*!
+ *  @brief 3D version of @ref fsl_noise_sample_blend_2d(), `x` varying fastest, then `y`.
+ */
+FSLAPI f64 fsl_noise_sample_blend_3d(const fsl_noise_sample *s, const v3f64 *g, f64 amplitude);
+
+/*!
+ *  @brief f32 version of @ref fsl_noise_sample_axis_init(), position given as
+ *  `origin` + `offset`.
+ *
+ *  the lattice cell of `origin` is taken once in f64, `offset` (e.g. chunk-relative)
+ *  is then added in f32 on the position within that cell.
+ *
+ *  @param origin integer part of the position, e.g. a chunk or block position.
+ */
+FSLAPI void fsl_noise_sample_axis_init_f32(fsl_noise_sample_f32 *s, u8 axis,
+        i64 origin, f32 offset, f64 frequency);
+
+/*!
+ *  @brief f32 version of @ref fsl_noise_sample_make_2d().
+ */
+FSLAPI f32 fsl_noise_sample_make_2d_f32(const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed);
+
+/*!
+ *  @brief f32 version of @ref fsl_noise_sample_make_3d().
+ */
+FSLAPI f32 fsl_noise_sample_make_3d_f32(const fsl_noise_sample_f32 *s, f32 amplitude, u64 seed);
+
+/*!
+ *  @brief f32 version of @ref fsl_noise_sample_blend_2d().
+ */
+FSLAPI f32 fsl_noise_sample_blend_2d_f32(const fsl_noise_sample_f32 *s, const v2f64 *g, f32 amplitude);
+
+/*!
+ *  @brief f32 version of @ref fsl_noise_sample_blend_3d().
+ */
+FSLAPI f32 fsl_noise_sample_blend_3d_f32(const fsl_noise_sample_f32 *s, const v3f64 *g, f32 amplitude);
+
+/*!
+ *  @brief simplex noise, 3 corners in 2D and 4 in 3D instead of 4 and 8.
+ *
+ *  @remark only reads `s->v`, gradients are sampled from @ref fsl_rand_tab like
+ *  the perlin samples.
+ */
+FSLAPI f64 fsl_noise_sample_make_simplex_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed);
+FSLAPI f64 fsl_noise_sample_make_simplex_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed);
+
+/*!
+ *  @brief OpenSimplex2 noise, 3 corners in 2D and 8 in 3D (two offset cubic lattices),
+ *  with fewer axis-aligned artifacts than simplex in 3D.
+ *
+ *  @remark only reads `s->v`.
+ *  @remark 2D shares the simplex lattice, but its gradients are OpenSimplex2's 24 unit
+ *  vectors, 15 degrees apart, picked by the hash of @ref fsl_noise_sample_hash_set(),
+ *  so its peaks are lower and slopes spread evenly over directions.
+ *  @remark 3D gradients are sampled from @ref fsl_rand_tab like the perlin samples.
+ *  @remark 3D is rotated for XY-plane terrain (z up).
+ */
+FSLAPI f64 fsl_noise_sample_make_opensimplex2_2d(const fsl_noise_sample *s, f64 amplitude, u64 seed);
+FSLAPI f64 fsl_noise_sample_make_opensimplex2_3d(const fsl_noise_sample *s, f64 amplitude, u64 seed);
+
 #endif /* FSL_NOISE_SAMPLER_SAMPLE_H */
@@ -7,6 +7,7 @@
 #define DIR_GAME                "game_hhc/"
 #define DIR_SRC_GAME            DIR_GAME"src/"
 #define DIR_OUT_GAME            DIR_GAME"out/"
+#define DIR_OBJ_GAME            DIR_GAME"obj/"
 
 #define DIR_TEXT_RENDERING      "text_rendering/"
 #define DIR_SRC_TEXT_RENDERING  DIR_TEXT_RENDERING"src/"
@@ -20,6 +21,14 @@
 #define DIR_SRC_COMPOSABLE_UI   DIR_COMPOSABLE_UI"src/"
 #define DIR_OUT_COMPOSABLE_UI   DIR_COMPOSABLE_UI"out/"
 
+#define DIR_PGO_TRAIN           "pgo_train/"
+#define DIR_SRC_PGO_TRAIN       DIR_PGO_TRAIN"src/"
+#define DIR_OUT_PGO_TRAIN       DIR_PGO_TRAIN"out/"
+
+#define DIR_CHECKS              "checks/"
+#define DIR_SRC_CHECKS          DIR_CHECKS"src/"
+#define DIR_OUT_CHECKS          DIR_CHECKS"out/"
+
 #define TEST_NAME_WIDTH 32
 #define TEST_NAME_WIDTH_FULL 64
 
@@ -30,12 +39,23 @@ typedef struct fsl_test_info
     u32 (*build_func)(int argc, char **argv);
 } fsl_test_info;
 
+typedef struct fsl_check_info
+{
+    str *name;      /* check name, built from 'checks/src/<name>.c' into 'checks/out/<name>' */
+    b8 terrain;     /* also compile the terrain sources of 'game_hhc/' */
+    b8 chunk_io;    /* also compile the chunk file sources of 'game_hhc/' */
+} fsl_check_info;
+
 bt_buf cmd = {0}; /* build cmd */
+bt_buf cmd_link = {0}; /* link cmd, for multi-file builds */
+bt_buf src = {0}; /* source files, for multi-file builds */
 
 u32 build_game(int argc, char **argv);
 u32 build_text_rendering(int argc, char **argv);
 u32 build_nine_slice(int argc, char **argv);
 u32 build_composable_ui(int argc, char **argv);
+u32 build_pgo_train(int argc, char **argv);
+u32 build_checks(int argc, char **argv);
 
 fsl_test_info test_list[] =
 {
@@ -43,7 +63,35 @@ fsl_test_info test_list[] =
     {"game_hhc",        "hhc",          build_game},
     {"text_rendering",  "txt",          build_text_rendering},
     {"nine_slice",      "9s",           build_nine_slice},
-    {"composable_ui",   "ui",           build_composable_ui}
+    {"composable_ui",   "ui",           build_composable_ui},
+    {"pgo_train",       "pgo",          build_pgo_train},
+    {"checks",          "chk",          build_checks}
+};
+
+fsl_check_info check_list[] =
+{
+    /* name                  terrain chunk_io */
+    {"mem_map_bench",        FALSE,  FALSE},
+    {"hash_map_check",       FALSE,  FALSE},
+    {"sort_check",           FALSE,  FALSE},
+    {"copy_file_check",      FALSE,  FALSE},
+    {"io_check",             FALSE,  FALSE},
+    {"atomic_write_check",   FALSE,  FALSE},
+    {"terrain_graph_check",  TRUE,   FALSE},
+    {"noise_hash_check",     FALSE,  FALSE},
+    {"perlin_batch_check",   FALSE,  FALSE},
+    {"noise_types_check",    FALSE,  FALSE},
+    {"lattice_cache_check",  TRUE,   FALSE},
+    {"terrain_sparse_check", TRUE,   FALSE},
+    {"biome_table_check",    TRUE,   FALSE},
+    {"terrain_f32_check",    TRUE,   FALSE},
+    {"matrix_check",         FALSE,  FALSE},
+    {"transform_soa_check",  FALSE,  FALSE},
+    {"dir_contents_check",   FALSE,  FALSE},
+    {"chunk_dir_check",      FALSE,  TRUE},
+    {"spawn_check",          FALSE,  FALSE},
+    {"depfile_check",        FALSE,  FALSE},
+    {"file_map_bench",       FALSE,  FALSE}
 };
 
 int main(int argc, char **argv)
@@ -60,7 +108,12 @@ int main(int argc, char **argv)
                 "    list       list available tests\n"
                 "    show       show build command in list format\n"
                 "    raw        show build command in raw format\n"
-                "    self       build build source\n");
+                "    self       build build source\n"
+                "    release    build without debug flags\n"
+                "    unity      compile multi-file tests as a single translation unit\n"
+                "    lto        compile and link with link-time optimization\n"
+                "    run        run checks after building them, stop on the first failure (checks only)\n"
+                "    -j<N>      run N compile jobs at once (default: number of processors)\n");
         _exit(ERR_SUCCESS);
     }
 
@@ -111,6 +164,7 @@ u32 build_game(int argc, char **argv)
     make_dir(DIR_OUT_GAME);
 
     cmd_push(&cmd, COMPILER);
+    cmd_push(&cmd_link, COMPILER);
 
     if (find_token("release", argc, argv))
         cmd_push(&cmd, "-DHHC_RELEASE_BUILD");
@@ -121,41 +175,61 @@ u32 build_game(int argc, char **argv)
         cmd_push(&cmd, "-Wformat-truncation=0");
         cmd_push(&cmd, "-Wpedantic");
         cmd_push(&cmd, "-ggdb");
+        cmd_push(&cmd_link, "-ggdb");
     }
 
-    cmd_push(&cmd, DIR_SRC_GAME"main.c");
-    cmd_push(&cmd, DIR_SRC_GAME"chunking/chunk_draw.c");
-    cmd_push(&cmd, DIR_SRC_GAME"chunking/chunk_work_receipt.c");
-    cmd_push(&cmd, DIR_SRC_GAME"chunking/chunking.c");
-    cmd_push(&cmd, DIR_SRC_GAME"chunking/chunking_debug_tools.c");
-    cmd_push(&cmd, DIR_SRC_GAME"gui/gui.c");
-    cmd_push(&cmd, DIR_SRC_GAME"gui/gui_callbacks.c");
-    cmd_push(&cmd, DIR_SRC_GAME"gui/gui_menus.c");
-    cmd_push(&cmd, DIR_SRC_GAME"plugins/big_num_separator/big_num_separator.c");
-    cmd_push(&cmd, DIR_SRC_GAME"settings/settings.c");
-    cmd_push(&cmd, DIR_SRC_GAME"super_debugger/super_debugger.c");
-    cmd_push(&cmd, DIR_SRC_GAME"super_debugger/super_debugger_callbacks.c");
-    cmd_push(&cmd, DIR_SRC_GAME"terrain/biome.c");
-    cmd_push(&cmd, DIR_SRC_GAME"terrain/terrain.c");
-    cmd_push(&cmd, DIR_SRC_GAME"assets.c");
-    cmd_push(&cmd, DIR_SRC_GAME"common.c");
-    cmd_push(&cmd, DIR_SRC_GAME"dir.c");
-    cmd_push(&cmd, DIR_SRC_GAME"input.c");
-    cmd_push(&cmd, DIR_SRC_GAME"player.c");
-    cmd_push(&cmd, DIR_SRC_GAME"world.c");
     cmd_push(&cmd, "-I"DIR_DEPS);
     cmd_push(&cmd, "-std=c89");
     cmd_push(&cmd, "-Ofast");
-    cmd_push(&cmd, "-L"DIR_ROOT"lib/"PLATFORM);
-    fsl_engine_link_libs(&cmd);
-    fsl_engine_set_runtime_path(&cmd);
-    cmd_push(&cmd, "-o");
-    cmd_push(&cmd, DIR_OUT_GAME"hhc");
+    cmd_push(&cmd_link, "-Ofast");
+
+    if (find_token("lto", argc, argv))
+    {
+        cmd_push(&cmd, "-flto=auto");
+        cmd_push(&cmd_link, "-flto=auto");
+    }
     cmd_ready(&cmd);
 
-    if (exec(&cmd, "build_game().cmd") != ERR_SUCCESS)
+    cmd_push(&src, DIR_SRC_GAME"main.c");
+    cmd_push(&src, DIR_SRC_GAME"chunking/chunk_draw.c");
+    cmd_push(&src, DIR_SRC_GAME"chunking/chunk_io.c");
+    cmd_push(&src, DIR_SRC_GAME"chunking/chunk_work_receipt.c");
+    cmd_push(&src, DIR_SRC_GAME"chunking/chunking.c");
+    cmd_push(&src, DIR_SRC_GAME"chunking/chunking_debug_tools.c");
+    cmd_push(&src, DIR_SRC_GAME"gui/gui.c");
+    cmd_push(&src, DIR_SRC_GAME"gui/gui_callbacks.c");
+    cmd_push(&src, DIR_SRC_GAME"gui/gui_menus.c");
+    cmd_push(&src, DIR_SRC_GAME"plugins/big_num_separator/big_num_separator.c");
+    cmd_push(&src, DIR_SRC_GAME"settings/settings.c");
+    cmd_push(&src, DIR_SRC_GAME"super_debugger/super_debugger.c");
+    cmd_push(&src, DIR_SRC_GAME"super_debugger/super_debugger_callbacks.c");
+    cmd_push(&src, DIR_SRC_GAME"terrain/biome.c");
+    cmd_push(&src, DIR_SRC_GAME"terrain/terrain.c");
+    cmd_push(&src, DIR_SRC_GAME"assets.c");
+    cmd_push(&src, DIR_SRC_GAME"common.c");
+    cmd_push(&src, DIR_SRC_GAME"dir.c");
+    cmd_push(&src, DIR_SRC_GAME"input.c");
+    cmd_push(&src, DIR_SRC_GAME"player.c");
+    cmd_push(&src, DIR_SRC_GAME"world.c");
+
+    if (find_token("unity", argc, argv))
+    {
+        if (compile_unity(&cmd, &src, DIR_OBJ_GAME, "hhc", &cmd_link) != ERR_SUCCESS)
+            cmd_fail(&cmd);
+    }
+    else if (compile(&cmd, &src, DIR_OBJ_GAME, &cmd_link) != ERR_SUCCESS)
         cmd_fail(&cmd);
 
+    cmd_push(&cmd_link, "-L"DIR_ROOT"lib/"PLATFORM);
+    fsl_engine_link_libs(&cmd_link);
+    fsl_engine_set_runtime_path(&cmd_link);
+    cmd_push(&cmd_link, "-o");
+    cmd_push(&cmd_link, DIR_OUT_GAME"hhc");
+    cmd_ready(&cmd_link);
+
+    if (link_objects(&cmd_link, DIR_OUT_GAME"hhc", DIR_OBJ_GAME, "build_game().cmd_link") != ERR_SUCCESS)
+        cmd_fail(&cmd_link);
+
     if (
             copy_dir(DIR_ROOT"fossil/fossil/", DIR_OUT_GAME, TRUE) != ERR_SUCCESS ||
             copy_dir(DIR_GAME"assets/", DIR_OUT_GAME, FALSE) != ERR_SUCCESS)
@@ -265,3 +339,113 @@ u32 build_composable_ui(int argc, char **argv)
     build_err = ERR_SUCCESS;
     return build_err;
 }
+
+u32 build_pgo_train(int argc, char **argv)
+{
+    if (is_dir_exists(DIR_SRC_PGO_TRAIN, TRUE) != ERR_SUCCESS)
+        return build_err;
+
+    make_dir(DIR_OUT_PGO_TRAIN);
+
+    cmd_push(&cmd, COMPILER);
+    cmd_push(&cmd, "-Wall");
+    cmd_push(&cmd, "-Wextra");
+    cmd_push(&cmd, "-Wformat-truncation=0");
+    cmd_push(&cmd, "-Wpedantic");
+    cmd_push(&cmd, DIR_SRC_PGO_TRAIN"main.c");
+    cmd_push(&cmd, "-std=c89");
+    cmd_push(&cmd, "-Ofast");
+    cmd_push(&cmd, "-L"DIR_ROOT"lib/"PLATFORM);
+    fsl_engine_link_libs(&cmd);
+    fsl_engine_set_runtime_path(&cmd);
+    cmd_push(&cmd, "-o");
+    cmd_push(&cmd, DIR_OUT_PGO_TRAIN"pgo_train");
+    cmd_ready(&cmd);
+
+    if (exec(&cmd, "build_pgo_train().cmd") != ERR_SUCCESS)
+        cmd_fail(&cmd);
+
+    if (copy_dir(DIR_ROOT"fossil/fossil/", DIR_OUT_PGO_TRAIN, TRUE) != ERR_SUCCESS)
+        cmd_fail(&cmd);
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
+
+u32 build_checks(int argc, char **argv)
+{
+    bt_buf cmd_run = {0};
+    b8 filter = FALSE;
+    u64 i = 0;
+
+    if (is_dir_exists(DIR_SRC_CHECKS, TRUE) != ERR_SUCCESS)
+        return build_err;
+
+    make_dir(DIR_OUT_CHECKS);
+
+    /* build only the checks named on the command line, if any */
+    for (i = 0; i < arr_len(check_list); ++i)
+        if (find_token(check_list[i].name, argc, argv))
+            filter = TRUE;
+
+    for (i = 0; i < arr_len(check_list); ++i)
+    {
+        if (filter && !find_token(check_list[i].name, argc, argv))
+            continue;
+
+        cmd_push(&cmd, COMPILER);
+        cmd_push(&cmd, "-Wall");
+        cmd_push(&cmd, "-Wextra");
+        cmd_push(&cmd, "-Wformat-truncation=0");
+        cmd_push(&cmd, "-Wpedantic");
+        cmd_push(&cmd, "-I"DIR_DEPS);
+        cmd_push(&cmd, stringf("%s%s.c", DIR_SRC_CHECKS, check_list[i].name));
+        if (check_list[i].terrain)
+        {
+            cmd_push(&cmd, DIR_SRC_GAME"terrain/biome.c");
+            cmd_push(&cmd, DIR_SRC_GAME"terrain/terrain.c");
+        }
+        if (check_list[i].chunk_io)
+            cmd_push(&cmd, DIR_SRC_GAME"chunking/chunk_io.c");
+        cmd_push(&cmd, "-std=c89");
+        cmd_push(&cmd, "-Ofast");
+        cmd_push(&cmd, "-L"DIR_ROOT"lib/"PLATFORM);
+        fsl_engine_link_libs(&cmd);
+        fsl_engine_set_runtime_path(&cmd);
+        cmd_push(&cmd, "-o");
+        cmd_push(&cmd, stringf("%s%s", DIR_OUT_CHECKS, check_list[i].name));
+        cmd_ready(&cmd);
+
+        if (exec(&cmd, "build_checks().cmd") != ERR_SUCCESS)
+            cmd_fail(&cmd);
+        cmd_free(&cmd);
+    }
+
+    if (copy_dir(DIR_ROOT"fossil/fossil/", DIR_OUT_CHECKS, TRUE) != ERR_SUCCESS)
+        cmd_fail(&cmd);
+
+    if (!find_token("run", argc, argv))
+    {
+        build_err = ERR_SUCCESS;
+        return build_err;
+    }
+
+    for (i = 0; i < arr_len(check_list); ++i)
+    {
+        if (filter && !find_token(check_list[i].name, argc, argv))
+            continue;
+
+        /* argv[2] is the log level of an engine program */
+        cmd_push(&cmd_run, stringf("%s%s", DIR_OUT_CHECKS, check_list[i].name));
+        cmd_push(&cmd_run, "checks");
+        cmd_push(&cmd_run, "loginfo");
+        cmd_ready(&cmd_run);
+
+        if (exec(&cmd_run, "build_checks().cmd_run") != ERR_SUCCESS)
+            cmd_fail(&cmd_run);
+        cmd_free(&cmd_run);
+    }
+
+    build_err = ERR_SUCCESS;
+    return build_err;
+}
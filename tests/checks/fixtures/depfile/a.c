@@ -0,0 +1,7 @@
+#include "shared.h"
+#include "a_private.h"
+
+int shared_value(void)
+{
+    return A_VALUE;
+}
@@ -0,0 +1,6 @@
+#ifndef A_PRIVATE_H
+#define A_PRIVATE_H
+
+#define A_VALUE 1
+
+#endif /* A_PRIVATE_H */
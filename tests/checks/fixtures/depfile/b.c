@@ -0,0 +1,7 @@
+#include "shared.h"
+#include "b_private.h"
+
+int b_value(void)
+{
+    return shared_value() + B_VALUE;
+}
@@ -0,0 +1,9 @@
+#ifndef B_PRIVATE_H
+#define B_PRIVATE_H
+
+/* a name the compiler has to escape in the depfile, `\ ` and `$$` */
+#include "sub dir/dol$lar.h"
+
+#define B_VALUE (2 + DOLLAR_VALUE)
+
+#endif /* B_PRIVATE_H */
@@ -0,0 +1,6 @@
+#ifndef SHARED_H
+#define SHARED_H
+
+int shared_value(void);
+
+#endif /* SHARED_H */
@@ -0,0 +1,6 @@
+#ifndef DOLLAR_H
+#define DOLLAR_H
+
+#define DOLLAR_VALUE 3
+
+#endif /* DOLLAR_H */
@@ -0,0 +1,334 @@
+/*!
+ *  checks of @ref fsl_write_file_atomic() and write batches, with failures injected at each
+ *  step of a write:
+ *
+ *  - creating the temp file (out of file descriptors, path too long),
+ *  - writing it (file size limit hit halfway),
+ *  - renaming it over the target (target is a non-empty directory),
+ *
+ *  after each failure the target must hold its old contents and no temp file may be left.
+ *  batches must leave targets untouched until committed, keep one temp file per path when a
+ *  path is written twice, and keep the pending write when a rewrite of it fails.
+ *  @ref fsl_dir_handle_open() must sweep stale temp files only when asked to, only files named
+ *  as the writer names them, and not the ones of a pending batch.
+ *  a rewritten target must keep its mode, a new one must get `0666` less the umask.
+ *
+ *  also times @ref BENCH_COUNT files written one by one vs. in one batch.
+ *
+ *  `fdatasync()` failures can't be injected from outside, they take the same cleanup path
+ *  as the rename failure.
+ */
+
+#include "check.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DIR_TEMP        "temp_atomic/"
+#define PATH_A          DIR_TEMP"a.bin"
+#define PATH_B          DIR_TEMP"b.bin"
+#define PATH_DIR        DIR_TEMP"dir.bin"
+#define DATA_SIZE       8192
+#define FSIZE_LIMIT     1024    /* a write of @ref DATA_SIZE fails past this */
+#define BENCH_COUNT     64
+
+static u8 data_old[DATA_SIZE];
+static u8 data_new[DATA_SIZE];
+static u8 data_new2[DATA_SIZE];
+static u8 file_buf[DATA_SIZE * 2];
+
+/*! @return `TRUE` if the file at `path` holds exactly `size` bytes of `expect`. */
+static b8 file_is(const str *path, const u8 *expect, u64 size)
+{
+    FILE *file = NULL;
+    u64 len = 0;
+
+    if ((file = fopen(path, "rb")) == NULL)
+        return FALSE;
+    len = fread(file_buf, 1, sizeof(file_buf), file);
+    fclose(file);
+    return len == size && !memcmp(file_buf, expect, size);
+}
+
+/*! @return number of entries in @ref DIR_TEMP ending in `.fsltmp`. */
+static u32 temp_count(void)
+{
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+    u64 len = 0;
+    u32 count = 0;
+
+    if ((dir = opendir(DIR_TEMP)) == NULL)
+        return 0;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        len = strlen(entry->d_name);
+        if (len > 7 && !strcmp(entry->d_name + len - 7, ".fsltmp"))
+            ++count;
+    }
+    closedir(dir);
+    return count;
+}
+
+static b8 file_make(const str *path, const u8 *buf, u64 size)
+{
+    FILE *file = NULL;
+
+    if ((file = fopen(path, "wb")) == NULL)
+        return FALSE;
+    fwrite(buf, 1, size, file);
+    return fclose(file) == 0;
+}
+
+static void check_intact(const str *name, const str *path, const u8 *expect)
+{
+    CHECK(file_is(path, expect, DATA_SIZE),
+            fsl_logger_stringf("%s: Target Lost Its Old Contents\n", name));
+    CHECK(!temp_count(),
+            fsl_logger_stringf("%s: %"PRIu32" Temp Files Left Behind\n", name, temp_count()));
+}
+
+static void check_fail_open(void)
+{
+    struct rlimit limit = {0}, limit_old = {0};
+    int fd_free = 0;
+
+    file_make(PATH_A, data_old, DATA_SIZE);
+
+    /* no file descriptor left for the temp file */
+    getrlimit(RLIMIT_NOFILE, &limit_old);
+    fd_free = dup(0);
+    close(fd_free);
+    limit = limit_old;
+    limit.rlim_cur = (rlim_t)fd_free;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    CHECK(fsl_write_file_atomic(PATH_A, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_FILE_OPEN_FAIL,
+            "Open: Write Didn't Fail\n");
+    setrlimit(RLIMIT_NOFILE, &limit_old);
+    check_intact("Open", PATH_A, data_old);
+}
+
+static void check_fail_name(void)
+{
+    str path[FSL_PATH_CAP] = {0};
+
+    /* room for the target name, not for the temp suffix */
+    memset(path, 'x', FSL_PATH_CAP - 3);
+    memcpy(path, DIR_TEMP, strlen(DIR_TEMP));
+    CHECK(fsl_write_file_atomic(path, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_PATH_TOO_LONG,
+            "Name: Write Didn't Fail\n");
+    CHECK(!temp_count(), "Name: Temp Files Left Behind\n");
+}
+
+static void check_fail_write(void)
+{
+    struct rlimit limit = {0}, limit_old = {0};
+
+    file_make(PATH_A, data_old, DATA_SIZE);
+
+    getrlimit(RLIMIT_FSIZE, &limit_old);
+    limit = limit_old;
+    limit.rlim_cur = FSIZE_LIMIT;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    CHECK(fsl_write_file_atomic(PATH_A, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_FILE_WRITE_FAIL,
+            "Write: Write Didn't Fail\n");
+    setrlimit(RLIMIT_FSIZE, &limit_old);
+    check_intact("Write", PATH_A, data_old);
+}
+
+static void check_fail_rename(void)
+{
+    /* a non-empty directory can't be renamed over */
+    mkdir(PATH_DIR, 0755);
+    file_make(PATH_DIR"/keep.bin", data_old, DATA_SIZE);
+
+    CHECK(fsl_write_file_atomic(PATH_DIR, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_FILE_WRITE_FAIL,
+            "Rename: Write Didn't Fail\n");
+    check_intact("Rename", PATH_DIR"/keep.bin", data_old);
+
+    remove(PATH_DIR"/keep.bin");
+    remove(PATH_DIR);
+}
+
+static void check_batch(void)
+{
+    struct rlimit limit = {0}, limit_old = {0};
+
+    file_make(PATH_A, data_old, DATA_SIZE);
+    file_make(PATH_B, data_old, DATA_SIZE);
+
+    fsl_write_batch_begin();
+    CHECK(fsl_write_file_atomic(PATH_A, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_SUCCESS &&
+            fsl_write_file_atomic(PATH_B, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_SUCCESS,
+            "Batch: Write Failed\n");
+    CHECK(file_is(PATH_A, data_old, DATA_SIZE) && file_is(PATH_B, data_old, DATA_SIZE),
+            "Batch: Targets Changed Before the Batch Ended\n");
+
+    /* the latest write of a path wins, its earlier temp file goes away */
+    CHECK(fsl_write_file_atomic(PATH_A, DATA_SIZE, data_new2, FALSE, FALSE, TRUE) == FSL_ERR_SUCCESS,
+            "Batch: Rewrite Failed\n");
+    CHECK(temp_count() == 2,
+            fsl_logger_stringf("Batch: %"PRIu32" Temp Files Pending, Expected 2\n", temp_count()));
+
+    /* a failing rewrite keeps the pending write */
+    getrlimit(RLIMIT_FSIZE, &limit_old);
+    limit = limit_old;
+    limit.rlim_cur = FSIZE_LIMIT;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    CHECK(fsl_write_file_atomic(PATH_B, DATA_SIZE, data_new2, FALSE, FALSE, TRUE) == FSL_ERR_FILE_WRITE_FAIL,
+            "Batch: Rewrite Didn't Fail\n");
+    setrlimit(RLIMIT_FSIZE, &limit_old);
+
+    CHECK(fsl_write_batch_end() == FSL_ERR_SUCCESS, "Batch: Commit Failed\n");
+    CHECK(file_is(PATH_A, data_new2, DATA_SIZE),
+            "Batch: Rewritten Target Doesn't Hold the Latest Write\n");
+    CHECK(file_is(PATH_B, data_new, DATA_SIZE),
+            "Batch: Failed Rewrite Dropped the Pending Write\n");
+    CHECK(!temp_count(), "Batch: Temp Files Left Behind\n");
+}
+
+static void check_sweep(void)
+{
+    /* not written by @ref fsl_write_file_atomic(), must survive */
+    static const str *keep_list[] =
+    {
+        DIR_TEMP"stale.tmp",
+        DIR_TEMP"a.bin.7.tmp",
+        DIR_TEMP"a.bin.fsltmp",
+        DIR_TEMP"a.bin.7x.fsltmp",
+        DIR_TEMP".7.fsltmp",
+        DIR_TEMP"a.bin.7.fsltmpx",
+    };
+    fsl_dir_handle dir = {0};
+    u64 i = 0;
+
+    file_make(PATH_A, data_old, DATA_SIZE);
+    file_make(DIR_TEMP"a.bin.7.fsltmp", data_new, 16);
+    for (i = 0; i < arr_len(keep_list); ++i)
+        file_make(keep_list[i], data_new, 16);
+
+    CHECK(fsl_dir_handle_open(&dir, DIR_TEMP, 0, FALSE) == FSL_ERR_SUCCESS &&
+            file_is(DIR_TEMP"a.bin.7.fsltmp", data_new, 16),
+            "Sweep: Swept Without Being Asked\n");
+    fsl_dir_handle_close(&dir);
+
+    fsl_write_batch_begin();
+    fsl_write_file_atomic(PATH_B, DATA_SIZE, data_new2, FALSE, FALSE, TRUE);
+
+    CHECK(fsl_dir_handle_open(&dir, DIR_TEMP, FSL_FLAG_DIR_HANDLE_SWEEP_TEMP, FALSE) == FSL_ERR_SUCCESS,
+            "Sweep: Open Failed\n");
+    CHECK(!file_is(DIR_TEMP"a.bin.7.fsltmp", data_new, 16), "Sweep: Stale Temp File Left\n");
+    for (i = 0; i < arr_len(keep_list); ++i)
+        CHECK(file_is(keep_list[i], data_new, 16),
+                fsl_logger_stringf("Sweep: Removed '%s', Not a Temp File\n", keep_list[i]));
+    CHECK(file_is(PATH_A, data_old, DATA_SIZE), "Sweep: Removed a Target\n");
+
+    CHECK(fsl_write_batch_end() == FSL_ERR_SUCCESS && file_is(PATH_B, data_new2, DATA_SIZE),
+            "Sweep: Pending Write Lost\n");
+
+    fsl_dir_handle_close(&dir);
+    for (i = 0; i < arr_len(keep_list); ++i)
+        remove(keep_list[i]);
+}
+
+static void check_mode(void)
+{
+    static const u32 mode_list[] = {0600, 0640, 0755, 0444};
+    struct stat stats = {0};
+    mode_t mask = umask(0);
+    u64 i = 0;
+
+    umask(mask);
+    for (i = 0; i < arr_len(mode_list); ++i)
+    {
+        file_make(PATH_A, data_old, DATA_SIZE);
+        chmod(PATH_A, (mode_t)mode_list[i]);
+        CHECK(fsl_write_file_atomic(PATH_A, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_SUCCESS &&
+                stat(PATH_A, &stats) == 0 && (stats.st_mode & 07777) == mode_list[i],
+                fsl_logger_stringf("Mode: %04"PRIo32" Became %04o\n",
+                    mode_list[i], (u32)(stats.st_mode & 07777)));
+        remove(PATH_A);
+    }
+
+    CHECK(fsl_write_file_atomic(PATH_A, DATA_SIZE, data_new, FALSE, FALSE, TRUE) == FSL_ERR_SUCCESS &&
+            stat(PATH_A, &stats) == 0 && (stats.st_mode & 07777) == (0666 & ~mask),
+            fsl_logger_stringf("Mode: New File Got %04o, Expected %04o\n",
+                (u32)(stats.st_mode & 07777), (u32)(0666 & ~mask)));
+}
+
+static void bench(void)
+{
+    u64 i = 0, time_start = 0;
+    f64 time_single = 0.0, time_batch = 0.0;
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < BENCH_COUNT; ++i)
+        fsl_write_file_atomic(fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i),
+                DATA_SIZE, data_new, FALSE, FALSE, TRUE);
+    time_single = check_time_since(time_start);
+
+    time_start = fsl_get_time_nsec();
+    fsl_write_batch_begin();
+    for (i = 0; i < BENCH_COUNT; ++i)
+        fsl_write_file_atomic(fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i),
+                DATA_SIZE, data_new2, FALSE, FALSE, TRUE);
+    CHECK(fsl_write_batch_end() == FSL_ERR_SUCCESS, "Bench: Commit Failed\n");
+    time_batch = check_time_since(time_start);
+
+    for (i = 0; i < BENCH_COUNT; ++i)
+    {
+        CHECK(file_is(fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i), data_new2, DATA_SIZE),
+                fsl_logger_stringf("Bench: File %"PRIu64" Not Committed\n", i));
+        remove(fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i));
+    }
+
+    CHECK_REPORT(fsl_logger_stringf("%d files: one by one %9.3fms, batched %9.3fms\n",
+                BENCH_COUNT, time_single * 1e3, time_batch * 1e3));
+}
+
+int main(int argc, char **argv)
+{
+    u64 i = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (fsl_make_dir(DIR_TEMP) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    /* a write past the file size limit must fail, not kill the process */
+    signal(SIGXFSZ, SIG_IGN);
+
+    for (i = 0; i < DATA_SIZE; ++i)
+    {
+        data_old[i] = (u8)fsl_rand_u64(i);
+        data_new[i] = (u8)fsl_rand_u64(i + DATA_SIZE);
+        data_new2[i] = (u8)fsl_rand_u64(i + DATA_SIZE * 2);
+    }
+
+    check_fail_open();
+    check_fail_name();
+    check_fail_write();
+    check_fail_rename();
+    check_batch();
+    check_sweep();
+    check_mode();
+
+    bench();
+
+cleanup:
+
+    remove(PATH_A);
+    remove(PATH_B);
+    remove(DIR_TEMP);
+    return CHECK_CLOSE();
+}
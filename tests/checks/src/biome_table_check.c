@@ -0,0 +1,265 @@
+/*!
+ *  checks and benchmark of the biome lookup table (@ref biome_table_get()) against scoring
+ *  every biome (@ref biome_match()).
+ *
+ *  - exactness: the same biome as brute force for millions of random parameter vectors,
+ *    for the biomes of @ref terrain_init() and for sets of random biomes up to the 32 a
+ *    table holds, with vectors on cell bounds, at the edges of [0.0, 1.0] and past them,
+ *  - columns per second of both, on random vectors, on vectors varying smoothly as
+ *    between adjacent columns and on the biome noises of generated terrain, for 5 to 32
+ *    biomes, against which @ref BIOME_TABLE_BIOME_MIN is set,
+ *  - share of vectors the table answers without scoring, and biomes scored otherwise.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
+#include "../../game_hhc/src/h/world.h"
+#include "../../game_hhc/src/terrain/biome.h"
+#include "../../game_hhc/src/terrain/terrain.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VECTOR_COUNT    4000000
+#define AREA_CHUNKS     128     /* chunks per side of the area sampled for terrain vectors */
+#define RANDOM_SET_MAX  32
+#define SEED            12345
+
+world_info world = {0};
+
+static hhc_biome_table table = {0};
+static f64 *param = NULL;
+
+static fsl_noise_sampler sampler = {0};
+static fsl_noise_sampler_context ctx = {0};
+
+/*! @return uniform in [0.0, 1.0]. */
+static f64 rand_unit(u64 seed)
+{
+    return (f64)(fsl_rand_u64(seed) >> 11) / (f64)(((u64)1 << 53) - 1);
+}
+
+/*!
+ *  @brief fill @ref param with random vectors, one in 16 values snapped to a cell bound
+ *  and one in 256 past [0.0, 1.0].
+ */
+static void param_fill(u64 seed)
+{
+    u64 i = 0, r = 0;
+
+    for (i = 0; i < (u64)VECTOR_COUNT * BIOME_NOISE_COUNT; ++i)
+    {
+        r = fsl_rand_u64(seed + i * 2 + 1);
+        param[i] = rand_unit(seed + i * 2);
+        if (!(r & 0xf))
+            param[i] = (f64)((r >> 4) % (BIOME_TABLE_RES + 1)) / BIOME_TABLE_RES;
+        else if (!(r & 0xff0))
+            param[i] = param[i] * 3.0 - 1.0;
+    }
+}
+
+/*!
+ *  @brief fill @ref param with vectors varying smoothly from one to the next, as biome
+ *  noises do between adjacent columns.
+ */
+static void param_fill_coherent(void)
+{
+    u64 i = 0, j = 0;
+
+    for (i = 0; i < VECTOR_COUNT; ++i)
+        for (j = 0; j < BIOME_NOISE_COUNT; ++j)
+            param[i * BIOME_NOISE_COUNT + j] = 0.5 + 0.5 * sin((f64)i * 1e-4 * (j + 1.3) + j);
+}
+
+/*!
+ *  @brief fill @ref param with the biome noises of the columns of a square of chunks
+ *  around the origin, chunk by chunk, as chunk generation reads them.
+ */
+static void param_fill_terrain(void)
+{
+    i32 cx = 0, cy = 0, x = 0, y = 0;
+    u64 i = 0;
+
+    for (cy = -AREA_CHUNKS / 2; cy < AREA_CHUNKS / 2; ++cy)
+        for (cx = -AREA_CHUNKS / 2; cx < AREA_CHUNKS / 2; ++cx)
+        {
+            fsl_noise_sampler_context_init(&sampler, &ctx,
+                    (f64)(cx * CHUNK_DIAMETER), (f64)(cy * CHUNK_DIAMETER), 0.0);
+            terrain_grid_bake(&ctx);
+
+            fsl_noise_sampler_axis_init(&ctx, 2, 0);
+            fsl_noise_sampler_axis_pre_update(&ctx, 2);
+
+            fsl_noise_sampler_axis_init(&ctx, 1, 0);
+            for (y = 0; y < CHUNK_DIAMETER; ++y, fsl_noise_sampler_axis_post_update(&ctx, 1))
+            {
+                fsl_noise_sampler_axis_pre_update(&ctx, 1);
+                sampler_noise_axis_update_2d(&ctx, 1);
+
+                fsl_noise_sampler_axis_init(&ctx, 0, 0);
+                for (x = 0; x < CHUNK_DIAMETER; ++x, fsl_noise_sampler_axis_post_update(&ctx, 0))
+                {
+                    fsl_noise_sampler_axis_pre_update(&ctx, 0);
+                    sampler_noise_axis_update_2d(&ctx, 0);
+                    sampler_noise_bake(&ctx);
+
+                    if (i < VECTOR_COUNT)
+                        memcpy(&param[i * BIOME_NOISE_COUNT],
+                                &sampler.noise_buf.noise_dst_buf[TERRAIN_NOISE_COUNT],
+                                BIOME_NOISE_COUNT * sizeof(f64));
+                    ++i;
+                }
+            }
+            fsl_noise_sampler_axis_post_update(&ctx, 2);
+        }
+}
+
+/*!
+ *  @brief report how often the table of `biome` answers without scoring, and how many
+ *  biomes it scores otherwise, over @ref param.
+ */
+static void table_stats(const str *input, const hhc_biome *biome, u32 biome_count)
+{
+    u64 i = 0, direct = 0, scored = 0, cell = 0, k = 0;
+    u32 candidate = 0;
+    i32 j = 0;
+
+    biome_table_build(&table, biome, biome_count);
+    for (i = 0; i < VECTOR_COUNT; ++i)
+    {
+        cell = 0;
+        for (j = BIOME_NOISE_COUNT - 1; j >= 0; --j)
+        {
+            k = (u64)(fsl_clamp_f64(param[i * BIOME_NOISE_COUNT + j], 0.0, 1.0) * BIOME_TABLE_RES);
+            cell = cell * BIOME_TABLE_RES + (k < BIOME_TABLE_RES ? k : BIOME_TABLE_RES - 1);
+        }
+
+        if (table.match[cell] != BIOME_TABLE_UNRESOLVED)
+            ++direct;
+        else
+            for (candidate = table.candidate[cell]; candidate; candidate &= candidate - 1)
+                ++scored;
+    }
+
+    CHECK_REPORT(fsl_logger_stringf("%-9s %2"PRIu32" biomes: %.1f%% answered by the table alone, "
+                "%.2f of %"PRIu32" biomes scored otherwise\n",
+                input, biome_count, (f64)direct / VECTOR_COUNT * 100.0,
+                direct < VECTOR_COUNT ? (f64)scored / (VECTOR_COUNT - direct) : 0.0, biome_count));
+}
+
+/*! @return vectors whose table biome differs from brute force. */
+static u64 check_biomes(const str *name, const hhc_biome *biome, u32 biome_count)
+{
+    u64 i = 0, mismatch = 0;
+
+    biome_table_build(&table, biome, biome_count);
+    for (i = 0; i < VECTOR_COUNT; ++i)
+        if (biome_table_get(&table, &param[i * BIOME_NOISE_COUNT]) !=
+                biome_match(biome, biome_count, &param[i * BIOME_NOISE_COUNT]))
+            ++mismatch;
+
+    CHECK(!mismatch,
+            fsl_logger_stringf("%s: %"PRIu64" of %d Vectors Matched a Different Biome\n",
+                name, mismatch, VECTOR_COUNT));
+    return mismatch;
+}
+
+static void bench(const str *input, const hhc_biome *biome, u32 biome_count)
+{
+    u64 i = 0, time_start = 0, sum_brute = 0, sum_table = 0;
+    f64 time_brute = 0.0, time_table = 0.0;
+
+    biome_table_build(&table, biome, biome_count);
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < VECTOR_COUNT; ++i)
+        sum_brute += biome_match(biome, biome_count, &param[i * BIOME_NOISE_COUNT]);
+    time_brute = check_time_since(time_start);
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < VECTOR_COUNT; ++i)
+        sum_table += biome_table_get(&table, &param[i * BIOME_NOISE_COUNT]);
+    time_table = check_time_since(time_start);
+
+    CHECK(sum_brute == sum_table, "Bench: Sums Differ\n");
+
+    CHECK_REPORT(fsl_logger_stringf("%-9s %2"PRIu32" biomes: brute force %7.2f Mcolumns/s, table %7.2f Mcolumns/s\n",
+                input, biome_count,
+                (f64)VECTOR_COUNT / time_brute * 1e-6, (f64)VECTOR_COUNT / time_table * 1e-6));
+}
+
+int main(int argc, char **argv)
+{
+    static hhc_biome random_biome[RANDOM_SET_MAX];
+    str name[FSL_ID_CAP] = {0};
+    u64 param_size = (u64)VECTOR_COUNT * BIOME_NOISE_COUNT * sizeof(f64);
+    u64 mismatch = 0;
+    u32 i = 0, j = 0, count = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&param, param_size, "main().param") != FSL_ERR_SUCCESS ||
+            fsl_noise_sampler_init(&sampler, TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT, 8,
+                (f64)(WORLD_RADIUS * CHUNK_DIAMETER),
+                (f64)(WORLD_RADIUS * CHUNK_DIAMETER),
+                (f64)(WORLD_RADIUS_VERTICAL * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER_VERTICAL * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER)) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    world.seed = SEED;
+    terrain_init();
+
+    param_fill(SEED);
+    mismatch += check_biomes("terrain", terrain_spec_get()->biome, BIOME_COUNT);
+
+    /* biome parameters within and a little past [0.0, 1.0], as @ref biome_init() allows */
+    for (count = 2; count <= RANDOM_SET_MAX; count *= 2)
+    {
+        for (i = 0; i < count; ++i)
+            for (j = 0; j < BIOME_NOISE_COUNT; ++j)
+                random_biome[i].spec[j] =
+                    rand_unit(SEED * count + i * BIOME_NOISE_COUNT + j) * 1.2 - 0.1;
+
+        snprintf(name, sizeof(name), "random %"PRIu32, count);
+        param_fill(SEED + count);
+        mismatch += check_biomes(name, random_biome, count);
+    }
+
+    param_fill(SEED);
+    bench("random", terrain_spec_get()->biome, BIOME_COUNT);
+    for (count = 8; count <= RANDOM_SET_MAX; count *= 2)
+        bench("random", random_biome, count);
+    table_stats("random", terrain_spec_get()->biome, BIOME_COUNT);
+
+    param_fill_coherent();
+    mismatch += check_biomes("coherent", terrain_spec_get()->biome, BIOME_COUNT);
+    bench("coherent", terrain_spec_get()->biome, BIOME_COUNT);
+    for (count = 8; count <= RANDOM_SET_MAX; count *= 2)
+        bench("coherent", random_biome, count);
+    table_stats("coherent", terrain_spec_get()->biome, BIOME_COUNT);
+
+    param_fill_terrain();
+    mismatch += check_biomes("terrain", terrain_spec_get()->biome, BIOME_COUNT);
+    bench("terrain", terrain_spec_get()->biome, BIOME_COUNT);
+    table_stats("terrain", terrain_spec_get()->biome, BIOME_COUNT);
+
+    CHECK_REPORT(fsl_logger_stringf("%"PRIu64" mismatches over %d vectors per biome set\n",
+                mismatch, VECTOR_COUNT));
+
+cleanup:
+
+    fsl_noise_sampler_free(&sampler);
+    fsl_mem_unmap((void*)&param, param_size, "main().param");
+    return CHECK_CLOSE();
+}
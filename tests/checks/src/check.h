@@ -0,0 +1,58 @@
+/*!
+ *  shared helpers for the headless checks and benchmarks in 'checks/src/' (`./build checks`).
+ *
+ *  every check is its own program: it initializes the engine headless, runs its cases,
+ *  logs a summary line per case and exits non-zero if any case failed, so
+ *  `./build checks run` can stop on the first failing one.
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include "../../../fossil/deps/fossil/fossil_engine.h"
+
+#include <inttypes.h>
+
+#define CHECK_ERR_FAIL 1
+
+#define arr_len(arr) ((u64)sizeof(arr) / sizeof(arr[0]))
+
+/*! @brief number of failed cases, the exit code of a check is non-zero if this is. */
+static u32 check_fail_count = 0;
+
+/*!
+ *  @brief fail the running case if `condition` doesn't hold, keep running.
+ *
+ *  @param message string from @ref fsl_logger_stringf(), logged on failure.
+ */
+#define CHECK(condition, message) \
+    do { \
+        if (!(condition)) \
+        { \
+            ++check_fail_count; \
+            LOGERROR(CHECK_ERR_FAIL, FSL_FLAG_LOG_NO_VERBOSE, message); \
+        } \
+    } while (0)
+
+/*! @brief log a case result or a timing, at info level. */
+#define CHECK_REPORT(message) \
+    LOGINFO(FSL_FLAG_LOG_NO_VERBOSE, message)
+
+/*!
+ *  @brief init the engine headless, log level is taken from `argv[2]` as for any engine program
+ *  (e.g., `./<check> checks loginfo`).
+ */
+#define CHECK_INIT(argc, argv) \
+    fsl_engine_init(argc, argv, NULL, 0, 0, FSL_FLAG_HEADLESS)
+
+/*! @brief close the engine and turn the failure count into an exit code. */
+#define CHECK_CLOSE() \
+    (fsl_engine_close(), check_fail_count ? CHECK_ERR_FAIL : FSL_ERR_SUCCESS)
+
+/*! @return seconds elapsed since `time_start` (from @ref fsl_get_time_nsec()). */
+static f64 check_time_since(u64 time_start)
+{
+    return (f64)(fsl_get_time_nsec() - time_start) * FSL_NSEC2SEC;
+}
+
+#endif /* CHECK_H */
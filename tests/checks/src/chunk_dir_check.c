@@ -0,0 +1,189 @@
+/*!
+ *  checks of @ref chunk_dir_update() and chunk files under a live `world.dir_chunks`,
+ *  headless, as @ref world_update() would drive them between frames.
+ *
+ *  - time per @ref chunk_dir_update() on a valid handle, paid every frame,
+ *  - round-trip of @ref chunk_export_internal() and @ref chunk_import_internal(), for
+ *    a chunk of mixed runs and single blocks and for an air chunk,
+ *  - chunk directory deleted: the handle goes invalid and updates keep failing,
+ *  - chunk directory recreated: the handle reopens, temp files left in it are swept,
+ *    chunk files written before are gone and new ones round-trip again,
+ *  - chunk directory deleted and recreated between two updates: the handle reopens
+ *    onto the new directory in one update.
+ */
+
+#include "check.h"
+#include "../../game_hhc/src/h/common.h"
+#include "../../game_hhc/src/h/world.h"
+#include "../../game_hhc/src/chunking/chunking.h"
+#include "../../game_hhc/src/chunking/chunking_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DIR_TEMP        "temp_chunk_dir/"
+#define DIR_CHUNKS      DIR_TEMP GAME_DIR_WORLD_NAME_CHUNKS
+#define FILE_STRAY      DIR_CHUNKS"0.0.0.hhcr.12345.fsltmp"
+#define UPDATE_COUNT    1000000
+
+world_info world = {0};
+
+static hhc_chunk chunk_src = {0};
+static hhc_chunk chunk_dst = {0};
+
+/*! @brief fill `chunk` with runs and single blocks, or none if `air`. */
+static void chunk_fill(hhc_chunk *chunk, i16 x, i16 y, i16 z, b8 air)
+{
+    u32 *block = (u32*)chunk->block;
+    u32 i = 0;
+
+    memset(chunk, 0, sizeof(*chunk));
+    chunk->pos_wrap.x = x;
+    chunk->pos_wrap.y = y;
+    chunk->pos_wrap.z = z;
+    if (air)
+        return;
+
+    chunk->flag = FLAG_CHUNK_NON_AIR;
+    for (i = 0; i < CHUNK_VOLUME; ++i)
+        block[i] = i < CHUNK_VOLUME / 2 ? (i / 37) % 4 : (u32)fsl_rand_u64(i) & MASK_BLOCK_ID;
+}
+
+/*! @return non-zero if `chunk_src` doesn't survive an export and an import. */
+static u32 round_trip(const str *label, i16 x, i16 y, i16 z, b8 air)
+{
+    hhc_chunk_receipt receipt = {0};
+    str name[FSL_ID_CAP] = {0};
+    str path[FSL_PATH_CAP] = {0};
+    u32 fail = 0;
+
+    chunk_fill(&chunk_src, x, y, z, air);
+    memset(&chunk_dst, 0xff, sizeof(chunk_dst));
+    snprintf(name, FSL_ID_CAP, FORMAT_FILE_NAME_HHCC, x, y, z);
+    snprintf(path, FSL_PATH_CAP, DIR_CHUNKS"%s", name);
+
+    fsl_write_batch_begin();
+    chunk_export_internal(&chunk_src, &receipt);
+    fsl_write_batch_end();
+
+    fail |= fsl_is_file_exists(path, FALSE) != FSL_ERR_SUCCESS;
+    fail |= !chunk_import_internal(name, &chunk_dst, &receipt);
+    fail |= memcmp(chunk_src.block, chunk_dst.block, air ? 0 : sizeof(chunk_src.block)) != 0;
+    fail |= (chunk_dst.flag & FLAG_CHUNK_NON_AIR) != (chunk_src.flag & FLAG_CHUNK_NON_AIR);
+    fail |= chunk_dst.pos_wrap.x != x || chunk_dst.pos_wrap.y != y || chunk_dst.pos_wrap.z != z;
+
+    CHECK(!fail, fsl_logger_stringf("%s: '%s' Didn't Round-Trip\n", label, name));
+    return fail;
+}
+
+/*! @brief delete @ref DIR_CHUNKS and the chunk files in it. */
+static void chunks_remove(void)
+{
+    fsl_buf contents = {0};
+    str path[FSL_PATH_CAP] = {0};
+    u64 i = 0;
+
+    if (fsl_is_dir_exists(DIR_CHUNKS, FALSE) != FSL_ERR_SUCCESS)
+        return;
+
+    contents = fsl_get_dir_contents(DIR_CHUNKS);
+    for (i = 0; i < contents.memb; ++i)
+    {
+        snprintf(path, FSL_PATH_CAP, DIR_CHUNKS"%s", (const str*)contents.i[i]);
+        remove(path);
+    }
+    fsl_mem_free_buf(&contents, "chunks_remove().contents");
+    remove(DIR_CHUNKS);
+}
+
+/*! @brief create @ref DIR_CHUNKS with a stray temp file in it. */
+static u32 chunks_create(void)
+{
+    FILE *file = NULL;
+
+    if (fsl_make_dir(DIR_CHUNKS) != FSL_ERR_SUCCESS || (file = fopen(FILE_STRAY, "wb")) == NULL)
+        return FSL_ERR_DIR_NOT_FOUND;
+    fclose(file);
+    return FSL_ERR_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    hhc_chunk_receipt receipt = {0};
+    str name[FSL_ID_CAP] = {0};
+    u64 i = 0, time_start = 0;
+    f64 time_update = 0.0;
+    b8 update = FALSE;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    chunks_remove();
+    remove(DIR_TEMP);
+    if ((fsl_make_dir(DIR_TEMP) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS) ||
+            chunks_create() != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    snprintf(world.path, FSL_PATH_CAP, "%s", DIR_TEMP);
+    fsl_dir_handle_open(&world.dir_chunks, DIR_CHUNKS, FSL_FLAG_DIR_HANDLE_SWEEP_TEMP, TRUE);
+    CHECK(chunk_dir_update(), "Open: Chunk Directory Not Ready\n");
+    CHECK(fsl_is_file_exists(FILE_STRAY, FALSE) != FSL_ERR_SUCCESS, "Open: Temp File Not Swept\n");
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0, update = TRUE; i < UPDATE_COUNT; ++i)
+        update &= chunk_dir_update();
+    time_update = check_time_since(time_start);
+    CHECK(update, "Open: Chunk Directory Not Ready Every Update\n");
+
+    round_trip("Open", 3, -2, 1, FALSE);
+    round_trip("Open", -7, 0, 4, TRUE);
+
+    /* ---- deleted, chunking pauses ---------------------------------------- */
+
+    chunks_remove();
+    for (i = 0, update = FALSE; i < 3; ++i)
+        update |= chunk_dir_update();
+    CHECK(!update, "Deleted: Chunk Directory Still Ready\n");
+    CHECK(!fsl_dir_handle_is_valid(&world.dir_chunks), "Deleted: Handle Still Valid\n");
+
+    /* ---- recreated, chunking resumes ------------------------------------- */
+
+    if (chunks_create() != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Recreate Failed\n");
+        goto cleanup;
+    }
+    CHECK(chunk_dir_update(), "Recreated: Chunk Directory Not Reopened\n");
+    CHECK(fsl_is_file_exists(FILE_STRAY, FALSE) != FSL_ERR_SUCCESS, "Recreated: Temp File Not Swept\n");
+
+    snprintf(name, FSL_ID_CAP, FORMAT_FILE_NAME_HHCC, 3, -2, 1);
+    CHECK(!chunk_import_internal(name, &chunk_dst, &receipt), "Recreated: Old Chunk File Imported\n");
+
+    round_trip("Recreated", 3, -2, 1, FALSE);
+    round_trip("Recreated", 5, 5, -5, TRUE);
+
+    /* ---- deleted and recreated between two updates ----------------------- */
+
+    chunks_remove();
+    if (chunks_create() != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Recreate Failed\n");
+        goto cleanup;
+    }
+    CHECK(chunk_dir_update(), "Swapped: Chunk Directory Not Reopened\n");
+    CHECK(fsl_is_file_exists(FILE_STRAY, FALSE) != FSL_ERR_SUCCESS, "Swapped: Temp File Not Swept\n");
+    round_trip("Swapped", -1, 9, 2, FALSE);
+
+    CHECK_REPORT(fsl_logger_stringf("chunk directory deleted, recreated and swapped under a live handle, "
+                "%.1fns per update while valid\n", time_update / UPDATE_COUNT * 1e9));
+
+cleanup:
+
+    fsl_dir_handle_close(&world.dir_chunks);
+    chunks_remove();
+    remove(DIR_TEMP);
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,137 @@
+/*!
+ *  checks of @ref fsl_copy_file_ex(): files of 0 and 1 bytes, sizes around a page, and a
+ *  sparse file past 2 GiB (past the per-call limit of `sendfile()`), compared by
+ *  streamed FNV-1a hashes and reported length, plus mode bits on linux.
+ */
+
+#include "check.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#define DIR_TEMP    "temp_copy_file/"
+#define PATH_SRC    DIR_TEMP"src.bin"
+#define PATH_DST    DIR_TEMP"dst.bin"
+#define HASH_CHUNK  (1024 * 1024)
+
+static u64 size_list[] =
+{
+    0, 1, 4095, 4096, 4097, 65536 * 3 + 17,
+    ((u64)2 << 30) + 4097,  /* sparse, only its first and last pages hold data */
+};
+
+static u8 *chunk = NULL;
+
+/*! @return FNV-1a of the file at `path`, read in chunks, 0 if it can't be opened. */
+static u64 file_hash(const str *path, u64 *len)
+{
+    FILE *file = NULL;
+    u64 hash = 0xcbf29ce484222325;
+    u64 read = 0, i = 0;
+
+    *len = 0;
+    if ((file = fopen(path, "rb")) == NULL)
+        return 0;
+
+    while ((read = fread(chunk, 1, HASH_CHUNK, file)) > 0)
+    {
+        for (i = 0; i < read; ++i)
+            hash = (hash ^ chunk[i]) * 0x100000001b3;
+        *len += read;
+    }
+
+    fclose(file);
+    return hash;
+}
+
+/*! @brief write `size` bytes, random data in the first and last pages, a hole in between. */
+static b8 file_make(const str *path, u64 size)
+{
+    FILE *file = NULL;
+    u64 head = size < 8192 ? size : 4096;
+    u64 i = 0;
+
+    if ((file = fopen(path, "wb")) == NULL)
+        return FALSE;
+
+    for (i = 0; i < head; ++i)
+        chunk[i] = (u8)fsl_rand_u64(i + size);
+    fwrite(chunk, 1, head, file);
+
+    if (size > head)
+    {
+        /* seeking past the end leaves a hole */
+        fseek(file, (long)(size - 4096), SEEK_SET);
+        for (i = 0; i < 4096; ++i)
+            chunk[i] = (u8)fsl_rand_u64(i + size + 4096);
+        fwrite(chunk, 1, 4096, file);
+    }
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    u64 hash_src = 0, hash_dst = 0, len_src = 0, len_dst = 0, copied = 0, i = 0, time_start = 0;
+    f64 time = 0.0;
+#ifdef FSL_PLATFORM_LINUX
+    struct stat stat_src = {0}, stat_dst = {0};
+#endif
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&chunk, HASH_CHUNK, "main().chunk") != FSL_ERR_SUCCESS ||
+            (fsl_make_dir(DIR_TEMP) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS))
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    for (i = 0; i < arr_len(size_list); ++i)
+    {
+        if (!file_make(PATH_SRC, size_list[i]))
+        {
+            CHECK(FALSE, fsl_logger_stringf("Size %"PRIu64": Failed to Write Source\n", size_list[i]));
+            continue;
+        }
+
+#ifdef FSL_PLATFORM_LINUX
+        chmod(PATH_SRC, (mode_t)(0600 | (i % 2 ? 0044 : 0010)));
+#endif
+
+        time_start = fsl_get_time_nsec();
+        copied = 0;
+        CHECK(fsl_copy_file_ex(PATH_SRC, PATH_DST, &copied) == FSL_ERR_SUCCESS,
+                fsl_logger_stringf("Size %"PRIu64": Copy Failed\n", size_list[i]));
+        time = check_time_since(time_start);
+
+        hash_src = file_hash(PATH_SRC, &len_src);
+        hash_dst = file_hash(PATH_DST, &len_dst);
+        CHECK(len_src == size_list[i] && len_dst == size_list[i] && copied == size_list[i],
+                fsl_logger_stringf("Size %"PRIu64": Source %"PRIu64"B, Copy %"PRIu64"B, Reported %"PRIu64"B\n",
+                    size_list[i], len_src, len_dst, copied));
+        CHECK(hash_src == hash_dst,
+                fsl_logger_stringf("Size %"PRIu64": Hash Mismatch\n", size_list[i]));
+
+#ifdef FSL_PLATFORM_LINUX
+        CHECK(stat(PATH_SRC, &stat_src) == 0 && stat(PATH_DST, &stat_dst) == 0 &&
+                (stat_src.st_mode & 07777) == (stat_dst.st_mode & 07777),
+                fsl_logger_stringf("Size %"PRIu64": Mode Not Preserved\n", size_list[i]));
+#endif
+
+        CHECK_REPORT(fsl_logger_stringf("%11"PRIu64"B copied in %9.3fms\n", size_list[i], time * 1e3));
+
+        remove(PATH_DST);
+        remove(PATH_SRC);
+    }
+
+cleanup:
+
+    remove(PATH_DST);
+    remove(PATH_SRC);
+    remove(DIR_TEMP);
+    fsl_mem_unmap((void*)&chunk, HASH_CHUNK, "main().chunk");
+    return CHECK_CLOSE();
+}
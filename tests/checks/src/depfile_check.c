@@ -0,0 +1,202 @@
+/*!
+ *  checks of the header tracking of `compile()` in buildtool (`is_deps_changed_internal()`),
+ *  on the fixture in 'checks/fixtures/depfile/': `a.c` and `b.c` both include `shared.h`,
+ *  each includes its own private header, and `b_private.h` includes `sub dir/dol$lar.h`,
+ *  whose name the compiler escapes in the depfile.
+ *
+ *  - touching each header recompiles exactly the objects including it, nothing else,
+ *  - a missing depfile recompiles its object only,
+ *  - the compiler's depfile holds the `\ `, `$$` and line continuation escapes checked,
+ *  - hand-written depfiles: escapes, `\r\n` continuations, missing and newer
+ *    prerequisites, a missing depfile and one without a target.
+ *
+ *  built against buildtool alone, the engine's headers would collide with it.
+ */
+
+/* buildtool is all `static`, most of it unused here */
+#pragma GCC diagnostic ignored "-Wunused-function"
+
+#include "../../../fossil/deps/fossil/external/buildtool/buildtool.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <utime.h>
+
+#define CHECK_ERR_FAIL  1
+
+#define DIR_FIXTURE     "checks/fixtures/depfile/"
+#define DIR_TEMP        "temp_depfile/"
+#define DIR_OBJ         DIR_TEMP"obj/"
+#define PATH_DEPFILE    DIR_TEMP"hand.d"
+#define AGE_SRC         1000    /* seconds sources and headers are backdated by */
+#define AGE_OBJ         100     /* seconds objects are backdated by before each case */
+#define AGE_TOUCH       50      /* seconds a touched header is backdated by, newer than objects */
+
+#define CHECK(condition, message) \
+    do { \
+        if (!(condition)) \
+        { \
+            ++check_fail_count; \
+            LOGERROR(CHECK_ERR_FAIL, FALSE, message); \
+        } \
+    } while (0)
+
+static u32 check_fail_count = 0;
+
+static const str *src_list[] = {DIR_TEMP"a.c", DIR_TEMP"b.c"};
+static const str *header_list[] =
+{
+    DIR_TEMP"shared.h",
+    DIR_TEMP"a_private.h",
+    DIR_TEMP"b_private.h",
+    DIR_TEMP"sub dir/dol$lar.h",
+};
+static const u32 header_mask[] = {0x3, 0x1, 0x2, 0x2}; /* objects including each of @ref header_list */
+
+static bt_buf cmd_cc = {0};
+static bt_buf src = {0};
+static str obj[2][PATH_CAP];
+
+/*! @brief set the access and modification times of `path` to `age` seconds ago. */
+static void backdate(const str *path, u64 age)
+{
+    struct utimbuf t = {0};
+
+    t.actime = t.modtime = (time_t)(get_time_nsec() / 1000000000 - age);
+    utime(path, &t);
+}
+
+/*! @brief compile @ref src_list into @ref DIR_OBJ.
+ *
+ *  @return bit `i` set if object `i` was (re)written.
+ */
+static u32 rebuild_mask(void)
+{
+    u64 mtime_old[2] = {0}, mtime_new[2] = {0};
+    u32 i = 0, mask = 0;
+
+    for (i = 0; i < arr_len(src_list); ++i)
+        get_file_mtime(obj[i], &mtime_old[i]);
+
+    if (compile(&cmd_cc, &src, DIR_OBJ, NULL) != ERR_SUCCESS)
+        return 0xffffffff;
+
+    for (i = 0; i < arr_len(src_list); ++i)
+        if (get_file_mtime(obj[i], &mtime_new[i]) == ERR_SUCCESS && mtime_new[i] != mtime_old[i])
+            mask |= 1 << i;
+    return mask;
+}
+
+static void objects_backdate(void)
+{
+    u32 i = 0;
+
+    for (i = 0; i < arr_len(src_list); ++i)
+        backdate(obj[i], AGE_OBJ);
+}
+
+/*! @return `TRUE` if `is_deps_changed_internal()` of a depfile holding `contents` is `expect`. */
+static b8 depfile_is(const str *contents, u64 age, b8 expect)
+{
+    FILE *file = NULL;
+
+    if ((file = fopen(PATH_DEPFILE, "wb")) == NULL)
+        return FALSE;
+    fputs(contents, file);
+    fclose(file);
+    return is_deps_changed_internal(PATH_DEPFILE, (get_time_nsec() / 1000000000 - age) * 1000000000) == expect;
+}
+
+static void check_compile(void)
+{
+    str *depfile = NULL;
+    u64 len = 0;
+    u32 i = 0, mask = 0;
+
+    mask = rebuild_mask();
+    CHECK(mask == 0x3, logger_stringf("First Build: Rebuilt 0x%x, Expected 0x3\n", mask));
+
+    objects_backdate();
+    mask = rebuild_mask();
+    CHECK(mask == 0, logger_stringf("Nothing Touched: Rebuilt 0x%x, Expected 0x0\n", mask));
+
+    for (i = 0; i < arr_len(header_list); ++i)
+    {
+        objects_backdate();
+        backdate(header_list[i], AGE_TOUCH);
+        mask = rebuild_mask();
+        backdate(header_list[i], AGE_SRC);
+        CHECK(mask == header_mask[i],
+                logger_stringf("Touched '%s': Rebuilt 0x%x, Expected 0x%x\n",
+                    header_list[i], mask, header_mask[i]));
+    }
+
+    objects_backdate();
+    remove(stringf("%s"DEPFILE_EXT, obj[0]));
+    mask = rebuild_mask();
+    CHECK(mask == 0x1, logger_stringf("Missing Depfile: Rebuilt 0x%x, Expected 0x1\n", mask));
+
+    len = get_file_contents(stringf("%s"DEPFILE_EXT, obj[1]), (void*)&depfile, 1, TRUE);
+    CHECK(depfile && strstr(depfile, "sub\\ dir/dol$$lar.h") && strstr(depfile, "\\\n"),
+            "Compiler Depfile: Escapes Missing\n");
+    if (depfile)
+        mem_free((void*)&depfile, len + 1, "check_compile().depfile");
+}
+
+static void check_depfile(void)
+{
+    CHECK(depfile_is("x.o: "DIR_TEMP"sub\\ dir/dol$$lar.h \\\n "DIR_TEMP"shared.h\n", 0, FALSE),
+            "Hand Depfile: Escapes Not Parsed\n");
+    CHECK(depfile_is("x.o: "DIR_TEMP"sub\\ dir/dol$$lar.h \\\n "DIR_TEMP"shared.h\n", AGE_SRC * 2, TRUE),
+            "Hand Depfile: Newer Prerequisite Missed\n");
+    CHECK(depfile_is("x.o: \\\r\n "DIR_TEMP"a_private.h \\\r\n "DIR_TEMP"shared.h\r\n", 0, FALSE),
+            "Hand Depfile: CRLF Continuation Not Parsed\n");
+    CHECK(depfile_is("x.o: "DIR_TEMP"shared.h "DIR_TEMP"gone.h\n", 0, TRUE),
+            "Hand Depfile: Missing Prerequisite Missed\n");
+    CHECK(depfile_is("x.o:\n", 0, FALSE),
+            "Hand Depfile: No Prerequisites Changed\n");
+    CHECK(depfile_is("x.o "DIR_TEMP"shared.h\n", 0, TRUE),
+            "Hand Depfile: No Target Unchanged\n");
+
+    remove(PATH_DEPFILE);
+    CHECK(is_deps_changed_internal(PATH_DEPFILE, get_time_nsec()), "Missing Depfile: Unchanged\n");
+}
+
+int main(void)
+{
+    u32 i = 0;
+
+    if (copy_dir(DIR_FIXTURE, DIR_TEMP, TRUE) != ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    cmd_push(&cmd_cc, COMPILER);
+    cmd_push(&cmd_cc, "-std=c89");
+    cmd_ready(&cmd_cc);
+
+    for (i = 0; i < arr_len(src_list); ++i)
+    {
+        cmd_push(&src, src_list[i]);
+        object_path_internal(src_list[i], DIR_OBJ, obj[i]);
+        backdate(src_list[i], AGE_SRC);
+    }
+    cmd_ready(&src);
+    for (i = 0; i < arr_len(header_list); ++i)
+        backdate(header_list[i], AGE_SRC);
+
+    check_compile();
+    check_depfile();
+
+    LOGINFO(FALSE,
+            logger_stringf("%"PRIu64" headers touched, %"PRIu32" failed\n",
+                (u64)arr_len(header_list), check_fail_count));
+
+cleanup:
+
+    cmd_free(&cmd_cc);
+    cmd_free(&src);
+    cmd_exec(3, "rm", "-rf", DIR_TEMP);
+    return check_fail_count ? CHECK_ERR_FAIL : ERR_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*!
+ *  checks and benchmark of @ref fsl_get_dir_contents() and @ref fsl_get_dir_contents_ex()
+ *  on a directory of 100k entries, enough to grow the contents buffer many times over.
+ *
+ *  - every entry listed once, directories slash terminated,
+ *  - only files of the extension listed when filtering,
+ *  - listing time of both against @ref fsl_get_dir_entry_count().
+ */
+
+#include "check.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DIR_TEMP        "temp_dir_contents/"
+#define FILE_COUNT      100000
+#define DIR_COUNT       16
+#define EXT             ".bin"
+#define EXT_EVERY       10  /* one file in `EXT_EVERY` doesn't end in @ref EXT */
+
+static u8 seen[FILE_COUNT + DIR_COUNT];
+
+/*!
+ *  @brief mark the entries of `contents` in @ref seen.
+ *
+ *  @return entries that are malformed, listed twice or filtered wrong.
+ */
+static u64 contents_mark(const fsl_buf *contents, b8 filtered)
+{
+    u64 i = 0, bad = 0, index = 0, len = 0;
+    const str *name = NULL;
+    str tail = 0;
+
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < contents->memb; ++i)
+    {
+        name = (const str*)contents->i[i];
+        len = strlen(name);
+        if (sscanf(name, "d%6"SCNu64"%c", &index, &tail) == 2 && tail == '/' &&
+                index < DIR_COUNT && name[len - 1] == '/')
+            index += FILE_COUNT;
+        else if (sscanf(name, "f%6"SCNu64, &index) != 1 || index >= FILE_COUNT ||
+                strcmp(name + 7, index % EXT_EVERY ? EXT : ".txt"))
+        {
+            ++bad;
+            continue;
+        }
+
+        if (seen[index] || (filtered && (index >= FILE_COUNT || !(index % EXT_EVERY))))
+            ++bad;
+        seen[index] = 1;
+    }
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    fsl_buf contents = {0};
+    FILE *file = NULL;
+    str path[FSL_PATH_CAP] = {0};
+    u64 i = 0, bad = 0, count = 0, time_start = 0;
+    f64 time_count = 0.0, time_all = 0.0, time_ext = 0.0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (fsl_make_dir(DIR_TEMP) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    for (i = 0; i < FILE_COUNT; ++i)
+    {
+        snprintf(path, FSL_PATH_CAP, DIR_TEMP"f%06"PRIu64"%s", i, i % EXT_EVERY ? EXT : ".txt");
+        if ((file = fopen(path, "wb")) == NULL)
+        {
+            CHECK(FALSE, fsl_logger_stringf("Failed to Create '%s'\n", path));
+            goto cleanup;
+        }
+        fclose(file);
+    }
+    for (i = 0; i < DIR_COUNT; ++i)
+    {
+        snprintf(path, FSL_PATH_CAP, DIR_TEMP"d%06"PRIu64, i);
+        if (fsl_make_dir(path) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS)
+        {
+            CHECK(FALSE, fsl_logger_stringf("Failed to Create '%s'\n", path));
+            goto cleanup;
+        }
+    }
+
+    time_start = fsl_get_time_nsec();
+    count = fsl_get_dir_entry_count(DIR_TEMP);
+    time_count = check_time_since(time_start);
+    CHECK(count == FILE_COUNT + DIR_COUNT,
+            fsl_logger_stringf("Entry Count %"PRIu64", Expected %d\n", count, FILE_COUNT + DIR_COUNT));
+
+    time_start = fsl_get_time_nsec();
+    contents = fsl_get_dir_contents(DIR_TEMP);
+    time_all = check_time_since(time_start);
+    bad = contents_mark(&contents, FALSE);
+    CHECK(contents.memb == FILE_COUNT + DIR_COUNT && !bad,
+            fsl_logger_stringf("All: %"PRIu64" Entries, %"PRIu64" Bad, Expected %d\n",
+                contents.memb, bad, FILE_COUNT + DIR_COUNT));
+    fsl_mem_free_buf(&contents, "main().contents");
+
+    time_start = fsl_get_time_nsec();
+    contents = fsl_get_dir_contents_ex(DIR_TEMP, EXT);
+    time_ext = check_time_since(time_start);
+    bad = contents_mark(&contents, TRUE);
+    CHECK(contents.memb == FILE_COUNT - FILE_COUNT / EXT_EVERY && !bad,
+            fsl_logger_stringf("'%s': %"PRIu64" Entries, %"PRIu64" Bad, Expected %d\n",
+                EXT, contents.memb, bad, FILE_COUNT - FILE_COUNT / EXT_EVERY));
+    fsl_mem_free_buf(&contents, "main().contents");
+
+    CHECK_REPORT(fsl_logger_stringf("%d entries: count %.3fms, contents %.3fms, contents '%s' %.3fms\n",
+                FILE_COUNT + DIR_COUNT, time_count * 1e3, time_all * 1e3, EXT, time_ext * 1e3));
+
+cleanup:
+
+    fsl_mem_free_buf(&contents, "main().contents");
+    for (i = 0; i < FILE_COUNT; ++i)
+    {
+        snprintf(path, FSL_PATH_CAP, DIR_TEMP"f%06"PRIu64"%s", i, i % EXT_EVERY ? EXT : ".txt");
+        remove(path);
+    }
+    for (i = 0; i < DIR_COUNT; ++i)
+    {
+        snprintf(path, FSL_PATH_CAP, DIR_TEMP"d%06"PRIu64, i);
+        remove(path);
+    }
+    remove(DIR_TEMP);
+    return CHECK_CLOSE();
+}
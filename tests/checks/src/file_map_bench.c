@@ -0,0 +1,225 @@
+/*!
+ *  benchmark of loading a file through @ref fsl_file_map() vs. @ref fsl_get_file_contents(),
+ *  on files of the sizes the loaders that map them read:
+ *
+ *  - a model (.fmesh) as shipped, and a large one as a cooked scene could be,
+ *  - the chunk bucket and chunk order look-ups (.lut) of the game at the largest
+ *    render distance.
+ *
+ *  a load is open, read every byte once as a loader's parse would, and release, from a
+ *  warm page cache. per file and way:
+ *
+ *  - time per load, best of @ref ROUNDS rounds of `count` loads,
+ *  - peak resident memory of the first load over the resident memory before, the larger
+ *    of `VmRSS` while loaded and `VmHWM` after (linux, reset through '/proc/self/clear_refs',
+ *    not raised by `munmap()`), and the anonymous share of it, which unlike mapped file
+ *    pages the kernel can't drop and read back under pressure. files go smallest first,
+ *    so a copy can't reuse heap a larger one left resident.
+ *
+ *  both ways must read the same bytes, timings are only reported.
+ */
+
+#include "check.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DIR_TEMP        "temp_file_map/"
+#define ROUNDS          5
+#define LOAD_BYTES      ((u64)256 << 20) /* bytes read per round and file, sets `count` */
+
+typedef struct bench_file
+{
+    const str *name;
+    u64 size;
+    u32 flags; /* enum @ref fsl_file_map_flag, as its loader maps it */
+} bench_file;
+
+static bench_file file_list[] =
+{
+    {"gizmo_axis.fmesh",    2336,               FSL_FLAG_FILE_MAP_SEQUENTIAL | FSL_FLAG_FILE_MAP_WILLNEED},
+    {"chunk_bucket.lut",    33 * 33 * 8,        FSL_FLAG_FILE_MAP_SEQUENTIAL},
+    {"chunk_order.lut",     65 * 65 * 65 * 3,   FSL_FLAG_FILE_MAP_SEQUENTIAL},
+    {"large.fmesh",         (u64)64 << 20,      FSL_FLAG_FILE_MAP_SEQUENTIAL | FSL_FLAG_FILE_MAP_WILLNEED},
+};
+
+/*! @return sum of `size` bytes at `buf`, read 8 at a time. */
+static u64 bytes_sum(const u8 *buf, u64 size)
+{
+    u64 sum = 0, word = 0, i = 0;
+
+    for (i = 0; i + sizeof(u64) <= size; i += sizeof(u64))
+    {
+        memcpy(&word, buf + i, sizeof(u64));
+        sum += word;
+    }
+    for (; i < size; ++i)
+        sum += buf[i];
+    return sum;
+}
+
+/*! @return field `name` of '/proc/self/status', in KiB, 0 if missing. */
+static u64 status_get(const str *name)
+{
+    FILE *file = NULL;
+    str line[FSL_ID_CAP] = {0};
+    u64 value = 0, len = strlen(name);
+
+    if ((file = fopen("/proc/self/status", "rb")) == NULL)
+        return 0;
+
+    while (fgets(line, FSL_ID_CAP, file))
+        if (!strncmp(line, name, len) && line[len] == ':')
+        {
+            sscanf(line + len + 1, "%"SCNu64, &value);
+            break;
+        }
+    fclose(file);
+    return value;
+}
+
+/*! @brief reset `VmHWM` to the current `VmRSS`. */
+static b8 peak_reset(void)
+{
+    FILE *file = NULL;
+
+    if ((file = fopen("/proc/self/clear_refs", "wb")) == NULL)
+        return FALSE;
+    fputs("5", file);
+    fclose(file);
+    return TRUE;
+}
+
+/*!
+ *  @brief load `path` once, mapped or copied.
+ *
+ *  @param rss if not `NULL`, recipient of `VmRSS` and `RssAnon` while loaded, in KiB.
+ *
+ *  @return sum of its bytes, 0 on failure.
+ */
+static u64 load(const str *path, u32 flags, b8 map, u64 *rss)
+{
+    u8 *buf = NULL;
+    u64 size = 0, sum = 0;
+
+    if (map)
+    {
+        if (fsl_file_map(path, (void*)&buf, &size, flags) != FSL_ERR_SUCCESS)
+            return 0;
+    }
+    else if ((size = fsl_get_file_contents(path, (void*)&buf, FALSE)) == 0)
+        return 0;
+
+    sum = bytes_sum(buf, size);
+    if (rss)
+    {
+        rss[0] = status_get("VmRSS");
+        rss[1] = status_get("RssAnon");
+    }
+
+    if (map)
+        fsl_file_unmap((void*)&buf, size);
+    else
+        fsl_mem_free((void*)&buf, size, "load().buf");
+    return sum;
+}
+
+/*! @brief write `size` bytes of noise to `path`. */
+static u32 file_write(const str *path, u64 size)
+{
+    FILE *file = NULL;
+    u64 i = 0, word = 0;
+
+    if ((file = fopen(path, "wb")) == NULL)
+        return FSL_ERR_FILE_OPEN_FAIL;
+
+    for (i = 0; i < size; i += sizeof(u64))
+    {
+        word = fsl_rand_u64(i);
+        fwrite(&word, 1, size - i < sizeof(u64) ? size - i : sizeof(u64), file);
+    }
+    fclose(file);
+    return FSL_ERR_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    static const str *way_name[] = {"contents", "map"};
+    str path[FSL_PATH_CAP] = {0};
+    u64 sum[2] = {0}, sum_timed = 0, rss_before[2] = {0}, rss[2] = {0}, rss_peak = 0;
+    u64 count = 0, i = 0, j = 0, k = 0, n = 0, time_start = 0;
+    f64 time = 0.0, time_best = 0.0;
+    u32 log_level = 0;
+    b8 peak = FALSE;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (fsl_make_dir(DIR_TEMP) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    /* quiet the per-load logs, they'd be timed too */
+    log_level = fsl_log_level_max;
+    fsl_log_level_max = FSL_LOG_LEVEL_WARNING;
+
+    for (i = 0; i < arr_len(file_list); ++i)
+    {
+        snprintf(path, FSL_PATH_CAP, DIR_TEMP"%s", file_list[i].name);
+        if (file_write(path, file_list[i].size) != FSL_ERR_SUCCESS)
+        {
+            CHECK(FALSE, fsl_logger_stringf("Failed to Create '%s'\n", path));
+            break;
+        }
+
+        count = LOAD_BYTES / file_list[i].size;
+        count = count ? count : 1;
+
+        for (j = 0; j < arr_len(way_name); ++j)
+        {
+            /* first load: warms the page cache, takes the sum both ways must agree on */
+            rss_before[0] = status_get("VmRSS");
+            rss_before[1] = status_get("RssAnon");
+            peak = peak_reset();
+            sum[j] = load(path, file_list[i].flags, (b8)j, rss);
+            rss_peak = status_get("VmHWM");
+            rss_peak = rss_peak > rss[0] ? rss_peak : rss[0];
+
+            time_best = 0.0;
+            sum_timed = 0;
+            for (k = 0; k < ROUNDS; ++k)
+            {
+                time_start = fsl_get_time_nsec();
+                for (n = 0; n < count; ++n)
+                    sum_timed += load(path, file_list[i].flags, (b8)j, NULL);
+                time = check_time_since(time_start) / count;
+                if (time_best == 0.0 || time < time_best)
+                    time_best = time;
+            }
+            CHECK(sum_timed == sum[j] * count * ROUNDS,
+                    fsl_logger_stringf("'%s': Timed Loads Read Different Data\n", file_list[i].name));
+
+            fsl_log_level_max = log_level;
+            CHECK_REPORT(fsl_logger_stringf("%-17s %9"PRIu64" bytes, %-8s %10.2fus per load, "
+                        "peak rss +%6"PRIu64" KiB, anonymous +%6"PRIu64" KiB%s\n",
+                        file_list[i].name, file_list[i].size, way_name[j], time_best * 1e6,
+                        rss_peak > rss_before[0] ? rss_peak - rss_before[0] : 0,
+                        rss[1] > rss_before[1] ? rss[1] - rss_before[1] : 0,
+                        peak ? "" : " (peak not reset)"));
+            fsl_log_level_max = FSL_LOG_LEVEL_WARNING;
+        }
+
+        CHECK(sum[0] && sum[0] == sum[1],
+                fsl_logger_stringf("'%s': Map and Contents Read Different Data\n", file_list[i].name));
+        remove(path);
+    }
+
+    fsl_log_level_max = log_level;
+
+cleanup:
+
+    remove(DIR_TEMP);
+    return CHECK_CLOSE();
+}
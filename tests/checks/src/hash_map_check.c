@@ -0,0 +1,232 @@
+/*!
+ *  checks and benchmark of @ref fsl_hash_map.
+ *
+ *  - adversarial collisions: every key on one hash, told apart by the full-key callback,
+ *    and keys whose hashes share all low bits, so they land on one probe run,
+ *  - insert, find, erase and iterate, against a plain array as reference,
+ *  - a duplicate insert doesn't grow the map,
+ *  - lookups at 1k, 10k and 100k keys, against @ref fsl_find_hash_u64().
+ */
+
+#include "check.h"
+
+#define KEY_COUNT_MAX   100000
+#define LOOKUP_COUNT    1000000
+#define LINEAR_BUDGET   200000000   /* compared hashes, caps the linear scan benchmark */
+
+typedef struct entry
+{
+    u64 key;
+    u64 val;
+} entry;
+
+static u64 *key_buf = NULL;
+
+static b8 entry_eq(const void *val, const void *key)
+{
+    return ((const entry*)val)->key == *(const u64*)key;
+}
+
+/*! @brief all keys share one hash, only @ref entry_eq() tells them apart. */
+static void check_same_hash(fsl_mem_arena *arena)
+{
+    fsl_hash_map map = {0};
+    entry e = {0}, *found = NULL;
+    u64 i = 0, cursor = 0, seen = 0;
+
+    if (fsl_hash_map_init(&map, arena, 0, sizeof(entry), entry_eq) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Same Hash: Init Failed\n");
+        return;
+    }
+
+    for (i = 0; i < 500; ++i)
+    {
+        e.key = i;
+        e.val = i * 3;
+        CHECK(fsl_hash_map_insert(&map, 42, &e.key, &e, NULL) == FSL_ERR_SUCCESS,
+                fsl_logger_stringf("Same Hash: Insert %"PRIu64" Failed\n", i));
+    }
+
+    for (i = 0; i < 500; ++i)
+    {
+        found = fsl_hash_map_find(&map, 42, &i);
+        CHECK(found && found->key == i && found->val == i * 3,
+                fsl_logger_stringf("Same Hash: Find %"PRIu64" Returned the Wrong Entry\n", i));
+    }
+
+    e.key = 7;
+    e.val = 0;
+    CHECK(fsl_hash_map_insert(&map, 42, &e.key, &e, (void*)&found) == FSL_ERR_KEY_EXISTS &&
+            found && found->val == 21 && map.count == 500,
+            "Same Hash: Duplicate Insert Changed the Map\n");
+
+    for (i = 0; i < 500; i += 2)
+        CHECK(fsl_hash_map_erase(&map, 42, &i),
+                fsl_logger_stringf("Same Hash: Erase %"PRIu64" Failed\n", i));
+    for (i = 0; i < 500; ++i)
+    {
+        found = fsl_hash_map_find(&map, 42, &i);
+        CHECK((i % 2) ? found && found->key == i : !found,
+                fsl_logger_stringf("Same Hash: Find %"PRIu64" After Erase Failed\n", i));
+    }
+
+    while (fsl_hash_map_next(&map, &cursor, NULL, (void**)&found))
+    {
+        CHECK(found->key % 2, "Same Hash: Iteration Returned an Erased Entry\n");
+        ++seen;
+    }
+    CHECK(seen == 250 && map.count == 250,
+            fsl_logger_stringf("Same Hash: Iterated %"PRIu64" Entries, Expected 250\n", seen));
+
+    fsl_hash_map_free(&map);
+}
+
+/*! @brief distinct hashes that share their low 32 bits, hash-only compare. */
+static void check_same_bucket(fsl_mem_arena *arena)
+{
+    fsl_hash_map map = {0};
+    u64 *found = NULL, i = 0, val = 0, cap = 0;
+
+    if (fsl_hash_map_init(&map, arena, 0, sizeof(u64), NULL) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Same Bucket: Init Failed\n");
+        return;
+    }
+
+    for (i = 0; i < 2000; ++i)
+    {
+        val = i;
+        CHECK(fsl_hash_map_insert(&map, (i << 32) | 0x1234, NULL, &val, NULL) == FSL_ERR_SUCCESS,
+                fsl_logger_stringf("Same Bucket: Insert %"PRIu64" Failed\n", i));
+    }
+    for (i = 0; i < 2000; ++i)
+    {
+        found = fsl_hash_map_find(&map, (i << 32) | 0x1234, NULL);
+        CHECK(found && *found == i,
+                fsl_logger_stringf("Same Bucket: Find %"PRIu64" Failed\n", i));
+    }
+    CHECK(!fsl_hash_map_find(&map, ((u64)2000 << 32) | 0x1234, NULL),
+            "Same Bucket: Found a Key Never Inserted\n");
+
+    /* fill up to the growth threshold, a duplicate insert must not grow */
+    for (i = 2000; (map.count + 1) * 8 <= map.cap * 7; ++i)
+        fsl_hash_map_insert(&map, (i << 32) | 0x1234, NULL, &i, NULL);
+    cap = map.cap;
+    val = 0;
+    CHECK(fsl_hash_map_insert(&map, 0x1234, NULL, &val, NULL) == FSL_ERR_KEY_EXISTS && map.cap == cap,
+            "Same Bucket: Duplicate Insert Grew the Map\n");
+
+    fsl_hash_map_free(&map);
+}
+
+/*! @brief random insert and erase, against a presence array. */
+static void check_random(fsl_mem_arena *arena)
+{
+    fsl_hash_map map = {0};
+    static b8 present[4096];
+    u64 *found = NULL, i = 0, k = 0, count = 0;
+
+    if (fsl_hash_map_init(&map, arena, 0, sizeof(u64), NULL) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Random: Init Failed\n");
+        return;
+    }
+
+    for (i = 0; i < 200000; ++i)
+    {
+        k = fsl_rand_u64(i) % 4096;
+        if (fsl_rand_u64(i + 0x10000000) % 3)
+        {
+            if (fsl_hash_map_insert(&map, fsl_rand_u64(k), NULL, &k, NULL) == FSL_ERR_SUCCESS)
+                CHECK(!present[k], "Random: Inserted a Present Key\n");
+            present[k] = TRUE;
+        }
+        else
+        {
+            CHECK(fsl_hash_map_erase(&map, fsl_rand_u64(k), NULL) == present[k],
+                    "Random: Erase Disagrees With Reference\n");
+            present[k] = FALSE;
+        }
+    }
+
+    for (k = 0; k < 4096; ++k)
+    {
+        found = fsl_hash_map_find(&map, fsl_rand_u64(k), NULL);
+        CHECK(present[k] ? found && *found == k : !found,
+                fsl_logger_stringf("Random: Find %"PRIu64" Disagrees With Reference\n", k));
+        count += present[k];
+    }
+    CHECK(map.count == count, "Random: Count Disagrees With Reference\n");
+
+    fsl_hash_map_free(&map);
+}
+
+static void bench(fsl_mem_arena *arena, u64 key_count)
+{
+    fsl_hash_map map = {0};
+    u64 i = 0, index = 0, hits = 0, hits_linear = 0, lookups_linear = 0, time_start = 0;
+    f64 time_map = 0.0, time_linear = 0.0;
+
+    if (fsl_hash_map_init(&map, arena, key_count, sizeof(u64), NULL) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Bench: Init Failed\n");
+        return;
+    }
+
+    for (i = 0; i < key_count; ++i)
+    {
+        key_buf[i] = fsl_rand_u64(i + 1);
+        fsl_hash_map_insert(&map, key_buf[i], NULL, &i, NULL);
+    }
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < LOOKUP_COUNT; ++i)
+        hits += fsl_hash_map_find(&map, key_buf[fsl_rand_u64(i) % key_count], NULL) != NULL;
+    time_map = check_time_since(time_start);
+
+    lookups_linear = LINEAR_BUDGET / key_count;
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < lookups_linear; ++i)
+        hits_linear += fsl_find_hash_u64(key_buf[fsl_rand_u64(i) % key_count], key_buf, &index, key_count);
+    time_linear = check_time_since(time_start);
+
+    CHECK(hits == LOOKUP_COUNT && hits_linear == lookups_linear,
+            fsl_logger_stringf("Bench: %"PRIu64" Keys, Lookups Missed\n", key_count));
+
+    CHECK_REPORT(fsl_logger_stringf("%6"PRIu64" keys: hash map %8.2f Mlookups/s, fsl_find_hash_u64 %8.4f Mlookups/s\n",
+                key_count,
+                (f64)LOOKUP_COUNT / time_map * 1e-6, (f64)lookups_linear / time_linear * 1e-6));
+
+    fsl_hash_map_free(&map);
+}
+
+int main(int argc, char **argv)
+{
+    fsl_mem_arena arena = {0};
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_arena_init(&arena, "main().arena") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&key_buf, KEY_COUNT_MAX * sizeof(u64), "main().key_buf") != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    check_same_hash(&arena);
+    check_same_bucket(&arena);
+    check_random(&arena);
+
+    bench(&arena, 1000);
+    bench(&arena, 10000);
+    bench(&arena, 100000);
+
+cleanup:
+
+    fsl_mem_unmap((void*)&key_buf, KEY_COUNT_MAX * sizeof(u64), "main().key_buf");
+    fsl_mem_arena_free(&arena, "main().arena");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,236 @@
+/*!
+ *  checks of the async I/O service (@ref fsl_io_submit(), @ref fsl_io_poll()), on every
+ *  backend: io_uring, worker threads and sync.
+ *
+ *  thousands of concurrent reads of temp files, some running past the end of file, and
+ *  writes read back afterwards. completion order is not guaranteed, so the checks are:
+ *
+ *  - every request completes exactly once, with the right state, length and contents,
+ *  - callbacks only run inside @ref fsl_io_poll(),
+ *  - nothing is left in flight once polling returns 0 requests pending,
+ *  - a queue depth far below the request count holds requests back without losing any.
+ */
+
+#include "check.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DIR_TEMP        "temp_io/"
+#define FILE_COUNT      16
+#define FILE_SIZE       (1024 * 1024 + 123)
+#define READ_COUNT      4096
+#define READ_SIZE       4096
+#define WRITE_COUNT     512
+#define FILE_BUF_SIZE   (WRITE_COUNT * READ_SIZE) /* holds a source file or the written one */
+
+static fsl_io_request request[READ_COUNT];
+static u32 complete_count[READ_COUNT];
+static int fd[FILE_COUNT + 1];
+static u8 *buf = NULL;
+static u8 *file_buf = NULL;
+static b8 polling = FALSE;
+static u32 callback_outside = 0;
+
+static u8 file_byte(u64 file, u64 pos)
+{
+    return (u8)((pos * 131 + file * 7) ^ (pos >> 9));
+}
+
+static void on_complete(fsl_io_request *x)
+{
+    ++complete_count[x - request];
+    if (!polling)
+        ++callback_outside;
+}
+
+static void poll_all(void)
+{
+    polling = TRUE;
+    while (fsl_io_in_flight())
+        fsl_io_poll(TRUE);
+    polling = FALSE;
+}
+
+static void check_reads(const str *name)
+{
+    u64 i = 0, j = 0, file = 0, expect = 0;
+    b8 ok_state = TRUE, ok_data = TRUE;
+
+    memset(complete_count, 0, sizeof(complete_count));
+    memset(buf, 0, (u64)READ_COUNT * READ_SIZE);
+    callback_outside = 0;
+
+    for (i = 0; i < READ_COUNT; ++i)
+    {
+        file = fsl_rand_u64(i) % FILE_COUNT;
+        memset(&request[i], 0, sizeof(fsl_io_request));
+        request[i].op = FSL_IO_OP_READ;
+        request[i].fd = fd[file];
+        request[i].buf = buf + i * READ_SIZE;
+        request[i].size = READ_SIZE;
+        /* every 8th read runs past the end of file, must come back short */
+        request[i].offset = (i % 8) ? fsl_rand_u64(i + READ_COUNT) % (FILE_SIZE - READ_SIZE) :
+            FILE_SIZE - fsl_rand_u64(i + READ_COUNT) % READ_SIZE;
+        request[i].callback = on_complete;
+        request[i].user = (void*)file;
+
+        CHECK(fsl_io_submit(&request[i]) == FSL_ERR_SUCCESS,
+                fsl_logger_stringf("%s: Submit %"PRIu64" Failed\n", name, i));
+    }
+
+    poll_all();
+
+    for (i = 0; i < READ_COUNT; ++i)
+    {
+        file = (u64)request[i].user;
+        expect = FILE_SIZE - request[i].offset < READ_SIZE ? FILE_SIZE - request[i].offset : READ_SIZE;
+        if (complete_count[i] != 1 || request[i].state != FSL_IO_STATE_DONE || request[i].result != expect)
+            ok_state = FALSE;
+        for (j = 0; j < expect; ++j)
+            if (buf[i * READ_SIZE + j] != file_byte(file, request[i].offset + j))
+                ok_data = FALSE;
+    }
+
+    CHECK(ok_state, fsl_logger_stringf("%s: Reads Completed Twice, Never, or With the Wrong State or Length\n", name));
+    CHECK(ok_data, fsl_logger_stringf("%s: Reads Returned Wrong Contents\n", name));
+    CHECK(!callback_outside, fsl_logger_stringf("%s: Callbacks Ran Outside fsl_io_poll()\n", name));
+}
+
+static void check_writes(const str *name)
+{
+    FILE *file = NULL;
+    u64 i = 0, j = 0, len = 0;
+    b8 ok = TRUE;
+
+    memset(complete_count, 0, sizeof(complete_count));
+    for (i = 0; i < (u64)WRITE_COUNT * READ_SIZE; ++i)
+        buf[i] = file_byte(FILE_COUNT, i);
+
+    for (i = 0; i < WRITE_COUNT; ++i)
+    {
+        memset(&request[i], 0, sizeof(fsl_io_request));
+        request[i].op = FSL_IO_OP_WRITE;
+        request[i].fd = fd[FILE_COUNT];
+        request[i].buf = buf + i * READ_SIZE;
+        request[i].size = READ_SIZE;
+        request[i].offset = i * READ_SIZE;
+        request[i].callback = on_complete;
+
+        CHECK(fsl_io_submit(&request[i]) == FSL_ERR_SUCCESS,
+                fsl_logger_stringf("%s: Submit Write %"PRIu64" Failed\n", name, i));
+    }
+
+    poll_all();
+
+    for (i = 0; i < WRITE_COUNT; ++i)
+        if (complete_count[i] != 1 || request[i].state != FSL_IO_STATE_DONE || request[i].result != READ_SIZE)
+            ok = FALSE;
+
+    if ((file = fopen(DIR_TEMP"write.bin", "rb")) != NULL)
+    {
+        len = fread(file_buf, 1, (u64)WRITE_COUNT * READ_SIZE, file);
+        fclose(file);
+    }
+    for (j = 0; j < (u64)WRITE_COUNT * READ_SIZE; ++j)
+        if (len != (u64)WRITE_COUNT * READ_SIZE || file_buf[j] != file_byte(FILE_COUNT, j))
+        {
+            ok = FALSE;
+            break;
+        }
+
+    CHECK(ok, fsl_logger_stringf("%s: Writes Incomplete or Read Back Wrong\n", name));
+}
+
+/*! @brief restart the I/O service on `backend` (value of `FSL_IO_BACKEND`). */
+static void run(const str *name, const str *backend, u32 queue_depth)
+{
+    static const str *backend_name[] = {"none", "io_uring", "threads", "sync"};
+    u64 time_start = 0;
+    f64 time_read = 0.0, time_write = 0.0;
+
+    fsl_io_free();
+    if (backend)
+        setenv("FSL_IO_BACKEND", backend, 1);
+    else
+        unsetenv("FSL_IO_BACKEND");
+
+    if (fsl_io_init(queue_depth) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, fsl_logger_stringf("%s: Init Failed\n", name));
+        return;
+    }
+
+    time_start = fsl_get_time_nsec();
+    check_reads(name);
+    time_read = check_time_since(time_start);
+
+    time_start = fsl_get_time_nsec();
+    check_writes(name);
+    time_write = check_time_since(time_start);
+
+    CHECK(!fsl_io_in_flight(), fsl_logger_stringf("%s: Requests Left in Flight\n", name));
+
+    CHECK_REPORT(fsl_logger_stringf("%-16s (%-8s): %d reads in %8.3fms, %d writes in %8.3fms\n",
+                name, backend_name[fsl_io_get_backend()],
+                READ_COUNT, time_read * 1e3, WRITE_COUNT, time_write * 1e3));
+}
+
+int main(int argc, char **argv)
+{
+    FILE *file = NULL;
+    u64 buf_size = (u64)READ_COUNT * READ_SIZE;
+    u64 i = 0, j = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&buf, buf_size, "main().buf") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&file_buf, FILE_BUF_SIZE, "main().file_buf") != FSL_ERR_SUCCESS ||
+            (fsl_make_dir(DIR_TEMP) != FSL_ERR_SUCCESS && fsl_err != FSL_ERR_DIR_EXISTS))
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    for (i = 0; i < FILE_COUNT; ++i)
+    {
+        for (j = 0; j < FILE_SIZE; ++j)
+            file_buf[j] = file_byte(i, j);
+        if ((file = fopen(fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i), "wb")) != NULL)
+        {
+            fwrite(file_buf, 1, FILE_SIZE, file);
+            fclose(file);
+        }
+        fd[i] = open(fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i), O_RDONLY);
+        CHECK(fd[i] >= 0, fsl_logger_stringf("Failed to Create Temp File %"PRIu64"\n", i));
+    }
+    fd[FILE_COUNT] = open(DIR_TEMP"write.bin", O_RDWR | O_CREAT | O_TRUNC, 0600);
+    CHECK(fd[FILE_COUNT] >= 0, "Failed to Create Temp File for Writes\n");
+
+    if (!check_fail_count)
+    {
+        run("default", NULL, 0);
+        run("default, depth 32", NULL, 32);
+        run("threads", "threads", 0);
+        run("sync", "sync", 0);
+    }
+
+cleanup:
+
+    fsl_io_free();
+    for (i = 0; i <= FILE_COUNT; ++i)
+    {
+        if (fd[i] > 0)
+            close(fd[i]);
+        remove(i < FILE_COUNT ? fsl_logger_stringf(DIR_TEMP"%02"PRIu64".bin", i) : DIR_TEMP"write.bin");
+    }
+    remove(DIR_TEMP);
+    fsl_mem_unmap((void*)&file_buf, FILE_BUF_SIZE, "main().file_buf");
+    fsl_mem_unmap((void*)&buf, buf_size, "main().buf");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,165 @@
+/*!
+ *  checks and benchmark of the lattice cache of the noise sampler
+ *  (@ref fsl_noise_lattice_cache) through the terrain generation of a world of a radius of
+ *  16 chunks, the way chunk generation drives it.
+ *
+ *  - determinism: every height and block of the world, generated with and without the
+ *    cache, must match bit for bit, at f64 and f32 sample precision,
+ *  - cache hits and misses, and the time saved against no cache.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler_cache.h"
+#include "../../game_hhc/src/h/world.h"
+#include "../../game_hhc/src/terrain/biome.h"
+#include "../../game_hhc/src/terrain/terrain.h"
+
+#include <string.h>
+
+#define WORLD_CHECK_RADIUS  16
+#define WORLD_CHECK_VOLUME  \
+    ((u64)(WORLD_CHECK_RADIUS * 2 + 1) * (WORLD_CHECK_RADIUS * 2 + 1) * CHUNK_VOLUME)
+#define CACHE_SIZE          1024    /* as @ref CHUNK_SAMPLER_LATTICE_CACHE_SIZE */
+#define SEED                12345
+
+world_info world = {0};
+
+static const str *precision_name[] = {"f64", "f32"};
+
+static fsl_noise_sampler sampler = {0};
+static fsl_noise_sampler_context ctx = {0};
+static fsl_noise_lattice_cache cache = {0};
+
+static f64 *height[2] = {NULL};
+static u8 *block[2] = {NULL};
+
+/*!
+ *  @brief generate the world into `height[pass]` and `block[pass]`, chunk by chunk,
+ *  spiraling out from the origin as the chunk buffer fills.
+ *
+ *  @return seconds taken.
+ */
+static f64 world_generate(u32 pass)
+{
+    hhc_terrain_sample terrain = {0};
+    i32 r = 0, cx = 0, cy = 0, x = 0, y = 0, z = 0;
+    u64 i = 0, time_start = 0;
+
+    time_start = fsl_get_time_nsec();
+    for (r = 0; r <= WORLD_CHECK_RADIUS; ++r)
+        for (cy = -r; cy <= r; ++cy)
+            for (cx = -r; cx <= r; ++cx)
+            {
+                if (cx != -r && cx != r && cy != -r && cy != r)
+                    continue;
+
+                fsl_noise_sampler_context_init(&sampler, &ctx,
+                        (f64)(cx * CHUNK_DIAMETER), (f64)(cy * CHUNK_DIAMETER), 0.0);
+                terrain_grid_bake(&ctx);
+
+                fsl_noise_sampler_axis_init(&ctx, 2, 0);
+                for (z = 0; z < CHUNK_DIAMETER; ++z, fsl_noise_sampler_axis_post_update(&ctx, 2))
+                {
+                    fsl_noise_sampler_axis_pre_update(&ctx, 2);
+
+                    fsl_noise_sampler_axis_init(&ctx, 1, 0);
+                    for (y = 0; y < CHUNK_DIAMETER; ++y, fsl_noise_sampler_axis_post_update(&ctx, 1))
+                    {
+                        fsl_noise_sampler_axis_pre_update(&ctx, 1);
+                        sampler_noise_axis_update_2d(&ctx, 1);
+
+                        fsl_noise_sampler_axis_init(&ctx, 0, 0);
+                        for (x = 0; x < CHUNK_DIAMETER; ++x, fsl_noise_sampler_axis_post_update(&ctx, 0))
+                        {
+                            fsl_noise_sampler_axis_pre_update(&ctx, 0);
+                            sampler_noise_axis_update_2d(&ctx, 0);
+                            sampler_noise_bake(&ctx);
+                            terrain_shape(&terrain, &ctx);
+
+                            height[pass][i] = terrain.value;
+                            block[pass][i] = (u8)terrain.block_id;
+                            ++i;
+                        }
+                    }
+                }
+            }
+    return check_time_since(time_start);
+}
+
+static void check_precision(hhc_terrain_precision precision)
+{
+    u64 i = 0, mismatch = 0;
+    f64 time_plain = 0.0, time_cached = 0.0, hit_rate = 0.0;
+
+    terrain_precision_set(precision);
+
+    sampler.lattice_cache = NULL;
+    time_plain = world_generate(0);
+
+    fsl_noise_lattice_cache_clear(&cache);
+    sampler.lattice_cache = &cache;
+    time_cached = world_generate(1);
+
+    for (i = 0; i < WORLD_CHECK_VOLUME; ++i)
+        if (memcmp(&height[0][i], &height[1][i], sizeof(f64)) || block[0][i] != block[1][i])
+            ++mismatch;
+
+    CHECK(!mismatch,
+            fsl_logger_stringf("%s: %"PRIu64" of %"PRIu64" Blocks Differ With the Cache\n",
+                precision_name[precision], mismatch, WORLD_CHECK_VOLUME));
+    CHECK(cache.hit, fsl_logger_stringf("%s: No Cache Hits\n", precision_name[precision]));
+
+    hit_rate = cache.hit + cache.miss ? (f64)cache.hit / (f64)(cache.hit + cache.miss) : 0.0;
+    CHECK_REPORT(fsl_logger_stringf("%s: %"PRIu64" blocks, no cache %.3fs, cached %.3fs (%.1f%% saved), "
+                "hits %"PRIu64", misses %"PRIu64" (%.2f%% hit rate)\n",
+                precision_name[precision], WORLD_CHECK_VOLUME, time_plain, time_cached,
+                (1.0 - time_cached / time_plain) * 100.0, cache.hit, cache.miss, hit_rate * 100.0));
+}
+
+int main(int argc, char **argv)
+{
+    u64 height_size = WORLD_CHECK_VOLUME * sizeof(f64);
+    u64 block_size = WORLD_CHECK_VOLUME * sizeof(u8);
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&height[0], height_size, "main().height[0]") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&height[1], height_size, "main().height[1]") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&block[0], block_size, "main().block[0]") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&block[1], block_size, "main().block[1]") != FSL_ERR_SUCCESS ||
+            fsl_noise_sampler_init(&sampler, TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT, 8,
+                (f64)(WORLD_RADIUS * CHUNK_DIAMETER),
+                (f64)(WORLD_RADIUS * CHUNK_DIAMETER),
+                (f64)(WORLD_RADIUS_VERTICAL * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER_VERTICAL * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER)) != FSL_ERR_SUCCESS ||
+            fsl_noise_lattice_cache_init(&cache, CACHE_SIZE) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    world.seed = SEED;
+    terrain_init();
+
+    check_precision(TERRAIN_PRECISION_F64);
+    check_precision(TERRAIN_PRECISION_F32);
+    terrain_precision_set(TERRAIN_PRECISION_F64);
+
+cleanup:
+
+    fsl_noise_lattice_cache_free(&cache);
+    fsl_noise_sampler_free(&sampler);
+    fsl_mem_unmap((void*)&block[1], block_size, "main().block[1]");
+    fsl_mem_unmap((void*)&block[0], block_size, "main().block[0]");
+    fsl_mem_unmap((void*)&height[1], height_size, "main().height[1]");
+    fsl_mem_unmap((void*)&height[0], height_size, "main().height[0]");
+    return CHECK_CLOSE();
+}
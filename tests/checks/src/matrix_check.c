@@ -0,0 +1,408 @@
+/*!
+ *  checks and benchmark of the pointer variants of the 4x4 matrix operations
+ *  (@ref fsl_multiply_m4f32_ptr() and others) at every kernel level this cpu runs
+ *  (@ref fsl_cpu_set_level()), and of @ref fsl_transform_bake_batch().
+ *
+ *  - multiply and transpose against the by-value versions, batch transform against the
+ *    matrix-vector product written out, also with `dst` aliasing an input and at batch
+ *    lengths that leave partial SIMD groups,
+ *  - inverse against the f64 inverse, `m` * inverse near identity, singular input
+ *    returning 0 and leaving `dst` untouched,
+ *  - m4f64 variants against their by-value versions and the written out product,
+ *  - baking 1e5 transforms against the by-value bake they replaced, error and time.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/h/cpu.h"
+#include "../../../fossil/deps/fossil/math/math.h"
+#include "../../../fossil/deps/fossil/math/matrix.h"
+#include "../../../fossil/deps/fossil/physics/transform.h"
+
+#include <math.h>
+#include <string.h>
+
+#define MATRIX_COUNT    20000
+#define VECTOR_MAX      37      /* batch lengths 0 to this, partial groups at every level */
+#define TRANSFORM_COUNT 100000
+#define BENCH_RUNS      7       /* best of */
+#define ERROR_MAX       1e-5    /* relative, f32 operations */
+#define ERROR_MAX_F64   1e-12   /* relative, f64 operations */
+#define INVERSE_ERROR_MAX 1e-3  /* relative to the inverse's magnitude */
+#define DET_MIN         1e-2    /* well enough conditioned for the inverse bounds */
+
+static const str *level_name[FSL_CPU_LEVEL_COUNT] = {"scalar", "sse4.1", "avx2", "avx512"};
+
+static fsl_transform_v3f64 *transform = NULL;
+static m4f32 *baked = NULL;
+
+/*! @return uniform in [-1.0, 1.0]. */
+static f32 rand_unit(u64 seed)
+{
+    return (f32)((f64)(fsl_rand_u64(seed) >> 11) / (f64)((u64)1 << 53) * 2.0 - 1.0);
+}
+
+static void rand_m4f32(m4f32 *m, u64 seed)
+{
+    f32 *e = &m->a11;
+    u32 i = 0;
+
+    for (i = 0; i < 16; ++i)
+        e[i] = rand_unit(seed * 16 + i);
+}
+
+/*! @return largest difference of `a` from `b`, relative to 1 + |`b`|. */
+static f64 diff_m4f32(const m4f32 *a, const m4f32 *b)
+{
+    const f32 *ea = &a->a11, *eb = &b->a11;
+    f64 d = 0.0, d_max = 0.0;
+    u32 i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        d = fabs((f64)ea[i] - eb[i]) / (1.0 + fabs(eb[i]));
+        d_max = d > d_max || d != d ? (d != d ? 1.0 : d) : d_max;
+    }
+    return d_max;
+}
+
+static f64 diff_m4f64(const m4f64 *a, const m4f64 *b)
+{
+    const f64 *ea = &a->a11, *eb = &b->a11;
+    f64 d = 0.0, d_max = 0.0;
+    u32 i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        d = fabs(ea[i] - eb[i]) / (1.0 + fabs(eb[i]));
+        d_max = d > d_max || d != d ? (d != d ? 1.0 : d) : d_max;
+    }
+    return d_max;
+}
+
+/*!
+ *  @brief `m` * `v`, column vector, in f64.
+ *
+ *  @remark not @ref fsl_multiply_vector_m4f64(), which scales each row by one component.
+ */
+static v4f64 transform_reference(const m4f64 *m, f64 x, f64 y, f64 z, f64 w)
+{
+    v4f64 t = {0};
+
+    t.x = m->a11 * x + m->a12 * y + m->a13 * z + m->a14 * w;
+    t.y = m->a21 * x + m->a22 * y + m->a23 * z + m->a24 * w;
+    t.z = m->a31 * x + m->a32 * y + m->a33 * z + m->a34 * w;
+    t.w = m->a41 * x + m->a42 * y + m->a43 * z + m->a44 * w;
+    return t;
+}
+
+static m4f64 m4f32_to_m4f64(const m4f32 *m)
+{
+    m4f64 dst = {0};
+    const f32 *e = &m->a11;
+    f64 *d = &dst.a11;
+    u32 i = 0;
+
+    for (i = 0; i < 16; ++i)
+        d[i] = e[i];
+    return dst;
+}
+
+static void check_level(u32 level)
+{
+    static v4f32 src[VECTOR_MAX + 1], dst[VECTOR_MAX + 1];
+    m4f32 a = {0}, b = {0}, r = {0}, ref = {0}, identity = fsl_identity_m4f32();
+    m4f64 a64 = {0}, inv64 = {0};
+    v4f64 v = {0};
+    u64 i = 0, j = 0, n = 0;
+    f64 e_multiply = 0.0, e_transpose = 0.0, e_transform = 0.0, e_inverse = 0.0;
+    f64 e_identity = 0.0, d = 0.0;
+    f32 det = 0.0f;
+    b8 tail_kept = TRUE, singular_kept = TRUE;
+
+    fsl_cpu_set_level(level);
+
+    for (i = 0; i < MATRIX_COUNT; ++i)
+    {
+        rand_m4f32(&a, i * 2);
+        rand_m4f32(&b, i * 2 + 1);
+
+        ref = fsl_multiply_m4f32(a, b);
+        fsl_multiply_m4f32_ptr(&a, &b, &r);
+        d = diff_m4f32(&r, &ref);
+        e_multiply = d > e_multiply ? d : e_multiply;
+        r = a;
+        fsl_multiply_m4f32_ptr(&r, &b, &r);
+        d = diff_m4f32(&r, &ref);
+        e_multiply = d > e_multiply ? d : e_multiply;
+
+        ref = fsl_transpose_m4f32(a);
+        r = a;
+        fsl_transpose_m4f32_ptr(&r, &r);
+        d = diff_m4f32(&r, &ref);
+        e_transpose = d > e_transpose ? d : e_transpose;
+
+        a64 = m4f32_to_m4f64(&a);
+        if (fabs(fsl_inverse_m4f64_ptr(&a64, &inv64)) >= DET_MIN)
+        {
+            r = a;
+            det = fsl_inverse_m4f32_ptr(&r, &r);
+            a64 = m4f32_to_m4f64(&r);
+            d = diff_m4f64(&a64, &inv64) / (1.0 + fabs(1.0 / det));
+            e_inverse = d > e_inverse ? d : e_inverse;
+
+            fsl_multiply_m4f32_ptr(&a, &r, &r);
+            d = diff_m4f32(&r, &identity);
+            e_identity = d > e_identity ? d : e_identity;
+        }
+
+        /* in place, length `n`, entries past `n` untouched */
+        n = i % (VECTOR_MAX + 1);
+        for (j = 0; j <= VECTOR_MAX; ++j)
+        {
+            src[j].x = rand_unit(i * 64 + j * 4 + 0);
+            src[j].y = rand_unit(i * 64 + j * 4 + 1);
+            src[j].z = rand_unit(i * 64 + j * 4 + 2);
+            src[j].w = 1.0f;
+            dst[j] = src[j];
+        }
+        fsl_multiply_vector_m4f32_batch(&a, dst, dst, n);
+        a64 = m4f32_to_m4f64(&a);
+        for (j = 0; j < n; ++j)
+        {
+            v = transform_reference(&a64, src[j].x, src[j].y, src[j].z, src[j].w);
+            d = fabs((f64)dst[j].x - v.x) + fabs((f64)dst[j].y - v.y) +
+                fabs((f64)dst[j].z - v.z) + fabs((f64)dst[j].w - v.w);
+            e_transform = d > e_transform || d != d ? (d != d ? 1.0 : d) : e_transform;
+        }
+        for (; j <= VECTOR_MAX; ++j)
+            if (memcmp(&dst[j], &src[j], sizeof(v4f32)))
+                tail_kept = FALSE;
+    }
+
+    /* rows 1 and 2 equal */
+    a = fsl_identity_m4f32();
+    a.a21 = a.a11;
+    a.a22 = a.a12;
+    a.a23 = a.a13;
+    a.a24 = a.a14;
+    r = identity;
+    r.a11 = 7.0f;
+    ref = r;
+    det = fsl_inverse_m4f32_ptr(&a, &r);
+    singular_kept = det == 0.0f && !memcmp(&r, &ref, sizeof(m4f32));
+
+    CHECK(e_multiply <= ERROR_MAX,
+            fsl_logger_stringf("%s: Multiply Error %.3g\n", level_name[level], e_multiply));
+    CHECK(e_transpose == 0.0,
+            fsl_logger_stringf("%s: Transpose Error %.3g\n", level_name[level], e_transpose));
+    CHECK(e_transform <= ERROR_MAX,
+            fsl_logger_stringf("%s: Transform Error %.3g\n", level_name[level], e_transform));
+    CHECK(tail_kept,
+            fsl_logger_stringf("%s: Transform Wrote Past the Batch\n", level_name[level]));
+    CHECK(e_inverse <= INVERSE_ERROR_MAX && e_identity <= INVERSE_ERROR_MAX,
+            fsl_logger_stringf("%s: Inverse Error %.3g, Identity Error %.3g\n",
+                level_name[level], e_inverse, e_identity));
+    CHECK(singular_kept,
+            fsl_logger_stringf("%s: Singular Inverse Returned %g or Wrote `dst`\n",
+                level_name[level], det));
+
+    CHECK_REPORT(fsl_logger_stringf("%-6s: multiply %.2g, transpose %.2g, transform %.2g, "
+                "inverse %.2g, m * inverse - identity %.2g\n",
+                level_name[level], e_multiply, e_transpose, e_transform, e_inverse, e_identity));
+}
+
+static void check_m4f64(void)
+{
+    m4f32 a32 = {0}, b32 = {0};
+    m4f64 a = {0}, b = {0}, r = {0}, ref = {0}, identity = fsl_identity_m4f64();
+    v4f64 src[VECTOR_MAX] = {0}, dst[VECTOR_MAX] = {0}, v = {0};
+    u64 i = 0, j = 0;
+    f64 e = 0.0, d = 0.0;
+
+    for (i = 0; i < MATRIX_COUNT / 10; ++i)
+    {
+        rand_m4f32(&a32, i * 2);
+        rand_m4f32(&b32, i * 2 + 1);
+        a = m4f32_to_m4f64(&a32);
+        b = m4f32_to_m4f64(&b32);
+
+        ref = fsl_multiply_m4f64(a, b);
+        r = a;
+        fsl_multiply_m4f64_ptr(&r, &b, &r);
+        d = diff_m4f64(&r, &ref);
+        e = d > e ? d : e;
+
+        ref = fsl_transpose_m4f64(a);
+        fsl_transpose_m4f64_ptr(&a, &r);
+        d = diff_m4f64(&r, &ref);
+        e = d > e ? d : e;
+
+        if (fabs(fsl_inverse_m4f64_ptr(&a, &r)) >= DET_MIN)
+        {
+            fsl_multiply_m4f64_ptr(&a, &r, &r);
+            d = diff_m4f64(&r, &identity) * ERROR_MAX_F64 / ERROR_MAX;
+            e = d > e ? d : e;
+        }
+
+        for (j = 0; j < VECTOR_MAX; ++j)
+        {
+            src[j].x = rand_unit(i * 64 + j * 4 + 0);
+            src[j].y = rand_unit(i * 64 + j * 4 + 1);
+            src[j].z = rand_unit(i * 64 + j * 4 + 2);
+            src[j].w = 1.0;
+        }
+        fsl_multiply_vector_m4f64_batch(&a, src, dst, VECTOR_MAX);
+        for (j = 0; j < VECTOR_MAX; ++j)
+        {
+            v = transform_reference(&a, src[j].x, src[j].y, src[j].z, src[j].w);
+            d = fabs(dst[j].x - v.x) + fabs(dst[j].y - v.y) + fabs(dst[j].z - v.z) + fabs(dst[j].w - v.w);
+            e = d > e ? d : e;
+        }
+    }
+
+    CHECK(e <= ERROR_MAX_F64, fsl_logger_stringf("m4f64: Error %.3g\n", e));
+    CHECK_REPORT(fsl_logger_stringf("m4f64 : multiply, transpose, transform, inverse %.2g\n", e));
+}
+
+/* ---- by-value bake ------------------------------------------------------- */
+
+static void bake_matrices(const v3f64 *pos, const v3f64 *rot, const v3f64 *scale,
+        m4f32 *location, m4f32 *rotation_pitch, m4f32 *rotation_yaw, m4f32 *scale_dst)
+{
+    f32 SPCH = sinf(rot->y * FSL_DEG2RAD);
+    f32 CPCH = sinf(rot->y * FSL_DEG2RAD + FSL_HALF_PI);
+    f32 SYAW = sinf(rot->z * FSL_DEG2RAD);
+    f32 CYAW = sinf(rot->z * FSL_DEG2RAD + FSL_HALF_PI);
+
+    *location = fsl_identity_m4f32();
+    location->a41 = pos->x;
+    location->a42 = pos->y;
+    location->a43 = pos->z;
+
+    *rotation_pitch = fsl_identity_m4f32();
+    rotation_pitch->a11 = CPCH;
+    rotation_pitch->a13 = -SPCH;
+    rotation_pitch->a31 = SPCH;
+    rotation_pitch->a33 = CPCH;
+
+    *rotation_yaw = fsl_identity_m4f32();
+    rotation_yaw->a11 = CYAW;
+    rotation_yaw->a12 = -SYAW;
+    rotation_yaw->a21 = SYAW;
+    rotation_yaw->a22 = CYAW;
+
+    *scale_dst = fsl_identity_m4f32();
+    scale_dst->a11 = scale->x;
+    scale_dst->a22 = scale->y;
+    scale_dst->a33 = scale->z;
+}
+
+/*! @brief @ref fsl_transform_bake() as it was, a chain of by-value multiplies. */
+static m4f32 bake_reference(const fsl_transform_v3f64 *t)
+{
+    m4f32 final = {0}, location = {0}, rotation_pitch = {0}, rotation_yaw = {0}, scale = {0};
+
+    bake_matrices(&t->pos, &t->rot, &t->scale, &location, &rotation_pitch, &rotation_yaw, &scale);
+    final = fsl_multiply_m4f32(scale, location);
+    final = fsl_multiply_m4f32(rotation_pitch, final);
+    final = fsl_multiply_m4f32(rotation_yaw, final);
+
+    bake_matrices(&t->pos_delta, &t->rot_delta, &t->scale_delta,
+            &location, &rotation_pitch, &rotation_yaw, &scale);
+    final = fsl_multiply_m4f32(scale, final);
+    final = fsl_multiply_m4f32(location, final);
+    final = fsl_multiply_m4f32(rotation_pitch, final);
+    final = fsl_multiply_m4f32(rotation_yaw, final);
+    return final;
+}
+
+static void bench_bake(u32 level_max)
+{
+    m4f32 ref = {0};
+    u64 i = 0, time_start = 0;
+    u32 level = 0, run = 0;
+    f64 time = 0.0, time_best = 0.0, e = 0.0, d = 0.0;
+
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+    {
+        fsl_position_set(&transform[i], rand_unit(i * 16 + 0) * 100.0,
+                rand_unit(i * 16 + 1) * 100.0, rand_unit(i * 16 + 2) * 100.0);
+        fsl_rotation_set(&transform[i], rand_unit(i * 16 + 3) * 180.0,
+                rand_unit(i * 16 + 4) * 180.0, rand_unit(i * 16 + 5) * 180.0);
+        fsl_scale_set(&transform[i], 1.0 + rand_unit(i * 16 + 6) * 0.5,
+                1.0 + rand_unit(i * 16 + 7) * 0.5, 1.0 + rand_unit(i * 16 + 8) * 0.5);
+        fsl_position_delta_set(&transform[i], rand_unit(i * 16 + 9),
+                rand_unit(i * 16 + 10), rand_unit(i * 16 + 11));
+        fsl_rotation_delta_set(&transform[i], rand_unit(i * 16 + 12) * 10.0,
+                rand_unit(i * 16 + 13) * 10.0, rand_unit(i * 16 + 14) * 10.0);
+        fsl_scale_delta_set(&transform[i], 1.0, 1.0, 1.0);
+    }
+
+    time_best = 0.0;
+    for (run = 0; run < BENCH_RUNS; ++run)
+    {
+        time_start = fsl_get_time_nsec();
+        for (i = 0; i < TRANSFORM_COUNT; ++i)
+            baked[i] = bake_reference(&transform[i]);
+        time = check_time_since(time_start);
+        time_best = !run || time < time_best ? time : time_best;
+    }
+    CHECK_REPORT(fsl_logger_stringf("bake %d by value: %7.2f ms\n", TRANSFORM_COUNT, time_best * 1e3));
+
+    for (level = FSL_CPU_LEVEL_SCALAR; level <= level_max; ++level)
+    {
+        fsl_cpu_set_level(level);
+
+        for (run = 0; run < BENCH_RUNS; ++run)
+        {
+            time_start = fsl_get_time_nsec();
+            fsl_transform_bake_batch(transform, baked, TRANSFORM_COUNT);
+            time = check_time_since(time_start);
+            time_best = !run || time < time_best ? time : time_best;
+        }
+
+        e = 0.0;
+        for (i = 0; i < TRANSFORM_COUNT; ++i)
+        {
+            ref = bake_reference(&transform[i]);
+            d = diff_m4f32(&baked[i], &ref);
+            e = d > e ? d : e;
+        }
+
+        CHECK(e <= ERROR_MAX,
+                fsl_logger_stringf("%s: Bake Error %.3g\n", level_name[level], e));
+        CHECK_REPORT(fsl_logger_stringf("bake %d %-6s: %7.2f ms, error %.2g\n",
+                    TRANSFORM_COUNT, level_name[level], time_best * 1e3, e));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    u64 transform_size = TRANSFORM_COUNT * sizeof(fsl_transform_v3f64);
+    u64 baked_size = TRANSFORM_COUNT * sizeof(m4f32);
+    u32 level = 0, level_max = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&transform, transform_size, "main().transform") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&baked, baked_size, "main().baked") != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    level_max = fsl_cpu_get_level_max();
+    for (level = FSL_CPU_LEVEL_SCALAR; level <= level_max; ++level)
+        check_level(level);
+    check_m4f64();
+    bench_bake(level_max);
+    fsl_cpu_set_level(level_max);
+
+cleanup:
+
+    fsl_mem_unmap((void*)&baked, baked_size, "main().baked");
+    fsl_mem_unmap((void*)&transform, transform_size, "main().transform");
+    return CHECK_CLOSE();
+}
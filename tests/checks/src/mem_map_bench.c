@@ -0,0 +1,152 @@
+/*!
+ *  benchmark of @ref fsl_mem_map_ex() backing hints, regular pages vs. transparent huge pages
+ *  vs. reserved huge pages, on the two TLB-heavy access patterns of the engine:
+ *
+ *  - chunk neighbor scans: random chunks of a large chunk buffer, each read with its
+ *    6 face neighbors,
+ *  - noise sampling: random lattice corners gathered from a copy of @ref fsl_rand_tab.
+ *
+ *  every backing must produce the same sums, timings are only reported.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/math/noise.h"
+
+#define CHUNK_DIAMETER  16
+#define CHUNK_VOLUME    (CHUNK_DIAMETER * CHUNK_DIAMETER * CHUNK_DIAMETER)
+#define CHUNK_GRID      24  /* chunks per axis, 56 MiB of blocks, a multiple of a huge page */
+#define CHUNK_COUNT     (CHUNK_GRID * CHUNK_GRID * CHUNK_GRID)
+#define SCAN_COUNT      400000
+#define SAMPLE_COUNT    8000000
+
+typedef struct backing
+{
+    const str *name;
+    u32 flags;
+} backing;
+
+static backing backing_list[] =
+{
+    {"regular",     0},
+    {"huge_page",   FSL_FLAG_MEM_MAP_HUGE_PAGE},
+    {"huge_tlb",    FSL_FLAG_MEM_MAP_HUGE_TLB | FSL_FLAG_MEM_MAP_POPULATE},
+};
+
+static u64 chunk_index(i64 x, i64 y, i64 z)
+{
+    x = (x + CHUNK_GRID) % CHUNK_GRID;
+    y = (y + CHUNK_GRID) % CHUNK_GRID;
+    z = (z + CHUNK_GRID) % CHUNK_GRID;
+    return (u64)((z * CHUNK_GRID + y) * CHUNK_GRID + x);
+}
+
+/*! @return sum of the center block of a chunk and of its 6 neighbors' facing border blocks. */
+static u64 chunk_scan(const u8 *chunk_buf, u64 seed)
+{
+    const u8 *c = NULL;
+    u64 sum = 0, i = 0, r = 0;
+    i64 x = 0, y = 0, z = 0;
+
+    for (i = 0; i < SCAN_COUNT; ++i)
+    {
+        r = fsl_rand_u64(seed + i);
+        x = (i64)(r % CHUNK_GRID);
+        y = (i64)((r >> 16) % CHUNK_GRID);
+        z = (i64)((r >> 32) % CHUNK_GRID);
+
+        c = chunk_buf + chunk_index(x, y, z) * CHUNK_VOLUME;
+        sum += c[CHUNK_VOLUME / 2];
+        c = chunk_buf + chunk_index(x - 1, y, z) * CHUNK_VOLUME;
+        sum += c[CHUNK_DIAMETER - 1];
+        c = chunk_buf + chunk_index(x + 1, y, z) * CHUNK_VOLUME;
+        sum += c[0];
+        c = chunk_buf + chunk_index(x, y - 1, z) * CHUNK_VOLUME;
+        sum += c[(CHUNK_DIAMETER - 1) * CHUNK_DIAMETER];
+        c = chunk_buf + chunk_index(x, y + 1, z) * CHUNK_VOLUME;
+        sum += c[CHUNK_DIAMETER];
+        c = chunk_buf + chunk_index(x, y, z - 1) * CHUNK_VOLUME;
+        sum += c[CHUNK_VOLUME - 1];
+        c = chunk_buf + chunk_index(x, y, z + 1) * CHUNK_VOLUME;
+        sum += c[CHUNK_DIAMETER * CHUNK_DIAMETER];
+    }
+    return sum;
+}
+
+/*! @return sum of 8 lattice corners per sample, the way a 3d noise sample reads them. */
+static f64 noise_gather(const f32 *tab, u64 seed)
+{
+    f64 sum = 0.0;
+    u64 i = 0, h = 0;
+
+    for (i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        h = fsl_rand_u64(seed + i);
+        sum +=
+            tab[(h + 0) % FSL_RAND_TAB_VOLUME] + tab[(h + 1) % FSL_RAND_TAB_VOLUME] +
+            tab[(h + FSL_RAND_TAB_DIAMETER) % FSL_RAND_TAB_VOLUME] +
+            tab[(h + FSL_RAND_TAB_DIAMETER + 1) % FSL_RAND_TAB_VOLUME] +
+            tab[(h + FSL_RAND_TAB_LAYER) % FSL_RAND_TAB_VOLUME] +
+            tab[(h + FSL_RAND_TAB_LAYER + 1) % FSL_RAND_TAB_VOLUME] +
+            tab[(h + FSL_RAND_TAB_LAYER + FSL_RAND_TAB_DIAMETER) % FSL_RAND_TAB_VOLUME] +
+            tab[(h + FSL_RAND_TAB_LAYER + FSL_RAND_TAB_DIAMETER + 1) % FSL_RAND_TAB_VOLUME];
+    }
+    return sum;
+}
+
+int main(int argc, char **argv)
+{
+    u8 *chunk_buf = NULL;
+    f32 *tab = NULL;
+    u64 chunk_size = (u64)CHUNK_COUNT * CHUNK_VOLUME;
+    u64 tab_size = FSL_RAND_TAB_VOLUME * sizeof(f32);
+    u64 scan_sum = 0, scan_ref = 0, i = 0, j = 0, time_start = 0;
+    f64 gather_sum = 0.0, gather_ref = 0.0, time_scan = 0.0, time_gather = 0.0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    for (i = 0; i < arr_len(backing_list); ++i)
+    {
+        if (
+                fsl_mem_map_ex((void*)&chunk_buf, chunk_size, backing_list[i].flags,
+                    "main().chunk_buf") != FSL_ERR_SUCCESS ||
+                fsl_mem_map_ex((void*)&tab, tab_size, backing_list[i].flags,
+                    "main().tab") != FSL_ERR_SUCCESS)
+        {
+            CHECK(FALSE, fsl_logger_stringf("Backing '%s' Failed to Map\n", backing_list[i].name));
+            break;
+        }
+
+        for (j = 0; j < chunk_size; ++j)
+            chunk_buf[j] = (u8)fsl_rand_u64(j);
+        for (j = 0; j < FSL_RAND_TAB_VOLUME; ++j)
+            tab[j] = fsl_rand_tab[j];
+
+        time_start = fsl_get_time_nsec();
+        scan_sum = chunk_scan(chunk_buf, 1337);
+        time_scan = check_time_since(time_start);
+
+        time_start = fsl_get_time_nsec();
+        gather_sum = noise_gather(tab, 1337);
+        time_gather = check_time_since(time_start);
+
+        if (!i)
+        {
+            scan_ref = scan_sum;
+            gather_ref = gather_sum;
+        }
+        CHECK(scan_sum == scan_ref && gather_sum == gather_ref,
+                fsl_logger_stringf("Backing '%s' Read Different Data\n", backing_list[i].name));
+
+        CHECK_REPORT(fsl_logger_stringf("%-10s neighbor scan: %8.2f Mscans/s, noise gather: %8.2f Msamples/s\n",
+                    backing_list[i].name,
+                    (f64)SCAN_COUNT / time_scan * 1e-6, (f64)SAMPLE_COUNT / time_gather * 1e-6));
+
+        fsl_mem_unmap((void*)&tab, tab_size, "main().tab");
+        fsl_mem_unmap((void*)&chunk_buf, chunk_size, "main().chunk_buf");
+    }
+
+    fsl_mem_unmap((void*)&tab, tab_size, "main().tab");
+    fsl_mem_unmap((void*)&chunk_buf, chunk_size, "main().chunk_buf");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,203 @@
+/*!
+ *  checks and benchmark of the lattice hashes of @ref fsl_noise_sample_hash_set().
+ *
+ *  - distribution: gradient components over a lattice block, binned by value, against the
+ *    value distribution of all of @ref fsl_rand_tab (chi-square), a hash reaching only part
+ *    of the table shows as the part's sampling noise,
+ *  - seed stability: the same seed gives the same gradients, also after switching hashes,
+ *    and neighboring seeds give uncorrelated noise,
+ *  - nanoseconds per gradient.
+ *
+ *  only @ref FSL_NOISE_HASH_MIX must pass the distribution check, @ref FSL_NOISE_HASH_TABLE
+ *  is kept as is for existing worlds and only reported.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/math/noise.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler_sample.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define BIN_MAX         360     /* @ref fsl_rand_tab holds sines of whole degrees */
+#define LATTICE_RADIUS  1000
+#define CORR_DIAMETER   300
+#define CORR_MAX        0.05
+#define BENCH_DIAMETER  3000
+#define SEED            12345
+
+static const str *hash_name[FSL_NOISE_HASH_COUNT] = {"table", "mix"};
+
+static f32 bin_value[BIN_MAX];
+static f64 bin_p[BIN_MAX];
+static u64 bin_count[BIN_MAX];
+static u32 bin_len = 0;
+
+static i32 cmp_f32(const void *a, const void *b)
+{
+    return (*(const f32*)a > *(const f32*)b) - (*(const f32*)a < *(const f32*)b);
+}
+
+/*! @return bin of `v`, by binary search over the distinct table values. */
+static u32 bin_of(f32 v)
+{
+    u32 lo = 0, hi = bin_len, mid = 0;
+
+    while (hi - lo > 1)
+    {
+        mid = (lo + hi) / 2;
+        if (bin_value[mid] <= v)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*! @brief collect the distinct values of @ref fsl_rand_tab and their share of it. */
+static void bins_init(void)
+{
+    static f32 sorted[FSL_RAND_TAB_VOLUME];
+    u64 i = 0;
+
+    for (i = 0; i < FSL_RAND_TAB_VOLUME; ++i)
+        sorted[i] = fsl_rand_tab[i];
+    qsort(sorted, FSL_RAND_TAB_VOLUME, sizeof(f32), cmp_f32);
+
+    for (i = 0; i < FSL_RAND_TAB_VOLUME && bin_len < BIN_MAX; ++i)
+        if (!i || sorted[i] != sorted[i - 1])
+            bin_value[bin_len++] = sorted[i];
+    for (i = 0; i < FSL_RAND_TAB_VOLUME; ++i)
+        bin_p[bin_of(fsl_rand_tab[i])] += 1.0 / FSL_RAND_TAB_VOLUME;
+}
+
+/*! @return chi-square of gradient components of `dim` dimensions against @ref bin_p. */
+static f64 chi_square(u32 dim, u64 seed)
+{
+    v2f64 g2 = {0};
+    v3f64 g3 = {0};
+    u64 n = 0, k = 0;
+    i32 x = 0, y = 0;
+    f64 chi = 0.0, expect = 0.0;
+
+    for (k = 0; k < bin_len; ++k)
+        bin_count[k] = 0;
+
+    for (y = -LATTICE_RADIUS; y < LATTICE_RADIUS; ++y)
+        for (x = -LATTICE_RADIUS; x < LATTICE_RADIUS; ++x)
+        {
+            if (dim == 2)
+            {
+                g2 = fsl_noise_sample_gradient_2d(x, y, seed);
+                ++bin_count[bin_of((f32)g2.x)];
+                ++bin_count[bin_of((f32)g2.y)];
+                n += 2;
+            }
+            else
+            {
+                g3 = fsl_noise_sample_gradient_3d(x, y, x ^ y, seed);
+                ++bin_count[bin_of((f32)g3.x)];
+                ++bin_count[bin_of((f32)g3.y)];
+                ++bin_count[bin_of((f32)g3.z)];
+                n += 3;
+            }
+        }
+
+    for (k = 0; k < bin_len; ++k)
+    {
+        expect = bin_p[k] * n;
+        chi += (bin_count[k] - expect) * (bin_count[k] - expect) / expect;
+    }
+    return chi;
+}
+
+/*! @return correlation of 2d noise of `seed_a` and `seed_b` over a block of points. */
+static f64 correlation(u64 seed_a, u64 seed_b)
+{
+    fsl_noise_sample s = {0};
+    f64 a = 0.0, b = 0.0, sab = 0.0, sa = 0.0, sb = 0.0, saa = 0.0, sbb = 0.0, n = 0.0;
+    i32 x = 0, y = 0;
+
+    for (y = 0; y < CORR_DIAMETER; ++y)
+        for (x = 0; x < CORR_DIAMETER; ++x)
+        {
+            fsl_noise_sample_axis_init(&s, 0, x * 0.37, 1.0);
+            fsl_noise_sample_axis_init(&s, 1, y * 0.37, 1.0);
+            a = fsl_noise_sample_make_2d(&s, 1.0, seed_a);
+            b = fsl_noise_sample_make_2d(&s, 1.0, seed_b);
+            sab += a * b;
+            sa += a;
+            sb += b;
+            saa += a * a;
+            sbb += b * b;
+            n += 1.0;
+        }
+
+    return (sab / n - sa / n * sb / n) /
+        sqrt((saa / n - sa / n * sa / n) * (sbb / n - sb / n * sb / n));
+}
+
+static void check_hash(u32 hash)
+{
+    v3f64 g = {0}, g_again = {0};
+    u64 time_start = 0;
+    i32 x = 0, y = 0;
+    f64 chi_2d = 0.0, chi_3d = 0.0, chi_max = 0.0, corr_near = 0.0, corr_far = 0.0, sum = 0.0;
+    f64 time = 0.0;
+
+    fsl_noise_sample_hash_set(hash);
+
+    /* bound at about 99.95%, normal approximation of chi-square */
+    chi_max = (bin_len - 1) + 3.3 * sqrt(2.0 * (bin_len - 1));
+    chi_2d = chi_square(2, SEED);
+    chi_3d = chi_square(3, SEED);
+    if (hash == FSL_NOISE_HASH_MIX)
+        CHECK(chi_2d < chi_max && chi_3d < chi_max,
+                fsl_logger_stringf("%s: Chi-Square %.1f (2D), %.1f (3D) Over %.1f\n",
+                    hash_name[hash], chi_2d, chi_3d, chi_max));
+
+    g = fsl_noise_sample_gradient_3d(7, -3, 11, SEED);
+    fsl_noise_sample_hash_set(!hash);
+    fsl_noise_sample_gradient_3d(7, -3, 11, SEED);
+    fsl_noise_sample_hash_set(hash);
+    g_again = fsl_noise_sample_gradient_3d(7, -3, 11, SEED);
+    CHECK(g.x == g_again.x && g.y == g_again.y && g.z == g_again.z,
+            fsl_logger_stringf("%s: Same Seed Gave Different Gradients\n", hash_name[hash]));
+
+    corr_near = correlation(SEED, SEED + 1);
+    corr_far = correlation(SEED, SEED * 8 + 1);
+    if (hash == FSL_NOISE_HASH_MIX)
+        CHECK(fabs(corr_near) < CORR_MAX && fabs(corr_far) < CORR_MAX,
+                fsl_logger_stringf("%s: Seeds Correlate, %.3f (Next Seed), %.3f (Far Seed)\n",
+                    hash_name[hash], corr_near, corr_far));
+
+    time_start = fsl_get_time_nsec();
+    for (y = 0; y < BENCH_DIAMETER; ++y)
+        for (x = 0; x < BENCH_DIAMETER; ++x)
+        {
+            g = fsl_noise_sample_gradient_3d(x, y, x + y, SEED);
+            sum += g.x + g.y + g.z;
+        }
+    time = check_time_since(time_start);
+
+    CHECK_REPORT(fsl_logger_stringf("%-5s: chi-square %7.1f (2D) %7.1f (3D) of %.1f, "
+                "seed correlation %6.3f (next) %6.3f (far), gradient_3d %6.2fns (sum %.1f)\n",
+                hash_name[hash], chi_2d, chi_3d, chi_max, corr_near, corr_far,
+                time / ((f64)BENCH_DIAMETER * BENCH_DIAMETER) * 1e9, sum));
+}
+
+int main(int argc, char **argv)
+{
+    u32 hash = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    bins_init();
+
+    for (hash = 0; hash < FSL_NOISE_HASH_COUNT; ++hash)
+        check_hash(hash);
+
+    fsl_noise_sample_hash_set(FSL_NOISE_HASH_TABLE);
+    return CHECK_CLOSE();
+}
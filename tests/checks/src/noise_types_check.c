@@ -0,0 +1,113 @@
+/*!
+ *  checks and benchmark of the noise sampler types, perlin, simplex and OpenSimplex2,
+ *  in 2D and 3D (@ref fsl_noise_sample_make_2d(), @ref fsl_noise_sample_make_simplex_2d(),
+ *  @ref fsl_noise_sample_make_opensimplex2_2d() and their 3D versions).
+ *
+ *  - range: every sample within the amplitude,
+ *  - mean: near 0, relative to the standard deviation,
+ *  - continuity: the largest step between points 1e-6 apart must shrink with the distance
+ *    as it does between points 1e-4 apart, a jump at a lattice or simplex edge doesn't,
+ *  - samples per second.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler_sample.h"
+
+#include <math.h>
+
+#define SAMPLE_COUNT    1000000
+#define STEP_FAR        1e-4
+#define STEP_NEAR       1e-6
+#define MEAN_MAX        0.05    /* |mean| / standard deviation */
+#define STEP_RATIO_MAX  0.05    /* near over far step, 0.01 for a continuous function */
+#define AMPLITUDE       1.0
+#define SEED            12345
+
+typedef f64 (*sample_func)(const fsl_noise_sample *s, f64 amplitude, u64 seed);
+
+typedef struct noise_type
+{
+    const str *name;
+    u32 dim;
+    sample_func func;
+} noise_type;
+
+static const noise_type type_list[] =
+{
+    {"perlin",          2, fsl_noise_sample_make_2d},
+    {"simplex",         2, fsl_noise_sample_make_simplex_2d},
+    {"opensimplex2",    2, fsl_noise_sample_make_opensimplex2_2d},
+    {"perlin",          3, fsl_noise_sample_make_3d},
+    {"simplex",         3, fsl_noise_sample_make_simplex_3d},
+    {"opensimplex2",    3, fsl_noise_sample_make_opensimplex2_3d},
+};
+
+/*! @brief sample point `i`, nudged by `step` along every axis. */
+static f64 sample(const noise_type *type, u64 i, f64 step)
+{
+    fsl_noise_sample s = {0};
+    u32 axis = 0;
+
+    for (axis = 0; axis < type->dim; ++axis)
+        fsl_noise_sample_axis_init(&s, axis,
+                (f64)((i64)(fsl_rand_u64(i * 3 + axis) % 2000000) - 1000000) * 0.001 + step, 1.0);
+    return type->func(&s, AMPLITUDE, SEED);
+}
+
+static void check_type(const noise_type *type)
+{
+    u64 i = 0, time_start = 0;
+    f64 v = 0.0, min = 0.0, max = 0.0, sum = 0.0, sum_sq = 0.0, mean = 0.0, deviation = 0.0;
+    f64 step = 0.0, step_far = 0.0, step_near = 0.0, time = 0.0;
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        v = sample(type, i, 0.0);
+        min = v < min ? v : min;
+        max = v > max ? v : max;
+        sum += v;
+        sum_sq += v * v;
+    }
+    time = check_time_since(time_start);
+
+    mean = sum / SAMPLE_COUNT;
+    deviation = sqrt(sum_sq / SAMPLE_COUNT - mean * mean);
+
+    for (i = 0; i < SAMPLE_COUNT / 10; ++i)
+    {
+        v = sample(type, i, 0.0);
+        step = fabs(sample(type, i, STEP_FAR) - v);
+        step_far = step > step_far ? step : step_far;
+        step = fabs(sample(type, i, STEP_NEAR) - v);
+        step_near = step > step_near ? step : step_near;
+    }
+
+    CHECK(min >= -AMPLITUDE && max <= AMPLITUDE,
+            fsl_logger_stringf("%s %"PRIu32"D: Range [%.3f, %.3f] Past the Amplitude\n",
+                type->name, type->dim, min, max));
+    CHECK(deviation > 0.0 && fabs(mean) / deviation < MEAN_MAX,
+            fsl_logger_stringf("%s %"PRIu32"D: Mean %.4f, Deviation %.4f\n",
+                type->name, type->dim, mean, deviation));
+    CHECK(step_near < step_far * STEP_RATIO_MAX,
+            fsl_logger_stringf("%s %"PRIu32"D: Discontinuous, Step %.3g at %g, %.3g at %g\n",
+                type->name, type->dim, step_near, STEP_NEAR, step_far, STEP_FAR));
+
+    CHECK_REPORT(fsl_logger_stringf("%-12s %"PRIu32"D: range [%6.3f, %6.3f], mean %7.4f, deviation %.4f, "
+                "step ratio %.4f, %7.2f Msamples/s\n",
+                type->name, type->dim, min, max, mean, deviation, step_near / step_far,
+                (f64)SAMPLE_COUNT / time * 1e-6));
+}
+
+int main(int argc, char **argv)
+{
+    u64 i = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    for (i = 0; i < arr_len(type_list); ++i)
+        check_type(&type_list[i]);
+
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,162 @@
+/*!
+ *  checks and benchmark of the batched perlin noise (@ref fsl_perlin_noise_1d_batch() and
+ *  its 2D and 3D versions) at every kernel level this cpu runs (@ref fsl_cpu_set_level()).
+ *
+ *  - error against the scalar @ref fsl_perlin_noise_1d_ex() and its 2D and 3D versions,
+ *    bounded relative to the summed octave amplitudes, at 1 to 8 octaves and at point
+ *    counts that leave partial SIMD groups,
+ *  - points per second per octave count, against the scalar calls.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/h/cpu.h"
+#include "../../../fossil/deps/fossil/math/noise.h"
+
+#include <math.h>
+
+#define POINT_COUNT     100003  /* not a multiple of any lane count */
+#define BENCH_COUNT     1000000
+#define AMPLITUDE       1.0f
+#define FREQUENCY       (1.0f / 37.0f)
+#define PERSIST_AMP     0.5f
+#define PERSIST_FREQ    2.0f
+#define SEED            12345
+#define ERROR_MAX       1e-5    /* relative to the summed octave amplitudes */
+
+static const str *level_name[FSL_CPU_LEVEL_COUNT] = {"scalar", "sse4.1", "avx2", "avx512"};
+static const u32 octave_list[] = {1, 4, 8};
+
+static f32 *px = NULL;
+static f32 *py = NULL;
+static f32 *pz = NULL;
+static f32 *dst = NULL;
+
+static f32 reference(u32 dim, u64 i, u32 octaves)
+{
+    switch (dim)
+    {
+        case 1:
+            return fsl_perlin_noise_1d_ex(px[i], AMPLITUDE, FREQUENCY,
+                    octaves, PERSIST_AMP, PERSIST_FREQ, SEED);
+        case 2:
+            return fsl_perlin_noise_2d_ex(px[i], py[i], AMPLITUDE, FREQUENCY,
+                    octaves, PERSIST_AMP, PERSIST_FREQ, SEED);
+    }
+    return fsl_perlin_noise_3d_ex(px[i], py[i], pz[i], AMPLITUDE, FREQUENCY,
+            octaves, PERSIST_AMP, PERSIST_FREQ, SEED);
+}
+
+static void batch(u32 dim, u64 n, u32 octaves)
+{
+    switch (dim)
+    {
+        case 1:
+            fsl_perlin_noise_1d_batch(px, dst, n, AMPLITUDE, FREQUENCY,
+                    octaves, PERSIST_AMP, PERSIST_FREQ, SEED);
+            return;
+        case 2:
+            fsl_perlin_noise_2d_batch(px, py, dst, n, AMPLITUDE, FREQUENCY,
+                    octaves, PERSIST_AMP, PERSIST_FREQ, SEED);
+            return;
+    }
+    fsl_perlin_noise_3d_batch(px, py, pz, dst, n, AMPLITUDE, FREQUENCY,
+            octaves, PERSIST_AMP, PERSIST_FREQ, SEED);
+}
+
+/*! @return largest relative error. */
+static f64 check_error(u32 level, u32 dim, u32 octaves)
+{
+    static const u64 len_list[] = {0, 1, 3, 7, 9, 17, POINT_COUNT};
+    u64 i = 0, j = 0;
+    f64 amp_sum = 0.0, amp = AMPLITUDE, error = 0.0, error_max = 0.0;
+
+    for (i = 0; i < octaves; ++i, amp *= PERSIST_AMP)
+        amp_sum += amp;
+
+    for (j = 0; j < arr_len(len_list); ++j)
+    {
+        for (i = 0; i < len_list[j] + 1; ++i)
+            dst[i] = 1234.0f;
+        batch(dim, len_list[j], octaves);
+
+        for (i = 0; i < len_list[j]; ++i)
+        {
+            error = fabs((f64)dst[i] - reference(dim, i, octaves)) / amp_sum;
+            if (error > error_max || error != error)
+                error_max = error != error ? 1.0 : error;
+        }
+        CHECK(dst[len_list[j]] == 1234.0f,
+                fsl_logger_stringf("%s: %"PRIu32"D, %"PRIu32" Octaves, %"PRIu64" Points Written Past the End\n",
+                    level_name[level], dim, octaves, len_list[j]));
+    }
+
+    CHECK(error_max <= ERROR_MAX,
+            fsl_logger_stringf("%s: %"PRIu32"D, %"PRIu32" Octaves, Error %.3g Over %.3g\n",
+                level_name[level], dim, octaves, error_max, ERROR_MAX));
+    return error_max;
+}
+
+static void bench(u32 level, u32 dim, u32 octaves, f64 error)
+{
+    u64 i = 0, time_start = 0;
+    f64 time_batch = 0.0, time_scalar = 0.0, sum = 0.0;
+
+    time_start = fsl_get_time_nsec();
+    batch(dim, BENCH_COUNT, octaves);
+    time_batch = check_time_since(time_start);
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < BENCH_COUNT; ++i)
+        sum += reference(dim, i, octaves);
+    time_scalar = check_time_since(time_start);
+
+    CHECK_REPORT(fsl_logger_stringf("%-6s %"PRIu32"D %"PRIu32" octaves: batch %8.2f Mpoints/s, scalar %8.2f Mpoints/s, error %.2g (sum %.1f)\n",
+                level_name[level], dim, octaves,
+                (f64)BENCH_COUNT / time_batch * 1e-6, (f64)BENCH_COUNT / time_scalar * 1e-6, error, sum));
+}
+
+int main(int argc, char **argv)
+{
+    u64 size = (BENCH_COUNT + 1) * sizeof(f32);
+    u64 i = 0;
+    u32 level = 0, level_max = 0, dim = 0, j = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&px, size, "main().px") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&py, size, "main().py") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&pz, size, "main().pz") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&dst, size, "main().dst") != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    /* negative and positive coordinates, lattice cells on both sides of the origin */
+    for (i = 0; i < BENCH_COUNT; ++i)
+    {
+        px[i] = (f32)((i64)(fsl_rand_u64(i * 3 + 0) % 200000) - 100000) * 0.01f;
+        py[i] = (f32)((i64)(fsl_rand_u64(i * 3 + 1) % 200000) - 100000) * 0.01f;
+        pz[i] = (f32)((i64)(fsl_rand_u64(i * 3 + 2) % 200000) - 100000) * 0.01f;
+    }
+
+    level_max = fsl_cpu_get_level_max();
+    for (level = FSL_CPU_LEVEL_SCALAR; level <= level_max; ++level)
+    {
+        fsl_cpu_set_level(level);
+        for (dim = 1; dim <= 3; ++dim)
+            for (j = 0; j < arr_len(octave_list); ++j)
+                bench(level, dim, octave_list[j], check_error(level, dim, octave_list[j]));
+    }
+    fsl_cpu_set_level(level_max);
+
+cleanup:
+
+    fsl_mem_unmap((void*)&dst, size, "main().dst");
+    fsl_mem_unmap((void*)&pz, size, "main().pz");
+    fsl_mem_unmap((void*)&py, size, "main().py");
+    fsl_mem_unmap((void*)&px, size, "main().px");
+    return CHECK_CLOSE();
+}
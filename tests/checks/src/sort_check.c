@@ -0,0 +1,175 @@
+/*!
+ *  checks and benchmark of @ref fsl_sort_radix_u32(), @ref fsl_sort_radix_u64() and
+ *  @ref fsl_sort_merge().
+ *
+ *  - order and stability (equal keys keep their payload order) at edge sizes,
+ *  - merge sort of odd-sized, unaligned and large elements,
+ *  - timings at 10^3 to 10^7 elements, against `qsort()`.
+ */
+
+#include "check.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LEN_MAX     10000000
+#define ODD_SIZE    13  /* element size of the unaligned merge sort case, in bytes */
+#define LARGE_SIZE  200 /* element size of the large merge sort case, in bytes */
+
+static u32 *key32 = NULL;
+static u64 *key64 = NULL;
+static u32 *key_index = NULL;
+static u8 *elem = NULL;
+static u8 *scratch = NULL;
+
+static u64 edge_len[] = {0, 1, 2, 3, 15, 16, 17, 255, 256, 257, 1000, 65537};
+
+static i32 cmp_u32(const void *a, const void *b)
+{
+    u32 x = 0, y = 0;
+    memcpy(&x, a, sizeof(u32));
+    memcpy(&y, b, sizeof(u32));
+    return (x > y) - (x < y);
+}
+
+/*! @brief compare by a 1-byte key at the start of an element, the rest is payload. */
+static i32 cmp_byte(const void *a, const void *b)
+{
+    return (i32)*(const u8*)a - (i32)*(const u8*)b;
+}
+
+static void check_radix(u64 len, u32 key_range)
+{
+    u64 i = 0;
+    b8 ok32 = TRUE, ok64 = TRUE;
+
+    for (i = 0; i < len; ++i)
+    {
+        key32[i] = (u32)(fsl_rand_u64(i) % key_range);
+        key_index[i] = (u32)i;
+    }
+    fsl_sort_radix_u32(key32, key_index, len, scratch);
+    for (i = 1; i < len; ++i)
+        if (key32[i - 1] > key32[i] || (key32[i - 1] == key32[i] && key_index[i - 1] > key_index[i]) ||
+                key32[i] != (u32)(fsl_rand_u64(key_index[i]) % key_range))
+            ok32 = FALSE;
+
+    for (i = 0; i < len; ++i)
+    {
+        key64[i] = (fsl_rand_u64(i) % key_range) << 40 | (fsl_rand_u64(i) % 7);
+        key_index[i] = (u32)i;
+    }
+    fsl_sort_radix_u64(key64, key_index, len, scratch);
+    for (i = 1; i < len; ++i)
+        if (key64[i - 1] > key64[i] || (key64[i - 1] == key64[i] && key_index[i - 1] > key_index[i]))
+            ok64 = FALSE;
+
+    CHECK(ok32, fsl_logger_stringf("Radix u32: Length %"PRIu64", Range %"PRIu32" Not Sorted or Not Stable\n",
+                len, key_range));
+    CHECK(ok64, fsl_logger_stringf("Radix u64: Length %"PRIu64", Range %"PRIu32" Not Sorted or Not Stable\n",
+                len, key_range));
+}
+
+/*!
+ *  @brief merge sort elements of `size` bytes at an odd address, key in the first byte,
+ *  the original position in the next 4 bytes, so stability can be checked.
+ */
+static void check_merge(u64 len, u64 size)
+{
+    u8 *buf = elem + 1;
+    u32 pos = 0, pos_prev = 0;
+    u64 i = 0;
+    b8 ok = TRUE;
+
+    for (i = 0; i < len; ++i)
+    {
+        pos = (u32)i;
+        memset(buf + i * size, (u8)i, size);
+        buf[i * size] = (u8)(fsl_rand_u64(i) % 5);
+        memcpy(buf + i * size + 1, &pos, sizeof(u32));
+    }
+
+    fsl_sort_merge(buf, len, size, cmp_byte, scratch + 3);
+
+    for (i = 0; i < len; ++i)
+    {
+        memcpy(&pos, buf + i * size + 1, sizeof(u32));
+        if (buf[i * size] != (u8)(fsl_rand_u64(pos) % 5) || buf[i * size + size - 1] != (u8)pos)
+            ok = FALSE;
+        if (i && (buf[(i - 1) * size] > buf[i * size] ||
+                    (buf[(i - 1) * size] == buf[i * size] && pos_prev > pos)))
+            ok = FALSE;
+        pos_prev = pos;
+    }
+
+    CHECK(ok, fsl_logger_stringf("Merge: Length %"PRIu64", Size %"PRIu64" Not Sorted, Not Stable or Corrupt\n",
+                len, size));
+}
+
+static void bench(u64 len)
+{
+    u64 i = 0, time_start = 0;
+    f64 time_radix = 0.0, time_merge = 0.0, time_qsort = 0.0;
+
+    for (i = 0; i < len; ++i)
+        key32[i] = (u32)fsl_rand_u64(i);
+    time_start = fsl_get_time_nsec();
+    fsl_sort_radix_u32(key32, NULL, len, scratch);
+    time_radix = check_time_since(time_start);
+
+    for (i = 0; i < len; ++i)
+        key32[i] = (u32)fsl_rand_u64(i);
+    time_start = fsl_get_time_nsec();
+    fsl_sort_merge(key32, len, sizeof(u32), cmp_u32, scratch);
+    time_merge = check_time_since(time_start);
+
+    for (i = 0; i < len; ++i)
+        key32[i] = (u32)fsl_rand_u64(i);
+    time_start = fsl_get_time_nsec();
+    qsort(key32, len, sizeof(u32), cmp_u32);
+    time_qsort = check_time_since(time_start);
+
+    CHECK_REPORT(fsl_logger_stringf("%8"PRIu64" u32: radix %9.3fms, merge %9.3fms, qsort %9.3fms\n",
+                len, time_radix * 1e3, time_merge * 1e3, time_qsort * 1e3));
+}
+
+int main(int argc, char **argv)
+{
+    u64 scratch_size = LEN_MAX * (sizeof(u64) + sizeof(u32)) + 16;
+    u64 elem_size = 65537 * LARGE_SIZE + 16;
+    u64 i = 0, len = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&key32, LEN_MAX * sizeof(u32), "main().key32") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&key64, LEN_MAX * sizeof(u64), "main().key64") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&key_index, LEN_MAX * sizeof(u32), "main().key_index") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&elem, elem_size, "main().elem") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&scratch, scratch_size, "main().scratch") != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    for (i = 0; i < arr_len(edge_len); ++i)
+    {
+        check_radix(edge_len[i], 3);
+        check_radix(edge_len[i], 0xffffffff);
+        check_merge(edge_len[i], ODD_SIZE);
+        check_merge(edge_len[i], LARGE_SIZE);
+    }
+
+    for (len = 1000; len <= LEN_MAX; len *= 10)
+        bench(len);
+
+cleanup:
+
+    fsl_mem_unmap((void*)&scratch, scratch_size, "main().scratch");
+    fsl_mem_unmap((void*)&elem, elem_size, "main().elem");
+    fsl_mem_unmap((void*)&key_index, LEN_MAX * sizeof(u32), "main().key_index");
+    fsl_mem_unmap((void*)&key64, LEN_MAX * sizeof(u64), "main().key64");
+    fsl_mem_unmap((void*)&key32, LEN_MAX * sizeof(u32), "main().key32");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,219 @@
+/*!
+ *  checks and benchmark of @ref fsl_spawn() and @ref fsl_process_poll().
+ *
+ *  - capture: stdout alone, stderr alone, both interleaved in write order, and output
+ *    past a pipe's capacity, which the child only gets to finish if it's drained,
+ *  - exit codes: zero and non-zero, and the @ref fsl_err each leaves,
+ *  - signal exits: the signal number in `exit_code`, @ref FSL_ERR_EXEC_SIGTERM,
+ *  - a command that doesn't exist fails at spawn, a running child polls `FALSE`,
+ *  - time per short process of `fork()` + `execvp()` vs. @ref fsl_spawn(), with a small
+ *    parent and with @ref ARENA_SIZE of touched memory mapped.
+ */
+
+#include "check.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BIG_SIZE        1000000     /* bytes of output, well past a 64 KiB pipe */
+#define BENCH_COUNT     2000
+#define BENCH_COUNT_ARENA 200       /* a `fork()` copies the arena's page tables each time */
+#define ARENA_SIZE      ((u64)1 << 30)
+
+/*! @brief point `cmd` at the `NULL` terminated `arg`. */
+static fsl_buf *cmd_make(fsl_buf *cmd, const str **arg)
+{
+    fsl_buf nocmd = {0};
+
+    *cmd = nocmd;
+    cmd->i = (void**)arg;
+    cmd->buf = (void*)arg;
+    cmd->size = sizeof(str*);
+    while (arg[cmd->memb])
+        ++cmd->memb;
+    cmd->loaded = TRUE;
+    return cmd;
+}
+
+/*! @brief run `sh -c script` to the end, capturing per `flags`. */
+static void run_sh(fsl_process *x, const str *script, u32 flags)
+{
+    const str *arg[] = {"sh", "-c", NULL, NULL};
+    fsl_buf cmd = {0};
+
+    arg[2] = script;
+    if (fsl_spawn(x, cmd_make(&cmd, arg), "sh", flags) == FSL_ERR_SUCCESS)
+        fsl_process_poll(x, TRUE);
+}
+
+static void check_capture(void)
+{
+    fsl_process x = {0};
+    u64 i = 0, bad = 0;
+
+    run_sh(&x, "printf out", FSL_FLAG_SPAWN_CAPTURE_STDOUT);
+    CHECK(x.result == FSL_ERR_SUCCESS && x.out && !strcmp(x.out, "out"),
+            fsl_logger_stringf("Stdout: Captured '%s'\n", x.out ? x.out : "(null)"));
+    fsl_process_free(&x);
+
+    run_sh(&x, "printf out >/dev/null; printf err >&2", FSL_FLAG_SPAWN_CAPTURE_STDERR);
+    CHECK(x.result == FSL_ERR_SUCCESS && x.out && !strcmp(x.out, "err"),
+            fsl_logger_stringf("Stderr: Captured '%s'\n", x.out ? x.out : "(null)"));
+    fsl_process_free(&x);
+
+    run_sh(&x, "printf 1; printf 2 >&2; printf 3; printf 4 >&2",
+            FSL_FLAG_SPAWN_CAPTURE_STDOUT | FSL_FLAG_SPAWN_CAPTURE_STDERR);
+    CHECK(x.result == FSL_ERR_SUCCESS && x.out && !strcmp(x.out, "1234"),
+            fsl_logger_stringf("Both: Captured '%s', Expected '1234'\n", x.out ? x.out : "(null)"));
+    fsl_process_free(&x);
+
+    run_sh(&x, "printf nothing", 0);
+    CHECK(x.result == FSL_ERR_SUCCESS && !x.out && !x.out_len, "None: Output Captured\n");
+    fsl_process_free(&x);
+
+    run_sh(&x, fsl_logger_stringf("head -c %d /dev/zero | tr '\\0' a", BIG_SIZE),
+            FSL_FLAG_SPAWN_CAPTURE_STDOUT);
+    for (i = 0; x.out && i < x.out_len; ++i)
+        bad += x.out[i] != 'a';
+    CHECK(x.result == FSL_ERR_SUCCESS && x.out_len == BIG_SIZE && !bad,
+            fsl_logger_stringf("Big: Captured %"PRIu64" Bytes, %"PRIu64" Wrong, Expected %d\n",
+                x.out_len, bad, BIG_SIZE));
+    fsl_process_free(&x);
+}
+
+static void check_exit(void)
+{
+    static const i32 code_list[] = {0, 1, 3, 127, 255};
+    static const i32 signal_list[] = {SIGTERM, SIGKILL, SIGSEGV};
+    fsl_process x = {0};
+    u64 i = 0;
+
+    for (i = 0; i < arr_len(code_list); ++i)
+    {
+        run_sh(&x, fsl_logger_stringf("exit %d", code_list[i]), 0);
+        CHECK(x.state == FSL_PROCESS_STATE_DONE && x.exit_code == code_list[i] &&
+                x.result == (code_list[i] ? FSL_ERR_EXEC_PROCESS_NON_ZERO : FSL_ERR_SUCCESS) &&
+                fsl_err == x.result,
+                fsl_logger_stringf("Exit %d: Exit Code %d, Result %"PRIu32"\n",
+                    code_list[i], x.exit_code, x.result));
+        fsl_process_free(&x);
+    }
+
+    for (i = 0; i < arr_len(signal_list); ++i)
+    {
+        run_sh(&x, fsl_logger_stringf("kill -%d $$", signal_list[i]), 0);
+        CHECK(x.state == FSL_PROCESS_STATE_DONE && x.exit_code == signal_list[i] &&
+                x.result == FSL_ERR_EXEC_SIGTERM && fsl_err == x.result,
+                fsl_logger_stringf("Signal %d: Exit Code %d, Result %"PRIu32"\n",
+                    signal_list[i], x.exit_code, x.result));
+        fsl_process_free(&x);
+    }
+}
+
+static void check_spawn(void)
+{
+    const str *arg_missing[] = {"fsl_spawn_check_no_such_command", NULL};
+    const str *arg_sleep[] = {"sleep", "0.2", NULL};
+    fsl_process x = {0};
+    fsl_buf cmd = {0};
+
+    CHECK(fsl_spawn(&x, cmd_make(&cmd, arg_missing), "missing", 0) == FSL_ERR_EXEC_FAIL &&
+            x.state == FSL_PROCESS_STATE_IDLE,
+            "Missing Command: Spawned\n");
+    fsl_process_free(&x);
+
+    fsl_spawn(&x, cmd_make(&cmd, arg_sleep), "sleep", 0);
+    CHECK(!fsl_process_poll(&x, FALSE) && x.state == FSL_PROCESS_STATE_RUNNING,
+            "Running: Polled Done\n");
+    CHECK(fsl_process_poll(&x, TRUE) && x.result == FSL_ERR_SUCCESS, "Running: Wait Failed\n");
+    fsl_process_free(&x);
+}
+
+/*! @return seconds per process of `fork()`, `execvp()` and `waitpid()` of `true`. */
+static f64 bench_fork(u64 count)
+{
+    str *const arg[] = {"true", NULL};
+    u64 i = 0, time_start = 0, fail = 0;
+    int status = 0;
+    pid_t pid = 0;
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < count; ++i)
+    {
+        if ((pid = fork()) == 0)
+        {
+            execvp(arg[0], arg);
+            _exit(127);
+        }
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status))
+            ++fail;
+    }
+    CHECK(!fail, fsl_logger_stringf("fork(): %"PRIu64" of %"PRIu64" Runs Failed\n", fail, count));
+    return check_time_since(time_start) / count;
+}
+
+/*! @return seconds per process of @ref fsl_spawn() and @ref fsl_process_poll() of `true`. */
+static f64 bench_spawn(u64 count)
+{
+    const str *arg[] = {"true", NULL};
+    fsl_process x = {0};
+    fsl_buf cmd = {0};
+    u64 i = 0, time_start = 0, fail = 0;
+
+    cmd_make(&cmd, arg);
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < count; ++i)
+    {
+        if (fsl_spawn(&x, &cmd, "true", 0) != FSL_ERR_SUCCESS ||
+                !fsl_process_poll(&x, TRUE) || x.result != FSL_ERR_SUCCESS)
+            ++fail;
+        fsl_process_free(&x);
+    }
+    CHECK(!fail, fsl_logger_stringf("fsl_spawn(): %"PRIu64" of %"PRIu64" Runs Failed\n", fail, count));
+    return check_time_since(time_start) / count;
+}
+
+int main(int argc, char **argv)
+{
+    u8 *arena = NULL;
+    u32 log_level = 0;
+    f64 time_fork[2] = {0}, time_spawn[2] = {0};
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    check_capture();
+    check_exit();
+    check_spawn();
+
+    /* quiet the per-process exit logs, they'd be timed too */
+    log_level = fsl_log_level_max;
+    fsl_log_level_max = FSL_LOG_LEVEL_WARNING;
+
+    time_fork[0] = bench_fork(BENCH_COUNT);
+    time_spawn[0] = bench_spawn(BENCH_COUNT);
+
+    if (fsl_mem_map((void*)&arena, ARENA_SIZE, "main().arena") != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+    memset(arena, 1, ARENA_SIZE);
+
+    time_fork[1] = bench_fork(BENCH_COUNT_ARENA);
+    time_spawn[1] = bench_spawn(BENCH_COUNT_ARENA);
+    fsl_log_level_max = log_level;
+
+    CHECK_REPORT(fsl_logger_stringf("%d processes: fork() %.1fus, spawn %.1fus each, "
+                "%d with %"PRIu64" MiB touched: fork() %.1fus, spawn %.1fus each\n",
+                BENCH_COUNT, time_fork[0] * 1e6, time_spawn[0] * 1e6,
+                BENCH_COUNT_ARENA, ARENA_SIZE >> 20, time_fork[1] * 1e6, time_spawn[1] * 1e6));
+
+cleanup:
+
+    fsl_mem_unmap((void*)&arena, ARENA_SIZE, "main().arena");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,154 @@
+/*!
+ *  checks and world diff of the f32 terrain samples (@ref TERRAIN_PRECISION_F32) against
+ *  the f64 reference, near the origin and near ±1e6 blocks, on a sampler whose map is
+ *  wide enough that neither wraps.
+ *
+ *  - block differences: columns whose surface block or biome differs, bounded, and the
+ *    surface voxels and biomes that differ,
+ *  - largest height error,
+ *  - generation time of both.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
+#include "../../game_hhc/src/h/world.h"
+#include "../../game_hhc/src/terrain/biome.h"
+#include "../../game_hhc/src/terrain/terrain.h"
+
+#include <math.h>
+
+#define AREA_RADIUS     8
+#define AREA_COLUMNS    ((u64)(AREA_RADIUS * 2 + 1) * (AREA_RADIUS * 2 + 1) * CHUNK_LAYER)
+#define MAP_RADIUS      4194304.0   /* blocks, past ±1e6 and its margins */
+#define MAP_MARGIN      ((f64)(WORLD_MARGIN * CHUNK_DIAMETER))
+#define COLUMN_RATE_MAX 1e-3        /* columns of a different surface block or biome */
+#define HEIGHT_ERROR_MAX 1e-2
+#define SEED            12345
+
+world_info world = {0};
+
+static const str *precision_name[] = {"f64", "f32"};
+static const i64 origin_list[] = {0, 1000000, -1000000};
+
+static fsl_noise_sampler sampler = {0};
+static fsl_noise_sampler_context ctx = {0};
+
+static f64 height[2][AREA_COLUMNS];
+static u8 biome[2][AREA_COLUMNS];
+
+/*!
+ *  @brief generate the bottom layer of each chunk around `origin` into `height[pass]` and
+ *  `biome[pass]`, the height of a column is the same at every layer.
+ *
+ *  @return seconds taken.
+ */
+static f64 area_generate(u32 pass, i64 origin)
+{
+    hhc_terrain_sample terrain = {0};
+    i32 cx = 0, cy = 0, x = 0, y = 0;
+    u64 i = 0, time_start = 0;
+
+    terrain_precision_set(pass);
+
+    time_start = fsl_get_time_nsec();
+    for (cy = -AREA_RADIUS; cy <= AREA_RADIUS; ++cy)
+        for (cx = -AREA_RADIUS; cx <= AREA_RADIUS; ++cx)
+        {
+            fsl_noise_sampler_context_init(&sampler, &ctx,
+                    (f64)(origin + cx * CHUNK_DIAMETER), (f64)(origin + cy * CHUNK_DIAMETER), 0.0);
+            terrain_grid_bake(&ctx);
+
+            fsl_noise_sampler_axis_init(&ctx, 2, 0);
+            fsl_noise_sampler_axis_pre_update(&ctx, 2);
+
+            fsl_noise_sampler_axis_init(&ctx, 1, 0);
+            for (y = 0; y < CHUNK_DIAMETER; ++y, fsl_noise_sampler_axis_post_update(&ctx, 1))
+            {
+                fsl_noise_sampler_axis_pre_update(&ctx, 1);
+                sampler_noise_axis_update_2d(&ctx, 1);
+
+                fsl_noise_sampler_axis_init(&ctx, 0, 0);
+                for (x = 0; x < CHUNK_DIAMETER; ++x, fsl_noise_sampler_axis_post_update(&ctx, 0))
+                {
+                    fsl_noise_sampler_axis_pre_update(&ctx, 0);
+                    sampler_noise_axis_update_2d(&ctx, 0);
+                    sampler_noise_bake(&ctx);
+                    terrain_shape(&terrain, &ctx);
+
+                    height[pass][i] = terrain.value;
+                    biome[pass][i] = (u8)terrain.biome;
+                    ++i;
+                }
+            }
+            fsl_noise_sampler_axis_post_update(&ctx, 2);
+        }
+    return check_time_since(time_start);
+}
+
+static void check_origin(i64 origin)
+{
+    u64 i = 0, column_diff = 0, voxel_diff = 0, biome_diff = 0;
+    f64 time[2] = {0}, error = 0.0, error_max = 0.0, top[2] = {0};
+
+    time[TERRAIN_PRECISION_F64] = area_generate(TERRAIN_PRECISION_F64, origin);
+    time[TERRAIN_PRECISION_F32] = area_generate(TERRAIN_PRECISION_F32, origin);
+
+    for (i = 0; i < AREA_COLUMNS; ++i)
+    {
+        /* a block is solid below the height, see @ref terrain_shape() */
+        top[0] = ceil(height[0][i]);
+        top[1] = ceil(height[1][i]);
+        biome_diff += biome[0][i] != biome[1][i];
+        if (top[0] != top[1] || biome[0][i] != biome[1][i])
+            ++column_diff;
+        voxel_diff += (u64)fabs(top[0] - top[1]);
+
+        error = fabs(height[0][i] - height[1][i]);
+        error_max = error > error_max ? error : error_max;
+    }
+
+    CHECK((f64)column_diff / AREA_COLUMNS <= COLUMN_RATE_MAX,
+            fsl_logger_stringf("Origin %+"PRId64": %"PRIu64" of %"PRIu64" Columns Differ (%.4f%%), Over %.4f%%\n",
+                origin, column_diff, AREA_COLUMNS,
+                (f64)column_diff / AREA_COLUMNS * 100.0, COLUMN_RATE_MAX * 100.0));
+    CHECK(error_max <= HEIGHT_ERROR_MAX,
+            fsl_logger_stringf("Origin %+"PRId64": Height Error %.3g Over %.3g\n",
+                origin, error_max, HEIGHT_ERROR_MAX));
+
+    CHECK_REPORT(fsl_logger_stringf("origin %+8"PRId64": %"PRIu64" columns, %"PRIu64" differ (%.4f%%), "
+                "%"PRIu64" surface voxels and %"PRIu64" biomes differ, height error max %.2e, "
+                "%s %.3fs, %s %.3fs\n",
+                origin, AREA_COLUMNS, column_diff, (f64)column_diff / AREA_COLUMNS * 100.0,
+                voxel_diff, biome_diff, error_max,
+                precision_name[TERRAIN_PRECISION_F64], time[TERRAIN_PRECISION_F64],
+                precision_name[TERRAIN_PRECISION_F32], time[TERRAIN_PRECISION_F32]));
+}
+
+int main(int argc, char **argv)
+{
+    u64 i = 0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (fsl_noise_sampler_init(&sampler, TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT, 8,
+                MAP_RADIUS, MAP_RADIUS, (f64)(WORLD_RADIUS_VERTICAL * CHUNK_DIAMETER),
+                MAP_RADIUS * 2.0, MAP_RADIUS * 2.0, (f64)(WORLD_DIAMETER_VERTICAL * CHUNK_DIAMETER),
+                MAP_MARGIN, MAP_MARGIN, MAP_MARGIN) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    world.seed = SEED;
+    terrain_init();
+
+    for (i = 0; i < arr_len(origin_list); ++i)
+        check_origin(origin_list[i]);
+    terrain_precision_set(TERRAIN_PRECISION_F64);
+
+cleanup:
+
+    fsl_noise_sampler_free(&sampler);
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,187 @@
+/*!
+ *  checks and benchmark of the terrain noise graph (@ref terrain_shape() and
+ *  @ref terrain_shape_row()) against the hand-written height formula it replaced.
+ *
+ *  - random noise vectors over the amplitude ranges of the default terrain spec, every
+ *    height must match the hand-written one bit for bit, not just within a tolerance,
+ *    one point at a time and a chunk row at a time,
+ *  - points per second of all three, each with its biome lookup, rows of
+ *    @ref TERRAIN_SHAPE_ROW_MAX points as in chunk generation.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
+#include "../../game_hhc/src/h/world.h"
+#include "../../game_hhc/src/terrain/biome.h"
+#include "../../game_hhc/src/terrain/terrain.h"
+
+#include <math.h>
+#include <string.h>
+
+#define NOISE_LEN       (TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT)
+#define POINT_COUNT     1000000
+#define BENCH_COUNT     10000000
+#define BENCH_SUM_ERROR_MAX 1e-3
+
+world_info world = {0};
+
+static f64 *noise = NULL;
+
+/* the reference is evaluated as written, as the noise graph is, see 'noise_graph.c' */
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC push_options
+#   pragma GCC optimize ("no-fast-math")
+#endif
+
+static f64 fade(f64 t)
+{
+    return t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+}
+
+/*! @brief the height formula of @ref terrain_shape() before the noise graph. */
+static f64 height_reference(const f64 *n)
+{
+    f64 value = 0.0, t = 0.0;
+
+    t = 1.0 - n[TERRAIN_NOISE_COUNT + BIOME_NOISE_TEMPERATURE];
+    t = fade(t);
+    value += n[TERRAIN_NOISE_REGIONAL] * t;
+
+    t = n[TERRAIN_NOISE_CONTINENTAL] / 1000.0 + 0.5;
+    t = fade(t);
+    value += n[TERRAIN_NOISE_CONTINENTAL] * t;
+
+    t = n[TERRAIN_NOISE_LOCAL] / 50.0 + 0.5;
+    t = fade(t);
+    value += (n[TERRAIN_NOISE_LOCAL] + 25.0) * t;
+    value -= 25.0;
+
+    t = n[TERRAIN_NOISE_COUNT + BIOME_NOISE_ROUGHNESS];
+    t = fade(t);
+    value += n[TERRAIN_NOISE_DETAIL] * t;
+
+    return value;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC pop_options
+#endif
+
+/*! @return uniform in [-`amp`, `amp`]. */
+static f64 rand_amp(u64 seed, f64 amp)
+{
+    return ((f64)(fsl_rand_u64(seed) >> 11) / (f64)((u64)1 << 53) * 2.0 - 1.0) * amp;
+}
+
+int main(int argc, char **argv)
+{
+    static const f64 amp[TERRAIN_NOISE_COUNT] = {1000.0, 200.0, 50.0, 5.0};
+    fsl_noise_sampler sampler = {0};
+    fsl_noise_sampler_context ctx = {0};
+    hhc_terrain_sample terrain = {0};
+    hhc_terrain_sample row[TERRAIN_SHAPE_ROW_MAX] = {0};
+    u64 noise_size = (u64)POINT_COUNT * NOISE_LEN * sizeof(f64);
+    u64 i = 0, j = 0, mismatch = 0, time_start = 0;
+    f64 reference = 0.0, diff_max = 0.0, sum_graph = 0.0, sum_reference = 0.0;
+    u64 sum_biome = 0, sum_biome_row = 0;
+    f64 time_graph = 0.0, time_row = 0.0, time_reference = 0.0, sum_row = 0.0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (fsl_mem_map((void*)&noise, noise_size, "main().noise") != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    terrain_init();
+
+    for (i = 0; i < POINT_COUNT; ++i)
+    {
+        for (j = 0; j < TERRAIN_NOISE_COUNT; ++j)
+            noise[i * NOISE_LEN + j] = rand_amp(i * NOISE_LEN + j, amp[j]);
+        for (; j < NOISE_LEN; ++j)
+            noise[i * NOISE_LEN + j] = rand_amp(i * NOISE_LEN + j, 0.5) + 0.5;
+    }
+
+    sampler.noise_buf.noise_len = NOISE_LEN;
+    ctx.sampler = &sampler;
+
+    for (i = 0; i < POINT_COUNT; ++i)
+    {
+        sampler.noise_buf.noise_dst_buf = &noise[i * NOISE_LEN];
+        terrain_shape(&terrain, &ctx);
+        reference = height_reference(&noise[i * NOISE_LEN]);
+        if (memcmp(&terrain.value, &reference, sizeof(f64)))
+        {
+            ++mismatch;
+            if (fabs(terrain.value - reference) > diff_max)
+                diff_max = fabs(terrain.value - reference);
+        }
+    }
+
+    CHECK(!mismatch,
+            fsl_logger_stringf("Exactness: %"PRIu64" of %d Heights Differ, by up to %g\n",
+                mismatch, POINT_COUNT, diff_max));
+
+    mismatch = 0;
+    for (i = 0; i + TERRAIN_SHAPE_ROW_MAX <= POINT_COUNT; i += TERRAIN_SHAPE_ROW_MAX)
+    {
+        terrain_shape_row(row, &noise[i * NOISE_LEN], 0.0, TERRAIN_SHAPE_ROW_MAX);
+        for (j = 0; j < TERRAIN_SHAPE_ROW_MAX; ++j)
+        {
+            reference = height_reference(&noise[(i + j) * NOISE_LEN]);
+            mismatch += memcmp(&row[j].value, &reference, sizeof(f64)) != 0;
+        }
+    }
+
+    CHECK(!mismatch,
+            fsl_logger_stringf("Exactness: %"PRIu64" of %d Heights Differ in Rows\n",
+                mismatch, POINT_COUNT));
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < BENCH_COUNT; ++i)
+    {
+        sampler.noise_buf.noise_dst_buf = &noise[(i % POINT_COUNT) * NOISE_LEN];
+        terrain_shape(&terrain, &ctx);
+        sum_graph += terrain.value;
+    }
+    time_graph = check_time_since(time_start);
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < BENCH_COUNT; i += TERRAIN_SHAPE_ROW_MAX)
+    {
+        terrain_shape_row(row, &noise[(i % POINT_COUNT) * NOISE_LEN], 0.0, TERRAIN_SHAPE_ROW_MAX);
+        for (j = 0; j < TERRAIN_SHAPE_ROW_MAX; ++j)
+        {
+            sum_row += row[j].value;
+            sum_biome_row += row[j].biome;
+        }
+    }
+    time_row = check_time_since(time_start);
+
+    time_start = fsl_get_time_nsec();
+    for (i = 0; i < BENCH_COUNT; ++i)
+    {
+        sum_reference += height_reference(&noise[(i % POINT_COUNT) * NOISE_LEN]);
+        sum_biome += biome_match(terrain_spec_get()->biome, BIOME_COUNT,
+                &noise[(i % POINT_COUNT) * NOISE_LEN + TERRAIN_NOISE_COUNT]);
+    }
+    time_reference = check_time_since(time_start);
+
+    /* the row sum may be reassociated under -Ofast, exactness is checked above */
+    CHECK(sum_graph == sum_reference && fabs(sum_row - sum_reference) <= BENCH_SUM_ERROR_MAX &&
+            sum_biome_row == sum_biome,
+            "Bench: Sums Differ\n");
+
+    CHECK_REPORT(fsl_logger_stringf("%d points: terrain_shape() %8.2f Mpoints/s, terrain_shape_row() %8.2f Mpoints/s, "
+                "hand-written %8.2f Mpoints/s\n",
+                BENCH_COUNT, (f64)BENCH_COUNT / time_graph * 1e-6, (f64)BENCH_COUNT / time_row * 1e-6,
+                (f64)BENCH_COUNT / time_reference * 1e-6));
+
+cleanup:
+
+    fsl_mem_unmap((void*)&noise, noise_size, "main().noise");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,188 @@
+/*!
+ *  checks and benchmark of the sparse terrain noise grid (@ref terrain_grid_bake()) against
+ *  sampling every noise at every block, over a block of chunks generated the way chunk
+ *  generation drives the sampler.
+ *
+ *  - voxel difference rate: blocks whose id differs from full resolution, and the part of
+ *    them that flips between solid and air, both bounded,
+ *  - height difference, largest and mean,
+ *  - generation time and work cost of both.
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
+#include "../../../fossil/deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler_cache.h"
+#include "../../game_hhc/src/h/world.h"
+#include "../../game_hhc/src/terrain/biome.h"
+#include "../../game_hhc/src/terrain/terrain.h"
+
+#include <math.h>
+
+#define NOISE_LEN       (TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT)
+#define AREA_RADIUS     8
+#define AREA_RADIUS_Z   2
+#define AREA_VOLUME     ((u64)(AREA_RADIUS * 2 + 1) * (AREA_RADIUS * 2 + 1) * \
+        (AREA_RADIUS_Z * 2 + 1) * CHUNK_VOLUME)
+#define DIFF_RATE_MAX   1e-3    /* voxels of a different block id */
+#define FLIP_RATE_MAX   1e-3    /* voxels flipping between solid and air */
+#define CACHE_SIZE      1024    /* as @ref CHUNK_SAMPLER_LATTICE_CACHE_SIZE */
+#define SEED            12345
+
+world_info world = {0};
+
+static fsl_noise_sampler sampler = {0};
+static fsl_noise_sampler_context ctx = {0};
+static fsl_noise_lattice_cache cache = {0};
+
+static f64 *height[2] = {NULL};
+static u8 *block[2] = {NULL};
+
+/*!
+ *  @brief generate the area into `height[pass]` and `block[pass]`.
+ *
+ *  @param cost work cost summed over the area.
+ *
+ *  @return seconds taken.
+ */
+static f64 area_generate(u32 pass, u64 *cost)
+{
+    hhc_terrain_sample terrain = {0};
+    i32 cx = 0, cy = 0, cz = 0, x = 0, y = 0, z = 0;
+    u64 i = 0, time_start = 0;
+
+    *cost = 0;
+    time_start = fsl_get_time_nsec();
+    for (cz = -AREA_RADIUS_Z; cz <= AREA_RADIUS_Z; ++cz)
+        for (cy = -AREA_RADIUS; cy <= AREA_RADIUS; ++cy)
+            for (cx = -AREA_RADIUS; cx <= AREA_RADIUS; ++cx)
+            {
+                fsl_noise_sampler_context_init(&sampler, &ctx,
+                        (f64)(cx * CHUNK_DIAMETER), (f64)(cy * CHUNK_DIAMETER),
+                        (f64)(cz * CHUNK_DIAMETER));
+                *cost += terrain_grid_bake(&ctx);
+
+                fsl_noise_sampler_axis_init(&ctx, 2, 0);
+                for (z = 0; z < CHUNK_DIAMETER; ++z, fsl_noise_sampler_axis_post_update(&ctx, 2))
+                {
+                    fsl_noise_sampler_axis_pre_update(&ctx, 2);
+
+                    fsl_noise_sampler_axis_init(&ctx, 1, 0);
+                    for (y = 0; y < CHUNK_DIAMETER; ++y, fsl_noise_sampler_axis_post_update(&ctx, 1))
+                    {
+                        fsl_noise_sampler_axis_pre_update(&ctx, 1);
+                        *cost += sampler_noise_axis_update_2d(&ctx, 1);
+
+                        fsl_noise_sampler_axis_init(&ctx, 0, 0);
+                        for (x = 0; x < CHUNK_DIAMETER; ++x, fsl_noise_sampler_axis_post_update(&ctx, 0))
+                        {
+                            fsl_noise_sampler_axis_pre_update(&ctx, 0);
+                            *cost += sampler_noise_axis_update_2d(&ctx, 0);
+                            *cost += sampler_noise_bake(&ctx);
+                            *cost += terrain_shape(&terrain, &ctx);
+
+                            height[pass][i] = terrain.value;
+                            block[pass][i] = (u8)terrain.block_id;
+                            ++i;
+                        }
+                    }
+                }
+            }
+    return check_time_since(time_start);
+}
+
+/*!
+ *  @brief set the grid step of every noise to `step`, or back to `spec` if 0.
+ */
+static void steps_set(const hhc_terrain_noise_spec *spec, u32 step)
+{
+    u32 i = 0;
+
+    for (i = 0; i < NOISE_LEN; ++i)
+        terrain_spec_set(i, spec->amp[i], spec->freq[i], spec->post_offset[i],
+                step ? step : spec->step[i]);
+}
+
+int main(int argc, char **argv)
+{
+    hhc_terrain_noise_spec spec = {0};
+    u64 height_size = AREA_VOLUME * sizeof(f64);
+    u64 block_size = AREA_VOLUME * sizeof(u8);
+    u64 i = 0, diff = 0, flip = 0, solid = 0, cost_full = 0, cost_sparse = 0;
+    f64 time_full = 0.0, time_sparse = 0.0, height_diff = 0.0, height_diff_max = 0.0;
+    f64 height_diff_sum = 0.0;
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&height[0], height_size, "main().height[0]") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&height[1], height_size, "main().height[1]") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&block[0], block_size, "main().block[0]") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&block[1], block_size, "main().block[1]") != FSL_ERR_SUCCESS ||
+            fsl_noise_sampler_init(&sampler, NOISE_LEN, 8,
+                (f64)(WORLD_RADIUS * CHUNK_DIAMETER),
+                (f64)(WORLD_RADIUS * CHUNK_DIAMETER),
+                (f64)(WORLD_RADIUS_VERTICAL * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER * CHUNK_DIAMETER),
+                (f64)(WORLD_DIAMETER_VERTICAL * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER),
+                (f64)(WORLD_MARGIN * CHUNK_DIAMETER)) != FSL_ERR_SUCCESS ||
+            fsl_noise_lattice_cache_init(&cache, CACHE_SIZE) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+    sampler.lattice_cache = &cache;
+
+    world.seed = SEED;
+    terrain_init();
+    spec = *terrain_spec_get();
+
+    steps_set(&spec, 1);
+    time_full = area_generate(0, &cost_full);
+    steps_set(&spec, 0);
+    time_sparse = area_generate(1, &cost_sparse);
+
+    for (i = 0; i < AREA_VOLUME; ++i)
+    {
+        solid += block[0][i] != 0;
+        if (block[0][i] != block[1][i])
+        {
+            ++diff;
+            flip += (block[0][i] != 0) != (block[1][i] != 0);
+        }
+
+        height_diff = fabs(height[0][i] - height[1][i]);
+        height_diff_max = height_diff > height_diff_max ? height_diff : height_diff_max;
+        height_diff_sum += height_diff;
+    }
+
+    CHECK(solid && solid < AREA_VOLUME, "Area Holds No Surface\n");
+    CHECK((f64)diff / AREA_VOLUME <= DIFF_RATE_MAX,
+            fsl_logger_stringf("%"PRIu64" of %"PRIu64" Voxels Differ (%.4f%%), Over %.4f%%\n",
+                diff, AREA_VOLUME, (f64)diff / AREA_VOLUME * 100.0, DIFF_RATE_MAX * 100.0));
+    CHECK((f64)flip / AREA_VOLUME <= FLIP_RATE_MAX,
+            fsl_logger_stringf("%"PRIu64" of %"PRIu64" Voxels Flip Solid and Air (%.4f%%), Over %.4f%%\n",
+                flip, AREA_VOLUME, (f64)flip / AREA_VOLUME * 100.0, FLIP_RATE_MAX * 100.0));
+
+    CHECK_REPORT(fsl_logger_stringf("%"PRIu64" voxels (%"PRIu64" solid): %"PRIu64" differ (%.4f%%), "
+                "%"PRIu64" solid/air flips (%.4f%%), height diff max %.4f, mean %.6f\n",
+                AREA_VOLUME, solid, diff, (f64)diff / AREA_VOLUME * 100.0,
+                flip, (f64)flip / AREA_VOLUME * 100.0,
+                height_diff_max, height_diff_sum / AREA_VOLUME));
+    CHECK_REPORT(fsl_logger_stringf("full %.3fs (cost %"PRIu64"), sparse %.3fs (cost %"PRIu64"), "
+                "speedup %.2fx\n",
+                time_full, cost_full, time_sparse, cost_sparse, time_full / time_sparse));
+
+cleanup:
+
+    fsl_noise_lattice_cache_free(&cache);
+    fsl_noise_sampler_free(&sampler);
+    fsl_mem_unmap((void*)&block[1], block_size, "main().block[1]");
+    fsl_mem_unmap((void*)&block[0], block_size, "main().block[0]");
+    fsl_mem_unmap((void*)&height[1], height_size, "main().height[1]");
+    fsl_mem_unmap((void*)&height[0], height_size, "main().height[0]");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,273 @@
+/*!
+ *  checks and benchmark of the SoA transforms (@ref fsl_transform_soa_bake()) and their
+ *  sines and cosines (@ref fsl_sincos_f32_batch()), at every kernel level this cpu runs
+ *  (@ref fsl_cpu_set_level()).
+ *
+ *  - sine and cosine within 2 ulp of the correctly rounded ones for |x| < 8192, in place
+ *    and at lengths that leave partial SIMD groups,
+ *  - every baked matrix against @ref fsl_transform_bake_batch() with identity deltas,
+ *  - only dirty transforms baked and written, their bits cleared,
+ *  - baking 1e5 transforms at 1%, 10% and 100% dirty, against baking all of them with
+ *    @ref fsl_transform_bake_batch().
+ */
+
+#include "check.h"
+#include "../../../fossil/deps/fossil/h/cpu.h"
+#include "../../../fossil/deps/fossil/math/trigonometry.h"
+#include "../../../fossil/deps/fossil/physics/transform.h"
+
+#include <math.h>
+#include <string.h>
+
+#define ANGLE_COUNT     1000003 /* not a multiple of any lane count */
+#define ANGLE_MAX       8192.0
+#define ULP_MAX         2
+#define TRANSFORM_COUNT 100000  /* not a multiple of 64, a partial bitset word */
+#define BENCH_RUNS      7       /* best of */
+#define ERROR_MAX       1e-5    /* relative */
+
+static const str *level_name[FSL_CPU_LEVEL_COUNT] = {"scalar", "sse4.1", "avx2", "avx512"};
+static const u32 dirty_percent[] = {1, 10, 100};
+
+static f32 *angle = NULL;
+static f32 *angle_sin = NULL;
+static f32 *angle_cos = NULL;
+static fsl_transform_v3f64 *transform = NULL;
+static m4f32 *baked = NULL;
+static m4f32 *baked_soa = NULL;
+static fsl_transform_soa soa = {0};
+
+/*! @return uniform in [-1.0, 1.0]. */
+static f32 rand_unit(u64 seed)
+{
+    return (f32)((f64)(fsl_rand_u64(seed) >> 11) / (f64)((u64)1 << 53) * 2.0 - 1.0);
+}
+
+/*! @return distance of `a` from `b` in units in the last place. */
+static u32 ulp_f32(f32 a, f32 b)
+{
+    i32 ia = 0, ib = 0;
+
+    if (a == b)
+        return 0;
+    memcpy(&ia, &a, sizeof(f32));
+    memcpy(&ib, &b, sizeof(f32));
+    if ((ia < 0) != (ib < 0))
+        return 1u << 20;
+    return ia > ib ? (u32)(ia - ib) : (u32)(ib - ia);
+}
+
+static f64 diff_m4f32(const m4f32 *a, const m4f32 *b)
+{
+    const f32 *ea = &a->a11, *eb = &b->a11;
+    f64 d = 0.0, d_max = 0.0;
+    u32 i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        d = fabs((f64)ea[i] - eb[i]) / (1.0 + fabs(eb[i]));
+        d_max = d > d_max || d != d ? (d != d ? 1.0 : d) : d_max;
+    }
+    return d_max;
+}
+
+static void check_sincos(u32 level)
+{
+    static const u64 len_list[] = {0, 1, 3, 7, 9, 17};
+    u64 i = 0, j = 0;
+    u32 ulp = 0, ulp_sin = 0, ulp_cos = 0;
+    f64 error = 0.0, error_max = 0.0;
+    b8 tail_kept = TRUE;
+
+    fsl_sincos_f32_batch(angle, angle_sin, angle_cos, ANGLE_COUNT);
+    for (i = 0; i < ANGLE_COUNT; ++i)
+    {
+        /* ulp only where it means anything, near 0 the absolute error bounds it */
+        if (fabs(sin(angle[i])) > 1e-3)
+        {
+            ulp = ulp_f32(angle_sin[i], (f32)sin(angle[i]));
+            ulp_sin = ulp > ulp_sin ? ulp : ulp_sin;
+        }
+        if (fabs(cos(angle[i])) > 1e-3)
+        {
+            ulp = ulp_f32(angle_cos[i], (f32)cos(angle[i]));
+            ulp_cos = ulp > ulp_cos ? ulp : ulp_cos;
+        }
+        error = fabs(angle_sin[i] - sin(angle[i])) + fabs(angle_cos[i] - cos(angle[i]));
+        error_max = error > error_max || error != error ? (error != error ? 1.0 : error) : error_max;
+    }
+
+    /* in place over `x`, entries past `n` untouched */
+    for (j = 0; j < arr_len(len_list); ++j)
+    {
+        for (i = 0; i <= len_list[j]; ++i)
+        {
+            angle_sin[i] = angle[i];
+            angle_cos[i] = 1234.0f;
+        }
+        fsl_sincos_f32_batch(angle_sin, angle_sin, angle_cos, len_list[j]);
+        for (i = 0; i < len_list[j]; ++i)
+            if (fabs(angle_sin[i] - sin(angle[i])) > 1e-6)
+                tail_kept = FALSE;
+        if (angle_sin[len_list[j]] != angle[len_list[j]] || angle_cos[len_list[j]] != 1234.0f)
+            tail_kept = FALSE;
+    }
+
+    CHECK(ulp_sin <= ULP_MAX && ulp_cos <= ULP_MAX && error_max <= 1e-6,
+            fsl_logger_stringf("%s: Sin %"PRIu32" ulp, Cos %"PRIu32" ulp, Error %.3g\n",
+                level_name[level], ulp_sin, ulp_cos, error_max));
+    CHECK(tail_kept,
+            fsl_logger_stringf("%s: Sincos Wrong in Place or Wrote Past the Batch\n", level_name[level]));
+
+    CHECK_REPORT(fsl_logger_stringf("%-6s: sincos %"PRIu32" ulp (sin), %"PRIu32" ulp (cos), error %.2g\n",
+                level_name[level], ulp_sin, ulp_cos, error_max));
+}
+
+/*! @brief mark `percent` of the transforms dirty, differently each `run`. */
+static void dirty_set(u32 percent, u32 run)
+{
+    u64 i = 0;
+
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+        if (fsl_rand_u64((u64)run * TRANSFORM_COUNT + i) % 100 < percent)
+            fsl_transform_soa_dirty_set(&soa, i);
+}
+
+static void check_bake(u32 level)
+{
+    static const u64 dirty_list[] = {0, 63, 64, 77, TRANSFORM_COUNT - 1};
+    m4f32 untouched = {0};
+    u64 i = 0, count = 0, written = 0;
+    u32 j = 0, run = 0;
+    u64 time_start = 0;
+    f64 e = 0.0, d = 0.0, time = 0.0, time_best = 0.0;
+
+    /* all dirty from the setters */
+    count = fsl_transform_soa_bake(&soa, baked_soa);
+    fsl_transform_bake_batch(transform, baked, TRANSFORM_COUNT);
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+    {
+        d = diff_m4f32(&baked_soa[i], &baked[i]);
+        e = d > e ? d : e;
+    }
+    CHECK(count == TRANSFORM_COUNT && e <= ERROR_MAX,
+            fsl_logger_stringf("%s: Baked %"PRIu64" of %d, Error %.3g\n",
+                level_name[level], count, TRANSFORM_COUNT, e));
+    CHECK(!fsl_transform_soa_bake(&soa, baked_soa),
+            fsl_logger_stringf("%s: Bake Left Dirty Bits\n", level_name[level]));
+
+    /* only dirty entries written */
+    memset(&untouched, 0xa5, sizeof(m4f32));
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+        baked_soa[i] = untouched;
+    for (j = 0; j < arr_len(dirty_list); ++j)
+        fsl_transform_soa_dirty_set(&soa, dirty_list[j]);
+    count = fsl_transform_soa_bake(&soa, baked_soa);
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+        written += !!memcmp(&baked_soa[i], &untouched, sizeof(m4f32));
+    for (j = 0; j < arr_len(dirty_list); ++j)
+        if (diff_m4f32(&baked_soa[dirty_list[j]], &baked[dirty_list[j]]) > ERROR_MAX)
+            written = 0;
+    CHECK(count == arr_len(dirty_list) && written == arr_len(dirty_list),
+            fsl_logger_stringf("%s: %"PRIu64" Dirty, Baked %"PRIu64", Written %"PRIu64"\n",
+                level_name[level], arr_len(dirty_list), count, written));
+
+    for (run = 0; run < BENCH_RUNS; ++run)
+    {
+        time_start = fsl_get_time_nsec();
+        fsl_transform_bake_batch(transform, baked, TRANSFORM_COUNT);
+        time = check_time_since(time_start);
+        time_best = !run || time < time_best ? time : time_best;
+    }
+    CHECK_REPORT(fsl_logger_stringf("%-6s: bake %d, fsl_transform_bake_batch() %7.3f ms, error %.2g\n",
+                level_name[level], TRANSFORM_COUNT, time_best * 1e3, e));
+
+    for (j = 0; j < arr_len(dirty_percent); ++j)
+    {
+        for (run = 0; run < BENCH_RUNS; ++run)
+        {
+            dirty_set(dirty_percent[j], run);
+            time_start = fsl_get_time_nsec();
+            count = fsl_transform_soa_bake(&soa, baked_soa);
+            time = check_time_since(time_start);
+            time_best = !run || time < time_best ? time : time_best;
+        }
+        CHECK_REPORT(fsl_logger_stringf("%-6s: bake %d, %3"PRIu32"%% dirty (%6"PRIu64") %7.3f ms\n",
+                    level_name[level], TRANSFORM_COUNT, dirty_percent[j], count, time_best * 1e3));
+    }
+
+    /* all dirty for the next level */
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+        fsl_transform_soa_dirty_set(&soa, i);
+}
+
+int main(int argc, char **argv)
+{
+    u64 angle_size = (ANGLE_COUNT + 1) * sizeof(f32);
+    u64 transform_size = TRANSFORM_COUNT * sizeof(fsl_transform_v3f64);
+    u64 baked_size = TRANSFORM_COUNT * sizeof(m4f32);
+    u64 i = 0;
+    u32 level = 0, level_max = 0;
+    f32 pos[3] = {0}, rot[3] = {0}, scale[3] = {0};
+
+    if (CHECK_INIT(argc, argv) != FSL_ERR_SUCCESS)
+        return fsl_err;
+
+    if (
+            fsl_mem_map((void*)&angle, angle_size, "main().angle") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&angle_sin, angle_size, "main().angle_sin") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&angle_cos, angle_size, "main().angle_cos") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&transform, transform_size, "main().transform") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&baked, baked_size, "main().baked") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&baked_soa, baked_size, "main().baked_soa") != FSL_ERR_SUCCESS ||
+            fsl_transform_soa_init(&soa, TRANSFORM_COUNT) != FSL_ERR_SUCCESS)
+    {
+        CHECK(FALSE, "Init Failed\n");
+        goto cleanup;
+    }
+
+    for (i = 0; i <= ANGLE_COUNT; ++i)
+        angle[i] = (f32)(((f64)i / ANGLE_COUNT * 2.0 - 1.0) * ANGLE_MAX);
+
+    for (i = 0; i < TRANSFORM_COUNT; ++i)
+    {
+        pos[0] = rand_unit(i * 16 + 0) * 1000.0f;
+        pos[1] = rand_unit(i * 16 + 1) * 1000.0f;
+        pos[2] = rand_unit(i * 16 + 2) * 1000.0f;
+        rot[0] = rand_unit(i * 16 + 3) * 360.0f;
+        rot[1] = rand_unit(i * 16 + 4) * 360.0f;
+        rot[2] = rand_unit(i * 16 + 5) * 360.0f;
+        scale[0] = 1.0f + rand_unit(i * 16 + 6) * 0.5f;
+        scale[1] = 1.0f + rand_unit(i * 16 + 7) * 0.5f;
+        scale[2] = 1.0f + rand_unit(i * 16 + 8) * 0.5f;
+
+        fsl_position_set(&transform[i], pos[0], pos[1], pos[2]);
+        fsl_rotation_set(&transform[i], rot[0], rot[1], rot[2]);
+        fsl_scale_set(&transform[i], scale[0], scale[1], scale[2]);
+        fsl_scale_delta_set(&transform[i], 1.0, 1.0, 1.0);
+
+        fsl_transform_soa_position_set(&soa, i, pos[0], pos[1], pos[2]);
+        fsl_transform_soa_rotation_set(&soa, i, rot[0], rot[1], rot[2]);
+        fsl_transform_soa_scale_set(&soa, i, scale[0], scale[1], scale[2]);
+    }
+
+    level_max = fsl_cpu_get_level_max();
+    for (level = FSL_CPU_LEVEL_SCALAR; level <= level_max; ++level)
+    {
+        fsl_cpu_set_level(level);
+        check_sincos(level);
+        check_bake(level);
+    }
+    fsl_cpu_set_level(level_max);
+
+cleanup:
+
+    fsl_transform_soa_free(&soa);
+    fsl_mem_unmap((void*)&baked_soa, baked_size, "main().baked_soa");
+    fsl_mem_unmap((void*)&baked, baked_size, "main().baked");
+    fsl_mem_unmap((void*)&transform, transform_size, "main().transform");
+    fsl_mem_unmap((void*)&angle_cos, angle_size, "main().angle_cos");
+    fsl_mem_unmap((void*)&angle_sin, angle_size, "main().angle_sin");
+    fsl_mem_unmap((void*)&angle, angle_size, "main().angle");
+    return CHECK_CLOSE();
+}
@@ -0,0 +1,176 @@
+#include "deps/fossil/common/limits.h"
+#include "deps/fossil/logger/logger.h"
+#include "deps/fossil/string/string.h"
+
+#include "deps/fossil/h/dir.h"
+
+#include "../h/common.h"
+#include "../h/world.h"
+
+#include "chunk_work.h"
+#include "chunking.h"
+#include "chunking_internal.h"
+
+#include <stdio.h>
+
+/* ---- section: chunk directory -------------------------------------------- */
+
+b8 chunk_dir_update(void)
+{
+    if (fsl_dir_handle_is_valid(&world.dir_chunks))
+        return TRUE;
+
+    if (world.dir_chunks.loaded)
+    {
+        LOGWARNING(FSL_ERR_DIR_NOT_FOUND, FSL_FLAG_LOG_NO_VERBOSE,
+                fsl_logger_stringf("Chunk Directory '%s' Gone, Chunking Paused\n", world.dir_chunks.path));
+        fsl_dir_handle_close(&world.dir_chunks);
+    }
+
+    /* one failing `open()` per frame while it's missing */
+    if (fsl_dir_handle_open(&world.dir_chunks,
+                fsl_stringf("%s"GAME_DIR_WORLD_NAME_CHUNKS, world.path),
+                FSL_FLAG_DIR_HANDLE_SWEEP_TEMP, FALSE) != FSL_ERR_SUCCESS)
+        return FALSE;
+
+    LOGINFO(FSL_FLAG_LOG_NO_VERBOSE,
+            fsl_logger_stringf("Chunk Directory '%s' Back, Chunking Resumed\n", world.dir_chunks.path));
+    return TRUE;
+}
+
+/* ---- section: chunk files ------------------------------------------------ */
+
+chunk_work_cost chunk_export_internal(hhc_chunk *chunk, hhc_chunk_receipt *receipt)
+{
+    chunk_work_cost cost = 0;
+    str name[FSL_ID_CAP] = {0};
+    static u16 buf[CHUNK_VOLUME] = {0};
+    u32 *blocks = (u32*)chunk->block;
+    u32 i = 0;
+    u32 j = 0;
+    u32 rle = 0; /* run-length */
+
+    snprintf(name, FSL_ID_CAP, FORMAT_FILE_NAME_HHCC,
+            chunk->pos_wrap.x, chunk->pos_wrap.y, chunk->pos_wrap.z);
+
+    if (!(chunk->flag & FLAG_CHUNK_NON_AIR))
+    {
+        buf[0] = 0 | FLAG_BLOCK_RLE;
+        buf[1] = CHUNK_VOLUME;
+        j = 2;
+        cost = CHUNK_WORK_COST_EXPORT_AIR;
+        goto finish_export;
+    }
+
+    for (; i < CHUNK_VOLUME; ++j, i += rle, blocks += rle)
+    {
+        buf[j] = *blocks;
+        rle = fsl_rle(blocks, sizeof(u32), CHUNK_VOLUME - i);
+        if (rle > 1)
+        {
+            buf[j++] |= FLAG_BLOCK_RLE;
+            buf[j] = rle;
+        }
+    }
+
+    cost = CHUNK_WORK_COST_EXPORT_NON_AIR;
+
+finish_export:
+
+    receipt->cost[CHUNK_RECEIPT_ITEM_EXPORT] += cost;
+    chunk->receipt.cost[CHUNK_RECEIPT_ITEM_EXPORT] += cost;
+
+    /* batched per tick by @ref chunk_scheduler_update_internal() */
+    fsl_write_file_atomic_at(&world.dir_chunks, name, j * sizeof(u16), buf, TRUE, FALSE, FALSE);
+    return cost;
+}
+
+chunk_work_cost chunk_import_internal(const str *name, hhc_chunk *chunk,
+        hhc_chunk_receipt *receipt)
+{
+    chunk_work_cost cost = 0;
+    const str *cursor = name;
+    i64 pos_cache[3] = {0};
+    static u16 buf[CHUNK_VOLUME + 1] = {0}; /* one spare entry, so an oversized file shows */
+    u32 *blocks = (u32*)chunk->block;
+    u64 len = 0; /* entries read */
+    u32 i = 0;
+    u32 j = 0;
+    u32 rle = 0;
+
+    /* a missing file is the common case, the chunk gets generated instead */
+    len = fsl_read_file_at(&world.dir_chunks, name, buf, sizeof(buf), FALSE);
+    if (!len)
+        return 0;
+
+    /* validate before touching `chunk`, a bad file gets regenerated over */
+    if (len % sizeof(u16) || len == sizeof(buf))
+        goto fail_corrupt;
+    len /= sizeof(u16);
+
+    for (i = 0; i < len; ++i)
+    {
+        if (buf[i] & FLAG_BLOCK_RLE)
+        {
+            if (++i == len || buf[i] > CHUNK_VOLUME - j)
+                goto fail_corrupt;
+            j += buf[i];
+        }
+        else if (++j > CHUNK_VOLUME)
+            goto fail_corrupt;
+    }
+    if (j != CHUNK_VOLUME)
+        goto fail_corrupt;
+
+    for (i = 0; i < 3; ++i)
+    {
+        fsl_convert_str_to_i64(cursor, &pos_cache[i]);
+        while (cursor && *cursor++ != '.')
+        {}
+        if (!cursor)
+            break;
+    }
+
+    chunk->flag = FLAG_CHUNK_LOADED | FLAG_CHUNK_IMPORTED | FLAG_CHUNK_DIRTY | FLAG_CHUNK_GENERATED;
+    chunk->pos_wrap.x = pos_cache[0];
+    chunk->pos_wrap.y = pos_cache[1];
+    chunk->pos_wrap.z = pos_cache[2];
+
+    /* written by @ref chunk_export_internal() for chunks without blocks */
+    if (len == 2 && buf[0] == (0 | FLAG_BLOCK_RLE) && buf[1] == CHUNK_VOLUME)
+    {
+        cost = CHUNK_WORK_COST_IMPORT_AIR;
+        goto finish_import;
+    }
+
+    chunk->flag |= FLAG_CHUNK_NON_AIR;
+
+    for (i = 0, j = 0; i < len; ++i)
+    {
+        if (buf[i] & FLAG_BLOCK_RLE)
+        {
+            buf[i] &= ~FLAG_BLOCK_RLE;
+            rle = buf[i + 1];
+            while (rle--)
+                blocks[j++] = buf[i];
+            ++i;
+        }
+        else
+            blocks[j++] = buf[i];
+    }
+
+    cost = CHUNK_WORK_COST_IMPORT_NON_AIR;
+
+finish_import:
+
+    receipt->cost[CHUNK_RECEIPT_ITEM_IMPORT] += cost;
+    chunk->receipt.cost[CHUNK_RECEIPT_ITEM_IMPORT] += cost;
+    return cost;
+
+fail_corrupt:
+
+    LOGWARNING(FSL_ERR_FILE_DATA_CORRUPT,
+            FSL_FLAG_LOG_NO_VERBOSE,
+            fsl_logger_stringf("Chunk File '%s' Truncated or Corrupt, Regenerating\n", name));
+    return 0;
+}
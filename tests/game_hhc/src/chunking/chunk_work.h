@@ -58,6 +58,7 @@ typedef enum chunk_work_cost_table
     CHUNK_WORK_COST_GENERATE_NOISE_INIT = 20,
     CHUNK_WORK_COST_GENERATE_NOISE_SAMPLE_2D = 40,
     CHUNK_WORK_COST_GENERATE_NOISE_SAMPLE_3D = 50,
+    CHUNK_WORK_COST_GENERATE_NOISE_GRID_LERP = 4,
     CHUNK_WORK_COST_CHEAP_CHECK = 3
 } chunk_work_cost_table;
 
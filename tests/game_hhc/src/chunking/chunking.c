@@ -23,6 +23,7 @@
 #include "chunking_internal.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 /* ---- section: declarations ----------------------------------------------- */
@@ -59,7 +60,7 @@ u32 chunking_init(v3i32 *player_chunk_delta)
         chunk_order.chunks_max = chunk_order.len[settings.render_distance];
     }
 
-    if (fsl_mem_arena_init(&memory_arena_chunking_internal,
+    if (fsl_mem_arena_init_ex(&memory_arena_chunking_internal, FSL_FLAG_MEM_MAP_HUGE_PAGE,
                 "chunking_init().memory_arena_chunking_internal") != FSL_ERR_SUCCESS ||
 
             fsl_mem_arena_push(&memory_arena_chunking_internal, &chunk_sched.handle_p,
@@ -112,6 +113,11 @@ u32 chunking_init(v3i32 *player_chunk_delta)
             (f64)(WORLD_MARGIN * CHUNK_DIAMETER)) != FSL_ERR_SUCCESS)
         goto cleanup;
 
+    if (fsl_noise_lattice_cache_init(&chunk_sampler.lattice_cache,
+                CHUNK_SAMPLER_LATTICE_CACHE_SIZE) != FSL_ERR_SUCCESS)
+        goto cleanup;
+    chunk_sampler.sampler.lattice_cache = &chunk_sampler.lattice_cache;
+
     core.flag.chunks_initialized = TRUE;
 
     chunk_buf_update_internal(player_chunk_delta);
@@ -168,8 +174,8 @@ u32 chunks_max_init_internal(void)
         chunk_order.len[i] = chunk_count;
     }
 
-    if (fsl_write_file(path, (SET_RENDER_DISTANCE_MAX + 1) * sizeof(u32),
-                chunk_order.len, TRUE, FALSE) != FSL_ERR_SUCCESS)
+    if (fsl_write_file_atomic(path, (SET_RENDER_DISTANCE_MAX + 1) * sizeof(u32),
+                chunk_order.len, TRUE, FALSE, FALSE) != FSL_ERR_SUCCESS)
         goto cleanup;
 
     LOGSUCCESS(FSL_FLAG_LOG_NO_VERBOSE,
@@ -296,13 +302,14 @@ u32 chunk_order_build_internal(void)
         data_buf[--bucket_buf[distance_buf[i]].pos] = pos_buf[i];
 
     snprintf(path, FSL_PATH_CAP, "%s%s", GAME_DIR_NAME_LOOKUPS, GAME_FILE_NAME_LOOKUP_CHUNK_ORDER);
-    if (fsl_write_file(path, chunk_count * sizeof(v3i8), data_buf, TRUE, FALSE) != FSL_ERR_SUCCESS)
+    if (fsl_write_file_atomic(path, chunk_count * sizeof(v3i8), data_buf, TRUE, FALSE, FALSE) != FSL_ERR_SUCCESS)
         goto cleanup;
     LOGSUCCESS(FSL_FLAG_LOG_NO_VERBOSE,
             fsl_logger_stringf("`chunk_order` Look-up '%s' Exported\n", path));
 
     snprintf(path, FSL_PATH_CAP, "%s%s", GAME_DIR_NAME_LOOKUPS, GAME_FILE_NAME_LOOKUP_CHUNK_BUCKET);
-    if (fsl_write_file(path, buckets_max * sizeof(hhc_chunk_bucket_format), bucket_buf, TRUE, FALSE) != FSL_ERR_SUCCESS)
+    if (fsl_write_file_atomic(path, buckets_max * sizeof(hhc_chunk_bucket_format), bucket_buf,
+                TRUE, FALSE, FALSE) != FSL_ERR_SUCCESS)
         goto cleanup;
     LOGSUCCESS(FSL_FLAG_LOG_NO_VERBOSE,
             fsl_logger_stringf("`chunk_sched` Look-up '%s' Exported\n", path));
@@ -347,9 +354,15 @@ u32 chunk_order_load_internal(u32 render_distance)
     u32 index = 0;
 
     snprintf(path, FSL_PATH_CAP, "%s%s", GAME_DIR_NAME_LOOKUPS, GAME_FILE_NAME_LOOKUP_CHUNK_ORDER);
-    file_len = fsl_get_file_contents(path, (void*)&file_contents, FALSE);
-    if (file_contents == NULL)
+    if (fsl_file_map(path, (void*)&file_contents, &file_len,
+                FSL_FLAG_FILE_MAP_SEQUENTIAL) != FSL_ERR_SUCCESS)
+        goto cleanup;
+
+    if (file_len < chunk_order.chunks_max * sizeof(v3i8))
+    {
+        *GAME_ERR = FSL_ERR_FILE_DATA_CORRUPT;
         goto cleanup;
+    }
 
     for (i = 0; i < chunk_order.chunks_max; ++i)
     {
@@ -360,16 +373,14 @@ u32 chunk_order_load_internal(u32 render_distance)
         chunk_order.p[i] = index;
     }
 
-    fsl_mem_free((void*)&file_contents, file_len,
-            "chunk_order_load_internal().file_contents");
+    fsl_file_unmap((void*)&file_contents, file_len);
 
     *GAME_ERR = FSL_ERR_SUCCESS;
     return *GAME_ERR;
 
 cleanup:
 
-    fsl_mem_free((void*)&file_contents, file_len,
-            "chunk_order_load_internal().file_contents");
+    fsl_file_unmap((void*)&file_contents, file_len);
     return *GAME_ERR;
 }
 
@@ -382,10 +393,16 @@ u32 chunk_bucket_load_internal(void)
     u32 i = 0;
 
     snprintf(path, FSL_PATH_CAP, "%s%s", GAME_DIR_NAME_LOOKUPS, GAME_FILE_NAME_LOOKUP_CHUNK_BUCKET);
-    file_len = fsl_get_file_contents(path, (void*)&file_contents, FALSE);
-    if (file_contents == NULL)
+    if (fsl_file_map(path, (void*)&file_contents, &file_len,
+                FSL_FLAG_FILE_MAP_SEQUENTIAL) != FSL_ERR_SUCCESS)
         goto cleanup;
 
+    if (file_len < chunk_sched.buckets_max * sizeof(hhc_chunk_bucket_format))
+    {
+        *GAME_ERR = FSL_ERR_FILE_DATA_CORRUPT;
+        goto cleanup;
+    }
+
     for (i = 0; i < chunk_sched.buckets_max; ++i)
     {
         chunk_sched.bucket[i].pos = file_contents[i].pos;
@@ -394,16 +411,14 @@ u32 chunk_bucket_load_internal(void)
         chunk_sched.bucket[i].pop = file_contents[i].pos;
     }
 
-    fsl_mem_free((void*)&file_contents, file_len,
-            "chunk_order_load_internal().file_contents");
+    fsl_file_unmap((void*)&file_contents, file_len);
 
     *GAME_ERR = FSL_ERR_SUCCESS;
     return *GAME_ERR;
 
 cleanup:
 
-    fsl_mem_free((void*)&file_contents, file_len,
-            "chunk_order_load_internal().file_contents");
+    fsl_file_unmap((void*)&file_contents, file_len);
     return *GAME_ERR;
 }
 
@@ -657,6 +672,7 @@ void chunking_free(void)
     u32 i = 0;
 
     fsl_noise_sampler_free(&chunk_sampler.sampler);
+    fsl_noise_lattice_cache_free(&chunk_sampler.lattice_cache);
 
     if (chunk_tab.p)
     {
@@ -1038,19 +1054,16 @@ void chunk_pos_set_internal(hhc_chunk *chunk,
 chunk_work_cost chunk_load_internal(hhc_chunk *chunk, chunk_work_budget budget,
         hhc_chunk_receipt *receipt)
 {
-    fsl_fs_path path[FSL_PATH_CAP] = {0};
+    str name[FSL_ID_CAP] = {0};
 
     if (!chunk || chunk->flag & FLAG_CHUNK_GENERATED)
         return 0;
 
-    snprintf(path, FSL_PATH_CAP,
-            "%s"GAME_DIR_WORLD_NAME_CHUNKS FORMAT_FILE_NAME_HHCC,
-            world.path, chunk->pos_wrap.x, chunk->pos_wrap.y, chunk->pos_wrap.z);
+    snprintf(name, FSL_ID_CAP, FORMAT_FILE_NAME_HHCC,
+            chunk->pos_wrap.x, chunk->pos_wrap.y, chunk->pos_wrap.z);
 
 #if MODE_INTERNAL_IMPORT_CHUNKS
-    if (fsl_is_file_exists(path, FALSE) == FSL_ERR_SUCCESS)
-        chunk_import_internal(path, chunk, receipt);
-    else
+    if (!chunk_import_internal(name, chunk, receipt))
 #endif /* MODE_INTERNAL_IMPORT_CHUNKS */
         chunk_generate_internal(chunk, budget, receipt);
     return 0;
@@ -1088,10 +1101,16 @@ chunk_work_cost chunk_generate_internal(hhc_chunk *chunk, chunk_work_budget budg
 {
     chunk_work_cost cost = 0;
     hhc_chunk_neighbors chunk_neighbors = {0};
-    hhc_terrain_sample terrain = {0};
+    /* a row of baked noises, shaped at once when the row ends or the budget runs out */
+    static f64 row_noise[TERRAIN_SHAPE_ROW_MAX * (TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT)];
+    hhc_terrain_sample terrain[TERRAIN_SHAPE_ROW_MAX];
+    u64 noise_size = (TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT) * sizeof(f64);
     v3i32 pos = {0};
     v2i32 pos_cheap_check = {0};
+    i32 row_start = 0;
+    i32 i = 0;
     b8 non_air = FALSE;
+    b8 budget_spent = FALSE;
 
     chunk_neighbors = chunk_neighbors_get_internal(chunk);
 
@@ -1117,6 +1136,8 @@ chunk_work_cost chunk_generate_internal(hhc_chunk *chunk, chunk_work_budget budg
 
 begin_generation:
 
+    cost += terrain_grid_bake(&chunk_sampler.context);
+
     /* `pos.x`, `pos.y` and `pos.z` reset at the end of their loops because they
      * should first pick up from where `chunk->cursor` left off last time. */
     fsl_noise_sampler_axis_init(&chunk_sampler.context, 2, pos.z);
@@ -1130,23 +1151,32 @@ begin_generation:
             fsl_noise_sampler_axis_pre_update(&chunk_sampler.context, 1);
             cost += sampler_noise_axis_update_2d(&chunk_sampler.context, 1);
 
+            row_start = pos.x;
             fsl_noise_sampler_axis_init(&chunk_sampler.context, 0, pos.x);
-            for (; pos.x < CHUNK_DIAMETER; ++pos.x, fsl_noise_sampler_axis_post_update(&chunk_sampler.context, 0))
+            for (; pos.x < CHUNK_DIAMETER && !budget_spent;
+                    ++pos.x, fsl_noise_sampler_axis_post_update(&chunk_sampler.context, 0))
             {
                 fsl_noise_sampler_axis_pre_update(&chunk_sampler.context, 0);
                 cost += sampler_noise_axis_update_2d(&chunk_sampler.context, 0);
                 cost += sampler_noise_bake(&chunk_sampler.context);
-                cost += terrain_shape(&terrain, &chunk_sampler.context);
+                memcpy(&row_noise[(pos.x - row_start) * (TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT)],
+                        chunk_sampler.sampler.noise_buf.noise_dst_buf, noise_size);
+
+                budget_spent = cost >= (u32)budget;
+            }
 
-                if (terrain.block_id)
+            cost += terrain_shape_row(terrain, row_noise, chunk_sampler.context.pos_tab[0][2],
+                    pos.x - row_start);
+            for (i = row_start; i < pos.x; ++i)
+                if (terrain[i - row_start].block_id)
                 {
-                    block_add_internal(&chunk_neighbors, pos.x, pos.y, pos.z, terrain.block_id);
+                    block_add_internal(&chunk_neighbors, i, pos.y, pos.z, terrain[i - row_start].block_id);
                     non_air = TRUE;
                 }
 
-                if (cost >= (u32)budget)
-                    goto finish_generation;
-            }
+            /* `pos.x` is past the last voxel shaped, at the row's end it's the next row's start */
+            if (budget_spent)
+                goto finish_generation;
             pos.x = 0;
         }
 
@@ -1301,119 +1331,6 @@ finish_meshing:
     return cost;
 }
 
-chunk_work_cost chunk_export_internal(hhc_chunk *chunk, hhc_chunk_receipt *receipt)
-{
-    chunk_work_cost cost = 0;
-    fsl_fs_path path[FSL_PATH_CAP] = {0};
-    static u16 buf[CHUNK_VOLUME] = {0};
-    u32 *blocks = (u32*)chunk->block;
-    u32 i = 0;
-    u32 j = 0;
-    u32 rle = 0; /* run-length */
-
-    snprintf(path, FSL_PATH_CAP,
-            "%s"GAME_DIR_WORLD_NAME_CHUNKS FORMAT_FILE_NAME_HHCC,
-            world.path, chunk->pos_wrap.x, chunk->pos_wrap.y, chunk->pos_wrap.z);
-
-    if (!(chunk->flag & FLAG_CHUNK_NON_AIR))
-    {
-        buf[0] = 0 | FLAG_BLOCK_RLE;
-        buf[1] = CHUNK_VOLUME;
-        j = 2;
-        cost = CHUNK_WORK_COST_EXPORT_AIR;
-        goto finish_export;
-    }
-
-    for (; i < CHUNK_VOLUME; ++j, i += rle, blocks += rle)
-    {
-        buf[j] = *blocks;
-        rle = fsl_rle(blocks, sizeof(u32), CHUNK_VOLUME - i);
-        if (rle > 1)
-        {
-            buf[j++] |= FLAG_BLOCK_RLE;
-            buf[j] = rle;
-        }
-    }
-
-    cost = CHUNK_WORK_COST_EXPORT_NON_AIR;
-
-finish_export:
-
-    receipt->cost[CHUNK_RECEIPT_ITEM_EXPORT] += cost;
-    chunk->receipt.cost[CHUNK_RECEIPT_ITEM_EXPORT] += cost;
-
-    fsl_write_file(path, j * sizeof(u16), buf, TRUE, FALSE);
-    return cost;
-}
-
-chunk_work_cost chunk_import_internal(const fsl_fs_path *path, hhc_chunk *chunk,
-        hhc_chunk_receipt *receipt)
-{
-    chunk_work_cost cost = 0;
-    FILE *file = NULL;
-    str file_name[FSL_ID_CAP] = {0};
-    str *cursor = file_name;
-    i64 pos_cache[3] = {0};
-    static u16 buf[CHUNK_VOLUME] = {0};
-    u32 *blocks = (u32*)chunk->block;
-    u32 i = 0;
-    u32 j = 0;
-    u32 rle = 0;
-
-    fsl_get_base_name(path, file_name, FSL_ID_CAP);
-
-    for (i = 0; i < 3; ++i)
-    {
-        fsl_convert_str_to_i64(cursor, &pos_cache[i]);
-        while (cursor && *cursor++ != '.')
-        {}
-        if (!cursor)
-            break;
-    }
-
-    chunk->flag = FLAG_CHUNK_LOADED | FLAG_CHUNK_IMPORTED | FLAG_CHUNK_DIRTY | FLAG_CHUNK_GENERATED;
-    chunk->pos_wrap.x = pos_cache[0];
-    chunk->pos_wrap.y = pos_cache[1];
-    chunk->pos_wrap.z = pos_cache[2];
-
-    file = fopen(path, "rb");
-    fseek(file, 0, SEEK_END);
-    i = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    fread(buf, 1, i, file);
-    fclose(file);
-
-    if (i == 2 * sizeof(u16) && buf[0] & FLAG_BLOCK_RLE && !buf[1])
-    {
-        cost = CHUNK_WORK_COST_IMPORT_AIR;
-        goto finish_import;
-    }
-
-    chunk->flag |= FLAG_CHUNK_NON_AIR;
-
-    for (i = 0; i < CHUNK_VOLUME && j < CHUNK_VOLUME; ++i)
-    {
-        if (buf[i] & FLAG_BLOCK_RLE)
-        {
-            buf[i] &= ~FLAG_BLOCK_RLE;
-            rle = buf[i + 1];
-            while (rle--)
-                blocks[j++] = buf[i];
-            ++i;
-        }
-        else
-            blocks[j++] = buf[i];
-    }
-
-    cost = CHUNK_WORK_COST_IMPORT_NON_AIR;
-
-finish_import:
-
-    receipt->cost[CHUNK_RECEIPT_ITEM_IMPORT] += cost;
-    chunk->receipt.cost[CHUNK_RECEIPT_ITEM_IMPORT] += cost;
-    return cost;
-}
-
 void chunk_buf_update_internal(v3i32 *player_chunk_delta)
 {
     i32 i = 0;
@@ -1575,6 +1492,10 @@ pop:
     if (!chunk_sched.count || budget <= 0)
         return;
 
+#if MODE_INTERNAL_EXPORT_CHUNKS
+    fsl_write_batch_begin();
+#endif /* MODE_INTERNAL_EXPORT_CHUNKS */
+
     end = chunk_sched.buckets_max;
     for (i = 0; i < end && chunk_sched.count && budget > 0; ++i)
     {
@@ -1634,6 +1555,10 @@ pop:
             chunk_sched.priority = 0;
         continue;
     }
+
+#if MODE_INTERNAL_EXPORT_CHUNKS
+    fsl_write_batch_end();
+#endif /* MODE_INTERNAL_EXPORT_CHUNKS */
 }
 
 chunk_work_cost chunk_scheduler_push_internal(hhc_chunk *chunk)
@@ -297,6 +297,16 @@ void chunking_update(v3i32 player_chunk, v3i32 *player_chunk_delta, block_hit hi
 
 void chunking_free(void);
 
+/*!
+ *  @brief check `world.dir_chunks`, reopen it if the directory was recreated.
+ *
+ *  @remark called every frame from @ref world_update(), chunking pauses while it
+ *  returns `FALSE`.
+ *
+ *  @return `TRUE` if chunk I/O can go ahead.
+ */
+b8 chunk_dir_update(void);
+
 /*!
  *  @brief get first block pointed at by start point towards end point.
  *
@@ -15,6 +15,13 @@
  */
 #define BLOCK_BUFFERS_MAX 2
 
+/*!
+ *  @brief lattice cells held by @ref hhc_chunk_sampler.lattice_cache, across all
+ *  noises, enough for the detail noise cells of a few chunk rows, coarser noises
+ *  span many chunks per cell and stay cached.
+ */
+#define CHUNK_SAMPLER_LATTICE_CACHE_SIZE 1024
+
 /* ---- section: block flag ------------------------------------------------- */
 
 /*  63 [00000000 00000000 00000000 00000000] 32;
@@ -124,6 +131,7 @@ typedef struct hhc_chunk_sampler
 {
     fsl_noise_sampler sampler;
     fsl_noise_sampler_context context;
+    fsl_noise_lattice_cache lattice_cache;
 } hhc_chunk_sampler;
 
 /* ---- section: declarations ----------------------------------------------- */
@@ -256,9 +264,12 @@ chunk_work_cost chunk_export_internal(hhc_chunk *chunk, hhc_chunk_receipt *recei
 /*!
  *  @brief read chunk from disk.
  *
+ *  @param name file name, relative to `world.dir_chunks`.
+ *
  *  @return cost of operation (used in @ref chunk_scheduler_update_internal()).
+ *  @return 0 if the file is missing, truncated or corrupt, `chunk` is left untouched.
  */
-chunk_work_cost chunk_import_internal(const fsl_fs_path *path, hhc_chunk *chunk,
+chunk_work_cost chunk_import_internal(const str *name, hhc_chunk *chunk,
         hhc_chunk_receipt *receipt);
 
 void chunk_buf_update_internal(v3i32 *player_chunk_delta);
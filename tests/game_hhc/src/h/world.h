@@ -5,6 +5,8 @@
 #include "deps/fossil/math/vector.h"
 #include "deps/fossil/physics/physics_types.h"
 
+#include "deps/fossil/h/dir.h"
+
 #include "player.h"
 
 #define WORLD_TICK_SPEED        20.0
@@ -19,12 +21,15 @@ typedef struct world_info
     str path[FSL_PATH_CAP];
     u32 type; /* gamemode set at world creation */
     u64 seed;
+    u32 noise_hash; /* enum @ref fsl_noise_hash, kept beside the seed, same seed and hash same terrain */
     u64 tick;
     u64 tick_start;
     u64 days;
 
     fsl_physics_material physics_material;
     fsl_physics_force gravity;
+
+    fsl_dir_handle dir_chunks; /* all chunk reads and writes go relative to it */
 } world_info;
 
 /*!
@@ -58,20 +63,32 @@ u32 world_dir_init(const str *world_name);
  *  @brief load world and initialize files if not present.
  *
  *  load world data into memory if present and generate and write to disk if not:
- *  1. seed.txt, file containing world seed, can be changed,
- *     but changes only apply if world is loaded again.
+ *  1. metadata.conf, file containing world seed and noise hash (@ref fsl_noise_hash)
+ *     on a line each, can be changed, but changes only apply if world is loaded again.
  *
- *  @param seed if file 'seed.txt' not present, it will be created and `seed`
- *  will be written to it.
+ *  @param seed if file 'metadata.conf' not present, it will be created and `seed`
+ *  will be written to it, with @ref FSL_NOISE_HASH_MIX.
  *
  *  @remark if `seed` is 0, a random seed will be generated.
+ *  @remark worlds whose metadata has no hash were created with
+ *  @ref FSL_NOISE_HASH_TABLE and keep it, so their terrain doesn't change.
  *
  *  @return non-zero on failure and @ref *GAME_ERR is set accordingly.
  */
 u32 world_load(world_info *world, const str *world_name, u64 seed);
 
+/*!
+ *  @brief update world, run chunking while the world's chunk directory exists.
+ *
+ *  @remark if the chunk directory is deleted, chunking pauses until it's recreated.
+ */
 void world_update(hhc_player *p);
 
+/*!
+ *  @brief release world resources (directory handles).
+ */
+void world_free(void);
+
 /*!
  *  @brief write world state into disk on specific time intervals.
  *
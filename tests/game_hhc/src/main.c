@@ -1072,6 +1072,7 @@ cleanup:
     gui_free();
     assets_free();
     chunking_free();
+    world_free();
     fsl_engine_close();
     return *GAME_ERR;
 }
@@ -20,6 +20,14 @@
 #define BIOME_NOISE_LIFE_MAX            140.0
 #define BIOME_NOISE_LIFE_MIN            2.0
 
+/*!
+ *  @internal
+ *
+ *  @brief @ref biome_match() over the biomes set in `candidate` only.
+ */
+static u32 biome_match_internal(const hhc_biome *biome, u32 biome_count,
+        u32 candidate, const f64 *param);
+
 hhc_biome biome_init(str *name,
         f64 temperature, f64 humidity, f64 extremity, f64 roughness, f64 depth, f64 life)
 {
@@ -53,14 +61,147 @@ f64 biome_param_set(f64 param, f64 min, f64 max)
     return fsl_map_range_f64(param, min, max, 0.0, 1.0);
 }
 
-f64 biome_score_get(hhc_biome a, hhc_biome b)
+f64 biome_score_get(const f64 *param, const hhc_biome *biome)
 {
     u32 i = 0;
+    f64 d = 0.0;
     f64 sum = 0.0;
     for (i = 0; i < BIOME_NOISE_COUNT; ++i)
     {
-        b.spec[i] -= a.spec[i];
-        sum += b.spec[i] * b.spec[i];
+        d = biome->spec[i] - param[i];
+        sum += d * d;
     }
     return sum;
 }
+
+u32 biome_match(const hhc_biome *biome, u32 biome_count, const f64 *param)
+{
+    return biome_match_internal(biome, biome_count, ~0u, param);
+}
+
+void biome_table_build(hhc_biome_table *table, const hhc_biome *biome, u32 biome_count)
+{
+    u32 cell = 0, i = 0, c = 0, j = 0, k = 0;
+    f64 lo = 0.0, hi = 0.0;
+    f64 sb = 0.0, sc = 0.0, d_lo = 0.0, d_hi = 0.0;
+    f64 gap = 0.0, margin = 0.0, score_max = 0.0;
+    u32 candidate = 0;
+
+    table->biome = biome;
+    table->biome_count = biome_count;
+
+    for (cell = 0; cell < BIOME_TABLE_CELLS; ++cell)
+    {
+        candidate = 0;
+        for (i = 0; i < biome_count; ++i)
+        {
+            candidate |= 1u << i;
+
+            for (c = 0; c < biome_count; ++c)
+            {
+                if (c == i)
+                    continue;
+
+                /* score `i` - score `c` is linear in the parameters, so its minimum
+                 * over the cell sits on a corner, picked per parameter; `i` is
+                 * dropped if `c` beats it everywhere in the cell */
+                gap = 0.0;
+                margin = 1.0;
+                for (j = 0, k = cell; j < BIOME_NOISE_COUNT; ++j, k /= BIOME_TABLE_RES)
+                {
+                    lo = (f64)(k % BIOME_TABLE_RES) / BIOME_TABLE_RES;
+                    hi = (f64)(k % BIOME_TABLE_RES + 1) / BIOME_TABLE_RES;
+                    sb = biome[i].spec[j];
+                    sc = biome[c].spec[j];
+
+                    d_lo = (sb - lo) * (sb - lo) - (sc - lo) * (sc - lo);
+                    d_hi = (sb - hi) * (sb - hi) - (sc - hi) * (sc - hi);
+                    gap += d_lo < d_hi ? d_lo : d_hi;
+                    margin += (sb * sb + sc * sc + 2.0);
+                }
+
+                /* margin covers rounding, ties are kept so the tie-break matches
+                 * biome_match() */
+                if (gap > margin * 1e-9)
+                {
+                    candidate &= ~(1u << i);
+                    break;
+                }
+            }
+        }
+
+        table->candidate[cell] = candidate;
+        table->match[cell] = BIOME_TABLE_UNRESOLVED;
+
+        /* a lone candidate that scores below BIOME_SCORE_MAX across the whole cell
+         * needs no scoring at all */
+        for (i = 0; i < biome_count; ++i)
+            if (candidate == 1u << i)
+                break;
+        if (i == biome_count)
+            continue;
+
+        score_max = 0.0;
+        margin = 1.0;
+        for (j = 0, k = cell; j < BIOME_NOISE_COUNT; ++j, k /= BIOME_TABLE_RES)
+        {
+            lo = (f64)(k % BIOME_TABLE_RES) / BIOME_TABLE_RES;
+            hi = (f64)(k % BIOME_TABLE_RES + 1) / BIOME_TABLE_RES;
+            sb = biome[i].spec[j];
+
+            d_lo = (sb - lo) * (sb - lo);
+            d_hi = (sb - hi) * (sb - hi);
+            score_max += d_lo > d_hi ? d_lo : d_hi;
+            margin += sb * sb + 1.0;
+        }
+
+        if (score_max + margin * 1e-9 < BIOME_SCORE_MAX)
+            table->match[cell] = (u8)i;
+    }
+}
+
+u32 biome_table_get(const hhc_biome_table *table, const f64 *param)
+{
+    u32 cell = 0;
+    u32 k = 0;
+    i32 i = BIOME_NOISE_COUNT;
+
+    while (i--)
+    {
+        if (!(param[i] >= 0.0 && param[i] <= 1.0))
+            return biome_match(table->biome, table->biome_count, param);
+
+        k = (u32)(param[i] * BIOME_TABLE_RES);
+        cell = cell * BIOME_TABLE_RES + (k < BIOME_TABLE_RES ? k : BIOME_TABLE_RES - 1);
+    }
+
+    if (table->match[cell] != BIOME_TABLE_UNRESOLVED)
+        return table->match[cell];
+
+    return biome_match_internal(table->biome, table->biome_count,
+            table->candidate[cell], param);
+}
+
+static u32 biome_match_internal(const hhc_biome *biome, u32 biome_count,
+        u32 candidate, const f64 *param)
+{
+    f64 score = 0.0;
+    f64 best_score = BIOME_SCORE_MAX;
+    u32 best_index = 0;
+    u32 i = biome_count;
+
+    while (i--)
+    {
+        if (!(candidate & (1u << i)))
+            continue;
+
+        score = biome_score_get(param, &biome[i]);
+        if (score < best_score)
+        {
+            best_score = score;
+            best_index = i;
+        }
+    }
+
+    return best_index;
+}
@@ -25,12 +25,46 @@ typedef enum hhc_biome_index
     BIOME_COUNT
 } hhc_biome_index;
 
+/*!
+ *  @brief scores at or above this never match, @ref biome_table_get() falls back to
+ *  biome 0.
+ */
+#define BIOME_SCORE_MAX     10000.0
+
+/*!
+ *  @brief cells per parameter in @ref hhc_biome_table, power of 2 so cell bounds
+ *  are exact.
+ */
+#define BIOME_TABLE_RES     4
+#define BIOME_TABLE_CELLS   (BIOME_TABLE_RES * BIOME_TABLE_RES * BIOME_TABLE_RES * \
+        BIOME_TABLE_RES * BIOME_TABLE_RES * BIOME_TABLE_RES)
+#define BIOME_TABLE_UNRESOLVED  0xff
+
+/*!
+ *  @brief biome count from which @ref hhc_biome_table beats scoring every biome, below
+ *  it a lookup and the fallback scoring cost more than @ref biome_match() (see
+ *  biome_table_check: slower at 5 to 16 biomes, faster at 32 on coherent columns).
+ */
+#define BIOME_TABLE_BIOME_MIN   24
+
 typedef struct hhc_biome
 {
     str name[FSL_ID_CAP];
     f64 spec[BIOME_NOISE_COUNT]; /* preferred value for each noise */
 } hhc_biome;
 
+/*!
+ *  @brief quantized grid over the parameter space [0.0, 1.0], holding per cell the
+ *  biomes that can score best for some point in it.
+ */
+typedef struct hhc_biome_table
+{
+    const hhc_biome *biome;
+    u32 biome_count; /* 1 to 32 */
+    u32 candidate[BIOME_TABLE_CELLS]; /* bit `i` set if `biome[i]` can match */
+    u8 match[BIOME_TABLE_CELLS]; /* the biome matching anywhere in the cell, else @ref BIOME_TABLE_UNRESOLVED */
+} hhc_biome_table;
+
 /*!
  *  @brief initialize a biome.
  */
@@ -43,12 +77,35 @@ hhc_biome biome_init(str *name, f64 temperature, f64 humidity, f64 extremity,
 f64 biome_param_set(f64 param, f64 min, f64 max);
 
 /*!
- *  @brief compare likelihood of biomes `a` and `b` matching.
+ *  @brief compare likelihood of `biome` matching noise values `param`.
  *
- *  euclidean distance between relevant parameters is used.
+ *  squared euclidean distance between relevant parameters is used.
+ *
+ *  @param param noise values, @ref BIOME_NOISE_COUNT of them.
+ *
+ *  @return biome score, lower is closer.
+ */
+f64 biome_score_get(const f64 *param, const hhc_biome *biome);
+
+/*!
+ *  @brief score every biome in `biome` against `param`.
+ *
+ *  @return index of the lowest-scoring biome, the highest index on ties, 0 if no
+ *  score is below @ref BIOME_SCORE_MAX.
+ */
+u32 biome_match(const hhc_biome *biome, u32 biome_count, const f64 *param);
+
+/*!
+ *  @brief build `table` for `biome`, `biome` must outlive `table`.
+ */
+void biome_table_build(hhc_biome_table *table, const hhc_biome *biome, u32 biome_count);
+
+/*!
+ *  @brief @ref biome_match() through `table`, only the candidates of the cell
+ *  holding `param` are scored.
  *
- *  @return biome score.
+ *  `param` outside the table falls back to @ref biome_match().
  */
-f64 biome_score_get(hhc_biome a, hhc_biome b);
+u32 biome_table_get(const hhc_biome_table *table, const f64 *param);
 
 #endif /* HHC_BIOME_H */
@@ -1,13 +1,16 @@
 #include "deps/fossil/common/limits.h"
 #include "deps/fossil/math/math.h"
+#include "deps/fossil/plugins/fsl_native/noise_graph/noise_graph.h"
 #include "deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
 #include "deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler_sample.h"
 
+#include "../chunking/chunking.h"
 #include "../h/world.h"
 
 #include "biome.h"
 #include "terrain.h"
 
+#include <math.h>
 #include <stdio.h>
 
 #define TERRAIN_SEED_DEFAULT 0
@@ -25,30 +28,65 @@
 #define BIOME_NOISE_LIFE_FREQUENCY          (1.0 / 443.04)
 
 static hhc_terrain_noise_spec terrain_spec = {0};
+static fsl_noise_graph terrain_graph = {0};
+static hhc_biome_table terrain_biome_table = {0};
+
+/*!
+ *  @brief noise values on the grid points of the last chunk baked, for noises
+ *  with a step above 1, `x` varying fastest.
+ */
+static struct terrain_grid
+{
+    f64 value[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT][TERRAIN_GRID_POINTS_MAX];
+    f64 offset[3];  /* sampler offset baked for */
+    u64 seed;       /* world seed baked for */
+    b8 valid;
+} terrain_grid;
+
+/*!
+ *  @brief sample base data per noise for @ref TERRAIN_PRECISION_F32, in place of
+ *  @ref fsl_noise_buffer.sample_src_buf.
+ */
+static fsl_noise_sample_f32 terrain_sample_f32[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT][8];
+
+/*!
+ *  @brief build the terrain height graph over the baked noises.
+ */
+static void terrain_graph_init(void);
+
+/*!
+ *  @brief update a single axis of each sample of a single noise.
+ */
+static void noise_axis_update_internal(fsl_noise_sampler_context *ctx, u8 axis, u32 noise_index);
+
+/*!
+ *  @brief sample and interpolate a single noise at the sampler's position.
+ */
+static f64 noise_bake_internal(fsl_noise_sampler_context *ctx, u32 noise_index);
 
 void terrain_init(void)
 {
     f64 coef = 2.0f / 3.0f;
 
-    terrain_spec_set(TERRAIN_NOISE_CONTINENTAL, 1000.0, FREQ_CONTINENTAL, 0.0);
-    terrain_spec_set(TERRAIN_NOISE_REGIONAL, 200.0, FREQ_REGIONAL, 0.0);
-    terrain_spec_set(TERRAIN_NOISE_LOCAL, 50.0, FREQ_LOCAL, 0.0);
-    terrain_spec_set(TERRAIN_NOISE_DETAIL, 5.0, FREQ_DETAIL, 0.0);
+    terrain_spec_set(TERRAIN_NOISE_CONTINENTAL, 1000.0, FREQ_CONTINENTAL, 0.0, 16);
+    terrain_spec_set(TERRAIN_NOISE_REGIONAL, 200.0, FREQ_REGIONAL, 0.0, 8);
+    terrain_spec_set(TERRAIN_NOISE_LOCAL, 50.0, FREQ_LOCAL, 0.0, 4);
+    terrain_spec_set(TERRAIN_NOISE_DETAIL, 5.0, FREQ_DETAIL, 0.0, 1);
 
     terrain_spec_set(TERRAIN_NOISE_COUNT + BIOME_NOISE_TEMPERATURE,
-            coef, BIOME_NOISE_TEMPERATURE_FREQUENCY, coef);
+            coef, BIOME_NOISE_TEMPERATURE_FREQUENCY, coef, 8);
 
     terrain_spec_set(TERRAIN_NOISE_COUNT + BIOME_NOISE_HUMIDITY,
-            coef, BIOME_NOISE_HUMIDITY_FREQUENCY, coef);
+            coef, BIOME_NOISE_HUMIDITY_FREQUENCY, coef, 8);
 
     terrain_spec_set(TERRAIN_NOISE_COUNT + BIOME_NOISE_EXTREMITY,
-            coef, BIOME_NOISE_EXTREMITY_FREQUENCY, coef);
+            coef, BIOME_NOISE_EXTREMITY_FREQUENCY, coef, 8);
 
     terrain_spec_set(TERRAIN_NOISE_COUNT + BIOME_NOISE_ROUGHNESS,
-            coef, BIOME_NOISE_ROUGHNESS_FREQUENCY, coef);
+            coef, BIOME_NOISE_ROUGHNESS_FREQUENCY, coef, 8);
 
     terrain_spec_set(TERRAIN_NOISE_COUNT + BIOME_NOISE_LIFE,
-            coef, BIOME_NOISE_LIFE_FREQUENCY, coef);
+            coef, BIOME_NOISE_LIFE_FREQUENCY, coef, 8);
 
     terrain_spec.biome[BIOME_STONE] = biome_init("Stone",
             32.033, 12.030, 0.334, 17.047, -10.068, 1.009);
@@ -64,121 +102,337 @@ void terrain_init(void)
 
     terrain_spec.biome[BIOME_JUNGLE] = biome_init("Jungle",
             0.270, 0.290, 0.430, 0.780, 3.000, 260.000);
+
+    if (BIOME_COUNT >= BIOME_TABLE_BIOME_MIN)
+        biome_table_build(&terrain_biome_table, terrain_spec.biome, BIOME_COUNT);
+    terrain_graph_init();
+}
+
+static void terrain_graph_init(void)
+{
+    fsl_noise_graph *g = &terrain_graph;
+    u32 continental = 0, regional = 0, local = 0, detail = 0;
+    u32 temperature = 0, roughness = 0;
+    u32 value = 0;
+
+    fsl_noise_graph_init(g);
+
+    continental = fsl_noise_graph_source(g, TERRAIN_NOISE_CONTINENTAL);
+    regional = fsl_noise_graph_source(g, TERRAIN_NOISE_REGIONAL);
+    local = fsl_noise_graph_source(g, TERRAIN_NOISE_LOCAL);
+    detail = fsl_noise_graph_source(g, TERRAIN_NOISE_DETAIL);
+    temperature = fsl_noise_graph_source(g, TERRAIN_NOISE_COUNT + BIOME_NOISE_TEMPERATURE);
+    roughness = fsl_noise_graph_source(g, TERRAIN_NOISE_COUNT + BIOME_NOISE_ROUGHNESS);
+
+    /* regional, faded out with temperature */
+    value = fsl_noise_graph_mul(g, regional,
+            fsl_noise_graph_fade(g,
+                fsl_noise_graph_offset(g, fsl_noise_graph_scale(g, temperature, -1.0), 1.0)));
+
+    /* continental, weighed by itself */
+    value = fsl_noise_graph_add(g, value,
+            fsl_noise_graph_mul(g, continental,
+                fsl_noise_graph_fade(g,
+                    fsl_noise_graph_offset(g, fsl_noise_graph_div(g, continental, 1000.0), 0.5))));
+
+    /* local, weighed by itself */
+    value = fsl_noise_graph_add(g, value,
+            fsl_noise_graph_mul(g, fsl_noise_graph_offset(g, local, 25.0),
+                fsl_noise_graph_fade(g,
+                    fsl_noise_graph_offset(g, fsl_noise_graph_div(g, local, 50.0), 0.5))));
+    value = fsl_noise_graph_offset(g, value, -25.0);
+
+    /* detail, weighed by roughness */
+    value = fsl_noise_graph_add(g, value,
+            fsl_noise_graph_mul(g, detail, fsl_noise_graph_fade(g, roughness)));
+
+    fsl_noise_graph_compile(g, value);
 }
 
-void terrain_spec_set(hhc_terrain_noise_index noise_index, f64 amp, f64 freq, f64 post_offset)
+void terrain_spec_set(hhc_terrain_noise_index noise_index, f64 amp, f64 freq, f64 post_offset,
+        u32 step)
 {
+    u32 shift = 0;
+
+    if (step < 2 || step > CHUNK_DIAMETER || CHUNK_DIAMETER % step)
+        step = 1;
+
+    while ((1u << shift) < step)
+        ++shift;
+
     terrain_spec.amp[noise_index] = amp;
     terrain_spec.freq[noise_index] = freq;
     terrain_spec.post_offset[noise_index] = post_offset;
+    terrain_spec.step[noise_index] = step;
+    terrain_spec.step_shift[noise_index] = shift;
+    terrain_grid.valid = FALSE;
+}
+
+const hhc_terrain_noise_spec *terrain_spec_get(void)
+{
+    return &terrain_spec;
+}
+
+void terrain_precision_set(hhc_terrain_precision precision)
+{
+    terrain_spec.precision = precision;
+    terrain_grid.valid = FALSE;
 }
 
 chunk_work_cost sampler_noise_axis_update_2d(fsl_noise_sampler_context *ctx, u8 axis)
 {
     u32 i = 0;
-    u32 j = 0;
     u64 noise_count = ctx->sampler->noise_buf.noise_len;
-    u32 sample_count = ctx->sample_count;
-    fsl_noise_sample *sample_src_buf = NULL;
+    u64 full_count = 0;
 
     for (i = 0; i < noise_count; ++i)
     {
-        sample_src_buf = &ctx->sampler->noise_buf.sample_src_buf[i * sample_count];
-        for (j = 0; j < sample_count; ++j)
-        {
-            fsl_noise_sample_axis_init(&sample_src_buf[j], axis,
-                    *ctx->pos[j][axis], terrain_spec.freq[i]);
-        }
+        if (terrain_spec.step[i] > 1)
+            continue;
+        noise_axis_update_internal(ctx, axis, i);
+        ++full_count;
     }
 
-    return CHUNK_WORK_COST_GENERATE_NOISE_INIT * noise_count * sample_count;
+    return CHUNK_WORK_COST_GENERATE_NOISE_INIT * full_count * ctx->sample_count;
 }
 
 chunk_work_cost sampler_noise_bake(fsl_noise_sampler_context *ctx)
 {
-    u64 i = 0;
-    u64 j = 0;
-    fsl_noise_buffer *noise_buf = &ctx->sampler->noise_buf;
-    u64 noise_count = noise_buf->noise_len;
-    u64 sample_count = ctx->sample_count;
-    fsl_noise_sample *sample_src_buf = NULL;
-    f64 *sample_dst_buf = NULL;
-    f64 *noise_dst_buf = noise_buf->noise_dst_buf;
-    f64 *t = ctx->t;
+    u32 i = 0;
+    u32 j = 0;
+    u64 noise_count = ctx->sampler->noise_buf.noise_len;
+    u64 full_count = 0;
+    f64 *noise_dst_buf = ctx->sampler->noise_buf.noise_dst_buf;
+    const f64 *grid = NULL;
+    u32 shift = 0, shift_last = 0, len = 0;
+    u32 p[3] = {0};     /* block position in chunk */
+    f64 t[3] = {0};     /* block position between grid points */
+    f64 w[4] = {0};
+    u32 k = 0, k_upper = 0;
+
+    for (j = 0; j < 3; ++j)
+        p[j] = (u32)(ctx->pos_tab[0][j] - ctx->sample_offset[j]);
 
     for (i = 0; i < noise_count; ++i)
     {
-        sample_src_buf = &noise_buf->sample_src_buf[i * sample_count];
-        sample_dst_buf = &noise_buf->sample_dst_buf[i * sample_count];
-        for (j = 0; j < sample_count; ++j)
+        shift = terrain_spec.step_shift[i];
+        if (!shift)
         {
-            sample_dst_buf[j] = fsl_noise_sample_make_2d(&sample_src_buf[j], terrain_spec.amp[i],
-                    world.seed + TERRAIN_SEED_DEFAULT + i * 10);
+            noise_dst_buf[i] = noise_bake_internal(ctx, i);
+            ++full_count;
+            continue;
         }
 
+        /* noises on the same step share weights */
+        if (shift != shift_last)
+        {
+            shift_last = shift;
+            len = (CHUNK_DIAMETER >> shift) + 1;
+            for (j = 0; j < 3; ++j)
+                t[j] = (f64)(p[j] & ((1u << shift) - 1)) / (f64)(1u << shift);
+
+            w[0] = (1.0 - t[0]) * (1.0 - t[1]);
+            w[1] = t[0] * (1.0 - t[1]);
+            w[2] = (1.0 - t[0]) * t[1];
+            w[3] = t[0] * t[1];
+
+            /* blocks stop short of the upper chunk faces, so all 8 grid points exist */
+            k = (((p[2] >> shift) * len) + (p[1] >> shift)) * len + (p[0] >> shift);
+            k_upper = k + len * len;
+        }
+
+        grid = terrain_grid.value[i];
         noise_dst_buf[i] =
-            ctx->noise_sample_lerp_func(sample_dst_buf, t) +
-            terrain_spec.post_offset[i];
+            (grid[k] * w[0] +
+             grid[k + 1] * w[1] +
+             grid[k + len] * w[2] +
+             grid[k + len + 1] * w[3]) * (1.0 - t[2]) +
+            (grid[k_upper] * w[0] +
+             grid[k_upper + 1] * w[1] +
+             grid[k_upper + len] * w[2] +
+             grid[k_upper + len + 1] * w[3]) * t[2];
     }
 
-    for (i = TERRAIN_NOISE_COUNT; i < noise_count; ++i)
+    return CHUNK_WORK_COST_GENERATE_NOISE_SAMPLE_2D * full_count * ctx->sample_count +
+        CHUNK_WORK_COST_GENERATE_NOISE_GRID_LERP * (noise_count - full_count);
+}
+
+chunk_work_cost terrain_grid_bake(fsl_noise_sampler_context *ctx)
+{
+    chunk_work_cost cost = 0;
+    u64 noise_count = ctx->sampler->noise_buf.noise_len;
+    u32 step = 0, len = 0;
+    u32 x = 0, y = 0, z = 0;
+    u32 i = 0, k = 0;
+
+    if (terrain_grid.valid &&
+            terrain_grid.offset[0] == ctx->sample_offset[0] &&
+            terrain_grid.offset[1] == ctx->sample_offset[1] &&
+            terrain_grid.offset[2] == ctx->sample_offset[2] &&
+            terrain_grid.seed == world.seed)
+        return 0;
+
+    /* one pass per step in use, every layer on that step shares the sampler positions */
+    for (step = 2; step <= CHUNK_DIAMETER; step <<= 1)
     {
-        noise_dst_buf[i] = fsl_clamp_f64(noise_dst_buf[i], 0.0, 1.0);
+        for (i = 0; i < noise_count; ++i)
+            if (terrain_spec.step[i] == step)
+                break;
+        if (i == noise_count)
+            continue;
+
+        len = CHUNK_DIAMETER / step + 1;
+        for (z = 0, k = 0; z < len; ++z)
+        {
+            fsl_noise_sampler_axis_init(ctx, 2, (f64)(z * step));
+            fsl_noise_sampler_axis_pre_update(ctx, 2);
+            for (y = 0; y < len; ++y)
+            {
+                fsl_noise_sampler_axis_init(ctx, 1, (f64)(y * step));
+                fsl_noise_sampler_axis_pre_update(ctx, 1);
+                for (x = 0; x < len; ++x, ++k)
+                {
+                    fsl_noise_sampler_axis_init(ctx, 0, (f64)(x * step));
+                    fsl_noise_sampler_axis_pre_update(ctx, 0);
+
+                    for (i = 0; i < noise_count; ++i)
+                    {
+                        if (terrain_spec.step[i] != step)
+                            continue;
+                        noise_axis_update_internal(ctx, 0, i);
+                        noise_axis_update_internal(ctx, 1, i);
+                        terrain_grid.value[i][k] = noise_bake_internal(ctx, i);
+                        cost += (CHUNK_WORK_COST_GENERATE_NOISE_INIT * 2 +
+                                CHUNK_WORK_COST_GENERATE_NOISE_SAMPLE_2D) * ctx->sample_count;
+                    }
+                }
+            }
+        }
     }
 
-    return CHUNK_WORK_COST_GENERATE_NOISE_SAMPLE_2D * noise_count * sample_count;
+    terrain_grid.offset[0] = ctx->sample_offset[0];
+    terrain_grid.offset[1] = ctx->sample_offset[1];
+    terrain_grid.offset[2] = ctx->sample_offset[2];
+    terrain_grid.seed = world.seed;
+    terrain_grid.valid = TRUE;
+
+    return cost;
 }
 
-chunk_work_cost terrain_shape(hhc_terrain_sample *terrain, fsl_noise_sampler_context *ctx)
+static void noise_axis_update_internal(fsl_noise_sampler_context *ctx, u8 axis, u32 noise_index)
 {
-    chunk_work_cost cost = 0;
-    f64 *noise_dst_buf = ctx->sampler->noise_buf.noise_dst_buf;
-    hhc_terrain_sample noterrain = {0};
-    hhc_biome biome = {0};
-    f64 biome_score = 0.0;
-    f64 biome_best_score = 10000.0;
-    i32 biome_best_index = 0;
-    i32 i = 0;
-    f64 t = 0.0;
+    u32 j = 0;
+    u32 sample_count = ctx->sample_count;
+    fsl_noise_sample *sample_src_buf =
+        &ctx->sampler->noise_buf.sample_src_buf[noise_index * sample_count];
+    f64 pos = 0.0;
+    i64 origin = 0;
 
-    *terrain = noterrain;
+    if (terrain_spec.precision == TERRAIN_PRECISION_F32 &&
+            ctx->sampler->noise_type == FSL_NOISE_TYPE_PERLIN)
+    {
+        for (j = 0; j < sample_count; ++j)
+        {
+            pos = *ctx->pos[j][axis];
+            origin = (i64)floor(pos);
+            fsl_noise_sample_axis_init_f32(&terrain_sample_f32[noise_index][j], axis,
+                    origin, (f32)(pos - (f64)origin), terrain_spec.freq[noise_index]);
+        }
+        return;
+    }
 
-    for (i = 0; i < BIOME_NOISE_COUNT; ++i)
-        biome.spec[i] = noise_dst_buf[i + TERRAIN_NOISE_COUNT];
+    for (j = 0; j < sample_count; ++j)
+    {
+        fsl_noise_sample_axis_init(&sample_src_buf[j], axis,
+                *ctx->pos[j][axis], terrain_spec.freq[noise_index]);
+    }
+}
 
-    i = BIOME_COUNT;
-    while (i--)
+static f64 noise_bake_internal(fsl_noise_sampler_context *ctx, u32 noise_index)
+{
+    u32 j = 0;
+    fsl_noise_buffer *noise_buf = &ctx->sampler->noise_buf;
+    u32 sample_count = ctx->sample_count;
+    fsl_noise_sample *sample_src_buf = &noise_buf->sample_src_buf[noise_index * sample_count];
+    f64 *sample_dst_buf = &noise_buf->sample_dst_buf[noise_index * sample_count];
+    u64 seed = world.seed + TERRAIN_SEED_DEFAULT + noise_index * 10;
+    fsl_noise_lattice_cache *cache = NULL;
+    f64 value = 0.0;
+
+    /* the cache only holds perlin lattice cells */
+    if (ctx->sampler->noise_type == FSL_NOISE_TYPE_PERLIN)
+        cache = ctx->sampler->lattice_cache;
+
+    if (terrain_spec.precision == TERRAIN_PRECISION_F32 &&
+            ctx->sampler->noise_type == FSL_NOISE_TYPE_PERLIN)
     {
-        biome_score = biome_score_get(biome, terrain_spec.biome[i]);
-        if (biome_score < biome_best_score)
+        for (j = 0; j < sample_count; ++j)
         {
-            biome_best_score = biome_score;
-            biome_best_index = i;
+            sample_dst_buf[j] = cache ?
+                fsl_noise_sample_make_2d_f32_cached(cache, &terrain_sample_f32[noise_index][j],
+                        (f32)terrain_spec.amp[noise_index], seed) :
+                fsl_noise_sample_make_2d_f32(&terrain_sample_f32[noise_index][j],
+                        (f32)terrain_spec.amp[noise_index], seed);
+        }
+    }
+    else if (cache)
+    {
+        for (j = 0; j < sample_count; ++j)
+        {
+            sample_dst_buf[j] = fsl_noise_sample_make_2d_cached(cache, &sample_src_buf[j],
+                    terrain_spec.amp[noise_index], seed);
+        }
+    }
+    else
+    {
+        for (j = 0; j < sample_count; ++j)
+        {
+            sample_dst_buf[j] = ctx->sampler->noise_sample_make_2d_func(&sample_src_buf[j],
+                    terrain_spec.amp[noise_index], seed);
         }
     }
 
-    terrain->biome = biome_best_index;
+    value = ctx->noise_sample_lerp_func(sample_dst_buf, ctx->t) +
+        terrain_spec.post_offset[noise_index];
 
-    t = 1.0 - noise_dst_buf[TERRAIN_NOISE_COUNT + BIOME_NOISE_TEMPERATURE];
-    t = t * t * t * (t * (t * 6.0 - 15.0) + 10);
-    terrain->value += noise_dst_buf[TERRAIN_NOISE_REGIONAL] * t;
+    if (noise_index >= TERRAIN_NOISE_COUNT)
+        value = fsl_clamp_f64(value, 0.0, 1.0);
 
-    t = noise_dst_buf[TERRAIN_NOISE_CONTINENTAL] / 1000.0 + 0.5;
-    t = t * t * t * (t * (t * 6.0 - 15.0) + 10);
-    terrain->value += noise_dst_buf[TERRAIN_NOISE_CONTINENTAL] * t;
+    return value;
+}
 
-    t = noise_dst_buf[TERRAIN_NOISE_LOCAL] / 50.0 + 0.5;
-    t = t * t * t * (t * (t * 6.0 - 15.0) + 10);
-    terrain->value += (noise_dst_buf[TERRAIN_NOISE_LOCAL] + 25.0) * t;
-    terrain->value -= 25.0;
+chunk_work_cost terrain_shape(hhc_terrain_sample *terrain, fsl_noise_sampler_context *ctx)
+{
+    return terrain_shape_row(terrain, ctx->sampler->noise_buf.noise_dst_buf, ctx->pos_tab[0][2], 1);
+}
 
-    t = noise_dst_buf[TERRAIN_NOISE_COUNT + BIOME_NOISE_ROUGHNESS];
-    t = t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
-    terrain->value += noise_dst_buf[TERRAIN_NOISE_DETAIL] * t;
+chunk_work_cost terrain_shape_row(hhc_terrain_sample *terrain, const f64 *noise, f64 z, u32 n)
+{
+    chunk_work_cost cost = 0;
+    fsl_noise_graph_input input = {0};
+    hhc_terrain_sample noterrain = {0};
+    f64 value[TERRAIN_SHAPE_ROW_MAX];
+    u32 i = 0;
+
+    input.noise = noise;
+    input.noise_len = TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT;
+    fsl_noise_graph_eval(&terrain_graph, &input, value, n);
 
-    if (ctx->pos_tab[0][2] < terrain->value)
+    for (i = 0; i < n; ++i)
     {
-        terrain->block_id = biome_best_index + 1;
+        terrain[i] = noterrain;
+        if (BIOME_COUNT >= BIOME_TABLE_BIOME_MIN)
+            terrain[i].biome = biome_table_get(&terrain_biome_table,
+                    &noise[i * input.noise_len + TERRAIN_NOISE_COUNT]);
+        else
+            terrain[i].biome = biome_match(terrain_spec.biome, BIOME_COUNT,
+                    &noise[i * input.noise_len + TERRAIN_NOISE_COUNT]);
+        terrain[i].value = value[i];
+
+        if (z < terrain[i].value)
+        {
+            terrain[i].block_id = terrain[i].biome + 1;
+        }
     }
 
     return cost;
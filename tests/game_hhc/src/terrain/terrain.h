@@ -5,11 +5,23 @@
 #include "deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler.h"
 
 #include "../chunking/chunk_work.h"
+#include "../chunking/chunking.h"
 
 #include "../h/assets.h"
 
 #include "biome.h"
 
+/*!
+ *  @brief grid points per chunk at the smallest grid step, 2.
+ */
+#define TERRAIN_GRID_POINTS_MAX \
+    ((CHUNK_DIAMETER / 2 + 1) * (CHUNK_DIAMETER / 2 + 1) * (CHUNK_DIAMETER / 2 + 1))
+
+/*!
+ *  @brief points per @ref terrain_shape_row() call, a row of a chunk.
+ */
+#define TERRAIN_SHAPE_ROW_MAX CHUNK_DIAMETER
+
 typedef enum hhc_terrain_noise_index
 {
     TERRAIN_NOISE_CONTINENTAL,
@@ -19,12 +31,31 @@ typedef enum hhc_terrain_noise_index
     TERRAIN_NOISE_COUNT
 } hhc_terrain_noise_index;
 
+typedef enum hhc_terrain_precision
+{
+    TERRAIN_PRECISION_F64,
+    TERRAIN_PRECISION_F32  /* perlin samples in f32, see @ref fsl_noise_sample_f32 */
+} hhc_terrain_precision;
+
 typedef struct hhc_terrain_noise_spec
 {
     f64 amp[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT];
     f64 freq[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT];
     f64 post_offset[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT];
+
+    /*!
+     *  @brief grid step in blocks, noises above 1 are sampled on grid points per
+     *  chunk and interpolated trilinearly in between, 1 samples every block.
+     */
+    u32 step[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT];
+    u32 step_shift[TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT]; /* log2 of `step` */
     hhc_biome biome[BIOME_COUNT];
+
+    /*!
+     *  @brief noise sample precision, f32 applies while the sampler's noise type is
+     *  @ref FSL_NOISE_TYPE_PERLIN, other types sample in f64.
+     */
+    hhc_terrain_precision precision;
 } hhc_terrain_noise_spec;
 
 typedef struct hhc_terrain_sample
@@ -41,12 +72,27 @@ void terrain_init(void);
 
 /*!
  *  @brief set internal parameter preferences for a given terrain noise type.
+ *
+ *  @param step grid step, see @ref hhc_terrain_noise_spec.step, must divide
+ *  @ref CHUNK_DIAMETER, otherwise 1.
+ */
+void terrain_spec_set(hhc_terrain_noise_index noise_index, f64 amp, f64 freq, f64 post_offset,
+        u32 step);
+
+/*!
+ *  @brief current terrain settings, as set by @ref terrain_init(), @ref terrain_spec_set()
+ *  and @ref terrain_precision_set().
  */
-void terrain_spec_set(hhc_terrain_noise_index noise_index, f64 amp, f64 freq, f64 post_offset);
+const hhc_terrain_noise_spec *terrain_spec_get(void);
 
 /*!
- *  @brief update a single axis from each sample of each pre-defined 2D noise,
- *  for as many samples per noise as specified in `ctx`.
+ *  @brief set noise sample precision, default @ref TERRAIN_PRECISION_F64.
+ */
+void terrain_precision_set(hhc_terrain_precision precision);
+
+/*!
+ *  @brief update a single axis from each sample of each pre-defined 2D noise
+ *  sampled every block, for as many samples per noise as specified in `ctx`.
  *
  *  @param pos position along specified axis.
  */
@@ -56,13 +102,35 @@ chunk_work_cost sampler_noise_axis_update_2d(fsl_noise_sampler_context *ctx, u8
  *  @brief finalize and bake all pre-defined 2D and 3D noise maps to ready for
  *  terrain generation.
  *
+ *  noises with a grid step are interpolated from the grid of @ref terrain_grid_bake().
+ *
  *  @remark use quintic interpolation internally.
  */
 chunk_work_cost sampler_noise_bake(fsl_noise_sampler_context *ctx);
 
 /*!
- *  @brief default terrain shaping function.
+ *  @brief sample noises with a grid step on their grid points of the chunk `ctx`
+ *  was initialized for, no-op if already baked for it.
+ *
+ *  @remark moves the sampler position, re-initialize all axes after.
+ */
+chunk_work_cost terrain_grid_bake(fsl_noise_sampler_context *ctx);
+
+/*!
+ *  @brief default terrain shaping function, for the point `ctx` was last baked at.
+ *
+ *  @remark one point per call is the slow path of the terrain graph, prefer
+ *  @ref terrain_shape_row() where points come in rows.
  */
 chunk_work_cost terrain_shape(hhc_terrain_sample *terrain, fsl_noise_sampler_context *ctx);
 
+/*!
+ *  @brief @ref terrain_shape() for `n` points at height `z`, e.g. a row of a chunk,
+ *  the terrain graph is evaluated for all of them at once.
+ *
+ *  @param noise baked noise values, `TERRAIN_NOISE_COUNT + BIOME_NOISE_COUNT` per point.
+ *  @param n points, up to @ref TERRAIN_SHAPE_ROW_MAX.
+ */
+chunk_work_cost terrain_shape_row(hhc_terrain_sample *terrain, const f64 *noise, f64 z, u32 n);
+
 #endif /* HHC_TERRAIN_H */
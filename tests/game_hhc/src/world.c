@@ -9,6 +9,7 @@
 
 #include "deps/fossil/h/dir.h"
 #include "deps/fossil/h/time.h"
+#include "deps/fossil/plugins/fsl_native/noise_sampler/noise_sampler_sample.h"
 
 #include "chunking/chunking.h"
 #include "gui/gui.h"
@@ -21,6 +22,7 @@
 #include "h/main.h"
 #include "h/world.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -37,6 +39,10 @@ u32 world_init(str *name, u64 seed, hhc_player *p)
     if (*GAME_ERR != FSL_ERR_SUCCESS && *GAME_ERR != HHC_ERR_WORLD_EXISTS)
         return *GAME_ERR;
 
+    /* not fatal, chunking waits for the directory in @ref world_update() */
+    fsl_dir_handle_open(&world.dir_chunks,
+            fsl_stringf("%s"GAME_DIR_WORLD_NAME_CHUNKS, world.path), FSL_FLAG_DIR_HANDLE_SWEEP_TEMP, TRUE);
+
     if (chunking_init(&p->ch_delta) != FSL_ERR_SUCCESS)
         return *GAME_ERR;
 
@@ -122,7 +128,9 @@ u32 world_load(world_info *world, const str *world_name, u64 seed)
 {
     str string[2][FSL_PATH_CAP] = {0};
     str *file_contents = NULL;
+    str *line = NULL;
     u64 file_len = 0;
+    u64 noise_hash = FSL_NOISE_HASH_MIX;
 
     if (!strlen(world_name))
     {
@@ -167,7 +175,7 @@ u32 world_load(world_info *world, const str *world_name, u64 seed)
 
     world->type = 0;
 
-    /* ---- world seed ------------------------------------------------------ */
+    /* ---- world seed and noise hash --------------------------------------- */
 
     snprintf(string[0], FSL_PATH_CAP, GAME_DIR_NAME_WORLDS"%s/"GAME_FILE_NAME_WORLD_METADATA,
             world_name);
@@ -177,6 +185,11 @@ u32 world_load(world_info *world, const str *world_name, u64 seed)
         if (*GAME_ERR != FSL_ERR_SUCCESS || !file_contents)
             return *GAME_ERR;
         fsl_convert_str_to_u64(file_contents, &seed);
+
+        /* metadata written before the hash was saved holds the seed alone */
+        noise_hash = FSL_NOISE_HASH_TABLE;
+        if ((line = strchr(file_contents, '\n')) && fsl_is_digit(line[1]))
+            fsl_convert_str_to_u64(line + 1, &noise_hash);
         fsl_mem_free((void*)&file_contents, file_len, "world_load().file_contents");
     }
     else
@@ -184,13 +197,23 @@ u32 world_load(world_info *world, const str *world_name, u64 seed)
         if (!seed)
             seed = fsl_rand_u64(fsl_get_time_raw_nsec());
 
-        fsl_convert_u64_to_str(string[1], FSL_ID_CAP, seed);
-        if (fsl_write_file(string[0], strlen(string[1]),
-                    &string[1], TRUE, TRUE) != FSL_ERR_SUCCESS)
+        snprintf(string[1], FSL_PATH_CAP, "%"PRIu64"\n%"PRIu64, seed, noise_hash);
+        if (fsl_write_file_atomic(string[0], strlen(string[1]),
+                    &string[1], TRUE, TRUE, TRUE) != FSL_ERR_SUCCESS)
             return *GAME_ERR;
     }
 
+    if (noise_hash >= FSL_NOISE_HASH_COUNT || fsl_noise_sample_hash_set((u32)noise_hash) != FSL_ERR_SUCCESS)
+    {
+        LOGERROR(HHC_ERR_WORLD_CREATION_FAIL,
+                FSL_FLAG_LOG_NO_VERBOSE | FSL_FLAG_LOG_CMD,
+                fsl_logger_stringf("Failed to Load World '%s', Noise Hash %"PRIu64" Unknown\n",
+                    world_name, noise_hash));
+        return *GAME_ERR;
+    }
+
     world->seed = seed;
+    world->noise_hash = (u32)noise_hash;
 
     /* ---- TODO: load the rest of world metadata --------------------------- */
 
@@ -223,12 +246,15 @@ void world_update(hhc_player *p)
     player_update(p, 1.0 - exp(-1.0 * (f64)render->time_delta * FSL_NSEC2SEC));
     player_camera_movement_update(p, render->mouse_delta, should_the_mouse_move_the_3d_camera);
 
-    if (MODE_INTERNAL_LOAD_CHUNKS &&
-            fsl_is_dir_exists(fsl_stringf("%s"GAME_DIR_WORLD_NAME_CHUNKS,
-                    world.path), TRUE) == FSL_ERR_SUCCESS)
+    if (MODE_INTERNAL_LOAD_CHUNKS && chunk_dir_update())
         chunking_update(p->ch, &p->ch_delta, p->hit);
     player_target_update(p);
 
     fsl_projection_perspective_update(p->camera_hud, &p->camera_hud.projection, FALSE);
     fsl_projection_perspective_update(p->camera_ui, &p->camera_ui.projection, FALSE);
 }
+
+void world_free(void)
+{
+    fsl_dir_handle_close(&world.dir_chunks);
+}
@@ -0,0 +1,460 @@
+/*!
+ *  headless training workload for profile-guided optimization builds (`./build pgo`),
+ *  and a benchmark of the engine's hot paths.
+ *
+ *  deterministic: a fixed seed, a fixed world and a scripted walk, so profiles and
+ *  timings of two builds are comparable.
+ *
+ *  - generate a voxel world with perlin noise (height map + caves),
+ *  - mesh every chunk, looking up chunk neighbors through a hash map,
+ *  - walk a player box across the world, resolving collision with swept AABB,
+ *  - log per chunk row.
+ *
+ *  with `paths` as 3rd argument, also time each hot path alone after training, best of
+ *  @ref PATH_RUNS, and write them to @ref FILE_NAME_PATHS in the binary's directory as
+ *  `<path> <nanoseconds>` lines, for `./build modes`.
+ */
+
+#include "../../../fossil/deps/fossil/fossil_engine.h"
+#include "../../../fossil/deps/fossil/math/noise.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CHUNK_DIAMETER  16
+#define CHUNK_LAYER     (CHUNK_DIAMETER * CHUNK_DIAMETER)
+#define CHUNK_VOLUME    (CHUNK_LAYER * CHUNK_DIAMETER)
+#define WORLD_RADIUS    8   /* in chunks, on x and y */
+#define WORLD_HEIGHT    4   /* in chunks, on z */
+#define WORLD_CHUNKS    (WORLD_RADIUS * WORLD_RADIUS * 4 * WORLD_HEIGHT)
+#define WORLD_SEED      1337
+#define WORLD_PASSES    3
+#define PLAYER_STEPS    20000
+#define PATH_RUNS       5
+#define PATH_HASH_ROUNDS 64
+#define FILE_NAME_PATHS "paths.txt"
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+typedef struct chunk
+{
+    v3i32 pos;
+    u64 face_count;
+    u8 block[CHUNK_DIAMETER][CHUNK_DIAMETER][CHUNK_DIAMETER];
+} chunk;
+
+static struct /* core */
+{
+    fsl_mem_arena arena;
+    fsl_hash_map chunk_map; /* chunk position hash -> chunk index */
+    chunk *chunk_buf;
+    u64 *face_buf;
+    u64 chunk_count;
+    u64 face_count;
+    u64 hit_count;
+    f32 noise_sum; /* keeps timed noise calls observable */
+} core;
+
+static u64 chunk_hash(i32 x, i32 y, i32 z)
+{
+    u64 pack =
+        ((u64)(x & 0x1fffff) << 0) |
+        ((u64)(y & 0x1fffff) << 21) |
+        ((u64)(z & 0x1fffff) << 42);
+
+    /* odd multiplier, keeps positions unique and spreads them over the low bits */
+    return pack * (((u64)0x9e3779b9 << 32) | 0x7f4a7c15);
+}
+
+static chunk *chunk_get(i32 x, i32 y, i32 z)
+{
+    u32 *index = fsl_hash_map_find(&core.chunk_map, chunk_hash(x, y, z), NULL);
+    return index ? &core.chunk_buf[*index] : NULL;
+}
+
+static u8 block_get(i64 x, i64 y, i64 z)
+{
+    i32 cx = (i32)((x < 0 ? x - CHUNK_DIAMETER + 1 : x) / CHUNK_DIAMETER);
+    i32 cy = (i32)((y < 0 ? y - CHUNK_DIAMETER + 1 : y) / CHUNK_DIAMETER);
+    i32 cz = (i32)((z < 0 ? z - CHUNK_DIAMETER + 1 : z) / CHUNK_DIAMETER);
+    chunk *ch = chunk_get(cx, cy, cz);
+
+    if (!ch)
+        return 0;
+
+    return ch->block
+        [z - (i64)cz * CHUNK_DIAMETER]
+        [y - (i64)cy * CHUNK_DIAMETER]
+        [x - (i64)cx * CHUNK_DIAMETER];
+}
+
+static void chunk_generate(chunk *ch)
+{
+    f32 height[CHUNK_DIAMETER][CHUNK_DIAMETER] = {0};
+    f32 column_x[CHUNK_DIAMETER][CHUNK_DIAMETER] = {0};
+    f32 column_y[CHUNK_DIAMETER][CHUNK_DIAMETER] = {0};
+    f32 wx = 0.0f, wy = 0.0f, wz = 0.0f, cave = 0.0f;
+    i32 x = 0, y = 0, z = 0;
+
+    for (y = 0; y < CHUNK_DIAMETER; ++y)
+        for (x = 0; x < CHUNK_DIAMETER; ++x)
+        {
+            column_x[y][x] = (f32)(ch->pos.x * CHUNK_DIAMETER + x);
+            column_y[y][x] = (f32)(ch->pos.y * CHUNK_DIAMETER + y);
+        }
+
+    fsl_perlin_noise_2d_batch(&column_x[0][0], &column_y[0][0], &height[0][0],
+            CHUNK_DIAMETER * CHUNK_DIAMETER, 48.0f, 0.01f, 5, 0.5f, 2.0f, WORLD_SEED);
+
+    for (y = 0; y < CHUNK_DIAMETER; ++y)
+        for (x = 0; x < CHUNK_DIAMETER; ++x)
+            height[y][x] += CHUNK_DIAMETER * WORLD_HEIGHT * 0.5f;
+
+    for (z = 0; z < CHUNK_DIAMETER; ++z)
+    {
+        wz = (f32)(ch->pos.z * CHUNK_DIAMETER + z);
+        for (y = 0; y < CHUNK_DIAMETER; ++y)
+            for (x = 0; x < CHUNK_DIAMETER; ++x)
+            {
+                ch->block[z][y][x] = 0;
+                if (wz > height[y][x])
+                    continue;
+
+                wx = (f32)(ch->pos.x * CHUNK_DIAMETER + x);
+                wy = (f32)(ch->pos.y * CHUNK_DIAMETER + y);
+                cave = fsl_perlin_noise_3d_ex(wx, wy, wz, 1.0f, 0.05f, 2, 0.5f, 2.0f, WORLD_SEED + 1);
+                if (cave > 0.15f)
+                    continue;
+
+                ch->block[z][y][x] = wz > height[y][x] - 1.0f ? 2 : wz > height[y][x] - 4.0f ? 3 : 1;
+            }
+    }
+}
+
+static u64 chunk_mesh(chunk *ch, u64 *buf)
+{
+    chunk *px = chunk_get(ch->pos.x + 1, ch->pos.y, ch->pos.z);
+    chunk *nx = chunk_get(ch->pos.x - 1, ch->pos.y, ch->pos.z);
+    chunk *py = chunk_get(ch->pos.x, ch->pos.y + 1, ch->pos.z);
+    chunk *ny = chunk_get(ch->pos.x, ch->pos.y - 1, ch->pos.z);
+    chunk *pz = chunk_get(ch->pos.x, ch->pos.y, ch->pos.z + 1);
+    chunk *nz = chunk_get(ch->pos.x, ch->pos.y, ch->pos.z - 1);
+    u64 *cursor = buf;
+    u32 faces = 0;
+    i32 x = 0, y = 0, z = 0;
+
+    for (z = 0; z < CHUNK_DIAMETER; ++z)
+        for (y = 0; y < CHUNK_DIAMETER; ++y)
+            for (x = 0; x < CHUNK_DIAMETER; ++x)
+            {
+                if (!ch->block[z][y][x])
+                    continue;
+
+                faces = 0;
+                if (x == CHUNK_DIAMETER - 1 ? !px || !px->block[z][y][0] : !ch->block[z][y][x + 1])
+                    faces |= 0x01;
+                if (x == 0 ? !nx || !nx->block[z][y][CHUNK_DIAMETER - 1] : !ch->block[z][y][x - 1])
+                    faces |= 0x02;
+                if (y == CHUNK_DIAMETER - 1 ? !py || !py->block[z][0][x] : !ch->block[z][y + 1][x])
+                    faces |= 0x04;
+                if (y == 0 ? !ny || !ny->block[z][CHUNK_DIAMETER - 1][x] : !ch->block[z][y - 1][x])
+                    faces |= 0x08;
+                if (z == CHUNK_DIAMETER - 1 ? !pz || !pz->block[0][y][x] : !ch->block[z + 1][y][x])
+                    faces |= 0x10;
+                if (z == 0 ? !nz || !nz->block[CHUNK_DIAMETER - 1][y][x] : !ch->block[z - 1][y][x])
+                    faces |= 0x20;
+
+                if (!faces)
+                    continue;
+
+                *(cursor++) = (u64)ch->block[z][y][x] |
+                    (u64)faces << 8 |
+                    (u64)x << 16 |
+                    (u64)y << 20 |
+                    (u64)z << 24;
+            }
+
+    ch->face_count = (u64)(cursor - buf);
+    return ch->face_count;
+}
+
+/*!
+ *  @brief move `box` by `displacement`, sliding along the solid blocks it hits.
+ *
+ *  @return number of blocks hit.
+ */
+static u64 player_move(fsl_bounding_box *box, v3f64 *displacement)
+{
+    fsl_bounding_box block = {0};
+    fsl_collision_info info = {0};
+    fsl_collision_info first = {0};
+    i64 x = 0, y = 0, z = 0;
+    i64 min_x = 0, min_y = 0, min_z = 0, max_x = 0, max_y = 0, max_z = 0;
+    u64 hits = 0;
+    u32 pass = 0;
+
+    block.size.x = block.size.y = block.size.z = 1.0;
+
+    for (pass = 0; pass < 3; ++pass)
+    {
+        min_x = (i64)floor(MIN(box->pos.x, box->pos.x + displacement->x)) - 1;
+        min_y = (i64)floor(MIN(box->pos.y, box->pos.y + displacement->y)) - 1;
+        min_z = (i64)floor(MIN(box->pos.z, box->pos.z + displacement->z)) - 1;
+        max_x = (i64)floor(MAX(box->pos.x, box->pos.x + displacement->x) + box->size.x) + 1;
+        max_y = (i64)floor(MAX(box->pos.y, box->pos.y + displacement->y) + box->size.y) + 1;
+        max_z = (i64)floor(MAX(box->pos.z, box->pos.z + displacement->z) + box->size.z) + 1;
+
+        first.entry_time = 1.0;
+        first.hit = FALSE;
+        for (z = min_z; z <= max_z; ++z)
+            for (y = min_y; y <= max_y; ++y)
+                for (x = min_x; x <= max_x; ++x)
+                {
+                    if (!block_get(x, y, z))
+                        continue;
+
+                    block.pos.x = (f64)x;
+                    block.pos.y = (f64)y;
+                    block.pos.z = (f64)z;
+                    info = fsl_get_swept_aabb(*box, block, *displacement);
+                    if (info.hit && info.entry_time < first.entry_time)
+                        first = info;
+                }
+
+        if (!first.hit)
+            break;
+
+        ++hits;
+        box->pos.x += displacement->x * first.entry_time;
+        box->pos.y += displacement->y * first.entry_time;
+        box->pos.z += displacement->z * first.entry_time;
+
+        /* slide, drop the velocity into the surface */
+        displacement->x *= (1.0 - first.entry_time) * (first.normal.x != 0.0 ? 0.0 : 1.0);
+        displacement->y *= (1.0 - first.entry_time) * (first.normal.y != 0.0 ? 0.0 : 1.0);
+        displacement->z *= (1.0 - first.entry_time) * (first.normal.z != 0.0 ? 0.0 : 1.0);
+    }
+
+    box->pos.x += displacement->x;
+    box->pos.y += displacement->y;
+    box->pos.z += displacement->z;
+    return hits;
+}
+
+static void world_generate(void)
+{
+    chunk *ch = NULL;
+    i32 x = 0, y = 0, z = 0;
+    u32 index = 0;
+    u64 i = 0;
+
+    fsl_hash_map_clear(&core.chunk_map);
+    core.chunk_count = 0;
+
+    for (y = -WORLD_RADIUS; y < WORLD_RADIUS; ++y)
+    {
+        for (x = -WORLD_RADIUS; x < WORLD_RADIUS; ++x)
+            for (z = 0; z < WORLD_HEIGHT; ++z)
+            {
+                index = (u32)core.chunk_count;
+                ch = &core.chunk_buf[index];
+                ch->pos.x = x;
+                ch->pos.y = y;
+                ch->pos.z = z;
+                chunk_generate(ch);
+                fsl_hash_map_insert(&core.chunk_map, chunk_hash(x, y, z), NULL, &index, NULL);
+                ++core.chunk_count;
+            }
+
+        LOGDEBUG(FSL_FLAG_LOG_NO_VERBOSE | FSL_FLAG_LOG_NO_FILE,
+                fsl_logger_stringf("Chunk Row %"PRId32" Generated\n", y));
+    }
+
+    for (i = 0; i < core.chunk_count; ++i)
+        core.face_count += chunk_mesh(&core.chunk_buf[i], core.face_buf);
+}
+
+static void player_walk(void)
+{
+    fsl_bounding_box box = {0};
+    v3f64 displacement = {0};
+    f64 velocity_z = 0.0;
+    u64 hits = 0;
+    u32 i = 0;
+
+    box.size.x = 0.6;
+    box.size.y = 0.6;
+    box.size.z = 1.8;
+    box.pos.z = CHUNK_DIAMETER * WORLD_HEIGHT;
+
+    for (i = 0; i < PLAYER_STEPS; ++i)
+    {
+        /* scripted walk, a slow spiral out from the origin */
+        displacement.x = cos(i * 0.002) * 0.15;
+        displacement.y = sin(i * 0.002) * 0.15;
+        velocity_z = MAX(velocity_z - 0.02, -0.8);
+        displacement.z = velocity_z;
+
+        hits = player_move(&box, &displacement);
+        if (hits)
+        {
+            core.hit_count += hits;
+            if (displacement.z == 0.0)
+                velocity_z = (i % 40 == 0) ? 0.35 : 0.0; /* jump now and then */
+        }
+    }
+}
+
+static void path_perlin_2d_batch(void)
+{
+    f32 column_x[CHUNK_LAYER] = {0};
+    f32 column_y[CHUNK_LAYER] = {0};
+    f32 height[CHUNK_LAYER] = {0};
+    u64 i = 0;
+    u32 j = 0;
+
+    for (i = 0; i < core.chunk_count; ++i)
+    {
+        for (j = 0; j < CHUNK_LAYER; ++j)
+        {
+            column_x[j] = (f32)(core.chunk_buf[i].pos.x * CHUNK_DIAMETER + j % CHUNK_DIAMETER);
+            column_y[j] = (f32)(core.chunk_buf[i].pos.y * CHUNK_DIAMETER + j / CHUNK_DIAMETER);
+        }
+        fsl_perlin_noise_2d_batch(column_x, column_y, height,
+                CHUNK_LAYER, 48.0f, 0.01f, 5, 0.5f, 2.0f, WORLD_SEED);
+        core.noise_sum += height[0];
+    }
+}
+
+/*! @brief the cave noise of @ref chunk_generate(), over the whole world. */
+static void path_perlin_3d_ex(void)
+{
+    i32 x = 0, y = 0, z = 0;
+
+    for (z = 0; z < CHUNK_DIAMETER * WORLD_HEIGHT; ++z)
+        for (y = -WORLD_RADIUS * CHUNK_DIAMETER; y < WORLD_RADIUS * CHUNK_DIAMETER; y += 2)
+            for (x = -WORLD_RADIUS * CHUNK_DIAMETER; x < WORLD_RADIUS * CHUNK_DIAMETER; ++x)
+                core.noise_sum += fsl_perlin_noise_3d_ex((f32)x, (f32)y, (f32)z,
+                        1.0f, 0.05f, 2, 0.5f, 2.0f, WORLD_SEED + 1);
+}
+
+/*! @brief the neighbor lookups of @ref chunk_mesh(), alone. */
+static void path_hash_map(void)
+{
+    chunk *ch = NULL;
+    u64 i = 0, found = 0;
+    u32 round = 0;
+
+    for (round = 0; round < PATH_HASH_ROUNDS; ++round)
+        for (i = 0; i < core.chunk_count; ++i)
+        {
+            ch = &core.chunk_buf[i];
+            found += chunk_get(ch->pos.x + 1, ch->pos.y, ch->pos.z) != NULL;
+            found += chunk_get(ch->pos.x - 1, ch->pos.y, ch->pos.z) != NULL;
+            found += chunk_get(ch->pos.x, ch->pos.y + 1, ch->pos.z) != NULL;
+            found += chunk_get(ch->pos.x, ch->pos.y - 1, ch->pos.z) != NULL;
+            found += chunk_get(ch->pos.x, ch->pos.y, ch->pos.z + 1) != NULL;
+            found += chunk_get(ch->pos.x, ch->pos.y, ch->pos.z - 1) != NULL;
+        }
+    core.noise_sum += (f32)found;
+}
+
+static void path_mesh(void)
+{
+    u64 i = 0;
+
+    for (i = 0; i < core.chunk_count; ++i)
+        chunk_mesh(&core.chunk_buf[i], core.face_buf);
+}
+
+static const struct
+{
+    const str *name;
+    void (*run)(void);
+} path_list[] =
+{
+    {"perlin_2d_batch", path_perlin_2d_batch},
+    {"perlin_3d_ex",    path_perlin_3d_ex},
+    {"hash_map",        path_hash_map},
+    {"mesh",            path_mesh},
+    {"swept_aabb",      player_walk},
+};
+
+/*! @brief time each of @ref path_list on the generated world and write @ref FILE_NAME_PATHS. */
+static void paths_bench(void)
+{
+    FILE *file = NULL;
+    u64 time_best = 0, time = 0;
+    u32 i = 0, j = 0;
+
+    if ((file = fopen(FILE_NAME_PATHS, "wb")) == NULL)
+    {
+        LOGERROR(FSL_ERR_FILE_OPEN_FAIL, 0, fsl_logger_stringf("Failed to Open '%s'\n", FILE_NAME_PATHS));
+        return;
+    }
+
+    for (i = 0; i < sizeof(path_list) / sizeof(path_list[0]); ++i)
+    {
+        time_best = 0;
+        for (j = 0; j < PATH_RUNS; ++j)
+        {
+            time = fsl_get_time_nsec();
+            path_list[i].run();
+            time = fsl_get_time_nsec() - time;
+            if (!time_best || time < time_best)
+                time_best = time;
+        }
+
+        fprintf(file, "%s %"PRIu64"\n", path_list[i].name, time_best);
+        LOGINFO(FSL_FLAG_LOG_NO_VERBOSE,
+                fsl_logger_stringf("Path %-16s %9.3lfms\n", path_list[i].name, (f64)time_best * 1e-6));
+    }
+
+    fclose(file);
+}
+
+int main(int argc, char **argv)
+{
+    u64 time_start = 0;
+    u32 i = 0;
+
+    if (fsl_engine_init(argc, argv, NULL, 0, 0, FSL_FLAG_HEADLESS) != FSL_ERR_SUCCESS)
+        goto cleanup;
+
+    if (
+            fsl_mem_arena_init(&core.arena, "main().core.arena") != FSL_ERR_SUCCESS ||
+            fsl_hash_map_init(&core.chunk_map, &core.arena, WORLD_CHUNKS, sizeof(u32), NULL) != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&core.chunk_buf, WORLD_CHUNKS * sizeof(chunk),
+                "main().core.chunk_buf") != FSL_ERR_SUCCESS ||
+            fsl_mem_map((void*)&core.face_buf, CHUNK_VOLUME * sizeof(u64),
+                "main().core.face_buf") != FSL_ERR_SUCCESS)
+        goto cleanup;
+
+    time_start = fsl_get_time_nsec();
+
+    for (i = 0; i < WORLD_PASSES; ++i)
+    {
+        world_generate();
+        player_walk();
+    }
+
+    LOGINFO(FSL_FLAG_LOG_NO_VERBOSE,
+            fsl_logger_stringf("Training Done in %.3lfs, Chunks: %"PRIu64", Faces: %"PRIu64", Hits: %"PRIu64"\n",
+                (f64)(fsl_get_time_nsec() - time_start) * FSL_NSEC2SEC,
+                core.chunk_count, core.face_count, core.hit_count));
+
+    if (argc > 3 && !strcmp(argv[3], "paths"))
+        paths_bench();
+
+cleanup:
+
+    fsl_mem_unmap((void*)&core.face_buf, CHUNK_VOLUME * sizeof(u64), "main().core.face_buf");
+    fsl_mem_unmap((void*)&core.chunk_buf, WORLD_CHUNKS * sizeof(chunk), "main().core.chunk_buf");
+    fsl_hash_map_free(&core.chunk_map);
+    fsl_mem_arena_free(&core.arena, "main().core.arena");
+    fsl_engine_close();
+    return fsl_err;
+}